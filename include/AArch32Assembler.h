@@ -261,6 +261,10 @@ public:
 	void Vld1_32x4_u(QUAD_REGISTER, REGISTER);
 	void Vstr(SINGLE_REGISTER, REGISTER, const LdrAddress&);
 	void Vst1_32x4(QUAD_REGISTER, REGISTER);
+	void Vpush(DOUBLE_REGISTER, uint8);
+	void Vpop(DOUBLE_REGISTER, uint8);
+	void Vmov(DOUBLE_REGISTER, DOUBLE_REGISTER);
+	void Vmov(SINGLE_REGISTER, SINGLE_REGISTER);
 	void Vmov(DOUBLE_REGISTER, REGISTER, uint8);
 	void Vmov(REGISTER, DOUBLE_REGISTER, uint8);
 	void Vmovn_I16(DOUBLE_REGISTER, QUAD_REGISTER);
@@ -89,6 +89,8 @@ public:
 	LABEL CreateLabel();
 	void ClearLabels();
 	void MarkLabel(LABEL);
+	//NOPs are inserted before the label to align its position in the stream
+	void MarkAlignedLabel(LABEL, uint32);
 	void ResolveLabelReferences();
 	void ResolveLiteralReferences();
 
@@ -107,6 +109,8 @@ public:
 	void Asr(REGISTER64, REGISTER64, uint8);
 	void Asrv(REGISTER32, REGISTER32, REGISTER32);
 	void Asrv(REGISTER64, REGISTER64, REGISTER64);
+	void Bfi(REGISTER32, REGISTER32, uint8, uint8);
+	void Bfxil(REGISTER32, REGISTER32, uint8, uint8);
 	void B(LABEL);
 	void B_offset(uint32);
 	void Bl(uint32);
@@ -151,6 +155,8 @@ public:
 	void Fcvtzs_4s(REGISTERMD, REGISTERMD);
 	void Fdiv_1s(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Fdiv_4s(REGISTERMD, REGISTERMD, REGISTERMD);
+	void Fmadd_1s(REGISTERMD, REGISTERMD, REGISTERMD, REGISTERMD);
+	void Fmla_4s(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Fmov_1s(REGISTERMD, REGISTER32);
 	void Fmov_1s(REGISTERMD, uint8);
 	void Fmov_4s(REGISTERMD, uint8);
@@ -207,6 +213,7 @@ public:
 	void Mvn(REGISTER32, REGISTER32);
 	void Mvn_16b(REGISTERMD, REGISTERMD);
 	void Mvni_4s(REGISTERMD, uint8, MOVI_4S_IMM_SHIFT_TYPE);
+	void Nop();
 	void Orn_16b(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Orr(REGISTER32, REGISTER32, REGISTER32);
 	void Orr(REGISTER32, REGISTER32, uint8, uint8, uint8);
@@ -214,6 +221,7 @@ public:
 	void Ret(REGISTER64 = x30);
 	void Scvtf_1s(REGISTERMD, REGISTERMD);
 	void Scvtf_4s(REGISTERMD, REGISTERMD);
+	void Sbfx(REGISTER32, REGISTER32, uint8, uint8);
 	void Sdiv(REGISTER32, REGISTER32, REGISTER32);
 	void Shl_4s(REGISTERMD, REGISTERMD, uint8);
 	void Shl_8h(REGISTERMD, REGISTERMD, uint8);
@@ -254,8 +262,10 @@ public:
 	void Tbl(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Tst(REGISTER32, REGISTER32);
 	void Tst(REGISTER64, REGISTER64);
+	void Tst(REGISTER32, uint8, uint8, uint8);
 	void Uaddlv_8h(REGISTERMD, REGISTERMD);
 	void Uaddlv_16b(REGISTERMD, REGISTERMD);
+	void Ubfx(REGISTER32, REGISTER32, uint8, uint8);
 	void Udiv(REGISTER32, REGISTER32, REGISTER32);
 	void Umin_4s(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Umov_1s(REGISTER32, REGISTERMD, uint8);
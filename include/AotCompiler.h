@@ -0,0 +1,66 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Jitter.h"
+#include "ObjectFile.h"
+
+namespace Jitter
+{
+	//Compiles functions for ahead of time builds on a pool of worker threads, each owning
+	//its own jitter and code generator. Functions are assigned to object files in the order
+	//they were added, results don't depend on how compilation was scheduled.
+	class CAotCompiler
+	{
+	public:
+		typedef std::function<CCodeGen*()> CodeGenFactory;
+		typedef std::function<void(CJitter&)> FunctionEmitter;
+		typedef std::function<std::unique_ptr<CObjectFile>()> ObjectFileFactory;
+		typedef std::vector<std::unique_ptr<CObjectFile>> ObjectFileArray;
+
+		//Thread count of 0 uses all available hardware threads
+		CAotCompiler(CodeGenFactory, unsigned int = 0);
+		virtual ~CAotCompiler() = default;
+
+		void AddExternalSymbol(const std::string&, uintptr_t);
+
+		//Emitter is called on a worker thread and must generate one complete function (Begin to End)
+		void AddFunction(const std::string&, FunctionEmitter);
+
+		ObjectFileArray Compile(const ObjectFileFactory&, unsigned int = 1);
+
+	private:
+		struct FUNCTION
+		{
+			std::string name;
+			FunctionEmitter emitter;
+		};
+		typedef std::vector<FUNCTION> FunctionArray;
+
+		struct SYMBOL_REFERENCE
+		{
+			uintptr_t value = 0;
+			uint32 offset = 0;
+			CCodeGen::SYMBOL_REF_TYPE refType = CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER;
+		};
+		typedef std::vector<SYMBOL_REFERENCE> SymbolReferenceArray;
+
+		struct COMPILED_FUNCTION
+		{
+			std::vector<uint8> code;
+			SymbolReferenceArray symbolReferences;
+		};
+		typedef std::vector<COMPILED_FUNCTION> CompiledFunctionArray;
+		typedef std::vector<CObjectFile::EXTERNAL_SYMBOL> ExternalSymbolArray;
+
+		void CompileFunctions(CompiledFunctionArray&);
+		void FillObjectFile(CObjectFile&, const CCodeGen&, const CompiledFunctionArray&, size_t, size_t) const;
+
+		CodeGenFactory m_codeGenFactory;
+		unsigned int m_threadCount = 1;
+		ExternalSymbolArray m_externalSymbols;
+		FunctionArray m_functions;
+	};
+}
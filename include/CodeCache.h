@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Types.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Stream.h"
+#include "X86CpuFeatures.h"
+#include "Jitter_CodeGen.h"
+
+namespace Jitter
+{
+	//Persistent machine code cache. Entries are keyed by a fingerprint of the statements
+	//received by the jitter and are appended to a single file that is memory mapped on
+	//first lookup. References to external symbols are stored by name and patched with
+	//the addresses registered in the current process when an entry is read back.
+	//Records are checksummed and the file is locked while it is written, several
+	//processes can share the same cache.
+	class CCodeCache
+	{
+	public:
+		typedef uint64 KEY;
+
+		struct SYMBOL_REFERENCE
+		{
+			uintptr_t value = 0;
+			uint32 offset = 0;
+			CCodeGen::SYMBOL_REF_TYPE type = CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER;
+		};
+		typedef std::vector<SYMBOL_REFERENCE> SymbolReferenceArray;
+		typedef std::vector<uintptr_t> ExternalSymbolArray;
+
+		CCodeCache(std::string, const std::string&, const CX86CpuFeatures& = CX86CpuFeatures());
+		virtual ~CCodeCache();
+
+		CCodeCache(const CCodeCache&) = delete;
+		CCodeCache& operator=(const CCodeCache&) = delete;
+
+		void RegisterExternalSymbol(const std::string&, uintptr_t);
+
+		//Also returns the registered external symbols referenced by the statements
+		KEY ComputeKey(const StatementList&, const std::vector<uint32>&, ExternalSymbolArray&) const;
+
+		//Also returns the symbol references of the entry, with offsets relative to its start
+		bool Lookup(KEY, uint32, Framework::CStream&, SymbolReferenceArray&);
+		void Insert(KEY, const ExternalSymbolArray&, const uint8*, uint32, const SymbolReferenceArray&);
+
+		uint32 GetHitCount() const;
+
+	private:
+		//Relocations without a symbol name refer to unregistered values, those are part of the key
+		struct RELOCATION
+		{
+			uint32 offset = 0;
+			CCodeGen::SYMBOL_REF_TYPE type = CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER;
+			uint64 value = 0;
+			std::string symbolName;
+		};
+		typedef std::vector<RELOCATION> RelocationArray;
+
+		struct ENTRY
+		{
+			const uint8* code = nullptr;
+			uint32 codeSize = 0;
+			RelocationArray relocations;
+		};
+
+		struct SESSION_ENTRY
+		{
+			std::vector<uint8> code;
+			RelocationArray relocations;
+		};
+
+		typedef std::unordered_map<KEY, ENTRY> EntryMap;
+		typedef std::unordered_map<KEY, SESSION_ENTRY> SessionEntryMap;
+		typedef std::unordered_map<uintptr_t, std::string> SymbolNameMap;
+		typedef std::unordered_map<std::string, uintptr_t> SymbolValueMap;
+
+		void MapFile();
+		void UnmapFile();
+		void IndexMappedEntries();
+		bool WriteEntry(Framework::CStream&, uint32, const uint8*, uint32, const RelocationArray&, SymbolReferenceArray&) const;
+		bool AppendRecord(const uint8*, size_t) const;
+		bool ReplaceFile(const uint8*, size_t) const;
+
+		std::string m_path;
+		uint64 m_configKey = 0;
+
+		SymbolNameMap m_symbolNames;
+		SymbolValueMap m_symbolValues;
+
+		bool m_loaded = false;
+		const uint8* m_mappedData = nullptr;
+		size_t m_mappedSize = 0;
+		size_t m_validSize = 0;
+#ifdef _WIN32
+		void* m_fileHandle = nullptr;
+		void* m_mappingHandle = nullptr;
+#endif
+		EntryMap m_entries;
+		SessionEntryMap m_sessionEntries;
+		uint32 m_hitCount = 0;
+	};
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Jitter.h"
+#include "MemoryFunction.h"
+
+namespace Jitter
+{
+	//Compiles functions on worker threads, each with its own code generator, while the
+	//thread submitting jobs keeps running. Finished functions are handed back through a
+	//lock-free list and are picked up by calling CollectResults. Jobs that fail to compile
+	//never produce a result.
+	class CCompileService
+	{
+	public:
+		typedef std::function<CCodeGen*()> CodeGenFactory;
+
+		class CJob
+		{
+		public:
+			uint64 GetTag() const;
+
+			//Compiled function won't be returned by CollectResults once this returns
+			void Cancel();
+			bool IsCancelled() const;
+
+		private:
+			friend class CCompileService;
+
+			uint64 m_tag = 0;
+			CSymbolTable m_symbolTable;
+			StatementList m_statements;
+			std::atomic<bool> m_cancelled{false};
+		};
+		typedef std::shared_ptr<CJob> JobPtr;
+
+		struct RESULT
+		{
+			uint64 tag = 0;
+			CMemoryFunction function;
+		};
+		typedef std::function<void(RESULT&)> ResultHandler;
+
+		//Thread count of 0 uses all available hardware threads
+		CCompileService(CodeGenFactory, unsigned int = 1);
+		virtual ~CCompileService();
+
+		CCompileService(const CCompileService&) = delete;
+		CCompileService& operator=(const CCompileService&) = delete;
+
+		//Statements are copied, they can be discarded by the caller once this returns
+		JobPtr Submit(uint64, const StatementList&);
+
+		//Must be called from a single thread, the one that submits and cancels jobs
+		void CollectResults(const ResultHandler&);
+
+		//Blocks until all submitted jobs are compiled or cancelled
+		void WaitForIdle();
+
+	private:
+		struct COMPLETED_JOB
+		{
+			JobPtr job;
+			std::vector<uint8> code;
+			CMemoryFunction function;
+			COMPLETED_JOB* next = nullptr;
+		};
+
+		void WorkerThreadProc();
+		void PublishResult(COMPLETED_JOB*);
+
+		CodeGenFactory m_codeGenFactory;
+		std::vector<std::thread> m_threads;
+
+		std::mutex m_jobsMutex;
+		std::condition_variable m_jobsCondition;
+		std::condition_variable m_idleCondition;
+		std::deque<JobPtr> m_jobs;
+		unsigned int m_activeJobCount = 0;
+		bool m_stopping = false;
+
+		std::atomic<COMPLETED_JOB*> m_completedJobs{nullptr};
+	};
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Types.h"
+
+namespace Elf
+{
+	enum
+	{
+		ELF_MAGIC = 0x464C457F, //'\x7F' 'E' 'L' 'F'
+	};
+
+	enum IDENT
+	{
+		EI_CLASS = 4,
+		EI_DATA = 5,
+		EI_VERSION = 6,
+		EI_OSABI = 7,
+		EI_NIDENT = 16,
+
+		ELFCLASS64 = 2,
+		ELFDATA2LSB = 1,
+		EV_CURRENT = 1,
+		ELFOSABI_NONE = 0,
+	};
+
+	enum FILE_TYPE
+	{
+		ET_REL = 1,
+	};
+
+	enum MACHINE_TYPE
+	{
+		EM_X86_64 = 62,
+		EM_AARCH64 = 183,
+	};
+
+	enum SECTION_TYPE
+	{
+		SHT_NULL = 0,
+		SHT_PROGBITS = 1,
+		SHT_SYMTAB = 2,
+		SHT_STRTAB = 3,
+		SHT_RELA = 4,
+	};
+
+	enum SECTION_FLAGS
+	{
+		SHF_WRITE = 0x01,
+		SHF_ALLOC = 0x02,
+		SHF_EXECINSTR = 0x04,
+		SHF_INFO_LINK = 0x40,
+	};
+
+	enum SECTION_INDEX
+	{
+		SHN_UNDEF = 0,
+	};
+
+	enum SYMBOL_BINDING
+	{
+		STB_LOCAL = 0,
+		STB_GLOBAL = 1,
+	};
+
+	enum SYMBOL_TYPE
+	{
+		STT_NOTYPE = 0,
+		STT_OBJECT = 1,
+		STT_FUNC = 2,
+	};
+
+	enum SYMBOL_VISIBILITY
+	{
+		STV_DEFAULT = 0,
+		STV_HIDDEN = 2,
+	};
+
+	enum RELOC_TYPE
+	{
+		R_X86_64_64 = 1,
+		R_X86_64_PLT32 = 4,
+
+		R_AARCH64_ABS64 = 257,
+		R_AARCH64_CALL26 = 283,
+	};
+
+	struct HEADER_64
+	{
+		uint8 ident[EI_NIDENT];
+		uint16 type;
+		uint16 machine;
+		uint32 version;
+		uint64 entry;
+		uint64 programHeaderOffset;
+		uint64 sectionHeaderOffset;
+		uint32 flags;
+		uint16 headerSize;
+		uint16 programHeaderEntrySize;
+		uint16 programHeaderCount;
+		uint16 sectionHeaderEntrySize;
+		uint16 sectionHeaderCount;
+		uint16 sectionNameStringTableIndex;
+	};
+	static_assert(sizeof(HEADER_64) == 0x40, "Size of HEADER_64 structure must be 64 bytes.");
+
+	struct SECTION_HEADER_64
+	{
+		uint32 name;
+		uint32 type;
+		uint64 flags;
+		uint64 address;
+		uint64 offset;
+		uint64 size;
+		uint32 link;
+		uint32 info;
+		uint64 addressAlign;
+		uint64 entrySize;
+	};
+	static_assert(sizeof(SECTION_HEADER_64) == 0x40, "Size of SECTION_HEADER_64 structure must be 64 bytes.");
+
+	struct SYMBOL_64
+	{
+		uint32 name;
+		uint8 info;
+		uint8 other;
+		uint16 sectionIndex;
+		uint64 value;
+		uint64 size;
+	};
+	static_assert(sizeof(SYMBOL_64) == 0x18, "Size of SYMBOL_64 structure must be 24 bytes.");
+
+	struct RELOCATION_ADDEND_64
+	{
+		uint64 offset;
+		uint64 info;
+		int64 addend;
+	};
+	static_assert(sizeof(RELOCATION_ADDEND_64) == 0x18, "Size of RELOCATION_ADDEND_64 structure must be 24 bytes.");
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ObjectFile.h"
+#include "ElfDefs.h"
+#include <vector>
+
+namespace Jitter
+{
+	//ELF64 relocatable object file, supports x86-64 and AArch64
+	class CElfObjectFile : public CObjectFile
+	{
+	public:
+		CElfObjectFile(CPU_ARCH);
+		virtual ~CElfObjectFile() = default;
+
+		void Write(Framework::CStream&) override;
+
+	private:
+		typedef std::vector<Elf::SECTION_HEADER_64> SectionHeaderArray;
+		typedef std::vector<Elf::RELOCATION_ADDEND_64> RelocationArray;
+		typedef std::vector<Elf::SYMBOL_64> SymbolArray;
+
+		struct INTERNAL_SYMBOL_INFO
+		{
+			INTERNAL_SYMBOL_INFO()
+			{
+				nameOffset = 0;
+				dataOffset = 0;
+				symbolIndex = 0;
+			}
+
+			uint32 nameOffset;
+			uint32 dataOffset;
+			uint32 symbolIndex;
+		};
+		typedef std::vector<INTERNAL_SYMBOL_INFO> InternalSymbolInfoArray;
+
+		struct EXTERNAL_SYMBOL_INFO
+		{
+			EXTERNAL_SYMBOL_INFO()
+			{
+				nameOffset = 0;
+				symbolIndex = 0;
+			}
+
+			uint32 nameOffset;
+			uint32 symbolIndex;
+		};
+		typedef std::vector<EXTERNAL_SYMBOL_INFO> ExternalSymbolInfoArray;
+
+		typedef std::vector<char> StringTable;
+		typedef std::vector<uint8> SectionData;
+
+		struct SECTION
+		{
+			SectionData data;
+			SymbolReferenceArray symbolReferences;
+		};
+
+		static uint32 AddString(StringTable&, const std::string&);
+		static void FillStringTable(StringTable&, const InternalSymbolArray&, InternalSymbolInfoArray&);
+		static void FillStringTable(StringTable&, const ExternalSymbolArray&, ExternalSymbolInfoArray&);
+		static SECTION BuildSection(const InternalSymbolArray&, InternalSymbolInfoArray&, INTERNAL_SYMBOL_LOCATION);
+		static SymbolArray BuildSymbols(const InternalSymbolArray&, InternalSymbolInfoArray&, const ExternalSymbolArray&, ExternalSymbolInfoArray&);
+		RelocationArray BuildRelocations(SECTION&, const InternalSymbolInfoArray&, const ExternalSymbolInfoArray&) const;
+	};
+}
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <memory>
 #include <list>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <vector>
 #include <stack>
@@ -12,6 +14,7 @@
 #include "Stream.h"
 #include "Jitter_SymbolTable.h"
 #include "Jitter_CodeGen.h"
+#include "Jitter_CompileStats.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX ((size_t)-1)
@@ -21,6 +24,7 @@
 
 namespace Jitter
 {
+	class CCodeCache;
 
 	class CJitter
 	{
@@ -43,12 +47,24 @@ namespace Jitter
 
 		typedef unsigned int LABEL;
 
+		//Receives the statements of a function before they are compiled, blocks are delimited by OP_LABEL
+		typedef std::function<void(const StatementList&)> CaptureHandler;
+
+		typedef std::vector<uint32> RelativeOffsetArray;
+
 		CJitter(CCodeGen*);
 		virtual ~CJitter();
 
 		virtual void Begin();
 		virtual void End();
 
+		//Ends the function without compiling it. Statements are in the capture handler's format
+		//and reference symbols owned by the jitter, they stay valid until the next call to Begin
+		StatementList EndCapture();
+
+		//Compiles a function previously received by the capture handler
+		void Replay(const StatementList&);
+
 		bool IsStackEmpty() const;
 
 		void BeginIf(CONDITION);
@@ -159,6 +175,8 @@ namespace Jitter
 		void FP_MaxS();
 		void FP_MinS();
 		void FP_MulS();
+		void FP_MulAddS();
+		void FP_FusedMulAddS();
 		void FP_DivS();
 		void FP_CmpS(CONDITION);
 		void FP_NegS();
@@ -212,6 +230,7 @@ namespace Jitter
 		void MD_CmpGtS();
 		void MD_DivS();
 		void MD_ExpandW();
+		void MD_FusedMulAddS();
 		void MD_MakeClip();
 		void MD_MakeSignZero();
 		void MD_MaxH();
@@ -220,12 +239,15 @@ namespace Jitter
 		void MD_MinH();
 		void MD_MinW();
 		void MD_MinS();
+		void MD_MulAddS();
 		void MD_MulS();
 		void MD_NegS();
 		void MD_Not();
 		void MD_Or();
 		void MD_PackHB();
 		void MD_PackWH();
+		void MD_ShuffleB(const std::array<uint8, 16>&);
+		void MD_ShuffleW(uint8);
 		void MD_SllH(uint8);
 		void MD_SllW(uint8);
 		void MD_SraH(uint8);
@@ -256,6 +278,13 @@ namespace Jitter
 		CCodeGen* GetCodeGen();
 
 		void SetStream(Framework::CStream*);
+		void SetCodeCache(CCodeCache*);
+		void SetCaptureHandler(const CaptureHandler&);
+		void SetCompileStats(CCompileStats*);
+
+		//Context offsets whose value isn't read once compiled functions return or jump to another function
+		//(ie.: every successor overwrites them first). Stores to these that aren't read before exiting are removed.
+		void SetDeadOnExitRelatives(RelativeOffsetArray);
 
 	private:
 		struct SYMBOL_REGALLOCINFO
@@ -297,9 +326,22 @@ namespace Jitter
 			CSymbolTable symbolTable;
 			bool optimized = false;
 			bool hasJumpRef = false;
+			//Indexed like m_deadOnExitRelatives, set if the relative is overwritten before being read once the block exits
+			std::vector<bool> deadRelatives;
+			//Registers, taken from the end of the allocatable ones, holding values that live across the block's loop
+			unsigned int loopRegisterCount = 0;
+			//Set on exits added to loops, these only copy loop registers back and aren't register allocated
+			bool loopBoundary = false;
 		};
 		typedef std::list<BASIC_BLOCK> BasicBlockList;
 
+		struct LOOP
+		{
+			uint32 headerId = 0;
+			std::set<uint32> blockIds;
+		};
+		typedef std::vector<LOOP> LoopArray;
+
 		struct VERSIONED_STATEMENT_LIST
 		{
 			StatementList statements;
@@ -314,19 +356,36 @@ namespace Jitter
 		void InsertBinary64Statement(Jitter::OPERATION);
 		void InsertUnaryFp32Statement(Jitter::OPERATION);
 		void InsertBinaryFp32Statement(Jitter::OPERATION);
+		void InsertTernaryFp32Statement(Jitter::OPERATION);
 		void InsertUnaryMdStatement(Jitter::OPERATION);
 		void InsertBinaryMdStatement(Jitter::OPERATION);
+		void InsertTernaryMdStatement(Jitter::OPERATION);
 
 		void Compile();
+		void CompileCached();
+		StatementList FlattenBasicBlocks() const;
 
 		bool ConstantFolding(StatementList&);
+		bool MdConstantFolding(StatementList&);
 		bool ConstantPropagation(StatementList&);
 		bool CopyPropagation(StatementList&);
+		bool SimplifyKnownBits(StatementList&);
 		bool ReorderAdd(StatementList&);
 		bool CommonExpressionElimination(VERSIONED_STATEMENT_LIST&);
 		bool ClampingElimination(StatementList&);
 		bool MergeCmpSelectOps(StatementList&);
+		bool MergeCmpCondJmp(StatementList&);
+		bool FoldRelativeReferences(StatementList&);
+		bool MergeBitfieldOps(StatementList&);
+		bool StrengthReduceDivision(StatementList&);
+		bool StrengthReduceMultiplication(StatementList&);
 		bool DeadcodeElimination(VERSIONED_STATEMENT_LIST&);
+		void ComputeDeadRelatives();
+		bool IsRelativeDeadOnBlockExit(const BASIC_BLOCK&, uint32) const;
+		static bool MayReadAnyRelative(OPERATION);
+		bool OptimizeLoops();
+		LoopArray FindInnermostLoops() const;
+		bool OptimizeLoop(const LOOP&, unsigned int);
 
 		void FixFlowControl(StatementList&);
 
@@ -360,11 +419,14 @@ namespace Jitter
 		void PruneSymbols(BASIC_BLOCK&) const;
 
 		void AllocateRegisters(BASIC_BLOCK&);
+		void LowerAliasedLaneAccesses(BASIC_BLOCK&);
 		static AllocationRangeArray ComputeAllocationRanges(const BASIC_BLOCK&);
 		void ComputeLivenessForRange(const BASIC_BLOCK&, const AllocationRange&, SymbolRegAllocInfo&) const;
 		void MarkAliasedSymbols(const BASIC_BLOCK&, const AllocationRange&, SymbolRegAllocInfo&) const;
-		void AssociateSymbolsToRegisters(SymbolRegAllocInfo&) const;
+		void AssociateSymbolsToRegisters(SymbolRegAllocInfo&, unsigned int) const;
+		static unsigned int GetLastAccess(const SYMBOL_REGALLOCINFO&);
 
+		void CombineAdjacentStores(BASIC_BLOCK&, bool);
 		void NormalizeStatements(BASIC_BLOCK&);
 		unsigned int AllocateStack(BASIC_BLOCK&);
 
@@ -379,11 +441,20 @@ namespace Jitter
 		BASIC_BLOCK* m_currentBlock = nullptr;
 		BasicBlockList m_basicBlocks;
 		CCodeGen* m_codeGen = nullptr;
+		Framework::CStream* m_stream = nullptr;
+		CCodeCache* m_codeCache = nullptr;
+		CaptureHandler m_captureHandler;
+		CCompileStats* m_compileStats = nullptr;
+		RelativeOffsetArray m_deadOnExitRelatives;
 
 		unsigned int m_nextLabelId = 1;
 		LabelMapType m_labels;
 
 		bool m_codeGenSupportsCmpSelect = false;
+		bool m_codeGenSupportsBitfieldOps = false;
+		bool m_codeGenSupportsPairedStores = false;
+		bool m_codeGenSupportsLoopRegisters = false;
+		bool m_codeGenSupportsMdLaneOps = false;
 	};
 
 }
@@ -2,7 +2,9 @@
 
 #include "Stream.h"
 #include "Jitter_Statement.h"
+#include "Literal128.h"
 #include <map>
+#include <set>
 #include <functional>
 
 namespace Jitter
@@ -17,6 +19,7 @@ namespace Jitter
 			NATIVE_POINTER,
 			ARMV7_LOAD_HALF,
 			ARMV8_PCRELATIVE,
+			X86_64_PCRELATIVE,
 		};
 
 		typedef std::function<void(uintptr_t, uint32, SYMBOL_REF_TYPE)> ExternalSymbolReferencedHandler;
@@ -25,6 +28,7 @@ namespace Jitter
 
 		virtual void SetStream(Framework::CStream*) = 0;
 		void SetExternalSymbolReferencedHandler(const ExternalSymbolReferencedHandler&);
+		const ExternalSymbolReferencedHandler& GetExternalSymbolReferencedHandler() const;
 
 		virtual void GenerateCode(const StatementList&, unsigned int) = 0;
 		virtual unsigned int GetAvailableRegisterCount() const = 0;
@@ -33,6 +37,16 @@ namespace Jitter
 		virtual bool CanHold128BitsReturnValueInRegisters() const = 0;
 		virtual bool SupportsExternalJumps() const = 0;
 		virtual bool SupportsCmpSelect() const = 0;
+		virtual bool SupportsBitfieldOps() const = 0;
+		//Whether storing two 32-bit values with OP_MERGETO64 is cheaper than two separate stores
+		virtual bool SupportsPairedStores() const = 0;
+		//Whether values can be kept in registers across the blocks of a loop, which requires blocks
+		//to be inserted before the loop and on its exits
+		virtual bool SupportsLoopRegisters() const = 0;
+		//Whether a single FP32 lane of a MD register can be read or written without going through memory
+		virtual bool SupportsMdLaneOps() const = 0;
+		//Relative cost of an operation, used by the optimizer to decide if strength reductions are profitable
+		virtual unsigned int GetOperationCost(OPERATION) const = 0;
 		virtual void RegisterExternalSymbols(CObjectFile*) const = 0;
 		virtual uint32 GetPointerSize() const = 0;
 
@@ -96,6 +110,15 @@ namespace Jitter
 		bool SymbolMatches(MATCHTYPE, const SymbolRefPtr&);
 		static uint32 GetRegisterUsage(const StatementList&);
 
+		//Labels targeted by jumps coming after them, which start loops
+		static std::set<uint32> GetLoopHeadLabels(const StatementList&);
+
+		//Byte mask holding the source byte index of every destination byte of a MD_SHUFFLE_W/B statement
+		static LITERAL128 GetMdShuffleByteMask(const STATEMENT&);
+
+		//Value loaded by a MD_LDCST statement
+		static LITERAL128 GetMdLiteral(const STATEMENT&);
+
 		MatcherMapType m_matchers;
 		ExternalSymbolReferencedHandler m_externalSymbolReferencedHandler;
 	};
@@ -31,6 +31,11 @@ namespace Jitter
 		bool Has128BitsCallOperands() const override;
 		bool SupportsExternalJumps() const override;
 		bool SupportsCmpSelect() const override;
+		bool SupportsBitfieldOps() const override;
+		bool SupportsPairedStores() const override;
+		bool SupportsLoopRegisters() const override;
+		bool SupportsMdLaneOps() const override;
+		unsigned int GetOperationCost(OPERATION) const override;
 		uint32 GetPointerSize() const override;
 
 	private:
@@ -41,6 +46,7 @@ namespace Jitter
 		{
 			bool prepared = false;
 			unsigned int index = 0;
+			uint32 spillOffset = 0;
 		};
 
 		class CTempRegisterContext
@@ -74,6 +80,11 @@ namespace Jitter
 			MAX_REGISTERS = 6,
 		};
 
+		enum
+		{
+			MAX_MDREGISTERS = 12,
+		};
+
 		struct CONSTMATCHER
 		{
 			OPERATION op;
@@ -87,6 +98,9 @@ namespace Jitter
 		void InsertMatchers(const CONSTMATCHER*);
 
 		static uint16 GetSavedRegisterList(uint32);
+		static uint32 GetMdRegisterUsage(const StatementList&);
+		static uint8 GetSavedMdRegisterCount(uint32);
+		static uint32 GetMaxParamSpillSize(const StatementList&);
 
 		void Emit_Prolog();
 		void Emit_Epilog();
@@ -124,12 +138,27 @@ namespace Jitter
 		void LoadTemporaryFp32InRegister(CTempRegisterContext&, CAArch32Assembler::SINGLE_REGISTER, CSymbol*);
 		void StoreRegisterInTemporaryFp32(CTempRegisterContext&, CSymbol*, CAArch32Assembler::SINGLE_REGISTER);
 
+		void LoadSymbolFp32InRegister(CTempRegisterContext&, CAArch32Assembler::SINGLE_REGISTER, CSymbol*);
+		void StoreRegisterInSymbolFp32(CTempRegisterContext&, CSymbol*, CAArch32Assembler::SINGLE_REGISTER);
+
+		CAArch32Assembler::SINGLE_REGISTER PrepareSymbolRegisterDefFp32(CSymbol*, CAArch32Assembler::SINGLE_REGISTER);
+		CAArch32Assembler::SINGLE_REGISTER PrepareSymbolRegisterUseFp32(CTempRegisterContext&, CSymbol*, CAArch32Assembler::SINGLE_REGISTER);
+		void CommitSymbolRegisterFp32(CTempRegisterContext&, CSymbol*, CAArch32Assembler::SINGLE_REGISTER);
+
 		void LoadMemory128AddressInRegister(CAArch32Assembler::REGISTER, CSymbol*, uint32 = 0);
 		void LoadRelative128AddressInRegister(CAArch32Assembler::REGISTER, CSymbol*, uint32);
 		void LoadTemporary128AddressInRegister(CAArch32Assembler::REGISTER, CSymbol*, uint32);
 
 		void LoadTemporary256ElementAddressInRegister(CAArch32Assembler::REGISTER, CSymbol*, uint32);
 
+		void LoadMemory128InRegister(CAArch32Assembler::QUAD_REGISTER, CSymbol*);
+		void StoreRegisterInMemory128(CSymbol*, CAArch32Assembler::QUAD_REGISTER);
+		void LoadSymbol128HalfInRegister(CAArch32Assembler::DOUBLE_REGISTER, CSymbol*, uint32);
+
+		CAArch32Assembler::QUAD_REGISTER PrepareSymbolRegisterDefMd(CSymbol*, CAArch32Assembler::QUAD_REGISTER);
+		CAArch32Assembler::QUAD_REGISTER PrepareSymbolRegisterUseMd(CSymbol*, CAArch32Assembler::QUAD_REGISTER);
+		void CommitSymbolRegisterMd(CSymbol*, CAArch32Assembler::QUAD_REGISTER);
+
 		CAArch32Assembler::REGISTER PrepareSymbolRegisterDef(CSymbol*, CAArch32Assembler::REGISTER);
 		CAArch32Assembler::REGISTER PrepareSymbolRegisterUse(CSymbol*, CAArch32Assembler::REGISTER);
 		void CommitSymbolRegister(CSymbol*, CAArch32Assembler::REGISTER);
@@ -537,6 +566,7 @@ namespace Jitter
 		void Emit_Param_Mem64(const STATEMENT&);
 		void Emit_Param_Cst64(const STATEMENT&);
 		void Emit_Param_Mem128(const STATEMENT&);
+		void Emit_Param_Reg128(const STATEMENT&);
 
 		//PARAM_RET
 		void Emit_ParamRet_Tmp128(const STATEMENT&);
@@ -697,76 +727,88 @@ namespace Jitter
 
 		//FPUOP
 		template <typename>
-		void Emit_Fpu_MemMem(const STATEMENT&);
+		void Emit_Fpu_VarVar(const STATEMENT&);
 		template <typename>
-		void Emit_Fpu_MemMemMem(const STATEMENT&);
+		void Emit_Fpu_VarVarVar(const STATEMENT&);
 		template <typename>
-		void Emit_FpuMd_MemMemMem(const STATEMENT&);
-		void Emit_Fp_Rcpl_MemMem(const STATEMENT&);
-		void Emit_Fp_Rsqrt_MemMem(const STATEMENT&);
-		void Emit_Fp_Clamp_MemMem(const STATEMENT&);
-		void Emit_Fp_Cmp_AnyMemMem(const STATEMENT&);
-		void Emit_Fp_ToSingleI32_MemMem(const STATEMENT&);
-		void Emit_Fp_ToInt32TruncS_MemMem(const STATEMENT&);
+		void Emit_FpuMd_VarVarVar(const STATEMENT&);
+		void Emit_Fp_MulAdd_VarVarVarVar(const STATEMENT&);
+		void Emit_Fp_Rcpl_VarVar(const STATEMENT&);
+		void Emit_Fp_Rsqrt_VarVar(const STATEMENT&);
+		void Emit_Fp_Clamp_VarVar(const STATEMENT&);
+		void Emit_Fp_Cmp_AnyVarVar(const STATEMENT&);
+		void Emit_Fp_ToSingleI32_VarVar(const STATEMENT&);
+		void Emit_Fp_ToInt32TruncS_VarVar(const STATEMENT&);
+		void Emit_Fp_Mov_RegMem(const STATEMENT&);
+		void Emit_Fp_Mov_MemReg(const STATEMENT&);
+		void Emit_Fp_LdCst_RegCst(const STATEMENT&);
 		void Emit_Fp_LdCst_TmpCst(const STATEMENT&);
 		void Emit_Fp_SetRoundingMode_Cst(const STATEMENT&);
 
 		//MDOP
 		template <typename>
-		void Emit_Md_MemMem(const STATEMENT&);
+		void Emit_Md_VarVar(const STATEMENT&);
 		template <typename>
-		void Emit_Md_MemMemMem(const STATEMENT&);
+		void Emit_Md_VarVarVar(const STATEMENT&);
 		template <typename>
-		void Emit_Md_MemMemMemRev(const STATEMENT&);
+		void Emit_Md_VarVarVarRev(const STATEMENT&);
 		template <typename>
-		void Emit_Md_Shift_MemMemCst(const STATEMENT&);
-
-		void Emit_Md_Mov_MemMem(const STATEMENT&);
-		void Emit_Md_DivS_MemMemMem(const STATEMENT&);
-
-		void Emit_Md_Srl256_MemMemVar(const STATEMENT&);
-		void Emit_Md_Srl256_MemMemCst(const STATEMENT&);
-
-		void Emit_Md_LoadFromRef_MemVar(const STATEMENT&);
-		void Emit_Md_LoadFromRef_MemVarAny(const STATEMENT&);
-		void Emit_Md_StoreAtRef_VarMem(const STATEMENT&);
-		void Emit_Md_StoreAtRef_VarAnyMem(const STATEMENT&);
-		void Emit_Md_LoadFromRefMasked_MemMemAnyMem(const STATEMENT&);
-		void Emit_Md_StoreAtRefMasked_MemAnyMem(const STATEMENT&);
-
-		void Emit_Md_MovMasked_MemMemMem(const STATEMENT&);
-		void Emit_Md_ExpandW_MemReg(const STATEMENT&);
-		void Emit_Md_ExpandW_MemMem(const STATEMENT&);
-		void Emit_Md_ExpandW_MemCst(const STATEMENT&);
+		void Emit_Md_Shift_VarVarCst(const STATEMENT&);
+
+		void Emit_Md_Mov_VarVar(const STATEMENT&);
+		void Emit_Md_DivS_VarVarVar(const STATEMENT&);
+		void Emit_Md_MulAddS_VarVarVarVar(const STATEMENT&);
+
+		void Emit_Md_Srl256_VarMemVar(const STATEMENT&);
+		void Emit_Md_Srl256_VarMemCst(const STATEMENT&);
+
+		void Emit_Md_LoadFromRef_VarVar(const STATEMENT&);
+		void Emit_Md_LoadFromRef_VarVarAny(const STATEMENT&);
+		void Emit_Md_StoreAtRef_VarVar(const STATEMENT&);
+		void Emit_Md_StoreAtRef_VarAnyVar(const STATEMENT&);
+		void Emit_Md_LoadFromRefMasked_VarVarAnyVar(const STATEMENT&);
+		void Emit_Md_StoreAtRefMasked_VarAnyVar(const STATEMENT&);
+
+		void Emit_Md_MovMasked_VarVarVar(const STATEMENT&);
+		void Emit_Md_ExpandW_VarReg(const STATEMENT&);
+		void Emit_Md_ExpandW_VarMem(const STATEMENT&);
+		void Emit_Md_ExpandW_VarCst(const STATEMENT&);
 		void Emit_Md_ExpandW_VarVarCst(const STATEMENT&);
+		void Emit_Md_LdCst_VarCstCst(const STATEMENT&);
+		void Emit_Md_ExtractLaneS_VarVarCst(const STATEMENT&);
+		void Emit_Md_InsertLaneS_VarVarVarCst(const STATEMENT&);
+
+		void Emit_Md_ClampS_VarVar(const STATEMENT&);
 
-		void Emit_Md_ClampS_MemMem(const STATEMENT&);
+		void Emit_Md_MakeClip_VarVarVarVar(const STATEMENT&);
+		void Emit_Md_MakeSz_VarVar(const STATEMENT&);
 
-		void Emit_Md_MakeClip_VarMemMemMem(const STATEMENT&);
-		void Emit_Md_MakeSz_VarMem(const STATEMENT&);
+		void Emit_Md_PackHB_VarVarVar(const STATEMENT&);
+		void Emit_Md_PackWH_VarVarVar(const STATEMENT&);
 
-		void Emit_Md_PackHB_MemMemMem(const STATEMENT&);
-		void Emit_Md_PackWH_MemMemMem(const STATEMENT&);
+		void Emit_Md_Shuffle_VarVarCst(const STATEMENT&);
 
 		template <uint32>
-		void Emit_Md_UnpackBH_MemMemMem(const STATEMENT&);
+		void Emit_Md_UnpackBH_VarVarVar(const STATEMENT&);
 		template <uint32>
-		void Emit_Md_UnpackHW_MemMemMem(const STATEMENT&);
+		void Emit_Md_UnpackHW_VarVarVar(const STATEMENT&);
 		template <uint32>
-		void Emit_Md_UnpackWD_MemMemMem(const STATEMENT&);
+		void Emit_Md_UnpackWD_VarVarVar(const STATEMENT&);
 
-		void Emit_MergeTo256_MemMemMem(const STATEMENT&);
+		void Emit_MergeTo256_MemVarVar(const STATEMENT&);
 
 		static CONSTMATCHER g_constMatchers[];
 		static CONSTMATCHER g_64ConstMatchers[];
 		static CONSTMATCHER g_fpuConstMatchers[];
 		static CONSTMATCHER g_mdConstMatchers[];
 		static CAArch32Assembler::REGISTER g_registers[MAX_REGISTERS];
+		static CAArch32Assembler::QUAD_REGISTER g_registersMd[MAX_MDREGISTERS];
 		static CAArch32Assembler::REGISTER g_paramRegs[MAX_PARAM_REGS];
 		static CAArch32Assembler::REGISTER g_baseRegister;
 		static CAArch32Assembler::REGISTER g_callAddressRegister;
 		static CAArch32Assembler::REGISTER g_tempParamRegister0;
 		static CAArch32Assembler::REGISTER g_tempParamRegister1;
+		static CAArch32Assembler::REGISTER g_mdAddressRegister;
 
 		static const LITERAL128 g_fpClampMask1;
 		static const LITERAL128 g_fpClampMask2;
@@ -778,6 +820,8 @@ namespace Jitter
 		ParamStack m_params;
 		uint32 m_stackSize = 0;
 		uint16 m_registerSave = 0;
+		uint8 m_mdRegisterSaveCount = 0;
+		uint32 m_paramSpillBase = 0;
 		uint32 m_stackLevel = 0;
 		bool m_hasIntegerDiv = false;
 	};
@@ -24,6 +24,11 @@ namespace Jitter
 		bool CanHold128BitsReturnValueInRegisters() const override;
 		bool SupportsExternalJumps() const override;
 		bool SupportsCmpSelect() const override;
+		bool SupportsBitfieldOps() const override;
+		bool SupportsPairedStores() const override;
+		bool SupportsLoopRegisters() const override;
+		bool SupportsMdLaneOps() const override;
+		unsigned int GetOperationCost(OPERATION) const override;
 		uint32 GetPointerSize() const override;
 
 	private:
@@ -78,6 +83,11 @@ namespace Jitter
 			MAX_TEMP_MD_REGS = 4,
 		};
 
+		enum
+		{
+			LOOP_ALIGNMENT = 0x10,
+		};
+
 		struct CONSTMATCHER
 		{
 			OPERATION op;
@@ -633,6 +643,7 @@ namespace Jitter
 
 		void Emit_Not_VarVar(const STATEMENT&);
 		void Emit_Lzc_VarVar(const STATEMENT&);
+		void Emit_InsertBits_VarAnyAnyCst(const STATEMENT&);
 
 		void Emit_Mov_Mem64Mem64(const STATEMENT&);
 		void Emit_Mov_Mem64Cst64(const STATEMENT&);
@@ -731,6 +742,10 @@ namespace Jitter
 		template <typename>
 		void Emit_Logic_VarVarCst(const STATEMENT&);
 
+		//BITFIELD
+		template <bool>
+		void Emit_ExtractBits_VarVarCstCst(const STATEMENT&);
+
 		//MUL
 		template <bool>
 		void Emit_Mul_Tmp64AnyAny(const STATEMENT&);
@@ -760,6 +775,8 @@ namespace Jitter
 		void Emit_Fp_Cmp_AnyVarVar(const STATEMENT&);
 		void Emit_Fp_Rcpl_VarVar(const STATEMENT&);
 		void Emit_Fp_Rsqrt_VarVar(const STATEMENT&);
+		void Emit_Fp_MulAdd_VarVarVarVar(const STATEMENT&);
+		void Emit_Fp_FusedMulAdd_VarVarVarVar(const STATEMENT&);
 		void Emit_Fp_Clamp_VarVar(const STATEMENT&);
 		void Emit_Fp_ToSingleI32_VarVar(const STATEMENT&);
 		void Emit_Fp_ToInt32TruncS_VarVar(const STATEMENT&);
@@ -775,6 +792,8 @@ namespace Jitter
 		void Emit_Md_Shift_VarVarCst(const STATEMENT&);
 
 		void Emit_Md_ClampS_VarVar(const STATEMENT&);
+		void Emit_Md_MulAddS_VarVarVarVar(const STATEMENT&);
+		void Emit_Md_FusedMulAddS_VarVarVarVar(const STATEMENT&);
 		void Emit_Md_MakeClip_VarVarVarVar(const STATEMENT&);
 		void Emit_Md_MakeSz_VarVar(const STATEMENT&);
 
@@ -796,6 +815,12 @@ namespace Jitter
 		void Emit_Md_ExpandW_VarMem(const STATEMENT&);
 		void Emit_Md_ExpandW_VarCst(const STATEMENT&);
 		void Emit_Md_ExpandW_VarVarCst(const STATEMENT&);
+		void Emit_Md_LdCst_VarCstCst(const STATEMENT&);
+		void Emit_Md_ExtractLaneS_VarVarCst(const STATEMENT&);
+		void Emit_Md_InsertLaneS_VarVarVarCst(const STATEMENT&);
+
+		void Emit_Md_ShuffleW_VarVarCst(const STATEMENT&);
+		void Emit_Md_ShuffleB_VarVarCst(const STATEMENT&);
 
 		void Emit_Md_PackHB_VarVarVar(const STATEMENT&);
 		void Emit_Md_PackWH_VarVarVar(const STATEMENT&);
@@ -824,6 +849,7 @@ namespace Jitter
 		Framework::CStream* m_stream = nullptr;
 		CAArch64Assembler m_assembler;
 		LabelMapType m_labels;
+		std::set<uint32> m_loopHeadLabels;
 		ParamStack m_params;
 		uint32 m_nextTempRegister = 0;
 		uint32 m_nextTempRegisterMd = 0;
@@ -1,10 +1,11 @@
 #pragma once
 
+#include <map>
+#include <shared_mutex>
 #include <stack>
 #include "Jitter_CodeGen.h"
 #include "MemStream.h"
-
-class CWasmModuleBuilder;
+#include "WasmModuleBuilder.h"
 
 namespace Jitter
 {
@@ -21,7 +22,9 @@ namespace Jitter
 		static const WASM_FUNCTION_INFO* FindFunction(uintptr_t);
 
 	private:
+		//Code generators running on other threads look up functions while they're registered
 		static std::map<uintptr_t, WASM_FUNCTION_INFO> m_functions;
+		static std::shared_mutex m_functionsMutex;
 	};
 
 	class CCodeGen_Wasm : public CCodeGen
@@ -39,8 +42,18 @@ namespace Jitter
 		bool CanHold128BitsReturnValueInRegisters() const override;
 		bool SupportsExternalJumps() const override;
 		bool SupportsCmpSelect() const override;
+		bool SupportsBitfieldOps() const override;
+		bool SupportsPairedStores() const override;
+		bool SupportsLoopRegisters() const override;
+		bool SupportsMdLaneOps() const override;
+		unsigned int GetOperationCost(OPERATION) const override;
 		uint32 GetPointerSize() const override;
 
+		//Functions generated between BeginModule and EndModule are written to the stream as a single module
+		void BeginModule();
+		void RegisterModuleFunction(uintptr_t, uint32);
+		void EndModule();
+
 	private:
 		enum LABEL_FLOW
 		{
@@ -51,6 +64,17 @@ namespace Jitter
 			LABEL_FLOW_LOOP,
 		};
 
+		//Registers are function locals, the engine will do the actual register allocation
+		enum
+		{
+			MAX_REGISTERS = 32,
+		};
+
+		enum
+		{
+			MAX_MDREGISTERS = 32,
+		};
+
 		typedef void (CCodeGen_Wasm::*ConstCodeEmitterType)(const STATEMENT&);
 
 		typedef std::function<void(void)> ParamEmitterFunction;
@@ -77,9 +101,13 @@ namespace Jitter
 		void PrepareLocalVars(const StatementList&);
 
 		uint32 GetTemporaryLocation(CSymbol*) const;
+		uint32 GetRegisterLocation(CSymbol*) const;
 
 		void PushContext();
 
+		void PushRegister(CSymbol*);
+		void PullRegister(CSymbol*);
+
 		void PushRelativeAddress(CSymbol*);
 		void PushRelative(CSymbol*);
 
@@ -151,6 +179,7 @@ namespace Jitter
 
 		void Emit_Call(const STATEMENT&);
 		void Emit_RetVal_Tmp(const STATEMENT&);
+		void Emit_RetVal_Reg(const STATEMENT&);
 
 		void Emit_ExternJmp(const STATEMENT&);
 
@@ -192,12 +221,13 @@ namespace Jitter
 		template <uint32>
 		void Emit_Fpu_MemMemMem(const STATEMENT&);
 		void Emit_Fp_Cmp_AnyMemMem(const STATEMENT&);
+		void Emit_Fp_MulAdd_MemMemMemMem(const STATEMENT&);
 		void Emit_Fp_Rcpl_MemMem(const STATEMENT&);
 		void Emit_Fp_Rsqrt_MemMem(const STATEMENT&);
 		void Emit_Fp_Clamp_MemMem(const STATEMENT&);
 		void Emit_Fp_ToSingleI32_MemMem(const STATEMENT&);
 		void Emit_Fp_ToInt32TruncS_MemMem(const STATEMENT&);
-		void Emit_Fp_LdCst_TmpCst(const STATEMENT&);
+		void Emit_Fp_LdCst_VarCst(const STATEMENT&);
 		void Emit_Fp_SetRoundingMode_Cst(const STATEMENT&);
 
 		//MD
@@ -215,6 +245,7 @@ namespace Jitter
 		void Emit_Md_SubSSW_MemMemMem(const STATEMENT&);
 		void Emit_Md_SubUSW_MemMemMem(const STATEMENT&);
 		void Emit_Md_ClampS_MemMem(const STATEMENT&);
+		void Emit_Md_MulAddS_MemMemMemMem(const STATEMENT&);
 		void Emit_Md_MakeClip_MemMemMemMem(const STATEMENT&);
 		void Emit_Md_MakeSz_MemMem(const STATEMENT&);
 		void Emit_Md_LoadFromRef_MemMem(const STATEMENT&);
@@ -226,6 +257,10 @@ namespace Jitter
 		void Emit_Md_MovMasked_MemMemMem(const STATEMENT&);
 		void Emit_Md_ExpandW_MemAny(const STATEMENT&);
 		void Emit_Md_ExpandW_MemMemCst(const STATEMENT&);
+		void Emit_Md_LdCst_MemCstCst(const STATEMENT&);
+		void Emit_Md_ExtractLaneS_MemMemCst(const STATEMENT&);
+		void Emit_Md_InsertLaneS_MemMemMemCst(const STATEMENT&);
+		void Emit_Md_Shuffle_MemMemCst(const STATEMENT&);
 		void Emit_Md_Srl256_MemMemVar(const STATEMENT&);
 		void Emit_Md_Srl256_MemMemCst(const STATEMENT&);
 		void Emit_MergeTo256_MemMemMem(const STATEMENT&);
@@ -234,6 +269,9 @@ namespace Jitter
 
 		Framework::CStream* m_stream = nullptr;
 		Framework::CMemStream m_functionStream;
+		CWasmModuleBuilder m_moduleBuilder;
+		std::map<uintptr_t, uint32> m_moduleFunctions;
+		bool m_isBuildingModule = false;
 		std::map<uint32, LABEL_FLOW> m_labelFlows;
 		std::map<std::string, uint32> m_signatures;
 		std::map<TemporaryInstance, uint32> m_temporaryLocations;
@@ -241,6 +279,9 @@ namespace Jitter
 		uint32 m_localI64Count = 0;
 		uint32 m_localF32Count = 0;
 		uint32 m_localV128Count = 0;
+		uint32 m_registerI32Base = 0;
+		uint32 m_registerF32Base = 0;
+		uint32 m_registerV128Base = 0;
 		bool m_isInsideBlock = false;
 		bool m_isInsideLoop = false;
 		uint32 m_currentBlockDepth = 0;
@@ -20,10 +20,21 @@ namespace Jitter
 		bool Has128BitsCallOperands() const override;
 		bool SupportsExternalJumps() const override;
 		bool SupportsCmpSelect() const override;
+		bool SupportsBitfieldOps() const override;
+		bool SupportsPairedStores() const override;
+		bool SupportsLoopRegisters() const override;
+		bool SupportsMdLaneOps() const override;
+		unsigned int GetOperationCost(OPERATION) const override;
 
 	protected:
 		typedef std::map<uint32, CX86Assembler::LABEL> LabelMapType;
-		typedef std::vector<std::pair<uintptr_t, CX86Assembler::LABEL>> SymbolReferenceLabelArray;
+		struct SYMBOL_REFERENCE_LABEL
+		{
+			uintptr_t symbol = 0;
+			CX86Assembler::LABEL label = 0;
+			SYMBOL_REF_TYPE type = SYMBOL_REF_TYPE::NATIVE_POINTER;
+		};
+		typedef std::vector<SYMBOL_REFERENCE_LABEL> SymbolReferenceLabelArray;
 
 		// clang-format off
 		//ALUOP ----------------------------------------------------------
@@ -68,24 +79,28 @@ namespace Jitter
 		{
 			typedef void (CX86Assembler::*OpCstType)(const CX86Assembler::CAddress&, uint8);
 			typedef void (CX86Assembler::*OpVarType)(const CX86Assembler::CAddress&);
+			typedef void (CX86Assembler::*OpBmiType)(CX86Assembler::REGISTER, const CX86Assembler::CAddress&, CX86Assembler::REGISTER);
 		};
 
 		struct SHIFTOP_SRL : public SHIFTOP_BASE
 		{
 			static OpCstType OpCst() { return &CX86Assembler::ShrEd; }
 			static OpVarType OpVar() { return &CX86Assembler::ShrEd; }
+			static OpBmiType OpBmi() { return &CX86Assembler::ShrxEd; }
 		};
 
 		struct SHIFTOP_SRA : public SHIFTOP_BASE
 		{
 			static OpCstType OpCst() { return &CX86Assembler::SarEd; }
 			static OpVarType OpVar() { return &CX86Assembler::SarEd; }
+			static OpBmiType OpBmi() { return &CX86Assembler::SarxEd; }
 		};
 
 		struct SHIFTOP_SLL : public SHIFTOP_BASE
 		{
 			static OpCstType OpCst() { return &CX86Assembler::ShlEd; }
 			static OpVarType OpVar() { return &CX86Assembler::ShlEd; }
+			static OpBmiType OpBmi() { return &CX86Assembler::ShlxEd; }
 		};
 
 		//FP32OP -----------------------------------------------------------
@@ -598,6 +613,11 @@ namespace Jitter
 		template <typename>
 		void Emit_Shift_MemCstMem(const STATEMENT&);
 
+		template <typename>
+		void Emit_Shift_Bmi2_VarVarVar(const STATEMENT&);
+		template <typename>
+		void Emit_Shift_Bmi2_VarCstVar(const STATEMENT&);
+
 		//NOT
 		void Emit_Not_RegReg(const STATEMENT&);
 		void Emit_Not_RegMem(const STATEMENT&);
@@ -608,6 +628,7 @@ namespace Jitter
 		void Emit_Lzc(CX86Assembler::REGISTER, const CX86Assembler::CAddress&);
 		void Emit_Lzc_RegVar(const STATEMENT&);
 		void Emit_Lzc_MemVar(const STATEMENT&);
+		void Emit_Lzc_Lzcnt_VarVar(const STATEMENT&);
 
 		//CMP
 		void Cmp_GetFlag(const CX86Assembler::CAddress&, CONDITION);
@@ -659,6 +680,7 @@ namespace Jitter
 		void Emit_MergeTo64_Mem64RegCst(const STATEMENT&);
 		void Emit_MergeTo64_Mem64MemReg(const STATEMENT&);
 		void Emit_MergeTo64_Mem64MemMem(const STATEMENT&);
+		void Emit_MergeTo64_Mem64MemCst(const STATEMENT&);
 		void Emit_MergeTo64_Mem64CstReg(const STATEMENT&);
 		void Emit_MergeTo64_Mem64CstMem(const STATEMENT&);
 
@@ -737,6 +759,7 @@ namespace Jitter
 		void Emit_Fp_ToSingleI32_VarMem(const STATEMENT&);
 		void Emit_Fp_ToInt32TruncS_RegVar(const STATEMENT&);
 		void Emit_Fp_ToInt32TruncS_MemVar(const STATEMENT&);
+		void Emit_Fp_MulAddS_VarVarVarVar(const STATEMENT&);
 
 		//MDOP
 		template <typename>
@@ -769,6 +792,7 @@ namespace Jitter
 		void Emit_Md_SubUSW_VarVarVar(const STATEMENT&);
 		void Emit_Md_MinW_VarVarVar(const STATEMENT&);
 		void Emit_Md_MaxW_VarVarVar(const STATEMENT&);
+		void Emit_Md_MulAddS_VarVarVarVar(const STATEMENT&);
 		void Emit_Md_ClampS_RegVar(const STATEMENT&);
 		void Emit_Md_ClampS_MemVar(const STATEMENT&);
 		void Emit_Md_PackHB_VarVarVar(const STATEMENT&);
@@ -786,6 +810,13 @@ namespace Jitter
 		void Emit_Md_ExpandW_VarMem(const STATEMENT&);
 		void Emit_Md_ExpandW_VarCst(const STATEMENT&);
 		void Emit_Md_ExpandW_VarVarCst(const STATEMENT&);
+		void Emit_Md_LdCst_VarCstCst(const STATEMENT&);
+		void Emit_Md_ExtractLaneS_VarVarCst(const STATEMENT&);
+		void Emit_Md_InsertLaneS_Sse41_VarVarVarCst(const STATEMENT&);
+		void Emit_Md_InsertLaneS_MemVarCst(CSymbol*, CSymbol*, unsigned int);
+		void Emit_Md_ShuffleW_VarVarCst(const STATEMENT&);
+		void Emit_Md_ShuffleB_VarVarCst(const STATEMENT&);
+		void Emit_Md_ShuffleB_Ssse3_VarVarCst(const STATEMENT&);
 
 		void Emit_MergeTo256_MemVarVar(const STATEMENT&);
 
@@ -831,6 +862,8 @@ namespace Jitter
 		void Emit_Fp_Avx_ToSingleI32_VarMem(const STATEMENT&);
 		void Emit_Fp_Avx_ToInt32TruncS_RegVar(const STATEMENT&);
 		void Emit_Fp_Avx_ToInt32TruncS_MemVar(const STATEMENT&);
+		void Emit_Fp_Avx_MulAddS_VarVarVarVar(const STATEMENT&);
+		void Emit_Fp_Fma_MulAddS_VarVarVarVar(const STATEMENT&);
 
 		//MDOP AVX
 		template <typename>
@@ -855,6 +888,8 @@ namespace Jitter
 		void Emit_Md_Avx_SubSSW_VarVarVar(const STATEMENT&);
 		void Emit_Md_Avx_SubUSW_VarVarVar(const STATEMENT&);
 		void Emit_Md_Avx_ClampS_VarVar(const STATEMENT&);
+		void Emit_Md_Avx_MulAddS_VarVarVarVar(const STATEMENT&);
+		void Emit_Md_Fma_MulAddS_VarVarVarVar(const STATEMENT&);
 
 		void Emit_Md_Avx_PackHB_VarVarVar(const STATEMENT&);
 		void Emit_Md_Avx_PackWH_VarVarVar(const STATEMENT&);
@@ -865,6 +900,10 @@ namespace Jitter
 		void Emit_Md_Avx_ExpandW_VarVar(const STATEMENT&);
 		void Emit_Md_Avx_ExpandW_VarCst(const STATEMENT&);
 		void Emit_Md_Avx_ExpandW_VarVarCst(const STATEMENT&);
+		void Emit_Md_Avx_LdCst_VarCstCst(const STATEMENT&);
+
+		void Emit_Md_Avx_ExtractLaneS_VarVarCst(const STATEMENT&);
+		void Emit_Md_Avx_InsertLaneS_VarVarVarCst(const STATEMENT&);
 
 		void Emit_Md_Avx2_ExpandW_VarReg(const STATEMENT&);
 		void Emit_Md_Avx2_ExpandW_VarMem(const STATEMENT&);
@@ -872,6 +911,9 @@ namespace Jitter
 		void Emit_Md_Avx2_ExpandW_VarRegCst(const STATEMENT&);
 		void Emit_Md_Avx2_ExpandW_VarMemCst(const STATEMENT&);
 
+		void Emit_Md_Avx_ShuffleW_VarVarCst(const STATEMENT&);
+		void Emit_Md_Avx_ShuffleB_VarVarCst(const STATEMENT&);
+
 		void Emit_Avx_MergeTo256_MemVarVar(const STATEMENT&);
 
 		void Emit_Md_Avx_Srl256_VarMemVar(const STATEMENT&);
@@ -917,11 +959,13 @@ namespace Jitter
 		static const std::array<uint8, 4> g_mdExpandShufPatterns;
 		static const std::array<uint32, 4> g_fpMxcsrRoundBits;
 		static constexpr uint32 MXCSR_ROUND_MASK = 0x6000;
+		static constexpr uint32 LOOP_ALIGNMENT = 0x10;
 
 		CX86Assembler m_assembler;
 		CX86Assembler::REGISTER* m_registers = nullptr;
 		CX86Assembler::XMMREGISTER* m_mdRegisters = nullptr;
 		LabelMapType m_labels;
+		std::set<uint32> m_loopHeadLabels;
 		SymbolReferenceLabelArray m_symbolReferenceLabels;
 		uint32 m_stackLevel = 0;
 		uint32 m_registerUsage = 0;
@@ -945,10 +989,19 @@ namespace Jitter
 
 		static CONSTMATCHER g_constMatchers[];
 
+		static CONSTMATCHER g_noBmi2ConstMatchers[];
+		static CONSTMATCHER g_bmi2ConstMatchers[];
+
+		static CONSTMATCHER g_noLzcntConstMatchers[];
+		static CONSTMATCHER g_lzcntConstMatchers[];
+
 		static CONSTMATCHER g_fpuConstMatchers[];
 		static CONSTMATCHER g_fpuSseConstMatchers[];
 		static CONSTMATCHER g_fpuAvxConstMatchers[];
 
+		static CONSTMATCHER g_fpuNoFmaConstMatchers[];
+		static CONSTMATCHER g_fpuFmaConstMatchers[];
+
 		//SSE SIMD matchers
 		static CONSTMATCHER g_mdSseConstMatchers[];
 
@@ -963,5 +1016,8 @@ namespace Jitter
 
 		static CONSTMATCHER g_mdNoAvx2ConstMatchers[];
 		static CONSTMATCHER g_mdAvx2ConstMatchers[];
+
+		static CONSTMATCHER g_mdNoFmaConstMatchers[];
+		static CONSTMATCHER g_mdFmaConstMatchers[];
 	};
 }
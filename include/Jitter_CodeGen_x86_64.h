@@ -18,6 +18,7 @@ namespace Jitter
 		virtual ~CCodeGen_x86_64() = default;
 
 		void SetPlatformAbi(PLATFORM_ABI);
+		void SetGenerateRelocatableCalls(bool);
 
 		unsigned int GetAvailableRegisterCount() const override;
 		unsigned int GetAvailableMdRegisterCount() const override;
@@ -222,6 +223,7 @@ namespace Jitter
 		uint32 m_maxRegisters = 0;
 		uint32 m_maxParams = 0;
 		bool m_hasMdRegRetValues = false;
+		bool m_generateRelocatableCalls = false;
 		CX86Assembler::REGISTER* m_paramRegs = nullptr;
 
 		ParamStack m_params;
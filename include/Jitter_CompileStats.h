@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Types.h"
+
+namespace Jitter
+{
+	//Gathers statistics about functions compiled by a jitter it's attached to. Values
+	//are aggregated over all compilations. A collector can only be attached to a single
+	//jitter at a time, use Merge to combine collectors from jitters running on other threads.
+	class CCompileStats
+	{
+	public:
+		enum PASS
+		{
+			PASS_CLAMPING_ELIMINATION,
+			PASS_MERGE_CMP_SELECT_OPS,
+			PASS_FOLD_RELATIVE_REFERENCES,
+			PASS_CONSTANT_PROPAGATION,
+			PASS_CONSTANT_FOLDING,
+			PASS_MD_CONSTANT_FOLDING,
+			PASS_SIMPLIFY_KNOWN_BITS,
+			PASS_STRENGTH_REDUCE_DIVISION,
+			PASS_STRENGTH_REDUCE_MULTIPLICATION,
+			PASS_MERGE_BITFIELD_OPS,
+			PASS_REORDER_ADD,
+			PASS_COPY_PROPAGATION,
+			PASS_MERGE_CMP_CONDJMP,
+			PASS_DEADCODE_ELIMINATION,
+			PASS_COMMON_EXPRESSION_ELIMINATION,
+			PASS_FIX_FLOW_CONTROL,
+			PASS_PRUNE_BLOCKS,
+			PASS_MERGE_BLOCKS,
+			PASS_OPTIMIZE_LOOPS,
+			PASS_COALESCE_TEMPORARIES,
+			PASS_REMOVE_SELF_ASSIGNMENTS,
+			PASS_COMBINE_ADJACENT_STORES,
+			PASS_PRUNE_SYMBOLS,
+			PASS_ALLOCATE_REGISTERS,
+			PASS_ALLOCATE_STACK,
+			PASS_NORMALIZE_STATEMENTS,
+			PASS_GENERATE_CODE,
+			PASS_COUNT,
+		};
+
+		enum VALUE
+		{
+			VALUE_COMPILE_TIME,
+			VALUE_INPUT_STATEMENTS,
+			VALUE_OUTPUT_STATEMENTS,
+			VALUE_OPTIMIZATION_ITERATIONS,
+			VALUE_BLOCK_OPTIMIZATION_ITERATIONS,
+			VALUE_REGISTER_LOADS,
+			VALUE_REGISTER_SPILLS,
+			VALUE_STACK_SIZE,
+			VALUE_CODE_SIZE,
+			VALUE_COUNT,
+		};
+
+		//Bucket 0 holds zeroes, bucket N holds values in [2^(N - 1), 2^N)
+		class CHistogram
+		{
+		public:
+			enum
+			{
+				BUCKET_COUNT = 65,
+			};
+
+			void Add(uint64);
+			void Merge(const CHistogram&);
+
+			uint64 GetCount() const;
+			uint64 GetSum() const;
+			uint64 GetMin() const;
+			uint64 GetMax() const;
+			uint64 GetBucket(unsigned int) const;
+
+			static unsigned int GetBucketIndex(uint64);
+
+		private:
+			std::array<uint64, BUCKET_COUNT> m_buckets = {};
+			uint64 m_count = 0;
+			uint64 m_sum = 0;
+			uint64 m_min = UINT64_MAX;
+			uint64 m_max = 0;
+		};
+
+		struct PASS_STATS
+		{
+			uint64 runCount = 0;
+			uint64 changeCount = 0;
+			uint64 statementsBefore = 0;
+			uint64 statementsAfter = 0;
+			CHistogram time;
+		};
+
+		static const char* GetPassName(PASS);
+		static const char* GetValueName(VALUE);
+
+		uint64 GetCompileCount() const;
+		const PASS_STATS& GetPassStats(PASS) const;
+		const CHistogram& GetHistogram(VALUE) const;
+
+		void Merge(const CCompileStats&);
+		void Reset();
+
+		//Called by the jitter, times are in nanoseconds
+		void BeginCompile();
+		void EndCompile();
+		void AddPassRun(PASS, uint64, uint64, bool, uint64);
+		void AddValue(VALUE, uint64);
+
+	private:
+		uint64 m_compileCount = 0;
+		std::array<PASS_STATS, PASS_COUNT> m_passStats;
+		std::array<CHistogram, VALUE_COUNT> m_histograms;
+
+		//Values for the function being compiled
+		std::array<uint64, VALUE_COUNT> m_currentValues = {};
+	};
+}
@@ -3,6 +3,8 @@
 #include <list>
 #include <functional>
 #include "Jitter_SymbolRef.h"
+#include "Jitter_SymbolTable.h"
+#include "Stream.h"
 
 namespace Jitter
 {
@@ -35,6 +37,10 @@ namespace Jitter
 
 		OP_LZC,
 
+		OP_EXTRACTBITS,  //src2 is the lsb, src3 is the width
+		OP_EXTRACTBITSS, //Same as above, but result is sign extended
+		OP_INSERTBITS,   //src3 is a constant (lsb | (width << 8) | (src2 lsb << 16))
+
 		OP_RELTOREF,
 		OP_ADDREF,
 		OP_ISREFNULL,
@@ -122,6 +128,10 @@ namespace Jitter
 		OP_MD_TOSINGLE_I32,
 
 		OP_MD_EXPAND_W,
+		OP_MD_LDCST, //src1 and src2 are 64-bit constants holding the lower and upper halves of the value
+
+		OP_MD_EXTRACT_LANE_S, //dst (FP32) = src1[src2]
+		OP_MD_INSERT_LANE_S,  //dst = src1 with src1[src3] replaced by src2 (FP32)
 
 		OP_MD_UNPACK_LOWER_BH,
 		OP_MD_UNPACK_LOWER_HW,
@@ -134,10 +144,15 @@ namespace Jitter
 		OP_MD_PACK_HB,
 		OP_MD_PACK_WH,
 
+		OP_MD_SHUFFLE_W, //src2 is a pshufd-like pattern (2 bits per destination word)
+		OP_MD_SHUFFLE_B, //src2 is a 64-bit constant (4 bits per destination byte)
+
 		OP_MD_ADD_S,
 		OP_MD_SUB_S,
 		OP_MD_MUL_S,
 		OP_MD_DIV_S,
+		OP_MD_MULADD_S,      //src1 + (src2 * src3), rounded after each operation
+		OP_MD_FUSEDMULADD_S, //src1 + (src2 * src3), rounded once if the target supports it
 		OP_MD_ABS_S,
 		OP_MD_NEG_S,
 		OP_MD_MIN_S,
@@ -150,6 +165,8 @@ namespace Jitter
 		OP_FP_SUB_S,
 		OP_FP_MUL_S,
 		OP_FP_DIV_S,
+		OP_FP_MULADD_S,
+		OP_FP_FUSEDMULADD_S,
 		OP_FP_SQRT_S,
 		OP_FP_RSQRT_S,
 		OP_FP_RCPL_S,
@@ -263,6 +280,10 @@ namespace Jitter
 	void DumpStatementList(const StatementList&);
 	void DumpStatementList(std::ostream&, const StatementList&);
 
+	//Binary form of unversioned statement lists, symbols are created in the provided table when reading
+	void SerializeStatementList(Framework::CStream&, const StatementList&);
+	StatementList DeserializeStatementList(Framework::CStream&, CSymbolTable&);
+
 	template <typename ListType, typename IteratorType, typename ValueType>
 	class IndexedStatementListBase
 	{
@@ -3,6 +3,7 @@
 #include "Types.h"
 
 #if defined(__EMSCRIPTEN__)
+#include <vector>
 #include <emscripten/bind.h>
 #endif
 
@@ -31,6 +32,11 @@ public:
 
 	CMemoryFunction CreateInstance();
 
+#if defined(__EMSCRIPTEN__)
+	//Instantiates a module generated by CCodeGen_Wasm::BeginModule/EndModule once for all of its functions
+	static std::vector<CMemoryFunction> CreateModuleFunctions(const void*, size_t, uint32);
+#endif
+
 private:
 	void ClearCache();
 	void Reset();
@@ -46,5 +52,6 @@ private:
 
 #if defined(__EMSCRIPTEN__)
 	emscripten::val m_wasmModule;
+	uint32 m_wasmFunctionIndex = 0;
 #endif
 };
@@ -6,6 +6,7 @@
 #include <memory>
 #include <cstdint>
 #include "Stream.h"
+#include "Jitter_CodeGen.h"
 
 namespace Jitter
 {
@@ -31,6 +32,7 @@ namespace Jitter
 			SYMBOL_TYPE type = SYMBOL_TYPE_INTERNAL;
 			unsigned int symbolIndex = 0;
 			unsigned int offset = 0;
+			CCodeGen::SYMBOL_REF_TYPE refType = CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER;
 		};
 		typedef std::vector<SYMBOL_REFERENCE> SymbolReferenceArray;
 
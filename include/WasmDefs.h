@@ -55,6 +55,7 @@ namespace Wasm
 		INST_BR = 0x0C,
 		INST_BR_IF = 0x0D,
 		INST_BR_TABLE = 0x0E,
+		INST_CALL = 0x10,
 		INST_CALL_INDIRECT = 0x11,
 		INST_SELECT = 0x1B,
 		INST_LOCAL_GET = 0x20,
@@ -157,6 +158,8 @@ namespace Wasm
 		INST_F32_DEMOTE_F64 = 0xB6,
 		INST_F64_CONVERT_I64_S = 0xB9,
 		INST_F64_PROMOTE_F32 = 0xBB,
+		INST_I32_REINTERPRET_F32 = 0xBC,
+		INST_F32_REINTERPRET_I32 = 0xBE,
 		INST_I32x4_TRUNC_SAT_F32x4_S = 0xF8,
 		INST_F32x4_CONVERT_I32x4_S = 0xFA
 	};
@@ -182,6 +185,7 @@ namespace Wasm
 		INST_I8x16_REPLACE_LANE = 0x17,
 		INST_I32x4_EXTRACT_LANE = 0x1B,
 		INST_F32x4_EXTRACT_LANE = 0x1F,
+		INST_F32x4_REPLACE_LANE = 0x20,
 		INST_I8x16_EQ = 0x23,
 		INST_I8x16_GT_S = 0x27,
 		INST_I16x8_EQ = 0x2D,
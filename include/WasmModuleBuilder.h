@@ -2,6 +2,7 @@
 
 #include "Stream.h"
 #include "Types.h"
+#include <string>
 #include <vector>
 
 class CWasmModuleBuilder
@@ -28,8 +29,11 @@ public:
 
 	static uint32 GetULeb128Size(uint32);
 
+	static std::string GetFunctionExportName(uint32);
+
 	void AddFunctionType(FUNCTION_TYPE);
 	void AddFunction(FUNCTION);
+	uint32 GetFunctionCount() const;
 
 	void WriteModule(Framework::CStream&);
 
@@ -133,6 +133,8 @@ public:
 
 	LABEL CreateLabel();
 	void MarkLabel(LABEL, int32 = 0);
+	//Padding is inserted before the label to align its start, relative to the start of the code
+	void MarkAlignedLabel(LABEL, uint32);
 	uint32 GetLabelOffset(LABEL) const;
 
 	LITERAL128ID CreateLiteral128(const LITERAL128&);
@@ -151,6 +153,7 @@ public:
 	void AndIq(const CAddress&, uint64);
 	void BsrEd(REGISTER, const CAddress&);
 	void CallEd(const CAddress&);
+	void CallJd(uint32);
 	void CmoveEd(REGISTER, const CAddress&);
 	void CmovneEd(REGISTER, const CAddress&);
 	void CmovleEd(REGISTER, const CAddress&);
@@ -177,6 +180,7 @@ public:
 	void JlJx(LABEL);
 	void JleJx(LABEL);
 	void JmpEd(const CAddress&);
+	void JmpJd(uint32);
 	void JmpJx(LABEL);
 	void JnzJx(LABEL);
 	void JnbeJx(LABEL);
@@ -184,6 +188,7 @@ public:
 	void JnsJx(LABEL);
 	void LeaGd(REGISTER, const CAddress&);
 	void LeaGq(REGISTER, const CAddress&);
+	void LzcntEd(REGISTER, const CAddress&);
 	void MovEw(REGISTER, const CAddress&);
 	void MovEd(REGISTER, const CAddress&);
 	void MovEq(REGISTER, const CAddress&);
@@ -205,10 +210,12 @@ public:
 	void MulEd(const CAddress&);
 	void NegEd(const CAddress&);
 	void Nop();
+	void Nop(unsigned int);
 	void NotEd(const CAddress&);
 	void OrEd(REGISTER, const CAddress&);
 	void OrId(const CAddress&, uint32);
 	void Pop(REGISTER);
+	void PopcntEd(REGISTER, const CAddress&);
 	void Push(REGISTER);
 	void PushEd(const CAddress&);
 	void PushId(uint32);
@@ -250,11 +257,20 @@ public:
 	void TestEb(BYTEREGISTER, const CAddress&);
 	void TestEd(REGISTER, const CAddress&);
 	void TestEq(REGISTER, const CAddress&);
+	void TzcntEd(REGISTER, const CAddress&);
 	void XorEd(REGISTER, const CAddress&);
 	void XorId(const CAddress&, uint32);
 	void XorGd(const CAddress&, REGISTER);
 	void XorGq(const CAddress&, REGISTER);
 
+	//BMI
+	void AndnEd(REGISTER, REGISTER, const CAddress&);
+	void BzhiEd(REGISTER, const CAddress&, REGISTER);
+	void RorxEd(REGISTER, const CAddress&, uint8);
+	void SarxEd(REGISTER, const CAddress&, REGISTER);
+	void ShlxEd(REGISTER, const CAddress&, REGISTER);
+	void ShrxEd(REGISTER, const CAddress&, REGISTER);
+
 	//FPU
 	void FldEd(const CAddress&);
 	void FildEd(const CAddress&);
@@ -311,6 +327,8 @@ public:
 
 	void PandVo(XMMREGISTER, const CAddress&);
 	void PandnVo(XMMREGISTER, const CAddress&);
+	void PextrwVo(REGISTER, XMMREGISTER, uint8);
+	void PinsrwVo(XMMREGISTER, const CAddress&, uint8);
 	void PcmpeqbVo(XMMREGISTER, const CAddress&);
 	void PcmpeqwVo(XMMREGISTER, const CAddress&);
 	void PcmpeqdVo(XMMREGISTER, const CAddress&);
@@ -372,6 +390,7 @@ public:
 	void AddpsVo(XMMREGISTER, const CAddress&);
 	void BlendpsVo(XMMREGISTER, const CAddress&, uint8);
 	void DivpsVo(XMMREGISTER, const CAddress&);
+	void InsertpsVo(XMMREGISTER, const CAddress&, uint8);
 	void MaxpsVo(XMMREGISTER, const CAddress&);
 	void MinpsVo(XMMREGISTER, const CAddress&);
 	void MulpsVo(XMMREGISTER, const CAddress&);
@@ -394,6 +413,7 @@ public:
 	void VdivssEd(XMMREGISTER, XMMREGISTER, const CAddress&);
 	void VmaxssEd(XMMREGISTER, XMMREGISTER, const CAddress&);
 	void VminssEd(XMMREGISTER, XMMREGISTER, const CAddress&);
+	void Vfmadd231ssEd(XMMREGISTER, XMMREGISTER, const CAddress&);
 
 	void VcmpssEd(XMMREGISTER, XMMREGISTER, const CAddress&, SSE_CMP_TYPE);
 
@@ -467,6 +487,7 @@ public:
 	void VpunpckhdqVo(XMMREGISTER, XMMREGISTER, const CAddress&);
 
 	void VpshufbVo(XMMREGISTER, XMMREGISTER, const CAddress&);
+	void VpshufdVo(XMMREGISTER, const CAddress&, uint8);
 	void VpmovmskbVo(REGISTER, XMMREGISTER);
 	void VpbroadcastdVo(XMMREGISTER, const CAddress&);
 
@@ -474,6 +495,7 @@ public:
 	void VsubpsVo(XMMREGISTER, XMMREGISTER, const CAddress&);
 	void VmulpsVo(XMMREGISTER, XMMREGISTER, const CAddress&);
 	void VdivpsVo(XMMREGISTER, XMMREGISTER, const CAddress&);
+	void Vfmadd231psVo(XMMREGISTER, XMMREGISTER, const CAddress&);
 
 	void VcmpltpsVo(XMMREGISTER, XMMREGISTER, const CAddress&);
 	void VcmpgtpsVo(XMMREGISTER, XMMREGISTER, const CAddress&);
@@ -487,6 +509,7 @@ public:
 	void VcmppsVo(XMMREGISTER, XMMREGISTER, const CAddress&, SSE_CMP_TYPE);
 
 	void VblendpsVo(XMMREGISTER, XMMREGISTER, const CAddress&, uint8);
+	void VinsertpsVo(XMMREGISTER, XMMREGISTER, const CAddress&, uint8);
 	void VshufpsVo(XMMREGISTER, XMMREGISTER, const CAddress&, uint8);
 
 private:
@@ -523,11 +546,15 @@ private:
 	enum VEX_OPCODE_MAP : uint8
 	{
 		VEX_OPCODE_MAP_NONE = 0x01,
+		VEX_OPCODE_MAP_NONE_38 = 0x02,
 		VEX_OPCODE_MAP_66 = 0x11,
 		VEX_OPCODE_MAP_66_38 = 0x12,
 		VEX_OPCODE_MAP_66_3A = 0x13,
 		VEX_OPCODE_MAP_F3 = 0x21,
-		VEX_OPCODE_MAP_F2 = 0x31
+		VEX_OPCODE_MAP_F3_38 = 0x22,
+		VEX_OPCODE_MAP_F2 = 0x31,
+		VEX_OPCODE_MAP_F2_38 = 0x32,
+		VEX_OPCODE_MAP_F2_3A = 0x33
 	};
 
 	struct LABELREF
@@ -561,12 +588,16 @@ private:
 		    : start(0)
 		    , size(0)
 		    , projectedStart(0)
+		    , alignment(1)
+		    , padding(0)
 		{
 		}
 
 		uint32 start;
 		uint32 size;
 		uint32 projectedStart;
+		uint32 alignment;
+		uint32 padding;
 		LabelRefArray labelRefs;
 		Literal128Refs literal128Refs;
 	};
@@ -598,6 +629,7 @@ private:
 	void WriteVrOp_66_0F(uint8, uint8, XMMREGISTER);
 	void WriteVexVoOp(VEX_OPCODE_MAP, uint8, XMMREGISTER, XMMREGISTER, const CAddress&);
 	void WriteVexShiftVoOp(uint8, uint8, XMMREGISTER, XMMREGISTER, uint8);
+	void WriteVexGvEvOp(VEX_OPCODE_MAP, uint8, REGISTER, REGISTER, const CAddress&);
 	void WriteStOp(uint8, uint8, uint8);
 
 	void CreateLabelReference(LABEL, JMP_TYPE);
@@ -605,8 +637,11 @@ private:
 	void IncrementJumpOffsetsLocal(LABELINFO&, LabelRefArray::iterator, unsigned int);
 	void IncrementJumpOffsets(LabelArray::const_iterator, unsigned int);
 
+	bool UpdateLabelPaddings();
+
 	static unsigned int GetJumpSize(JMP_TYPE, JMP_LENGTH);
 	static void WriteJump(Framework::CStream*, JMP_TYPE, JMP_LENGTH, uint32);
+	static void WriteNops(Framework::CStream*, unsigned int);
 
 	void WriteLiteralPlaceholder(const CAddress&);
 
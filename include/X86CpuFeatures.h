@@ -7,6 +7,11 @@ public:
 	bool hasSse41 = false;
 	bool hasAvx = false;
 	bool hasAvx2 = false;
+	bool hasFma = false;
+	bool hasPopcnt = false;
+	bool hasLzcnt = false;
+	bool hasBmi1 = false;
+	bool hasBmi2 = false;
 
 	static CX86CpuFeatures AutoDetect();
 };
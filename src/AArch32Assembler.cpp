@@ -766,6 +766,49 @@ void CAArch32Assembler::Vst1_32x4(QUAD_REGISTER qd, REGISTER rn)
 	WriteWord(opcode);
 }
 
+void CAArch32Assembler::Vpush(DOUBLE_REGISTER firstReg, uint8 regCount)
+{
+	//VSTMDB sp!, {firstReg-...}
+	assert(regCount != 0 && regCount <= 16);
+	assert((firstReg + regCount) <= 32);
+	uint32 opcode = 0x0D2D0B00;
+	opcode |= (CONDITION_AL << 28);
+	opcode |= FPSIMD_EncodeDd(firstReg);
+	opcode |= static_cast<uint32>(regCount * 2);
+	WriteWord(opcode);
+}
+
+void CAArch32Assembler::Vpop(DOUBLE_REGISTER firstReg, uint8 regCount)
+{
+	//VLDMIA sp!, {firstReg-...}
+	assert(regCount != 0 && regCount <= 16);
+	assert((firstReg + regCount) <= 32);
+	uint32 opcode = 0x0CBD0B00;
+	opcode |= (CONDITION_AL << 28);
+	opcode |= FPSIMD_EncodeDd(firstReg);
+	opcode |= static_cast<uint32>(regCount * 2);
+	WriteWord(opcode);
+}
+
+void CAArch32Assembler::Vmov(DOUBLE_REGISTER dd, DOUBLE_REGISTER dm)
+{
+	//Alias of VORR dd, dm, dm
+	uint32 opcode = 0xF2200110;
+	opcode |= FPSIMD_EncodeDd(dd);
+	opcode |= FPSIMD_EncodeDn(dm);
+	opcode |= FPSIMD_EncodeDm(dm);
+	WriteWord(opcode);
+}
+
+void CAArch32Assembler::Vmov(SINGLE_REGISTER sd, SINGLE_REGISTER sm)
+{
+	uint32 opcode = 0x0EB00A40;
+	opcode |= (CONDITION_AL << 28);
+	opcode |= FPSIMD_EncodeSd(sd);
+	opcode |= FPSIMD_EncodeSm(sm);
+	WriteWord(opcode);
+}
+
 void CAArch32Assembler::Vmov(DOUBLE_REGISTER dd, REGISTER rt, uint8 offset)
 {
 	uint32 opcode = 0x0E000B10;
@@ -23,6 +23,16 @@ void CAArch64Assembler::MarkLabel(LABEL label)
 	m_labels[label] = static_cast<size_t>(m_stream->Tell());
 }
 
+void CAArch64Assembler::MarkAlignedLabel(LABEL label, uint32 alignment)
+{
+	assert((alignment != 0) && ((alignment & (alignment - 1)) == 0));
+	while((m_stream->Tell() & (alignment - 1)) != 0)
+	{
+		Nop();
+	}
+	MarkLabel(label);
+}
+
 void CAArch64Assembler::CreateBranchLabelReference(LABEL label, CONDITION condition)
 {
 	LABELREF reference;
@@ -240,6 +250,22 @@ void CAArch64Assembler::Asrv(REGISTER64 rd, REGISTER64 rn, REGISTER64 rm)
 	WriteDataProcOpReg2(0x9AC02800, rm, rn, rd);
 }
 
+void CAArch64Assembler::Bfi(REGISTER32 rd, REGISTER32 rn, uint8 lsb, uint8 width)
+{
+	assert((width != 0) && ((lsb + width) <= 32));
+	uint32 immr = -lsb & 0x1F;
+	uint32 imms = width - 1;
+	WriteLogicalOpImm(0x33000000, 0, immr, imms, rn, rd);
+}
+
+void CAArch64Assembler::Bfxil(REGISTER32 rd, REGISTER32 rn, uint8 lsb, uint8 width)
+{
+	assert((width != 0) && ((lsb + width) <= 32));
+	uint32 immr = lsb;
+	uint32 imms = lsb + width - 1;
+	WriteLogicalOpImm(0x33000000, 0, immr, imms, rn, rd);
+}
+
 void CAArch64Assembler::B(LABEL label)
 {
 	CreateBranchLabelReference(label, CONDITION_AL);
@@ -589,6 +615,25 @@ void CAArch64Assembler::Fdiv_4s(REGISTERMD rd, REGISTERMD rn, REGISTERMD rm)
 	WriteWord(opcode);
 }
 
+void CAArch64Assembler::Fmadd_1s(REGISTERMD rd, REGISTERMD rn, REGISTERMD rm, REGISTERMD ra)
+{
+	uint32 opcode = 0x1F000000;
+	opcode |= (rd << 0);
+	opcode |= (rn << 5);
+	opcode |= (ra << 10);
+	opcode |= (rm << 16);
+	WriteWord(opcode);
+}
+
+void CAArch64Assembler::Fmla_4s(REGISTERMD rd, REGISTERMD rn, REGISTERMD rm)
+{
+	uint32 opcode = 0x4E20CC00;
+	opcode |= (rd << 0);
+	opcode |= (rn << 5);
+	opcode |= (rm << 16);
+	WriteWord(opcode);
+}
+
 void CAArch64Assembler::Fmov_1s(REGISTERMD rd, REGISTER32 rn)
 {
 	uint32 opcode = 0x1E270000;
@@ -1098,6 +1143,11 @@ void CAArch64Assembler::Mvni_4s(REGISTERMD rd, uint8 imm, MOVI_4S_IMM_SHIFT_TYPE
 	WriteWord(opcode);
 }
 
+void CAArch64Assembler::Nop()
+{
+	WriteWord(0xD503201F);
+}
+
 void CAArch64Assembler::Orn_16b(REGISTERMD rd, REGISTERMD rn, REGISTERMD rm)
 {
 	uint32 opcode = 0x4EE01C00;
@@ -1153,6 +1203,14 @@ void CAArch64Assembler::Scvtf_4s(REGISTERMD rd, REGISTERMD rn)
 	WriteWord(opcode);
 }
 
+void CAArch64Assembler::Sbfx(REGISTER32 rd, REGISTER32 rn, uint8 lsb, uint8 width)
+{
+	assert((width != 0) && ((lsb + width) <= 32));
+	uint32 immr = lsb;
+	uint32 imms = lsb + width - 1;
+	WriteLogicalOpImm(0x13000000, 0, immr, imms, rn, rd);
+}
+
 void CAArch64Assembler::Sdiv(REGISTER32 rd, REGISTER32 rn, REGISTER32 rm)
 {
 	uint32 opcode = 0x1AC00C00;
@@ -1515,6 +1573,11 @@ void CAArch64Assembler::Tst(REGISTER64 rn, REGISTER64 rm)
 	WriteWord(opcode);
 }
 
+void CAArch64Assembler::Tst(REGISTER32 rn, uint8 n, uint8 immr, uint8 imms)
+{
+	WriteLogicalOpImm(0x72000000, n, immr, imms, rn, wZR);
+}
+
 void CAArch64Assembler::Uaddlv_8h(REGISTERMD rd, REGISTERMD rn)
 {
 	uint32 opcode = 0x6E703800;
@@ -1531,6 +1594,14 @@ void CAArch64Assembler::Uaddlv_16b(REGISTERMD rd, REGISTERMD rn)
 	WriteWord(opcode);
 }
 
+void CAArch64Assembler::Ubfx(REGISTER32 rd, REGISTER32 rn, uint8 lsb, uint8 width)
+{
+	assert((width != 0) && ((lsb + width) <= 32));
+	uint32 immr = lsb;
+	uint32 imms = lsb + width - 1;
+	WriteLogicalOpImm(0x53000000, 0, immr, imms, rn, rd);
+}
+
 void CAArch64Assembler::Udiv(REGISTER32 rd, REGISTER32 rn, REGISTER32 rm)
 {
 	uint32 opcode = 0x1AC00800;
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include "AotCompiler.h"
+#include "MemStream.h"
+
+using namespace Jitter;
+
+CAotCompiler::CAotCompiler(CodeGenFactory codeGenFactory, unsigned int threadCount)
+    : m_codeGenFactory(std::move(codeGenFactory))
+    , m_threadCount(threadCount)
+{
+	if(m_threadCount == 0)
+	{
+		m_threadCount = std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+	}
+}
+
+void CAotCompiler::AddExternalSymbol(const std::string& name, uintptr_t value)
+{
+	CObjectFile::EXTERNAL_SYMBOL symbol = {name, value};
+	m_externalSymbols.push_back(symbol);
+}
+
+void CAotCompiler::AddFunction(const std::string& name, FunctionEmitter emitter)
+{
+	FUNCTION function;
+	function.name = name;
+	function.emitter = std::move(emitter);
+	m_functions.push_back(std::move(function));
+}
+
+CAotCompiler::ObjectFileArray CAotCompiler::Compile(const ObjectFileFactory& objectFileFactory, unsigned int shardCount)
+{
+	assert(shardCount != 0);
+	shardCount = std::max<unsigned int>(shardCount, 1);
+
+	CompiledFunctionArray compiledFunctions(m_functions.size());
+	CompileFunctions(compiledFunctions);
+
+	//Only used to register the code generator's own external symbols
+	auto codeGen = std::unique_ptr<CCodeGen>(m_codeGenFactory());
+
+	ObjectFileArray objectFiles;
+	objectFiles.reserve(shardCount);
+	for(unsigned int shardIndex = 0; shardIndex < shardCount; shardIndex++)
+	{
+		size_t beginIndex = (m_functions.size() * shardIndex) / shardCount;
+		size_t endIndex = (m_functions.size() * (shardIndex + 1)) / shardCount;
+		auto objectFile = objectFileFactory();
+		FillObjectFile(*objectFile, *codeGen, compiledFunctions, beginIndex, endIndex);
+		objectFiles.push_back(std::move(objectFile));
+	}
+	return objectFiles;
+}
+
+void CAotCompiler::CompileFunctions(CompiledFunctionArray& compiledFunctions)
+{
+	std::atomic<size_t> nextFunctionIndex(0);
+	std::vector<std::exception_ptr> exceptions(m_functions.size());
+
+	auto workerProc =
+	    [&]() {
+		    SymbolReferenceArray* symbolReferences = nullptr;
+		    auto makeJitter =
+		        [&]() {
+			        auto jitter = std::make_unique<CJitter>(m_codeGenFactory());
+			        jitter->GetCodeGen()->SetExternalSymbolReferencedHandler(
+			            [&](uintptr_t value, uint32 offset, CCodeGen::SYMBOL_REF_TYPE refType) {
+				            SYMBOL_REFERENCE symbolReference;
+				            symbolReference.value = value;
+				            symbolReference.offset = offset;
+				            symbolReference.refType = refType;
+				            symbolReferences->push_back(symbolReference);
+			            });
+			        return jitter;
+		        };
+
+		    auto jitter = makeJitter();
+		    while(1)
+		    {
+			    size_t functionIndex = nextFunctionIndex++;
+			    if(functionIndex >= m_functions.size()) break;
+
+			    auto& compiledFunction = compiledFunctions[functionIndex];
+			    symbolReferences = &compiledFunction.symbolReferences;
+			    try
+			    {
+				    Framework::CMemStream codeStream;
+				    jitter->SetStream(&codeStream);
+				    m_functions[functionIndex].emitter(*jitter);
+				    compiledFunction.code = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+			    }
+			    catch(...)
+			    {
+				    exceptions[functionIndex] = std::current_exception();
+				    //Jitter and code generator might be left in the middle of a function, start over with new ones
+				    jitter = makeJitter();
+			    }
+		    }
+	    };
+
+	unsigned int threadCount = static_cast<unsigned int>(std::min<size_t>(m_threadCount, m_functions.size()));
+	if(threadCount <= 1)
+	{
+		workerProc();
+	}
+	else
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount);
+		for(unsigned int i = 0; i < threadCount; i++)
+		{
+			threads.emplace_back(workerProc);
+		}
+		for(auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	//Report the error of the first function that failed, regardless of scheduling
+	for(const auto& exception : exceptions)
+	{
+		if(exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+}
+
+void CAotCompiler::FillObjectFile(CObjectFile& objectFile, const CCodeGen& codeGen, const CompiledFunctionArray& compiledFunctions, size_t beginIndex, size_t endIndex) const
+{
+	codeGen.RegisterExternalSymbols(&objectFile);
+	for(const auto& externalSymbol : m_externalSymbols)
+	{
+		objectFile.AddExternalSymbol(externalSymbol);
+	}
+
+	for(size_t functionIndex = beginIndex; functionIndex < endIndex; functionIndex++)
+	{
+		const auto& compiledFunction = compiledFunctions[functionIndex];
+
+		CObjectFile::INTERNAL_SYMBOL internalSymbol;
+		internalSymbol.name = m_functions[functionIndex].name;
+		internalSymbol.location = CObjectFile::INTERNAL_SYMBOL_LOCATION_TEXT;
+		internalSymbol.data = compiledFunction.code;
+		for(const auto& symbolReference : compiledFunction.symbolReferences)
+		{
+			CObjectFile::SYMBOL_REFERENCE objectReference;
+			objectReference.type = CObjectFile::SYMBOL_TYPE_EXTERNAL;
+			objectReference.symbolIndex = objectFile.GetExternalSymbolIndexByValue(symbolReference.value);
+			objectReference.offset = symbolReference.offset;
+			objectReference.refType = symbolReference.refType;
+			internalSymbol.symbolReferences.push_back(objectReference);
+		}
+		objectFile.AddInternalSymbol(internalSymbol);
+	}
+}
@@ -0,0 +1,550 @@
+#include <cassert>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "CodeCache.h"
+#include "MemStream.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace Jitter;
+
+#define CACHE_FILE_MAGIC 0x4643434A //'JCCF'
+#define CACHE_FILE_VERSION 2
+#define CACHE_FILE_HEADER_SIZE 8
+
+//Record layout (little endian):
+//  uint64 key, uint64 checksum, uint32 codeSize, uint32 relocationCount
+//  relocationCount * (uint32 offset, uint8 type, uint8 reserved, uint16 nameLength, uint64 value, char name[nameLength])
+//  uint8 code[codeSize]
+//The checksum covers every other field of the record
+
+static const uint64 g_fnvOffsetBasis = 0xCBF29CE484222325ULL;
+static const uint64 g_fnvPrime = 0x100000001B3ULL;
+
+static void HashBytes(uint64& hash, const void* data, size_t size)
+{
+	auto bytes = reinterpret_cast<const uint8*>(data);
+	for(size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= g_fnvPrime;
+	}
+}
+
+template <typename ValueType>
+static void HashValue(uint64& hash, ValueType value)
+{
+	HashBytes(hash, &value, sizeof(ValueType));
+}
+
+static void HashString(uint64& hash, const std::string& value)
+{
+	HashValue<uint32>(hash, static_cast<uint32>(value.size()));
+	HashBytes(hash, value.data(), value.size());
+}
+
+CCodeCache::CCodeCache(std::string path, const std::string& backendName, const CX86CpuFeatures& cpuFeatures)
+    : m_path(std::move(path))
+{
+	uint32 features = 0;
+	features |= cpuFeatures.hasSsse3 ? (1 << 0) : 0;
+	features |= cpuFeatures.hasSse41 ? (1 << 1) : 0;
+	features |= cpuFeatures.hasAvx ? (1 << 2) : 0;
+	features |= cpuFeatures.hasAvx2 ? (1 << 3) : 0;
+	features |= cpuFeatures.hasFma ? (1 << 4) : 0;
+	features |= cpuFeatures.hasPopcnt ? (1 << 5) : 0;
+	features |= cpuFeatures.hasLzcnt ? (1 << 6) : 0;
+	features |= cpuFeatures.hasBmi1 ? (1 << 7) : 0;
+	features |= cpuFeatures.hasBmi2 ? (1 << 8) : 0;
+
+	m_configKey = g_fnvOffsetBasis;
+	HashValue<uint32>(m_configKey, CACHE_FILE_VERSION);
+	HashString(m_configKey, backendName);
+	HashValue<uint32>(m_configKey, features);
+}
+
+CCodeCache::~CCodeCache()
+{
+	UnmapFile();
+}
+
+void CCodeCache::RegisterExternalSymbol(const std::string& name, uintptr_t value)
+{
+	assert(m_symbolNames.find(value) == std::end(m_symbolNames));
+	assert(m_symbolValues.find(name) == std::end(m_symbolValues));
+	m_symbolNames[value] = name;
+	m_symbolValues[name] = value;
+}
+
+CCodeCache::KEY CCodeCache::ComputeKey(const StatementList& statements, const std::vector<uint32>& deadOnExitRelatives, ExternalSymbolArray& externalSymbols) const
+{
+	uint64 hash = m_configKey;
+	//Code generated for the same statements differs when stores can be removed
+	if(!deadOnExitRelatives.empty())
+	{
+		HashValue<uint32>(hash, static_cast<uint32>(deadOnExitRelatives.size()));
+		for(auto relative : deadOnExitRelatives)
+		{
+			HashValue<uint32>(hash, relative);
+		}
+	}
+	auto hashOperand = [&](const SymbolRefPtr& symbolRef) {
+		if(!symbolRef)
+		{
+			HashValue<uint8>(hash, 0);
+			return;
+		}
+		auto symbol = symbolRef->GetSymbol();
+		HashValue<uint8>(hash, 1);
+		HashValue<uint32>(hash, symbol->m_type);
+		if(symbol->m_type == SYM_CONSTANTPTR)
+		{
+			//Helper addresses change between runs, use their names instead
+			auto symbolNameIterator = m_symbolNames.find(symbol->GetConstantPtr());
+			if(symbolNameIterator != std::end(m_symbolNames))
+			{
+				externalSymbols.push_back(symbolNameIterator->first);
+				HashValue<uint8>(hash, 1);
+				HashString(hash, symbolNameIterator->second);
+				return;
+			}
+			HashValue<uint8>(hash, 0);
+		}
+		HashValue<uint32>(hash, symbol->m_valueLow);
+		HashValue<uint32>(hash, symbol->m_valueHigh);
+	};
+	for(const auto& statement : statements)
+	{
+		HashValue<uint32>(hash, statement.op);
+		HashValue<uint32>(hash, statement.jmpBlock);
+		HashValue<uint32>(hash, statement.jmpCondition);
+		hashOperand(statement.dst);
+		hashOperand(statement.src1);
+		hashOperand(statement.src2);
+		hashOperand(statement.src3);
+	}
+	return hash;
+}
+
+bool CCodeCache::Lookup(KEY key, uint32 pointerSize, Framework::CStream& stream, SymbolReferenceArray& symbolReferences)
+{
+	{
+		auto entryIterator = m_sessionEntries.find(key);
+		if(entryIterator != std::end(m_sessionEntries))
+		{
+			const auto& entry = entryIterator->second;
+			if(!WriteEntry(stream, pointerSize, entry.code.data(), static_cast<uint32>(entry.code.size()), entry.relocations, symbolReferences)) return false;
+			m_hitCount++;
+			return true;
+		}
+	}
+
+	if(!m_loaded)
+	{
+		MapFile();
+	}
+
+	{
+		auto entryIterator = m_entries.find(key);
+		if(entryIterator != std::end(m_entries))
+		{
+			const auto& entry = entryIterator->second;
+			if(!WriteEntry(stream, pointerSize, entry.code, entry.codeSize, entry.relocations, symbolReferences)) return false;
+			m_hitCount++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CCodeCache::Insert(KEY key, const ExternalSymbolArray& externalSymbols, const uint8* code, uint32 codeSize, const SymbolReferenceArray& symbolReferences)
+{
+	//Registered symbols are keyed by name, make sure every one of them can be relocated
+	for(const auto& externalSymbol : externalSymbols)
+	{
+		auto symbolReferenceIterator = std::find_if(std::begin(symbolReferences), std::end(symbolReferences),
+		                                            [externalSymbol](const SYMBOL_REFERENCE& symbolReference) { return symbolReference.value == externalSymbol; });
+		if(symbolReferenceIterator == std::end(symbolReferences)) return;
+	}
+
+	RelocationArray relocations;
+	for(const auto& symbolReference : symbolReferences)
+	{
+		//Code referencing symbols relative to its final location can't be moved around
+		if((symbolReference.type == CCodeGen::SYMBOL_REF_TYPE::ARMV8_PCRELATIVE) ||
+		   (symbolReference.type == CCodeGen::SYMBOL_REF_TYPE::X86_64_PCRELATIVE)) return;
+		RELOCATION relocation;
+		relocation.offset = symbolReference.offset;
+		relocation.type = symbolReference.type;
+		relocation.value = symbolReference.value;
+		//Unregistered values are part of the key and can be left as is
+		auto symbolNameIterator = m_symbolNames.find(symbolReference.value);
+		if(symbolNameIterator != std::end(m_symbolNames))
+		{
+			relocation.symbolName = symbolNameIterator->second;
+		}
+		relocations.push_back(std::move(relocation));
+	}
+
+	if(!m_loaded)
+	{
+		MapFile();
+	}
+
+	if(m_entries.find(key) != std::end(m_entries)) return;
+	if(m_sessionEntries.find(key) != std::end(m_sessionEntries)) return;
+
+	Framework::CMemStream recordBody;
+	recordBody.Write32(codeSize);
+	recordBody.Write32(static_cast<uint32>(relocations.size()));
+	for(const auto& relocation : relocations)
+	{
+		recordBody.Write32(relocation.offset);
+		recordBody.Write8(static_cast<uint8>(relocation.type));
+		recordBody.Write8(0);
+		recordBody.Write16(static_cast<uint16>(relocation.symbolName.size()));
+		recordBody.Write64(relocation.value);
+		recordBody.Write(relocation.symbolName.data(), relocation.symbolName.size());
+	}
+	recordBody.Write(code, codeSize);
+
+	uint64 checksum = g_fnvOffsetBasis;
+	HashValue<uint64>(checksum, key);
+	HashBytes(checksum, recordBody.GetBuffer(), recordBody.GetSize());
+
+	Framework::CMemStream record;
+	record.Write64(key);
+	record.Write64(checksum);
+	record.Write(recordBody.GetBuffer(), recordBody.GetSize());
+
+	//An empty mapping means that the file doesn't exist or is invalid, and records
+	//appended after a damaged one would never be read back. Start a new file then.
+	if((m_mappedData == nullptr) || (m_validSize != m_mappedSize))
+	{
+		if(ReplaceFile(record.GetBuffer(), record.GetSize()))
+		{
+			MapFile();
+		}
+	}
+	else
+	{
+		AppendRecord(record.GetBuffer(), record.GetSize());
+	}
+
+	SESSION_ENTRY entry;
+	entry.code = std::vector<uint8>(code, code + codeSize);
+	entry.relocations = std::move(relocations);
+	m_sessionEntries.emplace(key, std::move(entry));
+}
+
+uint32 CCodeCache::GetHitCount() const
+{
+	return m_hitCount;
+}
+
+void CCodeCache::MapFile()
+{
+	UnmapFile();
+	m_loaded = true;
+
+#ifdef _WIN32
+	auto fileHandle = CreateFileA(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+	                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(fileHandle == INVALID_HANDLE_VALUE) return;
+	LARGE_INTEGER fileSize = {};
+	GetFileSizeEx(fileHandle, &fileSize);
+	if(fileSize.QuadPart == 0)
+	{
+		CloseHandle(fileHandle);
+		return;
+	}
+	//Make sure that no record is being written while the file size is taken
+	OVERLAPPED overlapped = {};
+	LockFileEx(fileHandle, 0, 0, MAXDWORD, MAXDWORD, &overlapped);
+	GetFileSizeEx(fileHandle, &fileSize);
+	auto mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	UnlockFileEx(fileHandle, 0, MAXDWORD, MAXDWORD, &overlapped);
+	if(mappingHandle == NULL)
+	{
+		CloseHandle(fileHandle);
+		return;
+	}
+	m_fileHandle = fileHandle;
+	m_mappingHandle = mappingHandle;
+	m_mappedData = reinterpret_cast<const uint8*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	m_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int fd = open(m_path.c_str(), O_RDONLY);
+	if(fd == -1) return;
+	//Make sure that no record is being written while the file size is taken
+	flock(fd, LOCK_SH);
+	struct stat fileStat = {};
+	if((fstat(fd, &fileStat) == 0) && (fileStat.st_size != 0))
+	{
+		auto mappedData = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(mappedData != MAP_FAILED)
+		{
+			m_mappedData = reinterpret_cast<const uint8*>(mappedData);
+			m_mappedSize = fileStat.st_size;
+		}
+	}
+	flock(fd, LOCK_UN);
+	close(fd);
+#endif
+
+	if(m_mappedData)
+	{
+		IndexMappedEntries();
+	}
+}
+
+void CCodeCache::UnmapFile()
+{
+	m_entries.clear();
+#ifdef _WIN32
+	if(m_mappedData)
+	{
+		UnmapViewOfFile(m_mappedData);
+	}
+	if(m_mappingHandle)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = nullptr;
+	}
+	if(m_fileHandle)
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle = nullptr;
+	}
+#else
+	if(m_mappedData)
+	{
+		munmap(const_cast<uint8*>(m_mappedData), m_mappedSize);
+	}
+#endif
+	m_mappedData = nullptr;
+	m_mappedSize = 0;
+	m_validSize = 0;
+}
+
+void CCodeCache::IndexMappedEntries()
+{
+	size_t position = 0;
+	auto canRead = [&](size_t size) { return (m_mappedSize - position) >= size; };
+	auto read = [&](auto& value) {
+		memcpy(&value, m_mappedData + position, sizeof(value));
+		position += sizeof(value);
+	};
+
+	uint32 magic = 0, version = 0;
+	if(!canRead(CACHE_FILE_HEADER_SIZE)) return UnmapFile();
+	read(magic);
+	read(version);
+	if((magic != CACHE_FILE_MAGIC) || (version != CACHE_FILE_VERSION))
+	{
+		return UnmapFile();
+	}
+	m_validSize = position;
+
+	//A truncated or damaged record ends the index
+	while(canRead(24))
+	{
+		KEY key = 0;
+		uint64 checksum = 0;
+		ENTRY entry;
+		uint32 relocationCount = 0;
+		read(key);
+		read(checksum);
+		size_t bodyStart = position;
+		read(entry.codeSize);
+		read(relocationCount);
+		bool valid = true;
+		for(uint32 i = 0; i < relocationCount; i++)
+		{
+			if(!canRead(16))
+			{
+				valid = false;
+				break;
+			}
+			RELOCATION relocation;
+			uint8 type = 0, reserved = 0;
+			uint16 nameLength = 0;
+			read(relocation.offset);
+			read(type);
+			read(reserved);
+			read(nameLength);
+			read(relocation.value);
+			if(!canRead(nameLength))
+			{
+				valid = false;
+				break;
+			}
+			relocation.type = static_cast<CCodeGen::SYMBOL_REF_TYPE>(type);
+			relocation.symbolName = std::string(reinterpret_cast<const char*>(m_mappedData + position), nameLength);
+			position += nameLength;
+			entry.relocations.push_back(std::move(relocation));
+		}
+		if(!valid || !canRead(entry.codeSize)) break;
+		entry.code = m_mappedData + position;
+		position += entry.codeSize;
+		uint64 recordChecksum = g_fnvOffsetBasis;
+		HashValue<uint64>(recordChecksum, key);
+		HashBytes(recordChecksum, m_mappedData + bodyStart, position - bodyStart);
+		if(recordChecksum != checksum) break;
+		m_entries.emplace(key, std::move(entry));
+		m_validSize = position;
+	}
+}
+
+bool CCodeCache::WriteEntry(Framework::CStream& stream, uint32 pointerSize, const uint8* code, uint32 codeSize, const RelocationArray& relocations, SymbolReferenceArray& symbolReferences) const
+{
+	std::vector<uint8> patchedCode(code, code + codeSize);
+	symbolReferences.clear();
+	for(const auto& relocation : relocations)
+	{
+		SYMBOL_REFERENCE symbolReference;
+		symbolReference.offset = relocation.offset;
+		symbolReference.type = relocation.type;
+		if(relocation.symbolName.empty())
+		{
+			symbolReference.value = static_cast<uintptr_t>(relocation.value);
+			symbolReferences.push_back(symbolReference);
+			continue;
+		}
+		auto symbolValueIterator = m_symbolValues.find(relocation.symbolName);
+		if(symbolValueIterator == std::end(m_symbolValues)) return false;
+		uintptr_t value = symbolValueIterator->second;
+		symbolReference.value = value;
+		symbolReferences.push_back(symbolReference);
+		switch(relocation.type)
+		{
+		case CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER:
+			if((pointerSize != 4) && (pointerSize != 8)) return false;
+			if((static_cast<uint64>(relocation.offset) + pointerSize) > codeSize) return false;
+			if(pointerSize == 4)
+			{
+				uint32 value32 = static_cast<uint32>(value);
+				memcpy(patchedCode.data() + relocation.offset, &value32, 4);
+			}
+			else
+			{
+				uint64 value64 = static_cast<uint64>(value);
+				memcpy(patchedCode.data() + relocation.offset, &value64, 8);
+			}
+			break;
+		case CCodeGen::SYMBOL_REF_TYPE::ARMV7_LOAD_HALF:
+		{
+			//MOVW/MOVT pair, imm16 is split in imm4:imm12
+			if((static_cast<uint64>(relocation.offset) + 8) > codeSize) return false;
+			for(uint32 i = 0; i < 2; i++)
+			{
+				uint32 half = static_cast<uint32>(value >> (i * 16)) & 0xFFFF;
+				uint32 opcode = 0;
+				memcpy(&opcode, patchedCode.data() + relocation.offset + (i * 4), 4);
+				opcode &= ~0x000F0FFF;
+				opcode |= ((half >> 12) << 16) | (half & 0xFFF);
+				memcpy(patchedCode.data() + relocation.offset + (i * 4), &opcode, 4);
+			}
+		}
+		break;
+		default:
+			return false;
+		}
+	}
+	stream.Write(patchedCode.data(), patchedCode.size());
+	return true;
+}
+
+bool CCodeCache::AppendRecord(const uint8* record, size_t recordSize) const
+{
+	uint32 header[2] = {CACHE_FILE_MAGIC, CACHE_FILE_VERSION};
+	bool succeeded = true;
+#ifdef _WIN32
+	auto fileHandle = CreateFileA(m_path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE,
+	                              NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(fileHandle == INVALID_HANDLE_VALUE) return false;
+	OVERLAPPED overlapped = {};
+	LockFileEx(fileHandle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped);
+	auto writeData = [&](const void* data, size_t size) {
+		DWORD written = 0;
+		return (WriteFile(fileHandle, data, static_cast<DWORD>(size), &written, NULL) != FALSE) && (written == size);
+	};
+	//The file might have been removed since it was mapped
+	LARGE_INTEGER fileSize = {};
+	GetFileSizeEx(fileHandle, &fileSize);
+	if(fileSize.QuadPart == 0)
+	{
+		succeeded &= writeData(header, sizeof(header));
+	}
+	succeeded &= writeData(record, recordSize);
+	UnlockFileEx(fileHandle, 0, MAXDWORD, MAXDWORD, &overlapped);
+	CloseHandle(fileHandle);
+#else
+	int fd = open(m_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if(fd == -1) return false;
+	flock(fd, LOCK_EX);
+	auto writeData = [&](const void* data, size_t size) {
+		auto bytes = reinterpret_cast<const uint8*>(data);
+		while(size != 0)
+		{
+			auto written = ::write(fd, bytes, size);
+			if(written <= 0) return false;
+			bytes += written;
+			size -= written;
+		}
+		return true;
+	};
+	//The file might have been removed since it was mapped
+	struct stat fileStat = {};
+	if((fstat(fd, &fileStat) == 0) && (fileStat.st_size == 0))
+	{
+		succeeded &= writeData(header, sizeof(header));
+	}
+	succeeded &= writeData(record, recordSize);
+	flock(fd, LOCK_UN);
+	close(fd);
+#endif
+	return succeeded;
+}
+
+bool CCodeCache::ReplaceFile(const uint8* record, size_t recordSize) const
+{
+	//Other processes might have the file mapped, write a new one and move it in place
+#ifdef _WIN32
+	auto tempPath = m_path + "." + std::to_string(GetCurrentProcessId()) + ".tmp";
+#else
+	auto tempPath = m_path + "." + std::to_string(getpid()) + ".tmp";
+#endif
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if(!file) return false;
+	uint32 header[2] = {CACHE_FILE_MAGIC, CACHE_FILE_VERSION};
+	bool succeeded = true;
+	succeeded &= (fwrite(header, sizeof(header), 1, file) == 1);
+	//Keep the records that were valid
+	if(m_mappedData && (m_validSize > CACHE_FILE_HEADER_SIZE))
+	{
+		succeeded &= (fwrite(m_mappedData + CACHE_FILE_HEADER_SIZE, m_validSize - CACHE_FILE_HEADER_SIZE, 1, file) == 1);
+	}
+	succeeded &= (fwrite(record, recordSize, 1, file) == 1);
+	succeeded &= (fclose(file) == 0);
+#ifdef _WIN32
+	succeeded = succeeded && (MoveFileExA(tempPath.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE);
+#else
+	succeeded = succeeded && (rename(tempPath.c_str(), m_path.c_str()) == 0);
+#endif
+	if(!succeeded)
+	{
+		remove(tempPath.c_str());
+	}
+	return succeeded;
+}
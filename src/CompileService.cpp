@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cassert>
+#include "CompileService.h"
+#include "MemStream.h"
+
+using namespace Jitter;
+
+uint64 CCompileService::CJob::GetTag() const
+{
+	return m_tag;
+}
+
+void CCompileService::CJob::Cancel()
+{
+	m_cancelled = true;
+}
+
+bool CCompileService::CJob::IsCancelled() const
+{
+	return m_cancelled;
+}
+
+CCompileService::CCompileService(CodeGenFactory codeGenFactory, unsigned int threadCount)
+    : m_codeGenFactory(std::move(codeGenFactory))
+{
+	if(threadCount == 0)
+	{
+		threadCount = std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+	}
+	m_threads.reserve(threadCount);
+	for(unsigned int i = 0; i < threadCount; i++)
+	{
+		m_threads.emplace_back(&CCompileService::WorkerThreadProc, this);
+	}
+}
+
+CCompileService::~CCompileService()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_stopping = true;
+		m_jobs.clear();
+	}
+	m_jobsCondition.notify_all();
+	for(auto& thread : m_threads)
+	{
+		thread.join();
+	}
+
+	auto completedJob = m_completedJobs.exchange(nullptr);
+	while(completedJob)
+	{
+		auto nextJob = completedJob->next;
+		delete completedJob;
+		completedJob = nextJob;
+	}
+}
+
+CCompileService::JobPtr CCompileService::Submit(uint64 tag, const StatementList& statements)
+{
+	auto job = std::make_shared<CJob>();
+	job->m_tag = tag;
+
+	//Copy statements along with their symbols, the originals belong to the submitter's jitter
+	{
+		Framework::CMemStream stream;
+		SerializeStatementList(stream, statements);
+		stream.Seek(0, Framework::STREAM_SEEK_SET);
+		job->m_statements = DeserializeStatementList(stream, job->m_symbolTable);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_jobs.push_back(job);
+	}
+	m_jobsCondition.notify_one();
+	return job;
+}
+
+void CCompileService::CollectResults(const ResultHandler& resultHandler)
+{
+	auto completedJob = m_completedJobs.exchange(nullptr, std::memory_order_acquire);
+
+	//List is in reverse completion order
+	COMPLETED_JOB* orderedJobs = nullptr;
+	while(completedJob)
+	{
+		auto nextJob = completedJob->next;
+		completedJob->next = orderedJobs;
+		orderedJobs = completedJob;
+		completedJob = nextJob;
+	}
+
+	while(orderedJobs)
+	{
+		std::unique_ptr<COMPLETED_JOB> job(orderedJobs);
+		orderedJobs = orderedJobs->next;
+		if(job->job->IsCancelled()) continue;
+
+		RESULT result;
+		result.tag = job->job->GetTag();
+#ifdef __EMSCRIPTEN__
+		//Modules need to be instantiated on the thread that runs them
+		result.function = CMemoryFunction(job->code.data(), job->code.size());
+#else
+		result.function = std::move(job->function);
+#endif
+		resultHandler(result);
+	}
+}
+
+void CCompileService::WaitForIdle()
+{
+	std::unique_lock<std::mutex> lock(m_jobsMutex);
+	m_idleCondition.wait(lock, [this]() { return m_jobs.empty() && (m_activeJobCount == 0); });
+}
+
+void CCompileService::WorkerThreadProc()
+{
+	auto jitter = std::make_unique<CJitter>(m_codeGenFactory());
+	while(1)
+	{
+		JobPtr job;
+		{
+			std::unique_lock<std::mutex> lock(m_jobsMutex);
+			m_jobsCondition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+			if(m_stopping) break;
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+			m_activeJobCount++;
+		}
+
+		if(!job->IsCancelled())
+		{
+			try
+			{
+				Framework::CMemStream codeStream;
+				jitter->SetStream(&codeStream);
+				jitter->Replay(job->m_statements);
+
+				auto completedJob = std::make_unique<COMPLETED_JOB>();
+				completedJob->job = job;
+#ifdef __EMSCRIPTEN__
+				completedJob->code = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+#else
+				completedJob->function = CMemoryFunction(codeStream.GetBuffer(), codeStream.GetSize());
+#endif
+				PublishResult(completedJob.release());
+			}
+			catch(...)
+			{
+				//Submitter keeps running its previous version of the function, start over
+				//with a new jitter since this one was left in the middle of a compilation
+				jitter = std::make_unique<CJitter>(m_codeGenFactory());
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_jobsMutex);
+			m_activeJobCount--;
+		}
+		m_idleCondition.notify_all();
+	}
+}
+
+void CCompileService::PublishResult(COMPLETED_JOB* completedJob)
+{
+	completedJob->next = m_completedJobs.load(std::memory_order_relaxed);
+	while(!m_completedJobs.compare_exchange_weak(completedJob->next, completedJob, std::memory_order_release, std::memory_order_relaxed))
+	{
+	}
+}
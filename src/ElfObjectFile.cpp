@@ -0,0 +1,329 @@
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include "ElfObjectFile.h"
+
+using namespace Jitter;
+
+enum SECTION_INDEX
+{
+	SECTION_INDEX_NULL,
+	SECTION_INDEX_TEXT,
+	SECTION_INDEX_DATA,
+	SECTION_INDEX_RELA_TEXT,
+	SECTION_INDEX_RELA_DATA,
+	SECTION_INDEX_SYMTAB,
+	SECTION_INDEX_STRTAB,
+	SECTION_INDEX_SHSTRTAB,
+	SECTION_INDEX_NOTE_GNU_STACK,
+	SECTION_INDEX_COUNT,
+};
+
+static uint64 AlignOffset(uint64 offset, uint64 alignment)
+{
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+CElfObjectFile::CElfObjectFile(CPU_ARCH cpuArch)
+    : CObjectFile(cpuArch)
+{
+}
+
+void CElfObjectFile::Write(Framework::CStream& stream)
+{
+	uint16 machine = 0;
+	switch(m_cpuArch)
+	{
+	case CPU_ARCH_X64:
+		machine = Elf::EM_X86_64;
+		break;
+	case CPU_ARCH_ARM64:
+		machine = Elf::EM_AARCH64;
+		break;
+	default:
+		throw std::runtime_error("ElfObjectFile: Unsupported CPU architecture.");
+		break;
+	}
+
+	auto internalSymbolInfos = InternalSymbolInfoArray(m_internalSymbols.size());
+	auto externalSymbolInfos = ExternalSymbolInfoArray(m_externalSymbols.size());
+
+	StringTable stringTable;
+	stringTable.push_back(0x00);
+	FillStringTable(stringTable, m_internalSymbols, internalSymbolInfos);
+	FillStringTable(stringTable, m_externalSymbols, externalSymbolInfos);
+
+	auto textSection = BuildSection(m_internalSymbols, internalSymbolInfos, INTERNAL_SYMBOL_LOCATION_TEXT);
+	auto dataSection = BuildSection(m_internalSymbols, internalSymbolInfos, INTERNAL_SYMBOL_LOCATION_DATA);
+
+	auto symbols = BuildSymbols(m_internalSymbols, internalSymbolInfos, m_externalSymbols, externalSymbolInfos);
+
+	auto textSectionRelocations = BuildRelocations(textSection, internalSymbolInfos, externalSymbolInfos);
+	auto dataSectionRelocations = BuildRelocations(dataSection, internalSymbolInfos, externalSymbolInfos);
+
+	StringTable sectionStringTable;
+	sectionStringTable.push_back(0x00);
+
+	SectionHeaderArray sectionHeaders(SECTION_INDEX_COUNT);
+	memset(sectionHeaders.data(), 0, sizeof(Elf::SECTION_HEADER_64) * sectionHeaders.size());
+
+	uint64 currentOffset = sizeof(Elf::HEADER_64);
+	auto setupSection =
+	    [&](SECTION_INDEX index, const char* name, uint32 type, uint64 flags, uint64 size, uint64 alignment) {
+		    auto& sectionHeader = sectionHeaders[index];
+		    currentOffset = AlignOffset(currentOffset, alignment);
+		    sectionHeader.name = AddString(sectionStringTable, name);
+		    sectionHeader.type = type;
+		    sectionHeader.flags = flags;
+		    sectionHeader.offset = currentOffset;
+		    sectionHeader.size = size;
+		    sectionHeader.addressAlign = alignment;
+		    currentOffset += size;
+		    return &sectionHeader;
+	    };
+
+	setupSection(SECTION_INDEX_TEXT, ".text", Elf::SHT_PROGBITS, Elf::SHF_ALLOC | Elf::SHF_EXECINSTR, textSection.data.size(), 0x10);
+	setupSection(SECTION_INDEX_DATA, ".data", Elf::SHT_PROGBITS, Elf::SHF_ALLOC | Elf::SHF_WRITE, dataSection.data.size(), 0x08);
+
+	{
+		auto sectionHeader = setupSection(SECTION_INDEX_RELA_TEXT, ".rela.text", Elf::SHT_RELA, Elf::SHF_INFO_LINK,
+		                                  textSectionRelocations.size() * sizeof(Elf::RELOCATION_ADDEND_64), 0x08);
+		sectionHeader->link = SECTION_INDEX_SYMTAB;
+		sectionHeader->info = SECTION_INDEX_TEXT;
+		sectionHeader->entrySize = sizeof(Elf::RELOCATION_ADDEND_64);
+	}
+
+	{
+		auto sectionHeader = setupSection(SECTION_INDEX_RELA_DATA, ".rela.data", Elf::SHT_RELA, Elf::SHF_INFO_LINK,
+		                                  dataSectionRelocations.size() * sizeof(Elf::RELOCATION_ADDEND_64), 0x08);
+		sectionHeader->link = SECTION_INDEX_SYMTAB;
+		sectionHeader->info = SECTION_INDEX_DATA;
+		sectionHeader->entrySize = sizeof(Elf::RELOCATION_ADDEND_64);
+	}
+
+	{
+		auto sectionHeader = setupSection(SECTION_INDEX_SYMTAB, ".symtab", Elf::SHT_SYMTAB, 0,
+		                                  symbols.size() * sizeof(Elf::SYMBOL_64), 0x08);
+		sectionHeader->link = SECTION_INDEX_STRTAB;
+		sectionHeader->info = 1; //Index of first non local symbol
+		sectionHeader->entrySize = sizeof(Elf::SYMBOL_64);
+	}
+
+	setupSection(SECTION_INDEX_STRTAB, ".strtab", Elf::SHT_STRTAB, 0, stringTable.size(), 0x01);
+
+	//Mark stack as non executable
+	setupSection(SECTION_INDEX_NOTE_GNU_STACK, ".note.GNU-stack", Elf::SHT_PROGBITS, 0, 0, 0x01);
+
+	//Section string table must be last since it contains its own name
+	{
+		auto& sectionHeader = sectionHeaders[SECTION_INDEX_SHSTRTAB];
+		sectionHeader.name = AddString(sectionStringTable, ".shstrtab");
+		sectionHeader.type = Elf::SHT_STRTAB;
+		sectionHeader.offset = currentOffset;
+		sectionHeader.size = sectionStringTable.size();
+		sectionHeader.addressAlign = 0x01;
+		currentOffset += sectionStringTable.size();
+	}
+
+	uint64 sectionHeaderOffset = AlignOffset(currentOffset, 0x08);
+
+	Elf::HEADER_64 header = {};
+	*reinterpret_cast<uint32*>(header.ident) = Elf::ELF_MAGIC;
+	header.ident[Elf::EI_CLASS] = Elf::ELFCLASS64;
+	header.ident[Elf::EI_DATA] = Elf::ELFDATA2LSB;
+	header.ident[Elf::EI_VERSION] = Elf::EV_CURRENT;
+	header.ident[Elf::EI_OSABI] = Elf::ELFOSABI_NONE;
+	header.type = Elf::ET_REL;
+	header.machine = machine;
+	header.version = Elf::EV_CURRENT;
+	header.sectionHeaderOffset = sectionHeaderOffset;
+	header.headerSize = sizeof(Elf::HEADER_64);
+	header.sectionHeaderEntrySize = sizeof(Elf::SECTION_HEADER_64);
+	header.sectionHeaderCount = SECTION_INDEX_COUNT;
+	header.sectionNameStringTableIndex = SECTION_INDEX_SHSTRTAB;
+
+	auto writeAt =
+	    [&](uint64 offset, const void* data, uint64 size) {
+		    static const uint8 padding[0x10] = {};
+		    uint64 position = stream.Tell();
+		    assert(offset >= position);
+		    assert((offset - position) <= sizeof(padding));
+		    stream.Write(padding, offset - position);
+		    stream.Write(data, size);
+	    };
+
+	uint64 baseOffset = stream.Tell();
+	stream.Write(&header, sizeof(Elf::HEADER_64));
+	writeAt(baseOffset + sectionHeaders[SECTION_INDEX_TEXT].offset, textSection.data.data(), textSection.data.size());
+	writeAt(baseOffset + sectionHeaders[SECTION_INDEX_DATA].offset, dataSection.data.data(), dataSection.data.size());
+	writeAt(baseOffset + sectionHeaders[SECTION_INDEX_RELA_TEXT].offset, textSectionRelocations.data(), textSectionRelocations.size() * sizeof(Elf::RELOCATION_ADDEND_64));
+	writeAt(baseOffset + sectionHeaders[SECTION_INDEX_RELA_DATA].offset, dataSectionRelocations.data(), dataSectionRelocations.size() * sizeof(Elf::RELOCATION_ADDEND_64));
+	writeAt(baseOffset + sectionHeaders[SECTION_INDEX_SYMTAB].offset, symbols.data(), symbols.size() * sizeof(Elf::SYMBOL_64));
+	writeAt(baseOffset + sectionHeaders[SECTION_INDEX_STRTAB].offset, stringTable.data(), stringTable.size());
+	writeAt(baseOffset + sectionHeaders[SECTION_INDEX_SHSTRTAB].offset, sectionStringTable.data(), sectionStringTable.size());
+	writeAt(baseOffset + sectionHeaderOffset, sectionHeaders.data(), sectionHeaders.size() * sizeof(Elf::SECTION_HEADER_64));
+}
+
+uint32 CElfObjectFile::AddString(StringTable& stringTable, const std::string& value)
+{
+	uint32 offset = static_cast<uint32>(stringTable.size());
+	stringTable.insert(std::end(stringTable), std::begin(value), std::end(value));
+	stringTable.push_back(0);
+	return offset;
+}
+
+void CElfObjectFile::FillStringTable(StringTable& stringTable, const InternalSymbolArray& internalSymbols, InternalSymbolInfoArray& internalSymbolInfos)
+{
+	for(uint32 i = 0; i < internalSymbols.size(); i++)
+	{
+		internalSymbolInfos[i].nameOffset = AddString(stringTable, internalSymbols[i].name);
+	}
+}
+
+void CElfObjectFile::FillStringTable(StringTable& stringTable, const ExternalSymbolArray& externalSymbols, ExternalSymbolInfoArray& externalSymbolInfos)
+{
+	for(uint32 i = 0; i < externalSymbols.size(); i++)
+	{
+		externalSymbolInfos[i].nameOffset = AddString(stringTable, externalSymbols[i].name);
+	}
+}
+
+CElfObjectFile::SECTION CElfObjectFile::BuildSection(const InternalSymbolArray& internalSymbols, InternalSymbolInfoArray& internalSymbolInfos, INTERNAL_SYMBOL_LOCATION location)
+{
+	SECTION section;
+	auto& sectionData(section.data);
+	for(uint32 i = 0; i < internalSymbols.size(); i++)
+	{
+		const auto& internalSymbol = internalSymbols[i];
+		if(internalSymbol.location != location) continue;
+
+		//Keep functions and data aligned
+		sectionData.resize(AlignOffset(sectionData.size(), (location == INTERNAL_SYMBOL_LOCATION_TEXT) ? 0x10 : 0x08));
+
+		auto& internalSymbolInfo = internalSymbolInfos[i];
+		internalSymbolInfo.dataOffset = static_cast<uint32>(sectionData.size());
+		for(const auto& symbolReference : internalSymbol.symbolReferences)
+		{
+			SYMBOL_REFERENCE newReference;
+			newReference.offset = symbolReference.offset + internalSymbolInfo.dataOffset;
+			newReference.symbolIndex = symbolReference.symbolIndex;
+			newReference.type = symbolReference.type;
+			newReference.refType = symbolReference.refType;
+			section.symbolReferences.push_back(newReference);
+		}
+		sectionData.insert(std::end(sectionData), std::begin(internalSymbol.data), std::end(internalSymbol.data));
+	}
+	return section;
+}
+
+CElfObjectFile::SymbolArray CElfObjectFile::BuildSymbols(const InternalSymbolArray& internalSymbols, InternalSymbolInfoArray& internalSymbolInfos,
+                                                         const ExternalSymbolArray& externalSymbols, ExternalSymbolInfoArray& externalSymbolInfos)
+{
+	SymbolArray symbols;
+	symbols.reserve(1 + internalSymbols.size() + externalSymbols.size());
+
+	//First symbol is always undefined
+	symbols.push_back(Elf::SYMBOL_64());
+
+	//Internal symbols, global but not exported from the linked module
+	for(uint32 i = 0; i < internalSymbols.size(); i++)
+	{
+		const auto& internalSymbol = internalSymbols[i];
+		auto& internalSymbolInfo = internalSymbolInfos[i];
+		internalSymbolInfo.symbolIndex = static_cast<uint32>(symbols.size());
+
+		bool isText = (internalSymbol.location == CObjectFile::INTERNAL_SYMBOL_LOCATION_TEXT);
+
+		Elf::SYMBOL_64 symbol = {};
+		symbol.name = internalSymbolInfo.nameOffset;
+		symbol.info = (Elf::STB_GLOBAL << 4) | (isText ? Elf::STT_FUNC : Elf::STT_OBJECT);
+		symbol.other = Elf::STV_HIDDEN;
+		symbol.sectionIndex = isText ? SECTION_INDEX_TEXT : SECTION_INDEX_DATA;
+		symbol.value = internalSymbolInfo.dataOffset;
+		symbol.size = internalSymbol.data.size();
+		symbols.push_back(symbol);
+	}
+
+	//External symbols
+	for(uint32 i = 0; i < externalSymbols.size(); i++)
+	{
+		auto& externalSymbolInfo = externalSymbolInfos[i];
+		externalSymbolInfo.symbolIndex = static_cast<uint32>(symbols.size());
+
+		Elf::SYMBOL_64 symbol = {};
+		symbol.name = externalSymbolInfo.nameOffset;
+		symbol.info = (Elf::STB_GLOBAL << 4) | Elf::STT_NOTYPE;
+		symbol.other = Elf::STV_DEFAULT;
+		symbol.sectionIndex = Elf::SHN_UNDEF;
+		symbols.push_back(symbol);
+	}
+
+	return symbols;
+}
+
+CElfObjectFile::RelocationArray CElfObjectFile::BuildRelocations(SECTION& section, const InternalSymbolInfoArray& internalSymbolInfos,
+                                                                 const ExternalSymbolInfoArray& externalSymbolInfos) const
+{
+	RelocationArray relocations;
+	relocations.reserve(section.symbolReferences.size());
+
+	for(const auto& symbolReference : section.symbolReferences)
+	{
+		uint32 symbolIndex = (symbolReference.type == SYMBOL_TYPE_INTERNAL) ? internalSymbolInfos[symbolReference.symbolIndex].symbolIndex : externalSymbolInfos[symbolReference.symbolIndex].symbolIndex;
+		uint32 relocType = 0;
+		int64 addend = 0;
+
+		auto referenceData = section.data.data() + symbolReference.offset;
+		if(m_cpuArch == CObjectFile::CPU_ARCH_ARM64)
+		{
+			switch(symbolReference.refType)
+			{
+			case CCodeGen::SYMBOL_REF_TYPE::ARMV8_PCRELATIVE:
+			{
+				//B/BL emitted when generating relocatable calls
+				assert((symbolReference.offset + 4) <= section.data.size());
+				uint32 opcode = 0;
+				memcpy(&opcode, referenceData, 4);
+				assert((opcode & 0x7C000000) == 0x14000000);
+				relocType = Elf::R_AARCH64_CALL26;
+				opcode &= ~0x03FFFFFF;
+				memcpy(referenceData, &opcode, 4);
+			}
+			break;
+			case CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER:
+				relocType = Elf::R_AARCH64_ABS64;
+				memset(referenceData, 0, 8);
+				break;
+			default:
+				throw std::runtime_error("ElfObjectFile: Unsupported symbol reference type.");
+			}
+		}
+		else
+		{
+			assert(m_cpuArch == CObjectFile::CPU_ARCH_X64);
+			switch(symbolReference.refType)
+			{
+			case CCodeGen::SYMBOL_REF_TYPE::X86_64_PCRELATIVE:
+				//CALL/JMP rel32, relative to the end of the instruction
+				relocType = Elf::R_X86_64_PLT32;
+				addend = -4;
+				memset(referenceData, 0, 4);
+				break;
+			case CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER:
+				relocType = Elf::R_X86_64_64;
+				memset(referenceData, 0, 8);
+				break;
+			default:
+				throw std::runtime_error("ElfObjectFile: Unsupported symbol reference type.");
+			}
+		}
+
+		Elf::RELOCATION_ADDEND_64 relocation = {};
+		relocation.offset = symbolReference.offset;
+		relocation.info = (static_cast<uint64>(symbolIndex) << 32) | relocType;
+		relocation.addend = addend;
+		relocations.push_back(relocation);
+	}
+
+	return relocations;
+}
@@ -1,5 +1,9 @@
 #include <assert.h>
+#include <algorithm>
+#include <chrono>
 #include "Jitter.h"
+#include "CodeCache.h"
+#include "MemStream.h"
 #include "placeholder_def.h"
 
 using namespace std;
@@ -8,6 +12,10 @@ using namespace Jitter;
 CJitter::CJitter(CCodeGen* codeGen)
     : m_codeGen(codeGen)
     , m_codeGenSupportsCmpSelect(codeGen->SupportsCmpSelect())
+    , m_codeGenSupportsBitfieldOps(codeGen->SupportsBitfieldOps())
+    , m_codeGenSupportsPairedStores(codeGen->SupportsPairedStores())
+    , m_codeGenSupportsLoopRegisters(codeGen->SupportsLoopRegisters())
+    , m_codeGenSupportsMdLaneOps(codeGen->SupportsMdLaneOps())
 {
 }
 
@@ -23,9 +31,32 @@ CCodeGen* CJitter::GetCodeGen()
 
 void CJitter::SetStream(Framework::CStream* stream)
 {
+	m_stream = stream;
 	m_codeGen->SetStream(stream);
 }
 
+void CJitter::SetCodeCache(CCodeCache* codeCache)
+{
+	m_codeCache = codeCache;
+}
+
+void CJitter::SetCaptureHandler(const CaptureHandler& captureHandler)
+{
+	m_captureHandler = captureHandler;
+}
+
+void CJitter::SetCompileStats(CCompileStats* compileStats)
+{
+	m_compileStats = compileStats;
+}
+
+void CJitter::SetDeadOnExitRelatives(RelativeOffsetArray relatives)
+{
+	std::sort(relatives.begin(), relatives.end());
+	relatives.erase(std::unique(relatives.begin(), relatives.end()), relatives.end());
+	m_deadOnExitRelatives = std::move(relatives);
+}
+
 void CJitter::Begin()
 {
 	assert(m_blockStarted == false);
@@ -43,7 +74,171 @@ void CJitter::End()
 	assert(m_blockStarted == true);
 	m_blockStarted = false;
 
+	if(m_captureHandler)
+	{
+		m_captureHandler(FlattenBasicBlocks());
+	}
+
+	auto startTime = std::chrono::steady_clock::time_point();
+	uint64 codeStart = 0;
+	if(m_compileStats)
+	{
+		m_compileStats->BeginCompile();
+		for(const auto& basicBlock : m_basicBlocks)
+		{
+			m_compileStats->AddValue(CCompileStats::VALUE_INPUT_STATEMENTS, basicBlock.statements.size());
+		}
+		codeStart = m_stream ? m_stream->Tell() : 0;
+		startTime = std::chrono::steady_clock::now();
+	}
+
+	if(m_codeCache)
+	{
+		CompileCached();
+	}
+	else
+	{
+		Compile();
+	}
+
+	if(m_compileStats)
+	{
+		auto elapsed = std::chrono::steady_clock::now() - startTime;
+		m_compileStats->AddValue(CCompileStats::VALUE_COMPILE_TIME, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		m_compileStats->AddValue(CCompileStats::VALUE_CODE_SIZE, m_stream ? (m_stream->Tell() - codeStart) : 0);
+		m_compileStats->EndCompile();
+	}
+}
+
+StatementList CJitter::EndCapture()
+{
+	assert(m_shadow.GetCount() == 0);
+	assert(m_blockStarted == true);
+	m_blockStarted = false;
+
+	auto statements = FlattenBasicBlocks();
+	m_labels.clear();
+	return statements;
+}
+
+void CJitter::CompileCached()
+{
+	assert(m_stream);
+
+	//Fingerprint the statements as they were received, before any optimization pass
+	auto statements = FlattenBasicBlocks();
+
+	//Symbol references are relative to the function's start, handlers expect stream positions
+	auto codeStart = static_cast<uint32>(m_stream->Tell());
+	auto prevHandler = m_codeGen->GetExternalSymbolReferencedHandler();
+	auto reportSymbolReferences =
+	    [&](const CCodeCache::SymbolReferenceArray& symbolReferences) {
+		    if(!prevHandler) return;
+		    for(const auto& symbolReference : symbolReferences)
+		    {
+			    prevHandler(symbolReference.value, codeStart + symbolReference.offset, symbolReference.type);
+		    }
+	    };
+
+	CCodeCache::ExternalSymbolArray externalSymbols;
+	CCodeCache::SymbolReferenceArray symbolReferences;
+	auto key = m_codeCache->ComputeKey(statements, m_deadOnExitRelatives, externalSymbols);
+	if(m_codeCache->Lookup(key, m_codeGen->GetPointerSize(), *m_stream, symbolReferences))
+	{
+		reportSymbolReferences(symbolReferences);
+		m_labels.clear();
+		return;
+	}
+
+	//Generate code in a separate stream to have symbol reference offsets relative to the function's start
+	Framework::CMemStream codeStream;
+	symbolReferences.clear();
+	m_codeGen->SetStream(&codeStream);
+	m_codeGen->SetExternalSymbolReferencedHandler(
+	    [&](uintptr_t value, uint32 offset, CCodeGen::SYMBOL_REF_TYPE type) {
+		    CCodeCache::SYMBOL_REFERENCE symbolReference;
+		    symbolReference.value = value;
+		    symbolReference.offset = offset;
+		    symbolReference.type = type;
+		    symbolReferences.push_back(symbolReference);
+	    });
+
 	Compile();
+
+	m_codeGen->SetExternalSymbolReferencedHandler(prevHandler);
+	m_codeGen->SetStream(m_stream);
+
+	m_stream->Write(codeStream.GetBuffer(), codeStream.GetSize());
+	reportSymbolReferences(symbolReferences);
+	if(codeStream.GetSize() != 0)
+	{
+		m_codeCache->Insert(key, externalSymbols, codeStream.GetBuffer(), codeStream.GetSize(), symbolReferences);
+	}
+}
+
+StatementList CJitter::FlattenBasicBlocks() const
+{
+	StatementList statements;
+	for(const auto& basicBlock : m_basicBlocks)
+	{
+		STATEMENT labelStatement;
+		labelStatement.op = OP_LABEL;
+		labelStatement.jmpBlock = basicBlock.id;
+		statements.push_back(labelStatement);
+		for(auto statement : basicBlock.statements)
+		{
+			//Labels only exist while the function is being built, refer to their blocks instead
+			if(statement.op == OP_GOTO)
+			{
+				auto labelIterator = m_labels.find(statement.jmpBlock);
+				assert(labelIterator != m_labels.end());
+				statement.op = OP_JMP;
+				statement.jmpBlock = labelIterator->second;
+			}
+			statements.push_back(statement);
+		}
+	}
+	return statements;
+}
+
+void CJitter::Replay(const StatementList& statements)
+{
+	Begin();
+
+	bool firstLabel = true;
+	for(const auto& statement : statements)
+	{
+		if(statement.op == OP_LABEL)
+		{
+			if(firstLabel)
+			{
+				assert(m_currentBlock->statements.empty());
+				m_currentBlock->id = statement.jmpBlock;
+			}
+			else
+			{
+				StartBlock(statement.jmpBlock);
+			}
+			m_nextBlockId = std::max(m_nextBlockId, statement.jmpBlock + 1);
+			firstLabel = false;
+			continue;
+		}
+
+		//Symbols need to live in the symbol table of the block they're used in
+		STATEMENT newStatement(statement);
+		newStatement.VisitOperands(
+		    [this](SymbolRefPtr& symbolRef, bool) {
+			    auto symbol = symbolRef->GetSymbol();
+			    symbolRef = MakeSymbolRef(MakeSymbol(m_currentBlock, symbol->m_type, symbol->m_valueLow, symbol->m_valueHigh));
+			    if(symbol->IsTemporary())
+			    {
+				    m_nextTemporary = std::max(m_nextTemporary, symbol->m_valueLow + 1);
+			    }
+		    });
+		InsertStatement(newStatement);
+	}
+
+	End();
 }
 
 bool CJitter::IsStackEmpty() const
@@ -864,6 +1059,16 @@ void CJitter::FP_MulS()
 	InsertBinaryFp32Statement(OP_FP_MUL_S);
 }
 
+void CJitter::FP_MulAddS()
+{
+	InsertTernaryFp32Statement(OP_FP_MULADD_S);
+}
+
+void CJitter::FP_FusedMulAddS()
+{
+	InsertTernaryFp32Statement(OP_FP_FUSEDMULADD_S);
+}
+
 void CJitter::FP_DivS()
 {
 	InsertBinaryFp32Statement(OP_FP_DIV_S);
@@ -1466,6 +1671,41 @@ void CJitter::MD_PackWH()
 	InsertBinaryMdStatement(OP_MD_PACK_WH);
 }
 
+void CJitter::MD_ShuffleB(const std::array<uint8, 16>& indices)
+{
+	uint64 pattern = 0;
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		assert(indices[i] < 16);
+		pattern |= static_cast<uint64>(indices[i] & 0x0F) << (i * 4);
+	}
+
+	SymbolPtr tempSym = MakeSymbol(SYM_TEMPORARY128, m_nextTemporary++);
+
+	STATEMENT statement;
+	statement.op = OP_MD_SHUFFLE_B;
+	statement.src2 = MakeSymbolRef(MakeConstant64(pattern));
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	statement.dst = MakeSymbolRef(tempSym);
+	InsertStatement(statement);
+
+	m_shadow.Push(tempSym);
+}
+
+void CJitter::MD_ShuffleW(uint8 pattern)
+{
+	SymbolPtr tempSym = MakeSymbol(SYM_TEMPORARY128, m_nextTemporary++);
+
+	STATEMENT statement;
+	statement.op = OP_MD_SHUFFLE_W;
+	statement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, pattern));
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	statement.dst = MakeSymbolRef(tempSym);
+	InsertStatement(statement);
+
+	m_shadow.Push(tempSym);
+}
+
 void CJitter::MD_AddS()
 {
 	InsertBinaryMdStatement(OP_MD_ADD_S);
@@ -1486,6 +1726,16 @@ void CJitter::MD_DivS()
 	InsertBinaryMdStatement(OP_MD_DIV_S);
 }
 
+void CJitter::MD_MulAddS()
+{
+	InsertTernaryMdStatement(OP_MD_MULADD_S);
+}
+
+void CJitter::MD_FusedMulAddS()
+{
+	InsertTernaryMdStatement(OP_MD_FUSEDMULADD_S);
+}
+
 void CJitter::MD_ExpandW()
 {
 	InsertUnaryMdStatement(OP_MD_EXPAND_W);
@@ -1660,6 +1910,21 @@ void CJitter::InsertBinaryFp32Statement(Jitter::OPERATION operation)
 	m_shadow.Push(tempSym);
 }
 
+void CJitter::InsertTernaryFp32Statement(Jitter::OPERATION operation)
+{
+	auto tempSym = MakeSymbol(SYM_FP_TEMPORARY32, m_nextTemporary++);
+
+	STATEMENT statement;
+	statement.op = operation;
+	statement.src3 = MakeSymbolRef(m_shadow.Pull());
+	statement.src2 = MakeSymbolRef(m_shadow.Pull());
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	statement.dst = MakeSymbolRef(tempSym);
+	InsertStatement(statement);
+
+	m_shadow.Push(tempSym);
+}
+
 void CJitter::InsertUnaryMdStatement(Jitter::OPERATION operation)
 {
 	auto tempSym = MakeSymbol(SYM_TEMPORARY128, m_nextTemporary++);
@@ -1686,3 +1951,18 @@ void CJitter::InsertBinaryMdStatement(Jitter::OPERATION operation)
 
 	m_shadow.Push(tempSym);
 }
+
+void CJitter::InsertTernaryMdStatement(Jitter::OPERATION operation)
+{
+	auto tempSym = MakeSymbol(SYM_TEMPORARY128, m_nextTemporary++);
+
+	STATEMENT statement;
+	statement.op = operation;
+	statement.src3 = MakeSymbolRef(m_shadow.Pull());
+	statement.src2 = MakeSymbolRef(m_shadow.Pull());
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	statement.dst = MakeSymbolRef(tempSym);
+	InsertStatement(statement);
+
+	m_shadow.Push(tempSym);
+}
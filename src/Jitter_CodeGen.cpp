@@ -7,6 +7,11 @@ void CCodeGen::SetExternalSymbolReferencedHandler(const ExternalSymbolReferenced
 	m_externalSymbolReferencedHandler = externalSymbolReferencedHandler;
 }
 
+const CCodeGen::ExternalSymbolReferencedHandler& CCodeGen::GetExternalSymbolReferencedHandler() const
+{
+	return m_externalSymbolReferencedHandler;
+}
+
 bool CCodeGen::SymbolMatches(MATCHTYPE match, const SymbolRefPtr& symbolRef)
 {
 	if(match == MATCH_ANY) return true;
@@ -108,3 +113,71 @@ uint32 CCodeGen::GetRegisterUsage(const StatementList& statements)
 	}
 	return registerUsage;
 }
+
+std::set<uint32> CCodeGen::GetLoopHeadLabels(const StatementList& statements)
+{
+	std::set<uint32> markedLabels;
+	std::set<uint32> loopHeadLabels;
+	for(const auto& statement : statements)
+	{
+		if(statement.op == OP_LABEL)
+		{
+			markedLabels.insert(statement.jmpBlock);
+		}
+		else if((statement.op == OP_JMP) || (statement.op == OP_CONDJMP))
+		{
+			if(markedLabels.find(statement.jmpBlock) != std::end(markedLabels))
+			{
+				loopHeadLabels.insert(statement.jmpBlock);
+			}
+		}
+	}
+	return loopHeadLabels;
+}
+
+LITERAL128 CCodeGen::GetMdShuffleByteMask(const STATEMENT& statement)
+{
+	auto src2 = statement.src2->GetSymbol().get();
+
+	LITERAL128 mask(0, 0);
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		uint64 index = 0;
+		switch(statement.op)
+		{
+		case OP_MD_SHUFFLE_W:
+			assert(src2->m_type == SYM_CONSTANT);
+			index = (((src2->m_valueLow >> ((i / 4) * 2)) & 0x03) * 4) + (i % 4);
+			break;
+		case OP_MD_SHUFFLE_B:
+			assert(src2->m_type == SYM_CONSTANT64);
+			index = (src2->GetConstant64() >> (i * 4)) & 0x0F;
+			break;
+		default:
+			assert(false);
+			break;
+		}
+		if(i < 8)
+		{
+			mask.lo |= index << (i * 8);
+		}
+		else
+		{
+			mask.hi |= index << ((i - 8) * 8);
+		}
+	}
+	return mask;
+}
+
+LITERAL128 CCodeGen::GetMdLiteral(const STATEMENT& statement)
+{
+	assert(statement.op == OP_MD_LDCST);
+
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	assert(src1->m_type == SYM_CONSTANT64);
+	assert(src2->m_type == SYM_CONSTANT64);
+
+	return LITERAL128(src1->GetConstant64(), src2->GetConstant64());
+}
@@ -13,6 +13,7 @@ CAArch32Assembler::REGISTER CCodeGen_AArch32::g_baseRegister = CAArch32Assembler
 CAArch32Assembler::REGISTER CCodeGen_AArch32::g_callAddressRegister = CAArch32Assembler::r4;
 CAArch32Assembler::REGISTER CCodeGen_AArch32::g_tempParamRegister0 = CAArch32Assembler::r4;
 CAArch32Assembler::REGISTER CCodeGen_AArch32::g_tempParamRegister1 = CAArch32Assembler::r5;
+CAArch32Assembler::REGISTER CCodeGen_AArch32::g_mdAddressRegister = CAArch32Assembler::rIP;
 
 const LITERAL128 CCodeGen_AArch32::g_fpClampMask1(0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFF);
 const LITERAL128 CCodeGen_AArch32::g_fpClampMask2(0xFF7FFFFF, 0xFF7FFFFF, 0xFF7FFFFF, 0xFF7FFFFF);
@@ -28,6 +29,23 @@ CAArch32Assembler::REGISTER CCodeGen_AArch32::g_registers[MAX_REGISTERS] =
 	CAArch32Assembler::r10,
 };
 
+//q4-q7 are callee saved, q8-q15 are fine to use since registers don't live across calls
+CAArch32Assembler::QUAD_REGISTER CCodeGen_AArch32::g_registersMd[MAX_MDREGISTERS] =
+{
+	CAArch32Assembler::q4,
+	CAArch32Assembler::q5,
+	CAArch32Assembler::q6,
+	CAArch32Assembler::q7,
+	CAArch32Assembler::q8,
+	CAArch32Assembler::q9,
+	CAArch32Assembler::q10,
+	CAArch32Assembler::q11,
+	CAArch32Assembler::q12,
+	CAArch32Assembler::q13,
+	CAArch32Assembler::q14,
+	CAArch32Assembler::q15,
+};
+
 CAArch32Assembler::REGISTER CCodeGen_AArch32::g_paramRegs[MAX_PARAM_REGS] =
 {
 	CAArch32Assembler::r0,
@@ -208,6 +226,7 @@ CCodeGen_AArch32::CONSTMATCHER CCodeGen_AArch32::g_constMatchers[] =
 	{ OP_PARAM, MATCH_NIL, MATCH_MEMORY64,   MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Param_Mem64  },
 	{ OP_PARAM, MATCH_NIL, MATCH_CONSTANT64, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Param_Cst64  },
 	{ OP_PARAM, MATCH_NIL, MATCH_MEMORY128,  MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Param_Mem128 },
+	{ OP_PARAM, MATCH_NIL, MATCH_REGISTER128, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Param_Reg128 },
 
 	{ OP_PARAM_RET, MATCH_NIL, MATCH_TEMPORARY128, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_ParamRet_Tmp128 },
 
@@ -303,7 +322,7 @@ unsigned int CCodeGen_AArch32::GetAvailableRegisterCount() const
 
 unsigned int CCodeGen_AArch32::GetAvailableMdRegisterCount() const
 {
-	return 0;
+	return MAX_MDREGISTERS;
 }
 
 bool CCodeGen_AArch32::Has128BitsCallOperands() const
@@ -326,6 +345,46 @@ bool CCodeGen_AArch32::SupportsCmpSelect() const
 	return true;
 }
 
+bool CCodeGen_AArch32::SupportsBitfieldOps() const
+{
+	return false;
+}
+
+bool CCodeGen_AArch32::SupportsPairedStores() const
+{
+	return false;
+}
+
+bool CCodeGen_AArch32::SupportsLoopRegisters() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch32::SupportsMdLaneOps() const
+{
+	return true;
+}
+
+unsigned int CCodeGen_AArch32::GetOperationCost(OPERATION op) const
+{
+	switch(op)
+	{
+	case OP_MUL:
+	case OP_MULS:
+		//umull/smull into r0/r1, both halves stored separately to stack,
+		//constant operand needs to be loaded in a register first
+		return 4;
+	case OP_DIV:
+	case OP_DIVS:
+		//Might be a call to a helper function
+		return 20;
+	case OP_MERGETO64:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
 uint32 CCodeGen_AArch32::GetPointerSize() const
 {
 	return 4;
@@ -350,7 +409,12 @@ void CCodeGen_AArch32::GenerateCode(const StatementList& statements, unsigned in
 	//Align stack size (must be aligned on 16 bytes boundary)
 	m_stackSize = (stackSize + 0xF) & ~0xF;
 
+	//Spill area for 128-bit params held in registers lives after temporaries
+	m_paramSpillBase = m_stackSize;
+	m_stackSize += GetMaxParamSpillSize(statements);
+
 	m_registerSave = GetSavedRegisterList(GetRegisterUsage(statements));
+	m_mdRegisterSaveCount = GetSavedMdRegisterCount(GetMdRegisterUsage(statements));
 
 	Emit_Prolog();
 
@@ -420,9 +484,79 @@ uint16 CCodeGen_AArch32::GetSavedRegisterList(uint32 registerUsage)
 	return registerSave;
 }
 
+uint32 CCodeGen_AArch32::GetMdRegisterUsage(const StatementList& statements)
+{
+	//FP registers are allocated from the same register file as MD registers
+	uint32 registerUsage = 0;
+	for(const auto& statement : statements)
+	{
+		if(auto dst = dynamic_symbolref_cast(SYM_REGISTER128, statement.dst))
+		{
+			registerUsage |= (1 << dst->m_valueLow);
+		}
+		else if(auto dst = dynamic_symbolref_cast(SYM_FP_REGISTER32, statement.dst))
+		{
+			registerUsage |= (1 << dst->m_valueLow);
+		}
+	}
+	return registerUsage;
+}
+
+uint8 CCodeGen_AArch32::GetSavedMdRegisterCount(uint32 registerUsage)
+{
+	//Returns the amount of callee saved registers (q4-q7) to preserve, saved as a contiguous range
+	uint8 saveCount = 0;
+	for(unsigned int i = 0; i < MAX_MDREGISTERS; i++)
+	{
+		if(g_registersMd[i] > CAArch32Assembler::q7) continue;
+		if((1 << i) & registerUsage)
+		{
+			saveCount = static_cast<uint8>(((g_registersMd[i] - CAArch32Assembler::q4) / 2) + 1);
+		}
+	}
+	return saveCount;
+}
+
+uint32 CCodeGen_AArch32::GetMaxParamSpillSize(const StatementList& statements)
+{
+	uint32 maxParamSpillSize = 0;
+	uint32 currParamSpillSize = 0;
+	for(const auto& statement : statements)
+	{
+		switch(statement.op)
+		{
+		case OP_PARAM:
+		case OP_PARAM_RET:
+		{
+			CSymbol* src1 = statement.src1->GetSymbol().get();
+			switch(src1->m_type)
+			{
+			case SYM_REGISTER128:
+				currParamSpillSize += 16;
+				break;
+			default:
+				break;
+			}
+		}
+		break;
+		case OP_CALL:
+			maxParamSpillSize = std::max<uint32>(currParamSpillSize, maxParamSpillSize);
+			currParamSpillSize = 0;
+			break;
+		default:
+			break;
+		}
+	}
+	return maxParamSpillSize;
+}
+
 void CCodeGen_AArch32::Emit_Prolog()
 {
 	m_assembler.Stmdb(CAArch32Assembler::rSP, m_registerSave);
+	if(m_mdRegisterSaveCount != 0)
+	{
+		m_assembler.Vpush(CAArch32Assembler::d8, m_mdRegisterSaveCount * 2);
+	}
 	m_assembler.Mov(CAArch32Assembler::r11, CAArch32Assembler::r0);
 
 	//Align stack to 16 bytes boundary
@@ -475,6 +609,10 @@ void CCodeGen_AArch32::Emit_Epilog()
 	m_assembler.Ldmia(CAArch32Assembler::rSP, (1 << stackTempRegister));
 	m_assembler.Mov(CAArch32Assembler::rSP, stackTempRegister);
 
+	if(m_mdRegisterSaveCount != 0)
+	{
+		m_assembler.Vpop(CAArch32Assembler::d8, m_mdRegisterSaveCount * 2);
+	}
 	m_assembler.Ldmia(CAArch32Assembler::rSP, m_registerSave);
 }
 
@@ -988,6 +1126,31 @@ void CCodeGen_AArch32::Emit_Param_Mem128(const STATEMENT& statement)
 	    });
 }
 
+void CCodeGen_AArch32::Emit_Param_Reg128(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+
+	m_params.push_back(
+	    [this, src1](PARAM_STATE& paramState) {
+		    auto paramReg = PrepareParam(paramState);
+		    uint32 spillOffset = m_paramSpillBase + paramState.spillOffset + m_stackLevel;
+		    uint8 immediate = 0;
+		    uint8 shiftAmount = 0;
+		    if(TryGetAluImmediateParams(spillOffset, immediate, shiftAmount))
+		    {
+			    m_assembler.Add(paramReg, CAArch32Assembler::rSP, CAArch32Assembler::MakeImmediateAluOperand(immediate, shiftAmount));
+		    }
+		    else
+		    {
+			    LoadConstantInRegister(paramReg, spillOffset);
+			    m_assembler.Add(paramReg, CAArch32Assembler::rSP, paramReg);
+		    }
+		    m_assembler.Vst1_32x4(g_registersMd[src1->m_valueLow], paramReg);
+		    paramState.spillOffset += 0x10;
+		    CommitParam(paramState);
+	    });
+}
+
 void CCodeGen_AArch32::Emit_ParamRet_Tmp128(const STATEMENT& statement)
 {
 	Emit_Param_Mem128(statement);
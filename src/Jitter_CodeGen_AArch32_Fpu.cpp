@@ -104,21 +104,113 @@ void CCodeGen_AArch32::StoreRegisterInTemporaryFp32(CTempRegisterContext& tempRe
 	}
 }
 
+void CCodeGen_AArch32::LoadSymbolFp32InRegister(CTempRegisterContext& tempRegContext, CAArch32Assembler::SINGLE_REGISTER reg, CSymbol* symbol)
+{
+	switch(symbol->m_type)
+	{
+	case SYM_FP_REGISTER32:
+	{
+		//FP registers hold their value in the first lane of the MD register
+		auto srcReg = g_registersMd[symbol->m_valueLow];
+		if(srcReg <= CAArch32Assembler::q7)
+		{
+			m_assembler.Vmov(reg, static_cast<CAArch32Assembler::SINGLE_REGISTER>(srcReg * 2));
+		}
+		else
+		{
+			//No single precision alias for q8-q15
+			auto tmpReg = tempRegContext.Allocate();
+			m_assembler.Vmov(tmpReg, static_cast<CAArch32Assembler::DOUBLE_REGISTER>(srcReg), 0);
+			m_assembler.Vmov(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(reg / 2), tmpReg, reg & 1);
+			tempRegContext.Release(tmpReg);
+		}
+	}
+	break;
+	case SYM_FP_RELATIVE32:
+	case SYM_FP_TEMPORARY32:
+		LoadMemoryFp32InRegister(tempRegContext, reg, symbol);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+}
+
+void CCodeGen_AArch32::StoreRegisterInSymbolFp32(CTempRegisterContext& tempRegContext, CSymbol* symbol, CAArch32Assembler::SINGLE_REGISTER reg)
+{
+	switch(symbol->m_type)
+	{
+	case SYM_FP_REGISTER32:
+	{
+		auto dstReg = g_registersMd[symbol->m_valueLow];
+		if(dstReg <= CAArch32Assembler::q7)
+		{
+			m_assembler.Vmov(static_cast<CAArch32Assembler::SINGLE_REGISTER>(dstReg * 2), reg);
+		}
+		else
+		{
+			auto tmpReg = tempRegContext.Allocate();
+			m_assembler.Vmov(tmpReg, static_cast<CAArch32Assembler::DOUBLE_REGISTER>(reg / 2), reg & 1);
+			m_assembler.Vmov(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(dstReg), tmpReg, 0);
+			tempRegContext.Release(tmpReg);
+		}
+	}
+	break;
+	case SYM_FP_RELATIVE32:
+	case SYM_FP_TEMPORARY32:
+		StoreRegisterInMemoryFp32(tempRegContext, symbol, reg);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+}
+
+CAArch32Assembler::SINGLE_REGISTER CCodeGen_AArch32::PrepareSymbolRegisterDefFp32(CSymbol* symbol, CAArch32Assembler::SINGLE_REGISTER preferedRegister)
+{
+	if((symbol->m_type == SYM_FP_REGISTER32) && (g_registersMd[symbol->m_valueLow] <= CAArch32Assembler::q7))
+	{
+		return static_cast<CAArch32Assembler::SINGLE_REGISTER>(g_registersMd[symbol->m_valueLow] * 2);
+	}
+	return preferedRegister;
+}
+
+CAArch32Assembler::SINGLE_REGISTER CCodeGen_AArch32::PrepareSymbolRegisterUseFp32(CTempRegisterContext& tempRegContext, CSymbol* symbol, CAArch32Assembler::SINGLE_REGISTER preferedRegister)
+{
+	if((symbol->m_type == SYM_FP_REGISTER32) && (g_registersMd[symbol->m_valueLow] <= CAArch32Assembler::q7))
+	{
+		return static_cast<CAArch32Assembler::SINGLE_REGISTER>(g_registersMd[symbol->m_valueLow] * 2);
+	}
+	LoadSymbolFp32InRegister(tempRegContext, preferedRegister, symbol);
+	return preferedRegister;
+}
+
+void CCodeGen_AArch32::CommitSymbolRegisterFp32(CTempRegisterContext& tempRegContext, CSymbol* symbol, CAArch32Assembler::SINGLE_REGISTER usedRegister)
+{
+	if((symbol->m_type == SYM_FP_REGISTER32) && (g_registersMd[symbol->m_valueLow] <= CAArch32Assembler::q7))
+	{
+		assert(usedRegister == static_cast<CAArch32Assembler::SINGLE_REGISTER>(g_registersMd[symbol->m_valueLow] * 2));
+		return;
+	}
+	StoreRegisterInSymbolFp32(tempRegContext, symbol, usedRegister);
+}
+
 template <typename FPUOP>
-void CCodeGen_AArch32::Emit_Fpu_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Fpu_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
 	CTempRegisterContext tempRegisterContext;
 
-	LoadMemoryFp32InRegister(tempRegisterContext, CAArch32Assembler::s0, src1);
-	((m_assembler).*(FPUOP::OpReg()))(CAArch32Assembler::s1, CAArch32Assembler::s0);
-	StoreRegisterInMemoryFp32(tempRegisterContext, dst, CAArch32Assembler::s1);
+	auto dstReg = PrepareSymbolRegisterDefFp32(dst, CAArch32Assembler::s1);
+	auto src1Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src1, CAArch32Assembler::s0);
+	((m_assembler).*(FPUOP::OpReg()))(dstReg, src1Reg);
+	CommitSymbolRegisterFp32(tempRegisterContext, dst, dstReg);
 }
 
 template <typename FPUOP>
-void CCodeGen_AArch32::Emit_Fpu_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Fpu_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
@@ -126,14 +218,15 @@ void CCodeGen_AArch32::Emit_Fpu_MemMemMem(const STATEMENT& statement)
 
 	CTempRegisterContext tempRegisterContext;
 
-	LoadMemoryFp32InRegister(tempRegisterContext, CAArch32Assembler::s0, src1);
-	LoadMemoryFp32InRegister(tempRegisterContext, CAArch32Assembler::s1, src2);
-	((m_assembler).*(FPUOP::OpReg()))(CAArch32Assembler::s2, CAArch32Assembler::s0, CAArch32Assembler::s1);
-	StoreRegisterInMemoryFp32(tempRegisterContext, dst, CAArch32Assembler::s2);
+	auto dstReg = PrepareSymbolRegisterDefFp32(dst, CAArch32Assembler::s2);
+	auto src1Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src1, CAArch32Assembler::s0);
+	auto src2Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src2, CAArch32Assembler::s1);
+	((m_assembler).*(FPUOP::OpReg()))(dstReg, src1Reg, src2Reg);
+	CommitSymbolRegisterFp32(tempRegisterContext, dst, dstReg);
 }
 
 template <typename FPUMDOP>
-void CCodeGen_AArch32::Emit_FpuMd_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_FpuMd_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
@@ -141,42 +234,61 @@ void CCodeGen_AArch32::Emit_FpuMd_MemMemMem(const STATEMENT& statement)
 
 	CTempRegisterContext tempRegisterContext;
 
-	LoadMemoryFp32InRegister(tempRegisterContext, CAArch32Assembler::s0, src1);
-	LoadMemoryFp32InRegister(tempRegisterContext, CAArch32Assembler::s4, src2);
+	LoadSymbolFp32InRegister(tempRegisterContext, CAArch32Assembler::s0, src1);
+	LoadSymbolFp32InRegister(tempRegisterContext, CAArch32Assembler::s4, src2);
 	((m_assembler).*(FPUMDOP::OpReg()))(CAArch32Assembler::q2, CAArch32Assembler::q0, CAArch32Assembler::q1);
-	StoreRegisterInMemoryFp32(tempRegisterContext, dst, CAArch32Assembler::s8);
+	StoreRegisterInSymbolFp32(tempRegisterContext, dst, CAArch32Assembler::s8);
+}
+
+void CCodeGen_AArch32::Emit_Fp_MulAdd_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	CTempRegisterContext tempRegisterContext;
+
+	auto dstReg = PrepareSymbolRegisterDefFp32(dst, CAArch32Assembler::s3);
+	auto src1Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src1, CAArch32Assembler::s0);
+	auto src2Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src2, CAArch32Assembler::s1);
+	auto src3Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src3, CAArch32Assembler::s2);
+	//Product is kept in a temporary register, dst might be the same as src1
+	m_assembler.Vmul_F32(CAArch32Assembler::s4, src2Reg, src3Reg);
+	m_assembler.Vadd_F32(dstReg, src1Reg, CAArch32Assembler::s4);
+	CommitSymbolRegisterFp32(tempRegisterContext, dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Fp_Rcpl_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Fp_Rcpl_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
 	CTempRegisterContext tempRegisterContext;
 
-	LoadMemoryFp32InRegister(tempRegisterContext, CAArch32Assembler::s0, src1);
+	LoadSymbolFp32InRegister(tempRegisterContext, CAArch32Assembler::s0, src1);
 	m_assembler.Vrecpe_F32(CAArch32Assembler::q1, CAArch32Assembler::q0);
 	m_assembler.Vrecps_F32(CAArch32Assembler::q2, CAArch32Assembler::q1, CAArch32Assembler::q0);
 	m_assembler.Vmul_F32(CAArch32Assembler::s4, CAArch32Assembler::s4, CAArch32Assembler::s8);
-	StoreRegisterInMemoryFp32(tempRegisterContext, dst, CAArch32Assembler::s4);
+	StoreRegisterInSymbolFp32(tempRegisterContext, dst, CAArch32Assembler::s4);
 }
 
-void CCodeGen_AArch32::Emit_Fp_Rsqrt_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Fp_Rsqrt_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
 	CTempRegisterContext tempRegisterContext;
 
-	LoadMemoryFp32InRegister(tempRegisterContext, CAArch32Assembler::s0, src1);
+	LoadSymbolFp32InRegister(tempRegisterContext, CAArch32Assembler::s0, src1);
 	m_assembler.Vrsqrte_F32(CAArch32Assembler::q1, CAArch32Assembler::q0);
 	m_assembler.Vmul_F32(CAArch32Assembler::s8, CAArch32Assembler::s0, CAArch32Assembler::s4);
 	m_assembler.Vrsqrts_F32(CAArch32Assembler::q3, CAArch32Assembler::q2, CAArch32Assembler::q1);
 	m_assembler.Vmul_F32(CAArch32Assembler::s4, CAArch32Assembler::s4, CAArch32Assembler::s12);
-	StoreRegisterInMemoryFp32(tempRegisterContext, dst, CAArch32Assembler::s4);
+	StoreRegisterInSymbolFp32(tempRegisterContext, dst, CAArch32Assembler::s4);
 }
 
-void CCodeGen_AArch32::Emit_Fp_Clamp_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Fp_Clamp_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
@@ -192,13 +304,13 @@ void CCodeGen_AArch32::Emit_Fp_Clamp_MemMem(const STATEMENT& statement)
 	m_assembler.Adrl(cstAddrReg, g_fpClampMask2);
 	m_assembler.Vld1_32x4(cst1Reg, cstAddrReg);
 
-	LoadMemoryFp32InRegister(tempRegisterContext, static_cast<CAArch32Assembler::SINGLE_REGISTER>(tmpReg), src1);
+	LoadSymbolFp32InRegister(tempRegisterContext, static_cast<CAArch32Assembler::SINGLE_REGISTER>(tmpReg * 2), src1);
 	m_assembler.Vmin_I32(tmpReg, tmpReg, cst0Reg);
 	m_assembler.Vmin_U32(tmpReg, tmpReg, cst1Reg);
-	StoreRegisterInMemoryFp32(tempRegisterContext, dst, static_cast<CAArch32Assembler::SINGLE_REGISTER>(tmpReg));
+	StoreRegisterInSymbolFp32(tempRegisterContext, dst, static_cast<CAArch32Assembler::SINGLE_REGISTER>(tmpReg * 2));
 }
 
-void CCodeGen_AArch32::Emit_Fp_Cmp_AnyMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Fp_Cmp_AnyVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
@@ -210,9 +322,9 @@ void CCodeGen_AArch32::Emit_Fp_Cmp_AnyMemMem(const STATEMENT& statement)
 	auto dstReg = PrepareSymbolRegisterDef(dst, tmpReg);
 
 	m_assembler.Mov(dstReg, CAArch32Assembler::MakeImmediateAluOperand(0, 0));
-	LoadMemoryFp32InRegister(tempRegisterContext, CAArch32Assembler::s0, src1);
-	LoadMemoryFp32InRegister(tempRegisterContext, CAArch32Assembler::s1, src2);
-	m_assembler.Vcmp_F32(CAArch32Assembler::s0, CAArch32Assembler::s1);
+	auto src1Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src1, CAArch32Assembler::s0);
+	auto src2Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src2, CAArch32Assembler::s1);
+	m_assembler.Vcmp_F32(src1Reg, src2Reg);
 	m_assembler.Vmrs(CAArch32Assembler::rPC); //Move to general purpose status register
 	switch(statement.jmpCondition)
 	{
@@ -237,34 +349,65 @@ void CCodeGen_AArch32::Emit_Fp_Cmp_AnyMemMem(const STATEMENT& statement)
 	tempRegisterContext.Release(tmpReg);
 }
 
-void CCodeGen_AArch32::Emit_Fp_ToSingleI32_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Fp_ToSingleI32_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
 	CTempRegisterContext tempRegisterContext;
 
-	auto dstReg = CAArch32Assembler::s0;
-	auto src1Reg = CAArch32Assembler::s1;
-
-	LoadMemoryFp32InRegister(tempRegisterContext, src1Reg, src1);
+	auto dstReg = PrepareSymbolRegisterDefFp32(dst, CAArch32Assembler::s0);
+	auto src1Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src1, CAArch32Assembler::s1);
 	m_assembler.Vcvt_F32_S32(dstReg, src1Reg);
-	StoreRegisterInMemoryFp32(tempRegisterContext, dst, dstReg);
+	CommitSymbolRegisterFp32(tempRegisterContext, dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Fp_ToInt32TruncS_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Fp_ToInt32TruncS_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
 	CTempRegisterContext tempRegisterContext;
 
-	auto dstReg = CAArch32Assembler::s0;
-	auto src1Reg = CAArch32Assembler::s1;
-
-	LoadMemoryFp32InRegister(tempRegisterContext, src1Reg, src1);
+	auto dstReg = PrepareSymbolRegisterDefFp32(dst, CAArch32Assembler::s0);
+	auto src1Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src1, CAArch32Assembler::s1);
 	m_assembler.Vcvt_S32_F32(dstReg, src1Reg);
-	StoreRegisterInMemoryFp32(tempRegisterContext, dst, dstReg);
+	CommitSymbolRegisterFp32(tempRegisterContext, dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_Fp_Mov_RegMem(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	CTempRegisterContext tempRegisterContext;
+
+	auto dstReg = PrepareSymbolRegisterDefFp32(dst, CAArch32Assembler::s0);
+	LoadMemoryFp32InRegister(tempRegisterContext, dstReg, src1);
+	CommitSymbolRegisterFp32(tempRegisterContext, dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_Fp_Mov_MemReg(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	CTempRegisterContext tempRegisterContext;
+
+	auto src1Reg = PrepareSymbolRegisterUseFp32(tempRegisterContext, src1, CAArch32Assembler::s0);
+	StoreRegisterInMemoryFp32(tempRegisterContext, dst, src1Reg);
+}
+
+void CCodeGen_AArch32::Emit_Fp_LdCst_RegCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	assert(dst->m_type == SYM_FP_REGISTER32);
+	assert(src1->m_type == SYM_CONSTANT);
+
+	LoadConstantInRegister(CAArch32Assembler::r0, src1->m_valueLow);
+	m_assembler.Vmov(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(g_registersMd[dst->m_valueLow]), CAArch32Assembler::r0, 0);
 }
 
 void CCodeGen_AArch32::Emit_Fp_LdCst_TmpCst(const STATEMENT& statement)
@@ -287,28 +430,36 @@ void CCodeGen_AArch32::Emit_Fp_SetRoundingMode_Cst(const STATEMENT& statement)
 // clang-format off
 CCodeGen_AArch32::CONSTMATCHER CCodeGen_AArch32::g_fpuConstMatchers[] = 
 {
-	{ OP_FP_ADD_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_MemMemMem<FPUOP_ADD> },
-	{ OP_FP_SUB_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_MemMemMem<FPUOP_SUB> },
-	{ OP_FP_MUL_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_MemMemMem<FPUOP_MUL> },
-	{ OP_FP_DIV_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_MemMemMem<FPUOP_DIV> },
+	{ OP_FP_ADD_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_VarVarVar<FPUOP_ADD> },
+	{ OP_FP_SUB_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_VarVarVar<FPUOP_SUB> },
+	{ OP_FP_MUL_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_VarVarVar<FPUOP_MUL> },
+	{ OP_FP_DIV_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_VarVarVar<FPUOP_DIV> },
+
+	//vfma is not available on all targets, fused multiply-add is computed with separate roundings
+	{ OP_FP_MULADD_S,      MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, &CCodeGen_AArch32::Emit_Fp_MulAdd_VarVarVarVar },
+	{ OP_FP_FUSEDMULADD_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, &CCodeGen_AArch32::Emit_Fp_MulAdd_VarVarVarVar },
+
+	{ OP_FP_CMP_S, MATCH_ANY, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Cmp_AnyVarVar },
 
-	{ OP_FP_CMP_S, MATCH_ANY, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Cmp_AnyMemMem },
+	{ OP_FP_MIN_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_AArch32::Emit_FpuMd_VarVarVar<FPUMDOP_MIN> },
+	{ OP_FP_MAX_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_AArch32::Emit_FpuMd_VarVarVar<FPUMDOP_MAX> },
 
-	{ OP_FP_MIN_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, &CCodeGen_AArch32::Emit_FpuMd_MemMemMem<FPUMDOP_MIN> },
-	{ OP_FP_MAX_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, &CCodeGen_AArch32::Emit_FpuMd_MemMemMem<FPUMDOP_MAX> },
+	{ OP_FP_RCPL_S,  MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Rcpl_VarVar         },
+	{ OP_FP_SQRT_S,  MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_VarVar<FPUOP_SQRT> },
+	{ OP_FP_RSQRT_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Rsqrt_VarVar        },
 
-	{ OP_FP_RCPL_S,  MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Rcpl_MemMem         },
-	{ OP_FP_SQRT_S,  MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_MemMem<FPUOP_SQRT> },
-	{ OP_FP_RSQRT_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Rsqrt_MemMem        },
+	{ OP_FP_CLAMP_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Clamp_VarVar },
 
-	{ OP_FP_CLAMP_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Clamp_MemMem },
+	{ OP_FP_ABS_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_VarVar<FPUOP_ABS> },
+	{ OP_FP_NEG_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_VarVar<FPUOP_NEG> },
 
-	{ OP_FP_ABS_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_MemMem<FPUOP_ABS> },
-	{ OP_FP_NEG_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fpu_MemMem<FPUOP_NEG> },
+	{ OP_FP_TOSINGLE_I32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_ToSingleI32_VarVar   },
+	{ OP_FP_TOINT32_TRUNC_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_ToInt32TruncS_VarVar },
 
-	{ OP_FP_TOSINGLE_I32,    MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_ToSingleI32_MemMem   },
-	{ OP_FP_TOINT32_TRUNC_S, MATCH_FP_MEMORY32, MATCH_FP_MEMORY32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_ToInt32TruncS_MemMem },
+	{ OP_MOV, MATCH_FP_REGISTER32, MATCH_FP_MEMORY32,   MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Mov_RegMem },
+	{ OP_MOV, MATCH_FP_MEMORY32,   MATCH_FP_REGISTER32, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_Mov_MemReg },
 
+	{ OP_FP_LDCST, MATCH_FP_REGISTER32,  MATCH_CONSTANT, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_LdCst_RegCst },
 	{ OP_FP_LDCST, MATCH_FP_TEMPORARY32, MATCH_CONSTANT, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_LdCst_TmpCst },
 
 	{ OP_FP_SETROUNDINGMODE, MATCH_NIL, MATCH_CONSTANT, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Fp_SetRoundingMode_Cst },
@@ -1,3 +1,4 @@
+#include <stdexcept>
 #include "Jitter_CodeGen_AArch32.h"
 
 using namespace Jitter;
@@ -75,6 +76,87 @@ void CCodeGen_AArch32::LoadTemporary256ElementAddressInRegister(CAArch32Assemble
 	}
 }
 
+void CCodeGen_AArch32::LoadMemory128InRegister(CAArch32Assembler::QUAD_REGISTER dstReg, CSymbol* symbol)
+{
+	LoadMemory128AddressInRegister(g_mdAddressRegister, symbol);
+	m_assembler.Vld1_32x4(dstReg, g_mdAddressRegister);
+}
+
+void CCodeGen_AArch32::StoreRegisterInMemory128(CSymbol* symbol, CAArch32Assembler::QUAD_REGISTER srcReg)
+{
+	LoadMemory128AddressInRegister(g_mdAddressRegister, symbol);
+	m_assembler.Vst1_32x4(srcReg, g_mdAddressRegister);
+}
+
+void CCodeGen_AArch32::LoadSymbol128HalfInRegister(CAArch32Assembler::DOUBLE_REGISTER dstReg, CSymbol* symbol, uint32 offset)
+{
+	assert((offset == 0) || (offset == 8));
+	if(symbol->m_type == SYM_REGISTER128)
+	{
+		auto srcReg = static_cast<CAArch32Assembler::DOUBLE_REGISTER>(g_registersMd[symbol->m_valueLow] + (offset / 8));
+		m_assembler.Vmov(dstReg, srcReg);
+	}
+	else
+	{
+		LoadMemory128AddressInRegister(g_mdAddressRegister, symbol, offset);
+		m_assembler.Vld1_32x2(dstReg, g_mdAddressRegister);
+	}
+}
+
+CAArch32Assembler::QUAD_REGISTER CCodeGen_AArch32::PrepareSymbolRegisterDefMd(CSymbol* symbol, CAArch32Assembler::QUAD_REGISTER preferedRegister)
+{
+	switch(symbol->m_type)
+	{
+	case SYM_REGISTER128:
+		assert(symbol->m_valueLow < MAX_MDREGISTERS);
+		return g_registersMd[symbol->m_valueLow];
+		break;
+	case SYM_TEMPORARY128:
+	case SYM_RELATIVE128:
+		return preferedRegister;
+		break;
+	default:
+		throw std::runtime_error("Invalid symbol type.");
+		break;
+	}
+}
+
+CAArch32Assembler::QUAD_REGISTER CCodeGen_AArch32::PrepareSymbolRegisterUseMd(CSymbol* symbol, CAArch32Assembler::QUAD_REGISTER preferedRegister)
+{
+	switch(symbol->m_type)
+	{
+	case SYM_REGISTER128:
+		assert(symbol->m_valueLow < MAX_MDREGISTERS);
+		return g_registersMd[symbol->m_valueLow];
+		break;
+	case SYM_TEMPORARY128:
+	case SYM_RELATIVE128:
+		LoadMemory128InRegister(preferedRegister, symbol);
+		return preferedRegister;
+		break;
+	default:
+		throw std::runtime_error("Invalid symbol type.");
+		break;
+	}
+}
+
+void CCodeGen_AArch32::CommitSymbolRegisterMd(CSymbol* symbol, CAArch32Assembler::QUAD_REGISTER usedRegister)
+{
+	switch(symbol->m_type)
+	{
+	case SYM_REGISTER128:
+		assert(usedRegister == g_registersMd[symbol->m_valueLow]);
+		break;
+	case SYM_TEMPORARY128:
+	case SYM_RELATIVE128:
+		StoreRegisterInMemory128(symbol, usedRegister);
+		break;
+	default:
+		throw std::runtime_error("Invalid symbol type.");
+		break;
+	}
+}
+
 void CCodeGen_AArch32::MdBlendRegisters(
     CAArch32Assembler::QUAD_REGISTER dstReg, CAArch32Assembler::QUAD_REGISTER srcReg,
     CAArch32Assembler::REGISTER tmpReg, uint8 mask)
@@ -97,139 +179,147 @@ void CCodeGen_AArch32::MdBlendRegisters(
 }
 
 template <typename MDOP>
-void CCodeGen_AArch32::Emit_Md_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto dstReg = CAArch32Assembler::q0;
-	auto src1Reg = CAArch32Assembler::q1;
-
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q1);
 
-	m_assembler.Vld1_32x4(src1Reg, src1AddrReg);
 	((m_assembler).*(MDOP::OpReg()))(dstReg, src1Reg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
 template <typename MDOP>
-void CCodeGen_AArch32::Emit_Md_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto src2AddrReg = CAArch32Assembler::r2;
-	auto dstReg = CAArch32Assembler::q0;
-	auto src1Reg = CAArch32Assembler::q1;
-	auto src2Reg = CAArch32Assembler::q2;
-
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
-	LoadMemory128AddressInRegister(src2AddrReg, src2);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q1);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2, CAArch32Assembler::q2);
 
-	m_assembler.Vld1_32x4(src1Reg, src1AddrReg);
-	m_assembler.Vld1_32x4(src2Reg, src2AddrReg);
 	((m_assembler).*(MDOP::OpReg()))(dstReg, src1Reg, src2Reg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
 template <typename MDOP>
-void CCodeGen_AArch32::Emit_Md_MemMemMemRev(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_VarVarVarRev(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto src2AddrReg = CAArch32Assembler::r2;
-	auto dstReg = CAArch32Assembler::q0;
-	auto src1Reg = CAArch32Assembler::q1;
-	auto src2Reg = CAArch32Assembler::q2;
-
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
-	LoadMemory128AddressInRegister(src2AddrReg, src2);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q1);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2, CAArch32Assembler::q2);
 
-	m_assembler.Vld1_32x4(src1Reg, src1AddrReg);
-	m_assembler.Vld1_32x4(src2Reg, src2AddrReg);
 	((m_assembler).*(MDOP::OpReg()))(dstReg, src2Reg, src1Reg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
 template <typename MDSHIFTOP>
-void CCodeGen_AArch32::Emit_Md_Shift_MemMemCst(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_Shift_VarVarCst(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto dstReg = CAArch32Assembler::q0;
-	auto src1Reg = CAArch32Assembler::q1;
-
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q1);
 
-	m_assembler.Vld1_32x4(src1Reg, src1AddrReg);
 	((m_assembler).*(MDSHIFTOP::OpReg()))(dstReg, src1Reg, src2->m_valueLow);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_Mov_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_Mov_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto tmpReg = CAArch32Assembler::q0;
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
-	m_assembler.Vld1_32x4(tmpReg, src1AddrReg);
-	m_assembler.Vst1_32x4(tmpReg, dstAddrReg);
+	if(dst->m_type == SYM_REGISTER128)
+	{
+		auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+		auto src1Reg = PrepareSymbolRegisterUseMd(src1, dstReg);
+		if(dstReg != src1Reg)
+		{
+			m_assembler.Vorr(dstReg, src1Reg, src1Reg);
+		}
+	}
+	else
+	{
+		auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q0);
+		StoreRegisterInMemory128(dst, src1Reg);
+	}
 }
 
-void CCodeGen_AArch32::Emit_Md_DivS_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_DivS_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto src2AddrReg = CAArch32Assembler::r2;
-	auto dstReg = CAArch32Assembler::q0;
-	auto src1Reg = CAArch32Assembler::q1;
-	auto src2Reg = CAArch32Assembler::q2;
-
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
-	LoadMemory128AddressInRegister(src2AddrReg, src2);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q1);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2, CAArch32Assembler::q2);
 
-	m_assembler.Vld1_32x4(src1Reg, src1AddrReg);
-	m_assembler.Vld1_32x4(src2Reg, src2AddrReg);
+	//Single precision registers only alias q0-q7, move operands to scratch registers if needed
+	if(src1Reg > CAArch32Assembler::q7)
+	{
+		m_assembler.Vorr(CAArch32Assembler::q1, src1Reg, src1Reg);
+		src1Reg = CAArch32Assembler::q1;
+	}
+	if(src2Reg > CAArch32Assembler::q7)
+	{
+		m_assembler.Vorr(CAArch32Assembler::q2, src2Reg, src2Reg);
+		src2Reg = CAArch32Assembler::q2;
+	}
+	auto resultReg = (dstReg > CAArch32Assembler::q7) ? CAArch32Assembler::q0 : dstReg;
 
 	//No vector floating point divide on NEON, gotta do it 4x
 	for(unsigned int i = 0; i < 4; i++)
 	{
-		auto subDstReg = static_cast<CAArch32Assembler::SINGLE_REGISTER>(dstReg * 2 + i);
+		auto subDstReg = static_cast<CAArch32Assembler::SINGLE_REGISTER>(resultReg * 2 + i);
 		auto subSrc1Reg = static_cast<CAArch32Assembler::SINGLE_REGISTER>(src1Reg * 2 + i);
 		auto subSrc2Reg = static_cast<CAArch32Assembler::SINGLE_REGISTER>(src2Reg * 2 + i);
 		m_assembler.Vdiv_F32(subDstReg, subSrc1Reg, subSrc2Reg);
 	}
 
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+	if(resultReg != dstReg)
+	{
+		m_assembler.Vorr(dstReg, resultReg, resultReg);
+	}
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_Srl256_MemMemCst(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_MulAddS_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto mulReg = CAArch32Assembler::q0;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q1);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2, CAArch32Assembler::q2);
+	auto src3Reg = PrepareSymbolRegisterUseMd(src3, CAArch32Assembler::q3);
+
+	m_assembler.Vmul_F32(mulReg, src2Reg, src3Reg);
+	m_assembler.Vadd_F32(dstReg, src1Reg, mulReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_Md_Srl256_VarMemCst(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
@@ -238,20 +328,19 @@ void CCodeGen_AArch32::Emit_Md_Srl256_MemMemCst(const STATEMENT& statement)
 	assert(src1->m_type == SYM_TEMPORARY256);
 	assert(src2->m_type == SYM_CONSTANT);
 
-	auto dstAddrReg = CAArch32Assembler::r0;
 	auto src1AddrReg = CAArch32Assembler::r1;
-	auto dstReg = CAArch32Assembler::q0;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
 	uint32 offset = (src2->m_valueLow & 0x7F) / 8;
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
 	LoadTemporary256ElementAddressInRegister(src1AddrReg, src1, offset);
 
 	m_assembler.Vld1_32x4_u(dstReg, src1AddrReg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_Srl256_MemMemVar(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_Srl256_VarMemVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
@@ -260,15 +349,13 @@ void CCodeGen_AArch32::Emit_Md_Srl256_MemMemVar(const STATEMENT& statement)
 	assert(src1->m_type == SYM_TEMPORARY256);
 
 	auto offsetRegister = CAArch32Assembler::r0;
-	auto dstAddrReg = CAArch32Assembler::r1;
 	auto src1AddrReg = CAArch32Assembler::r2;
 	auto src2Register = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r3);
 
-	auto dstReg = CAArch32Assembler::q0;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
 	auto offsetShift = CAArch32Assembler::MakeConstantShift(CAArch32Assembler::SHIFT_LSR, 3);
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
 	LoadTemporary256ElementAddressInRegister(src1AddrReg, src1, 0);
 
 	//Compute offset and modify address
@@ -277,26 +364,24 @@ void CCodeGen_AArch32::Emit_Md_Srl256_MemMemVar(const STATEMENT& statement)
 	m_assembler.Add(src1AddrReg, src1AddrReg, offsetRegister);
 
 	m_assembler.Vld1_32x4_u(dstReg, src1AddrReg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_LoadFromRef_MemVar(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_LoadFromRef_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
 	auto src1AddrReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r0);
-	auto dstAddrReg = CAArch32Assembler::r1;
-
-	auto dstReg = CAArch32Assembler::q0;
-
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
 	m_assembler.Vld1_32x4(dstReg, src1AddrReg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_LoadFromRef_MemVarAny(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_LoadFromRef_VarVarAny(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
@@ -306,33 +391,27 @@ void CCodeGen_AArch32::Emit_Md_LoadFromRef_MemVarAny(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto src1AddrIdxReg = CAArch32Assembler::r1;
-	auto dstAddrReg = CAArch32Assembler::r2;
-	auto dstReg = CAArch32Assembler::q0;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
 	LoadRefIndexAddress(src1AddrIdxReg, src1, CAArch32Assembler::r0, src2, CAArch32Assembler::r3, scale);
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
 
 	m_assembler.Vld1_32x4(dstReg, src1AddrIdxReg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_StoreAtRef_VarMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_StoreAtRef_VarVar(const STATEMENT& statement)
 {
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
 	auto src1AddrReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r0);
-	auto src2AddrReg = CAArch32Assembler::r1;
-
-	auto src2Reg = CAArch32Assembler::q0;
-
-	LoadMemory128AddressInRegister(src2AddrReg, src2);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2, CAArch32Assembler::q0);
 
-	m_assembler.Vld1_32x4(src2Reg, src2AddrReg);
 	m_assembler.Vst1_32x4(src2Reg, src1AddrReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_StoreAtRef_VarAnyMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_StoreAtRef_VarAnyVar(const STATEMENT& statement)
 {
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
@@ -342,17 +421,14 @@ void CCodeGen_AArch32::Emit_Md_StoreAtRef_VarAnyMem(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto src1AddrIdxReg = CAArch32Assembler::r1;
-	auto valueAddrReg = CAArch32Assembler::r2;
-	auto valueReg = CAArch32Assembler::q0;
 
 	LoadRefIndexAddress(src1AddrIdxReg, src1, CAArch32Assembler::r0, src2, CAArch32Assembler::r3, scale);
-	LoadMemory128AddressInRegister(valueAddrReg, src3);
+	auto valueReg = PrepareSymbolRegisterUseMd(src3, CAArch32Assembler::q0);
 
-	m_assembler.Vld1_32x4(valueReg, valueAddrReg);
 	m_assembler.Vst1_32x4(valueReg, src1AddrIdxReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_LoadFromRefMasked_MemMemAnyMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_LoadFromRefMasked_VarVarAnyVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
@@ -364,20 +440,18 @@ void CCodeGen_AArch32::Emit_Md_LoadFromRefMasked_MemMemAnyMem(const STATEMENT& s
 	assert(dst->Equals(src3));
 
 	auto src1AddrIdxReg = CAArch32Assembler::r1;
-	auto dstAddrReg = CAArch32Assembler::r2;
-	auto dstReg = CAArch32Assembler::q0;
 	auto memReg = CAArch32Assembler::q1;
 
 	LoadRefIndexAddress(src1AddrIdxReg, src1, CAArch32Assembler::r0, src2, CAArch32Assembler::r3, scale);
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
+	auto dstReg = PrepareSymbolRegisterUseMd(dst, CAArch32Assembler::q0);
 
 	m_assembler.Vld1_32x4(memReg, src1AddrIdxReg);
-	m_assembler.Vld1_32x4(dstReg, dstAddrReg);
 	MdBlendRegisters(dstReg, memReg, CAArch32Assembler::r3, mask);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_StoreAtRefMasked_MemAnyMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_StoreAtRefMasked_VarAnyVar(const STATEMENT& statement)
 {
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
@@ -386,20 +460,17 @@ void CCodeGen_AArch32::Emit_Md_StoreAtRefMasked_MemAnyMem(const STATEMENT& state
 	uint8 scale = 1;
 
 	auto src1AddrIdxReg = CAArch32Assembler::r1;
-	auto src3AddrReg = CAArch32Assembler::r2;
-	auto src3Reg = CAArch32Assembler::q0;
 	auto memReg = CAArch32Assembler::q1;
 
 	LoadRefIndexAddress(src1AddrIdxReg, src1, CAArch32Assembler::r0, src2, CAArch32Assembler::r3, scale);
-	LoadMemory128AddressInRegister(src3AddrReg, src3);
+	auto src3Reg = PrepareSymbolRegisterUseMd(src3, CAArch32Assembler::q0);
 
 	m_assembler.Vld1_32x4(memReg, src1AddrIdxReg);
-	m_assembler.Vld1_32x4(src3Reg, src3AddrReg);
 	MdBlendRegisters(memReg, src3Reg, CAArch32Assembler::r3, mask);
 	m_assembler.Vst1_32x4(memReg, src1AddrIdxReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_MovMasked_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_MovMasked_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	FRAMEWORK_MAYBE_UNUSED auto src1 = statement.src1->GetSymbol().get();
@@ -409,73 +480,61 @@ void CCodeGen_AArch32::Emit_Md_MovMasked_MemMemMem(const STATEMENT& statement)
 
 	auto mask = static_cast<uint8>(statement.jmpCondition);
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src2AddrReg = CAArch32Assembler::r2;
 	auto tmpReg = CAArch32Assembler::r3;
-	auto dstReg = CAArch32Assembler::q0;
-	auto src2Reg = CAArch32Assembler::q2;
-
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src2AddrReg, src2);
+	auto dstReg = PrepareSymbolRegisterUseMd(dst, CAArch32Assembler::q0);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2, CAArch32Assembler::q2);
 
-	m_assembler.Vld1_32x4(dstReg, dstAddrReg);
-	m_assembler.Vld1_32x4(src2Reg, src2AddrReg);
 	MdBlendRegisters(dstReg, src2Reg, tmpReg, mask);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_ExpandW_MemReg(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_ExpandW_VarReg(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto tmpReg = CAArch32Assembler::q0;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
+	m_assembler.Vdup(dstReg, g_registers[src1->m_valueLow]);
 
-	m_assembler.Vdup(tmpReg, g_registers[src1->m_valueLow]);
-	m_assembler.Vst1_32x4(tmpReg, dstAddrReg);
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_ExpandW_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_ExpandW_VarMem(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
 	auto src1Reg = CAArch32Assembler::r1;
-	auto tmpReg = CAArch32Assembler::q0;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
 	LoadMemoryInRegister(src1Reg, src1);
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
 
-	m_assembler.Vdup(tmpReg, src1Reg);
-	m_assembler.Vst1_32x4(tmpReg, dstAddrReg);
+	m_assembler.Vdup(dstReg, src1Reg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_ExpandW_MemCst(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_ExpandW_VarCst(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
 	auto src1Reg = CAArch32Assembler::r1;
-	auto tmpReg = CAArch32Assembler::q0;
-
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
 	if(src1->m_valueLow == 0)
 	{
-		m_assembler.Veor(tmpReg, tmpReg, tmpReg);
+		m_assembler.Veor(dstReg, dstReg, dstReg);
 	}
 	else
 	{
 		LoadConstantInRegister(src1Reg, src1->m_valueLow);
-		m_assembler.Vdup(tmpReg, src1Reg);
+		m_assembler.Vdup(dstReg, src1Reg);
 	}
 
-	m_assembler.Vst1_32x4(tmpReg, dstAddrReg);
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
 void CCodeGen_AArch32::Emit_Md_ExpandW_VarVarCst(const STATEMENT& statement)
@@ -487,55 +546,135 @@ void CCodeGen_AArch32::Emit_Md_ExpandW_VarVarCst(const STATEMENT& statement)
 	assert(src2->m_type == SYM_CONSTANT);
 	assert(src2->m_valueLow < 4);
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto dstReg = CAArch32Assembler::q0;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 	auto src1Reg = CAArch32Assembler::d2;
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1, (src2->m_valueLow / 2) * 8);
+	if(src1->m_type == SYM_REGISTER128)
+	{
+		src1Reg = static_cast<CAArch32Assembler::DOUBLE_REGISTER>(g_registersMd[src1->m_valueLow] + (src2->m_valueLow / 2));
+	}
+	else
+	{
+		LoadSymbol128HalfInRegister(src1Reg, src1, (src2->m_valueLow / 2) * 8);
+	}
 
-	m_assembler.Vld1_32x2(src1Reg, src1AddrReg);
 	m_assembler.Vdup_32(dstReg, src1Reg, src2->m_valueLow & 1);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_Md_LdCst_VarCstCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+
+	auto cstAddrReg = CAArch32Assembler::r0;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+
+	m_assembler.Adrl(cstAddrReg, GetMdLiteral(statement));
+	m_assembler.Vld1_32x4(dstReg, cstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_ClampS_MemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_ExtractLaneS_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	assert(src2->m_type == SYM_CONSTANT);
+	assert(src2->m_valueLow < 4);
+
+	uint8 lane = static_cast<uint8>(src2->m_valueLow);
+
+	CTempRegisterContext tempRegContext;
+	auto dstReg = PrepareSymbolRegisterDefFp32(dst, CAArch32Assembler::s8);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q0);
+
+	if(src1Reg <= CAArch32Assembler::q7)
+	{
+		m_assembler.Vmov(dstReg, static_cast<CAArch32Assembler::SINGLE_REGISTER>((src1Reg * 2) + lane));
+	}
+	else
+	{
+		//No single precision alias for q8-q15
+		auto tmpReg = tempRegContext.Allocate();
+		m_assembler.Vmov(tmpReg, static_cast<CAArch32Assembler::DOUBLE_REGISTER>(src1Reg + (lane / 2)), lane & 1);
+		m_assembler.Vmov(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(dstReg / 2), tmpReg, dstReg & 1);
+		tempRegContext.Release(tmpReg);
+	}
+
+	CommitSymbolRegisterFp32(tempRegContext, dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_Md_InsertLaneS_VarVarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	assert(src3->m_type == SYM_CONSTANT);
+	assert(src3->m_valueLow < 4);
+
+	uint8 lane = static_cast<uint8>(src3->m_valueLow);
+
+	CTempRegisterContext tempRegContext;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, dstReg);
+	auto src2Reg = PrepareSymbolRegisterUseFp32(tempRegContext, src2, CAArch32Assembler::s8);
+
+	if(dstReg != src1Reg)
+	{
+		m_assembler.Vorr(dstReg, src1Reg, src1Reg);
+	}
+
+	if(dstReg <= CAArch32Assembler::q7)
+	{
+		m_assembler.Vmov(static_cast<CAArch32Assembler::SINGLE_REGISTER>((dstReg * 2) + lane), src2Reg);
+	}
+	else
+	{
+		auto tmpReg = tempRegContext.Allocate();
+		m_assembler.Vmov(tmpReg, static_cast<CAArch32Assembler::DOUBLE_REGISTER>(src2Reg / 2), src2Reg & 1);
+		m_assembler.Vmov(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(dstReg + (lane / 2)), tmpReg, lane & 1);
+		tempRegContext.Release(tmpReg);
+	}
+
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_Md_ClampS_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
 	auto cstAddrReg = CAArch32Assembler::r2;
-	auto dstReg = CAArch32Assembler::q0;
 	auto cst0Reg = CAArch32Assembler::q1;
 	auto cst1Reg = CAArch32Assembler::q2;
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q3);
 
 	m_assembler.Adrl(cstAddrReg, g_fpClampMask1);
 	m_assembler.Vld1_32x4(cst0Reg, cstAddrReg);
 	m_assembler.Adrl(cstAddrReg, g_fpClampMask2);
 	m_assembler.Vld1_32x4(cst1Reg, cstAddrReg);
 
-	m_assembler.Vld1_32x4(dstReg, src1AddrReg);
-	m_assembler.Vmin_I32(dstReg, dstReg, cst0Reg);
+	m_assembler.Vmin_I32(dstReg, src1Reg, cst0Reg);
 	m_assembler.Vmin_U32(dstReg, dstReg, cst1Reg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_MakeClip_VarMemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_MakeClip_VarVarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 	auto src3 = statement.src3->GetSymbol().get();
 
-	auto valueAddrReg = CAArch32Assembler::r0;
 	auto cstAddrReg = CAArch32Assembler::r1;
-	auto src1Reg = CAArch32Assembler::q0;
 	auto boundReg = CAArch32Assembler::q1;
 	auto gtReg = CAArch32Assembler::q2;
 	auto ltReg = CAArch32Assembler::q3;
@@ -543,21 +682,18 @@ void CCodeGen_AArch32::Emit_Md_MakeClip_VarMemMemMem(const STATEMENT& statement)
 	static const LITERAL128 lit1(0xFFFF180814041000UL, 0xFFFFFFFFFFFFFFFFUL);
 	static const LITERAL128 lit2(0x0000201008040201UL, 0x0000000000000000UL);
 
-	LoadMemory128AddressInRegister(valueAddrReg, src1);
-	m_assembler.Vld1_32x4(src1Reg, valueAddrReg);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q0);
 
 	//src1 > src2
 	{
-		LoadMemory128AddressInRegister(cstAddrReg, src2);
-		m_assembler.Vld1_32x4(boundReg, cstAddrReg);
-		m_assembler.Vcgt_F32(gtReg, src1Reg, boundReg);
+		auto src2Reg = PrepareSymbolRegisterUseMd(src2, boundReg);
+		m_assembler.Vcgt_F32(gtReg, src1Reg, src2Reg);
 	}
 
 	//src1 < src3
 	{
-		LoadMemory128AddressInRegister(cstAddrReg, src3);
-		m_assembler.Vld1_32x4(boundReg, cstAddrReg);
-		m_assembler.Vcgt_F32(ltReg, boundReg, src1Reg);
+		auto src3Reg = PrepareSymbolRegisterUseMd(src3, boundReg);
+		m_assembler.Vcgt_F32(ltReg, src3Reg, src1Reg);
 	}
 
 	auto dstReg = PrepareSymbolRegisterDef(dst, CAArch32Assembler::r0);
@@ -579,14 +715,12 @@ void CCodeGen_AArch32::Emit_Md_MakeClip_VarMemMemMem(const STATEMENT& statement)
 	CommitSymbolRegister(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_MakeSz_VarMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_MakeSz_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	auto src1AddrReg = CAArch32Assembler::r0;
 	auto cstAddrReg = CAArch32Assembler::r1;
-	auto src1Reg = CAArch32Assembler::q0;
 	auto signReg = CAArch32Assembler::q1;
 	auto zeroReg = CAArch32Assembler::q2;
 	auto cstReg = CAArch32Assembler::q3;
@@ -594,8 +728,7 @@ void CCodeGen_AArch32::Emit_Md_MakeSz_VarMem(const STATEMENT& statement)
 	static const LITERAL128 lit1(0x0004080C1014181CUL, 0xFFFFFFFFFFFFFFFFUL);
 	static const LITERAL128 lit2(0x8040201008040201UL, 0x0000000000000000UL);
 
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
-	m_assembler.Vld1_32x4(src1Reg, src1AddrReg);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q0);
 
 	auto dstReg = PrepareSymbolRegisterDef(dst, CAArch32Assembler::r0);
 
@@ -619,127 +752,176 @@ void CCodeGen_AArch32::Emit_Md_MakeSz_VarMem(const STATEMENT& statement)
 	CommitSymbolRegister(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_PackHB_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_PackHB_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto src2AddrReg = CAArch32Assembler::r2;
-	auto dstReg = CAArch32Assembler::q0;
-	auto src1Reg = CAArch32Assembler::q1;
-	auto src2Reg = CAArch32Assembler::q2;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q1);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2, CAArch32Assembler::q2);
+
+	//Upper half is written first, make sure it doesn't overwrite src2
+	auto resultReg = (dstReg == src2Reg) ? CAArch32Assembler::q0 : dstReg;
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
-	LoadMemory128AddressInRegister(src2AddrReg, src2);
+	m_assembler.Vmovn_I16(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 1), src1Reg);
+	m_assembler.Vmovn_I16(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 0), src2Reg);
+
+	if(resultReg != dstReg)
+	{
+		m_assembler.Vorr(dstReg, resultReg, resultReg);
+	}
 
-	m_assembler.Vld1_32x4(src1Reg, src1AddrReg);
-	m_assembler.Vld1_32x4(src2Reg, src2AddrReg);
-	m_assembler.Vmovn_I16(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(dstReg + 1), src1Reg);
-	m_assembler.Vmovn_I16(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(dstReg + 0), src2Reg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_Md_PackWH_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_PackWH_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto src2AddrReg = CAArch32Assembler::r2;
-	auto dstReg = CAArch32Assembler::q0;
-	auto src1Reg = CAArch32Assembler::q1;
-	auto src2Reg = CAArch32Assembler::q2;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q1);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2, CAArch32Assembler::q2);
+
+	//Upper half is written first, make sure it doesn't overwrite src2
+	auto resultReg = (dstReg == src2Reg) ? CAArch32Assembler::q0 : dstReg;
+
+	m_assembler.Vmovn_I32(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 1), src1Reg);
+	m_assembler.Vmovn_I32(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 0), src2Reg);
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
-	LoadMemory128AddressInRegister(src2AddrReg, src2);
+	if(resultReg != dstReg)
+	{
+		m_assembler.Vorr(dstReg, resultReg, resultReg);
+	}
 
-	m_assembler.Vld1_32x4(src1Reg, src1AddrReg);
-	m_assembler.Vld1_32x4(src2Reg, src2AddrReg);
-	m_assembler.Vmovn_I32(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(dstReg + 1), src1Reg);
-	m_assembler.Vmovn_I32(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(dstReg + 0), src2Reg);
-	m_assembler.Vst1_32x4(dstReg, dstAddrReg);
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_Md_Shuffle_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto maskAddrReg = CAArch32Assembler::r2;
+	auto maskReg = CAArch32Assembler::q2;
+
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q3);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q0);
+
+	//VTBL's table spans 4 registers, make sure it doesn't go past d31
+	if(src1Reg == CAArch32Assembler::q15)
+	{
+		m_assembler.Vorr(CAArch32Assembler::q0, src1Reg, src1Reg);
+		src1Reg = CAArch32Assembler::q0;
+	}
+
+	//Lower half is written first, make sure it doesn't overwrite src1
+	auto resultReg = (dstReg == src1Reg) ? CAArch32Assembler::q3 : dstReg;
+
+	m_assembler.Adrl(maskAddrReg, GetMdShuffleByteMask(statement));
+	m_assembler.Vld1_32x4(maskReg, maskAddrReg);
+	//Mask indices are below 16, only the first two registers of the table are accessed
+	m_assembler.Vtbl(
+	    static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 0),
+	    static_cast<CAArch32Assembler::DOUBLE_REGISTER>(src1Reg),
+	    static_cast<CAArch32Assembler::DOUBLE_REGISTER>(maskReg + 0));
+	m_assembler.Vtbl(
+	    static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 1),
+	    static_cast<CAArch32Assembler::DOUBLE_REGISTER>(src1Reg),
+	    static_cast<CAArch32Assembler::DOUBLE_REGISTER>(maskReg + 1));
+
+	if(resultReg != dstReg)
+	{
+		m_assembler.Vorr(dstReg, resultReg, resultReg);
+	}
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
 template <uint32 offset>
-void CCodeGen_AArch32::Emit_Md_UnpackBH_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_UnpackBH_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto src2AddrReg = CAArch32Assembler::r2;
-	auto src1Reg = CAArch32Assembler::d0;
-	auto src2Reg = CAArch32Assembler::d1;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1, offset);
-	LoadMemory128AddressInRegister(src2AddrReg, src2, offset);
+	//Sources are gathered in the result register, make sure this doesn't overwrite them
+	auto resultReg = (dst->Equals(src1) || dst->Equals(src2)) ? CAArch32Assembler::q0 : dstReg;
+	auto resultLoReg = static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 0);
+	auto resultHiReg = static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 1);
 
 	//Warning: VZIP modifies both registers
-	m_assembler.Vld1_32x2(src1Reg, src2AddrReg);
-	m_assembler.Vld1_32x2(src2Reg, src1AddrReg);
-	m_assembler.Vzip_I8(src1Reg, src2Reg);
-	m_assembler.Vst1_32x4(static_cast<CAArch32Assembler::QUAD_REGISTER>(src1Reg), dstAddrReg);
+	LoadSymbol128HalfInRegister(resultLoReg, src2, offset);
+	LoadSymbol128HalfInRegister(resultHiReg, src1, offset);
+	m_assembler.Vzip_I8(resultLoReg, resultHiReg);
+
+	if(resultReg != dstReg)
+	{
+		m_assembler.Vorr(dstReg, resultReg, resultReg);
+	}
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
 template <uint32 offset>
-void CCodeGen_AArch32::Emit_Md_UnpackHW_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_UnpackHW_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto src2AddrReg = CAArch32Assembler::r2;
-	auto src1Reg = CAArch32Assembler::d0;
-	auto src2Reg = CAArch32Assembler::d1;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1, offset);
-	LoadMemory128AddressInRegister(src2AddrReg, src2, offset);
+	//Sources are gathered in the result register, make sure this doesn't overwrite them
+	auto resultReg = (dst->Equals(src1) || dst->Equals(src2)) ? CAArch32Assembler::q0 : dstReg;
+	auto resultLoReg = static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 0);
+	auto resultHiReg = static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg + 1);
 
 	//Warning: VZIP modifies both registers
-	m_assembler.Vld1_32x2(src1Reg, src2AddrReg);
-	m_assembler.Vld1_32x2(src2Reg, src1AddrReg);
-	m_assembler.Vzip_I16(src1Reg, src2Reg);
-	m_assembler.Vst1_32x4(static_cast<CAArch32Assembler::QUAD_REGISTER>(src1Reg), dstAddrReg);
+	LoadSymbol128HalfInRegister(resultLoReg, src2, offset);
+	LoadSymbol128HalfInRegister(resultHiReg, src1, offset);
+	m_assembler.Vzip_I16(resultLoReg, resultHiReg);
+
+	if(resultReg != dstReg)
+	{
+		m_assembler.Vorr(dstReg, resultReg, resultReg);
+	}
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
 template <uint32 offset>
-void CCodeGen_AArch32::Emit_Md_UnpackWD_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_Md_UnpackWD_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 	auto src2 = statement.src2->GetSymbol().get();
 
-	auto dstAddrReg = CAArch32Assembler::r0;
-	auto src1AddrReg = CAArch32Assembler::r1;
-	auto src2AddrReg = CAArch32Assembler::r2;
-	auto src1Reg = CAArch32Assembler::d0;
-	auto src2Reg = CAArch32Assembler::d2;
+	auto tmpReg = CAArch32Assembler::q1;
+	auto dstReg = PrepareSymbolRegisterDefMd(dst, CAArch32Assembler::q0);
 
-	LoadMemory128AddressInRegister(dstAddrReg, dst);
-	LoadMemory128AddressInRegister(src1AddrReg, src1, offset);
-	LoadMemory128AddressInRegister(src2AddrReg, src2, offset);
+	//Sources are gathered in the result register, make sure this doesn't overwrite them
+	auto resultReg = (dst->Equals(src1) || dst->Equals(src2)) ? CAArch32Assembler::q0 : dstReg;
 
 	//Warning: VZIP modifies both registers
-	m_assembler.Vld1_32x2(src1Reg, src2AddrReg);
-	m_assembler.Vld1_32x2(src2Reg, src1AddrReg);
-	m_assembler.Vzip_I32(static_cast<CAArch32Assembler::QUAD_REGISTER>(src1Reg), static_cast<CAArch32Assembler::QUAD_REGISTER>(src2Reg));
-	m_assembler.Vst1_32x4(static_cast<CAArch32Assembler::QUAD_REGISTER>(src1Reg), dstAddrReg);
+	LoadSymbol128HalfInRegister(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(resultReg), src2, offset);
+	LoadSymbol128HalfInRegister(static_cast<CAArch32Assembler::DOUBLE_REGISTER>(tmpReg), src1, offset);
+	m_assembler.Vzip_I32(resultReg, tmpReg);
+
+	if(resultReg != dstReg)
+	{
+		m_assembler.Vorr(dstReg, resultReg, resultReg);
+	}
+
+	CommitSymbolRegisterMd(dst, dstReg);
 }
 
-void CCodeGen_AArch32::Emit_MergeTo256_MemMemMem(const STATEMENT& statement)
+void CCodeGen_AArch32::Emit_MergeTo256_MemVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
@@ -749,18 +931,13 @@ void CCodeGen_AArch32::Emit_MergeTo256_MemMemMem(const STATEMENT& statement)
 
 	auto dstLoAddrReg = CAArch32Assembler::r0;
 	auto dstHiAddrReg = CAArch32Assembler::r1;
-	auto src1AddrReg = CAArch32Assembler::r2;
-	auto src2AddrReg = CAArch32Assembler::r3;
-	auto src1Reg = CAArch32Assembler::q0;
-	auto src2Reg = CAArch32Assembler::q1;
+
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1, CAArch32Assembler::q0);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2, CAArch32Assembler::q1);
 
 	LoadTemporary256ElementAddressInRegister(dstLoAddrReg, dst, 0x00);
 	LoadTemporary256ElementAddressInRegister(dstHiAddrReg, dst, 0x10);
-	LoadMemory128AddressInRegister(src1AddrReg, src1);
-	LoadMemory128AddressInRegister(src2AddrReg, src2);
 
-	m_assembler.Vld1_32x4(src1Reg, src1AddrReg);
-	m_assembler.Vld1_32x4(src2Reg, src2AddrReg);
 	m_assembler.Vst1_32x4(src1Reg, dstLoAddrReg);
 	m_assembler.Vst1_32x4(src2Reg, dstHiAddrReg);
 }
@@ -768,111 +945,123 @@ void CCodeGen_AArch32::Emit_MergeTo256_MemMemMem(const STATEMENT& statement)
 // clang-format off
 CCodeGen_AArch32::CONSTMATCHER CCodeGen_AArch32::g_mdConstMatchers[] = 
 {
-	{ OP_MD_ADD_B, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDB> },
-	{ OP_MD_ADD_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDH> },
-	{ OP_MD_ADD_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDW> },
+	{ OP_MD_ADD_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDB> },
+	{ OP_MD_ADD_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDH> },
+	{ OP_MD_ADD_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDW> },
+
+	{ OP_MD_SUB_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBB> },
+	{ OP_MD_SUB_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBH> },
+	{ OP_MD_SUB_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBW> },
 
-	{ OP_MD_SUB_B, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBB> },
-	{ OP_MD_SUB_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBH> },
-	{ OP_MD_SUB_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBW> },
+	{ OP_MD_ADDUS_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDBUS> },
+	{ OP_MD_ADDUS_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDHUS> },
+	{ OP_MD_ADDUS_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDWUS> },
 
-	{ OP_MD_ADDUS_B, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDBUS> },
-	{ OP_MD_ADDUS_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDHUS> },
-	{ OP_MD_ADDUS_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDWUS> },
+	{ OP_MD_ADDSS_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDBSS> },
+	{ OP_MD_ADDSS_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDHSS> },
+	{ OP_MD_ADDSS_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDWSS> },
 
-	{ OP_MD_ADDSS_B, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDBSS> },
-	{ OP_MD_ADDSS_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDHSS> },
-	{ OP_MD_ADDSS_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDWSS> },
+	{ OP_MD_SUBUS_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBBUS> },
+	{ OP_MD_SUBUS_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBHUS> },
+	{ OP_MD_SUBUS_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBWUS> },
 
-	{ OP_MD_SUBUS_B, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBBUS> },
-	{ OP_MD_SUBUS_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBHUS> },
-	{ OP_MD_SUBUS_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBWUS> },
+	{ OP_MD_SUBSS_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBBSS> },
+	{ OP_MD_SUBSS_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBHSS> },
+	{ OP_MD_SUBSS_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBWSS> },
 
-	{ OP_MD_SUBSS_B, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBBSS> },
-	{ OP_MD_SUBSS_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBHSS> },
-	{ OP_MD_SUBSS_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBWSS> },
+	{ OP_MD_CLAMP_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL,       MATCH_NIL, &CCodeGen_AArch32::Emit_Md_ClampS_VarVar },
 
-	{ OP_MD_CLAMP_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL,       MATCH_NIL, &CCodeGen_AArch32::Emit_Md_ClampS_MemMem },
+	{ OP_MD_CMPEQ_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_CMPEQB> },
+	{ OP_MD_CMPEQ_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_CMPEQH> },
+	{ OP_MD_CMPEQ_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_CMPEQW> },
 
-	{ OP_MD_CMPEQ_B, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_CMPEQB> },
-	{ OP_MD_CMPEQ_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_CMPEQH> },
-	{ OP_MD_CMPEQ_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_CMPEQW> },
+	{ OP_MD_CMPGT_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_CMPGTB> },
+	{ OP_MD_CMPGT_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_CMPGTH> },
+	{ OP_MD_CMPGT_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_CMPGTW> },
 
-	{ OP_MD_CMPGT_B, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_CMPGTB> },
-	{ OP_MD_CMPGT_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_CMPGTH> },
-	{ OP_MD_CMPGT_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_CMPGTW> },
+	{ OP_MD_MIN_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_MINH> },
+	{ OP_MD_MIN_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_MINW> },
 
-	{ OP_MD_MIN_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_MINH> },
-	{ OP_MD_MIN_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_MINW> },
+	{ OP_MD_MAX_H, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_MAXH> },
+	{ OP_MD_MAX_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_MAXW> },
 
-	{ OP_MD_MAX_H, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_MAXH> },
-	{ OP_MD_MAX_W, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_MAXW> },
+	{ OP_MD_ADD_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_ADDS> },
+	{ OP_MD_SUB_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_SUBS> },
+	{ OP_MD_MUL_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_MULS> },
+	{ OP_MD_DIV_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_DivS_VarVarVar       },
 
-	{ OP_MD_ADD_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_ADDS> },
-	{ OP_MD_SUB_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_SUBS> },
-	{ OP_MD_MUL_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_MULS> },
-	{ OP_MD_DIV_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_DivS_MemMemMem       },
+	//vfma is not available on all targets, fused multiply-add is computed with separate roundings
+	{ OP_MD_MULADD_S,      MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_AArch32::Emit_Md_MulAddS_VarVarVarVar },
+	{ OP_MD_FUSEDMULADD_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_AArch32::Emit_Md_MulAddS_VarVarVarVar },
 
-	{ OP_MD_ABS_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL,       MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMem<MDOP_ABSS>      },
-	{ OP_MD_NEG_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL,       MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMem<MDOP_NEGS>      },
-	{ OP_MD_MIN_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<FPUMDOP_MIN> },
-	{ OP_MD_MAX_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<FPUMDOP_MAX> },
+	{ OP_MD_ABS_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL,       MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVar<MDOP_ABSS>      },
+	{ OP_MD_NEG_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL,       MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVar<MDOP_NEGS>      },
+	{ OP_MD_MIN_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<FPUMDOP_MIN> },
+	{ OP_MD_MAX_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<FPUMDOP_MAX> },
 
-	{ OP_MD_CMPLT_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMemRev<FPUMDOP_CMPGT> },
-	{ OP_MD_CMPGT_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<FPUMDOP_CMPGT>    },
+	{ OP_MD_CMPLT_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVarRev<FPUMDOP_CMPGT> },
+	{ OP_MD_CMPGT_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<FPUMDOP_CMPGT>    },
 
-	{ OP_MD_AND, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_AND> },
-	{ OP_MD_OR,  MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_OR>  },
-	{ OP_MD_XOR, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMemMem<MDOP_XOR> },
-	{ OP_MD_NOT, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL,       MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMem<MDOP_NOT>    },
+	{ OP_MD_AND, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_AND> },
+	{ OP_MD_OR,  MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_OR>  },
+	{ OP_MD_XOR, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVarVar<MDOP_XOR> },
+	{ OP_MD_NOT, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL,       MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVar<MDOP_NOT>    },
 
-	{ OP_MD_SLLH, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_MemMemCst<MDOP_SLLH> },
-	{ OP_MD_SLLW, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_MemMemCst<MDOP_SLLW> },
+	{ OP_MD_SLLH, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_VarVarCst<MDOP_SLLH> },
+	{ OP_MD_SLLW, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_VarVarCst<MDOP_SLLW> },
 
-	{ OP_MD_SRLH, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_MemMemCst<MDOP_SRLH> },
-	{ OP_MD_SRLW, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_MemMemCst<MDOP_SRLW> },
+	{ OP_MD_SRLH, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_VarVarCst<MDOP_SRLH> },
+	{ OP_MD_SRLW, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_VarVarCst<MDOP_SRLW> },
 
-	{ OP_MD_SRAH, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_MemMemCst<MDOP_SRAH> },
-	{ OP_MD_SRAW, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_MemMemCst<MDOP_SRAW> },
+	{ OP_MD_SRAH, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_VarVarCst<MDOP_SRAH> },
+	{ OP_MD_SRAW, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shift_VarVarCst<MDOP_SRAW> },
 
-	{ OP_MD_SRL256, MATCH_VARIABLE128, MATCH_MEMORY256, MATCH_VARIABLE, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Srl256_MemMemVar },
-	{ OP_MD_SRL256, MATCH_VARIABLE128, MATCH_MEMORY256, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Srl256_MemMemCst },
+	{ OP_MD_SRL256, MATCH_VARIABLE128, MATCH_MEMORY256, MATCH_VARIABLE, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Srl256_VarMemVar },
+	{ OP_MD_SRL256, MATCH_VARIABLE128, MATCH_MEMORY256, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Srl256_VarMemCst },
 
-	{ OP_MD_MAKECLIP, MATCH_VARIABLE, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, &CCodeGen_AArch32::Emit_Md_MakeClip_VarMemMemMem },
-	{ OP_MD_MAKESZ,   MATCH_VARIABLE, MATCH_MEMORY128, MATCH_NIL,       MATCH_NIL,       &CCodeGen_AArch32::Emit_Md_MakeSz_VarMem         },
+	{ OP_MD_MAKECLIP, MATCH_VARIABLE, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_AArch32::Emit_Md_MakeClip_VarVarVarVar },
+	{ OP_MD_MAKESZ,   MATCH_VARIABLE, MATCH_VARIABLE128, MATCH_NIL,       MATCH_NIL,       &CCodeGen_AArch32::Emit_Md_MakeSz_VarVar         },
 
-	{ OP_MD_TOSINGLE_I32,    MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMem<MDOP_TOSINGLE_I32> },
-	{ OP_MD_TOINT32_TRUNC_S, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MemMem<MDOP_TOINT32_S>    },
+	{ OP_MD_TOSINGLE_I32,    MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVar<MDOP_TOSINGLE_I32> },
+	{ OP_MD_TOINT32_TRUNC_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_VarVar<MDOP_TOINT32_S>    },
 
-	{ OP_MOV, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Mov_MemMem },
+	{ OP_MOV, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Mov_VarVar },
 
-	{ OP_LOADFROMREF, MATCH_MEMORY128, MATCH_VAR_REF, MATCH_NIL,       MATCH_NIL,       &CCodeGen_AArch32::Emit_Md_LoadFromRef_MemVar    },
-	{ OP_LOADFROMREF, MATCH_MEMORY128, MATCH_VAR_REF, MATCH_ANY32,     MATCH_NIL,       &CCodeGen_AArch32::Emit_Md_LoadFromRef_MemVarAny },
-	{ OP_STOREATREF,  MATCH_NIL,       MATCH_VAR_REF, MATCH_MEMORY128, MATCH_NIL,       &CCodeGen_AArch32::Emit_Md_StoreAtRef_VarMem     },
-	{ OP_STOREATREF,  MATCH_NIL,       MATCH_VAR_REF, MATCH_ANY32,     MATCH_MEMORY128, &CCodeGen_AArch32::Emit_Md_StoreAtRef_VarAnyMem  },
+	{ OP_LOADFROMREF, MATCH_VARIABLE128, MATCH_VAR_REF, MATCH_NIL,       MATCH_NIL,       &CCodeGen_AArch32::Emit_Md_LoadFromRef_VarVar    },
+	{ OP_LOADFROMREF, MATCH_VARIABLE128, MATCH_VAR_REF, MATCH_ANY32,     MATCH_NIL,       &CCodeGen_AArch32::Emit_Md_LoadFromRef_VarVarAny },
+	{ OP_STOREATREF,  MATCH_NIL,       MATCH_VAR_REF, MATCH_VARIABLE128, MATCH_NIL,       &CCodeGen_AArch32::Emit_Md_StoreAtRef_VarVar     },
+	{ OP_STOREATREF,  MATCH_NIL,       MATCH_VAR_REF, MATCH_ANY32,     MATCH_VARIABLE128, &CCodeGen_AArch32::Emit_Md_StoreAtRef_VarAnyVar  },
 
-	{ OP_MD_LOADFROMREF_MASKED, MATCH_MEMORY128, MATCH_VAR_REF, MATCH_ANY32, MATCH_MEMORY128, &CCodeGen_AArch32::Emit_Md_LoadFromRefMasked_MemMemAnyMem },
-	{ OP_MD_STOREATREF_MASKED,  MATCH_NIL,       MATCH_VAR_REF, MATCH_ANY32, MATCH_MEMORY128, &CCodeGen_AArch32::Emit_Md_StoreAtRefMasked_MemAnyMem     },
+	{ OP_MD_LOADFROMREF_MASKED, MATCH_VARIABLE128, MATCH_VAR_REF, MATCH_ANY32, MATCH_VARIABLE128, &CCodeGen_AArch32::Emit_Md_LoadFromRefMasked_VarVarAnyVar },
+	{ OP_MD_STOREATREF_MASKED,  MATCH_NIL,       MATCH_VAR_REF, MATCH_ANY32, MATCH_VARIABLE128, &CCodeGen_AArch32::Emit_Md_StoreAtRefMasked_VarAnyVar     },
 
-	{ OP_MD_MOV_MASKED, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MovMasked_MemMemMem },
+	{ OP_MD_MOV_MASKED, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_MovMasked_VarVarVar },
 
-	{ OP_MD_EXPAND_W, MATCH_MEMORY128,   MATCH_REGISTER,    MATCH_NIL,      MATCH_NIL, &CCodeGen_AArch32::Emit_Md_ExpandW_MemReg    },
-	{ OP_MD_EXPAND_W, MATCH_MEMORY128,   MATCH_MEMORY,      MATCH_NIL,      MATCH_NIL, &CCodeGen_AArch32::Emit_Md_ExpandW_MemMem    },
-	{ OP_MD_EXPAND_W, MATCH_MEMORY128,   MATCH_CONSTANT,    MATCH_NIL,      MATCH_NIL, &CCodeGen_AArch32::Emit_Md_ExpandW_MemCst    },
+	{ OP_MD_EXPAND_W, MATCH_VARIABLE128,   MATCH_REGISTER,    MATCH_NIL,      MATCH_NIL, &CCodeGen_AArch32::Emit_Md_ExpandW_VarReg    },
+	{ OP_MD_EXPAND_W, MATCH_VARIABLE128,   MATCH_MEMORY,      MATCH_NIL,      MATCH_NIL, &CCodeGen_AArch32::Emit_Md_ExpandW_VarMem    },
+	{ OP_MD_EXPAND_W, MATCH_VARIABLE128,   MATCH_CONSTANT,    MATCH_NIL,      MATCH_NIL, &CCodeGen_AArch32::Emit_Md_ExpandW_VarCst    },
 	{ OP_MD_EXPAND_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_ExpandW_VarVarCst },
 
-	{ OP_MD_PACK_HB, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_PackHB_MemMemMem },
-	{ OP_MD_PACK_WH, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_PackWH_MemMemMem },
+	{ OP_MD_LDCST, MATCH_VARIABLE128, MATCH_CONSTANT64, MATCH_CONSTANT64, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_LdCst_VarCstCst },
+
+	{ OP_MD_EXTRACT_LANE_S, MATCH_FP_VARIABLE32, MATCH_VARIABLE128, MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_AArch32::Emit_Md_ExtractLaneS_VarVarCst   },
+	{ OP_MD_INSERT_LANE_S,  MATCH_VARIABLE128,   MATCH_VARIABLE128, MATCH_FP_VARIABLE32, MATCH_CONSTANT, &CCodeGen_AArch32::Emit_Md_InsertLaneS_VarVarVarCst },
+
+	{ OP_MD_PACK_HB, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_PackHB_VarVarVar },
+	{ OP_MD_PACK_WH, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_PackWH_VarVarVar },
+
+	{ OP_MD_SHUFFLE_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT,   MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shuffle_VarVarCst },
+	{ OP_MD_SHUFFLE_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT64, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_Shuffle_VarVarCst },
 
-	{ OP_MD_UNPACK_LOWER_BH, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackBH_MemMemMem<0> },
-	{ OP_MD_UNPACK_LOWER_HW, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackHW_MemMemMem<0> },
-	{ OP_MD_UNPACK_LOWER_WD, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackWD_MemMemMem<0> },
+	{ OP_MD_UNPACK_LOWER_BH, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackBH_VarVarVar<0> },
+	{ OP_MD_UNPACK_LOWER_HW, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackHW_VarVarVar<0> },
+	{ OP_MD_UNPACK_LOWER_WD, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackWD_VarVarVar<0> },
 
-	{ OP_MD_UNPACK_UPPER_BH, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackBH_MemMemMem<8> },
-	{ OP_MD_UNPACK_UPPER_HW, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackHW_MemMemMem<8> },
-	{ OP_MD_UNPACK_UPPER_WD, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_MEMORY128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackWD_MemMemMem<8> },
+	{ OP_MD_UNPACK_UPPER_BH, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackBH_VarVarVar<8> },
+	{ OP_MD_UNPACK_UPPER_HW, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackHW_VarVarVar<8> },
+	{ OP_MD_UNPACK_UPPER_WD, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_Md_UnpackWD_VarVarVar<8> },
 
-	{ OP_MERGETO256, MATCH_MEMORY256, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_MergeTo256_MemMemMem },
+	{ OP_MERGETO256, MATCH_MEMORY256, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_AArch32::Emit_MergeTo256_MemVarVar },
 
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
@@ -243,6 +243,30 @@ void CCodeGen_AArch64::Emit_Logic_VarVarCst(const STATEMENT& statement)
 	CommitSymbolRegister(dst, dstReg);
 }
 
+template <bool isSigned>
+void CCodeGen_AArch64::Emit_ExtractBits_VarVarCstCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	assert(src2->m_type == SYM_CONSTANT);
+	assert(src3->m_type == SYM_CONSTANT);
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
+	auto src1Reg = PrepareSymbolRegisterUse(src1, GetNextTempRegister());
+	if(isSigned)
+	{
+		m_assembler.Sbfx(dstReg, src1Reg, src2->m_valueLow, src3->m_valueLow);
+	}
+	else
+	{
+		m_assembler.Ubfx(dstReg, src1Reg, src2->m_valueLow, src3->m_valueLow);
+	}
+	CommitSymbolRegister(dst, dstReg);
+}
+
 template <bool isSigned>
 void CCodeGen_AArch64::Emit_Mul_Tmp64AnyAny(const STATEMENT& statement)
 {
@@ -318,6 +342,10 @@ CCodeGen_AArch64::CONSTMATCHER CCodeGen_AArch64::g_constMatchers[] =
 
 	{ OP_NOT,            MATCH_VARIABLE,       MATCH_VARIABLE,       MATCH_NIL,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Not_VarVar                          },
 	{ OP_LZC,            MATCH_VARIABLE,       MATCH_VARIABLE,       MATCH_NIL,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Lzc_VarVar                          },
+
+	{ OP_EXTRACTBITS,    MATCH_VARIABLE,       MATCH_VARIABLE,       MATCH_CONSTANT,      MATCH_CONSTANT, &CCodeGen_AArch64::Emit_ExtractBits_VarVarCstCst<false>     },
+	{ OP_EXTRACTBITSS,   MATCH_VARIABLE,       MATCH_VARIABLE,       MATCH_CONSTANT,      MATCH_CONSTANT, &CCodeGen_AArch64::Emit_ExtractBits_VarVarCstCst<true>      },
+	{ OP_INSERTBITS,     MATCH_VARIABLE,       MATCH_ANY,            MATCH_ANY,           MATCH_CONSTANT, &CCodeGen_AArch64::Emit_InsertBits_VarAnyAnyCst             },
 	
 	{ OP_RELTOREF,       MATCH_VAR_REF,        MATCH_CONSTANT,       MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_RelToRef_VarCst                     },
 
@@ -468,6 +496,44 @@ bool CCodeGen_AArch64::SupportsCmpSelect() const
 	return true;
 }
 
+bool CCodeGen_AArch64::SupportsBitfieldOps() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch64::SupportsPairedStores() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch64::SupportsLoopRegisters() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch64::SupportsMdLaneOps() const
+{
+	return true;
+}
+
+unsigned int CCodeGen_AArch64::GetOperationCost(OPERATION op) const
+{
+	switch(op)
+	{
+	case OP_MUL:
+	case OP_MULS:
+		//umull/smull and result stored to stack
+		return 4;
+	case OP_DIV:
+	case OP_DIVS:
+		return 12;
+	case OP_MERGETO64:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
 uint32 CCodeGen_AArch64::GetPointerSize() const
 {
 	return 8;
@@ -492,6 +558,7 @@ void CCodeGen_AArch64::GenerateCode(const StatementList& statements, unsigned in
 	stackSize = (stackSize + 0xF) & ~0xF;
 
 	m_registerSave = GetSavedRegisterList(GetRegisterUsage(statements));
+	m_loopHeadLabels = GetLoopHeadLabels(statements);
 
 	Emit_Prolog(statements, stackSize);
 
@@ -526,6 +593,7 @@ void CCodeGen_AArch64::GenerateCode(const StatementList& statements, unsigned in
 	m_assembler.ClearLabels();
 	m_assembler.ResolveLiteralReferences();
 	m_labels.clear();
+	m_loopHeadLabels.clear();
 }
 
 uint32 CCodeGen_AArch64::GetMaxParamSpillSize(const StatementList& statements)
@@ -1009,7 +1077,14 @@ void CCodeGen_AArch64::MarkLabel(const STATEMENT& statement)
 {
 	ResetTempRegisterMdState();
 	auto label = GetLabel(statement.jmpBlock);
-	m_assembler.MarkLabel(label);
+	if(m_loopHeadLabels.find(statement.jmpBlock) != std::end(m_loopHeadLabels))
+	{
+		m_assembler.MarkAlignedLabel(label, LOOP_ALIGNMENT);
+	}
+	else
+	{
+		m_assembler.MarkLabel(label);
+	}
 }
 
 void CCodeGen_AArch64::Emit_Nop(const STATEMENT&)
@@ -1144,6 +1219,54 @@ void CCodeGen_AArch64::Emit_Lzc_VarVar(const STATEMENT& statement)
 	CommitSymbolRegister(dst, dstRegister);
 }
 
+void CCodeGen_AArch64::Emit_InsertBits_VarAnyAnyCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	assert(src3->m_type == SYM_CONSTANT);
+
+	uint8 lsb = src3->m_valueLow & 0xFF;
+	uint8 width = (src3->m_valueLow >> 8) & 0xFF;
+	uint8 srcLsb = (src3->m_valueLow >> 16) & 0xFF;
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
+	auto src1Reg = PrepareSymbolRegisterUse(src1, GetNextTempRegister());
+	auto src2Reg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+
+	//Make sure we don't overwrite src2 when copying src1 in the result register
+	auto resultReg = ((dstReg == src2Reg) && (dstReg != src1Reg)) ? GetNextTempRegister() : dstReg;
+
+	if(resultReg != src1Reg)
+	{
+		m_assembler.Mov(resultReg, src1Reg);
+	}
+
+	if(srcLsb == 0)
+	{
+		m_assembler.Bfi(resultReg, src2Reg, lsb, width);
+	}
+	else if(lsb == 0)
+	{
+		m_assembler.Bfxil(resultReg, src2Reg, srcLsb, width);
+	}
+	else
+	{
+		auto fieldReg = GetNextTempRegister();
+		m_assembler.Ubfx(fieldReg, src2Reg, srcLsb, width);
+		m_assembler.Bfi(resultReg, fieldReg, lsb, width);
+	}
+
+	if(resultReg != dstReg)
+	{
+		m_assembler.Mov(dstReg, resultReg);
+	}
+
+	CommitSymbolRegister(dst, dstReg);
+}
+
 void CCodeGen_AArch64::Emit_RelToRef_VarCst(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -1581,6 +1704,18 @@ void CCodeGen_AArch64::Emit_Call(const STATEMENT& statement)
 		}
 		m_assembler.Bl(0);
 	}
+	else if(m_externalSymbolReferencedHandler)
+	{
+		//Load target function address from a literal to allow it to be relocated
+		auto fctAddressReg = GetNextTempRegister64();
+		m_assembler.Ldr_Pc(fctAddressReg, 12);
+		m_assembler.Blr(fctAddressReg);
+		m_assembler.B_offset(12);
+
+		auto position = m_stream->GetLength();
+		m_externalSymbolReferencedHandler(src1->GetConstantPtr(), position, CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER);
+		m_stream->Write64(src1->GetConstantPtr());
+	}
 	else
 	{
 		auto fctAddressReg = GetNextTempRegister64();
@@ -1646,6 +1781,16 @@ void CCodeGen_AArch64::Emit_ExternJmp(const STATEMENT& statement)
 		}
 		m_assembler.B_offset(0);
 	}
+	else if(m_externalSymbolReferencedHandler)
+	{
+		auto fctAddressReg = GetNextTempRegister64();
+		m_assembler.Ldr_Pc(fctAddressReg, 8);
+		m_assembler.Br(fctAddressReg);
+
+		auto position = m_stream->GetLength();
+		m_externalSymbolReferencedHandler(src1->GetConstantPtr(), position, CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER);
+		m_stream->Write64(src1->GetConstantPtr());
+	}
 	else
 	{
 		auto fctAddressReg = GetNextTempRegister64();
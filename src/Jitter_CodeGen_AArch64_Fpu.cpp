@@ -205,6 +205,43 @@ void CCodeGen_AArch64::Emit_Fp_Rcpl_VarVar(const STATEMENT& statement)
 	CommitSymbolRegisterFp(dst, dstReg);
 }
 
+void CCodeGen_AArch64::Emit_Fp_MulAdd_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	//Product is computed first to limit the number of temporaries live at once
+	auto src2Reg = PrepareSymbolRegisterUseFp(src2);
+	auto src3Reg = PrepareSymbolRegisterUseFp(src3);
+	auto mulReg = GetNextTempRegisterMd();
+	m_assembler.Fmul_1s(mulReg, src2Reg, src3Reg);
+
+	auto src1Reg = PrepareSymbolRegisterUseFp(src1);
+	auto dstReg = PrepareSymbolRegisterDefFp(dst);
+	m_assembler.Fadd_1s(dstReg, src1Reg, mulReg);
+
+	CommitSymbolRegisterFp(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_Fp_FusedMulAdd_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto dstReg = PrepareSymbolRegisterDefFp(dst);
+	auto src1Reg = PrepareSymbolRegisterUseFp(src1);
+	auto src2Reg = PrepareSymbolRegisterUseFp(src2);
+	auto src3Reg = PrepareSymbolRegisterUseFp(src3);
+
+	m_assembler.Fmadd_1s(dstReg, src2Reg, src3Reg, src1Reg);
+
+	CommitSymbolRegisterFp(dst, dstReg);
+}
+
 void CCodeGen_AArch64::Emit_Fp_Rsqrt_VarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -318,6 +355,8 @@ CCodeGen_AArch64::CONSTMATCHER CCodeGen_AArch64::g_fpuConstMatchers[] =
 	{ OP_FP_SUB_S,           MATCH_FP_VARIABLE32,     MATCH_FP_VARIABLE32,   MATCH_FP_VARIABLE32,  MATCH_NIL, &CCodeGen_AArch64::Emit_Fpu_VarVarVar<FPUOP_SUB>    },
 	{ OP_FP_MUL_S,           MATCH_FP_VARIABLE32,     MATCH_FP_VARIABLE32,   MATCH_FP_VARIABLE32,  MATCH_NIL, &CCodeGen_AArch64::Emit_Fpu_VarVarVar<FPUOP_MUL>    },
 	{ OP_FP_DIV_S,           MATCH_FP_VARIABLE32,     MATCH_FP_VARIABLE32,   MATCH_FP_VARIABLE32,  MATCH_NIL, &CCodeGen_AArch64::Emit_Fpu_VarVarVar<FPUOP_DIV>    },
+	{ OP_FP_MULADD_S,        MATCH_FP_VARIABLE32,     MATCH_FP_VARIABLE32,   MATCH_FP_VARIABLE32,  MATCH_FP_VARIABLE32, &CCodeGen_AArch64::Emit_Fp_MulAdd_VarVarVarVar      },
+	{ OP_FP_FUSEDMULADD_S,   MATCH_FP_VARIABLE32,     MATCH_FP_VARIABLE32,   MATCH_FP_VARIABLE32,  MATCH_FP_VARIABLE32, &CCodeGen_AArch64::Emit_Fp_FusedMulAdd_VarVarVarVar },
 
 	{ OP_FP_CMP_S,           MATCH_ANY,               MATCH_FP_VARIABLE32,   MATCH_FP_VARIABLE32,  MATCH_NIL, &CCodeGen_AArch64::Emit_Fp_Cmp_AnyVarVar            },
 
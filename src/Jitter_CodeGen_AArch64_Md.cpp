@@ -259,6 +259,53 @@ void CCodeGen_AArch64::Emit_Md_ClampS_VarVar(const STATEMENT& statement)
 	CommitSymbolRegisterMd(dst, dstReg);
 }
 
+void CCodeGen_AArch64::Emit_Md_MulAddS_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	//Product is computed first to limit the number of temporaries live at once
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2);
+	auto src3Reg = PrepareSymbolRegisterUseMd(src3);
+	auto mulReg = GetNextTempRegisterMd();
+	m_assembler.Fmul_4s(mulReg, src2Reg, src3Reg);
+
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst);
+	m_assembler.Fadd_4s(dstReg, src1Reg, mulReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_Md_FusedMulAddS_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1);
+	auto src2Reg = PrepareSymbolRegisterUseMd(src2);
+	auto src3Reg = PrepareSymbolRegisterUseMd(src3);
+	auto dstReg = PrepareSymbolRegisterDefMd(dst);
+
+	//fmla accumulates in its destination, make sure we don't clobber a multiplicand
+	auto resultReg = ((dstReg == src2Reg) || (dstReg == src3Reg)) ? GetNextTempRegisterMd() : dstReg;
+	if(resultReg != src1Reg)
+	{
+		m_assembler.Mov(resultReg, src1Reg);
+	}
+	m_assembler.Fmla_4s(resultReg, src2Reg, src3Reg);
+	if(resultReg != dstReg)
+	{
+		m_assembler.Mov(dstReg, resultReg);
+	}
+
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
 void CCodeGen_AArch64::Emit_Md_MakeClip_VarVarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -635,6 +682,98 @@ void CCodeGen_AArch64::Emit_Md_ExpandW_VarVarCst(const STATEMENT& statement)
 	CommitSymbolRegisterMd(dst, dstReg);
 }
 
+void CCodeGen_AArch64::Emit_Md_LdCst_VarCstCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+
+	auto dstReg = PrepareSymbolRegisterDefMd(dst);
+
+	m_assembler.Ldr_Pc(dstReg, GetMdLiteral(statement));
+
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_Md_ExtractLaneS_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	assert(src2->m_type == SYM_CONSTANT);
+	assert(src2->m_valueLow < 4);
+
+	auto dstReg = PrepareSymbolRegisterDefFp(dst);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1);
+
+	m_assembler.Dup_4s(dstReg, src1Reg, src2->m_valueLow);
+
+	CommitSymbolRegisterFp(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_Md_InsertLaneS_VarVarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	assert(src3->m_type == SYM_CONSTANT);
+	assert(src3->m_valueLow < 4);
+
+	auto dstReg = PrepareSymbolRegisterDefMd(dst);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1);
+	auto src2Reg = PrepareSymbolRegisterUseFp(src2);
+
+	if(dstReg != src1Reg)
+	{
+		m_assembler.Mov(dstReg, src1Reg);
+	}
+	m_assembler.Ins_1s(dstReg, src3->m_valueLow, src2Reg, 0);
+
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_Md_ShuffleW_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	uint8 pattern = static_cast<uint8>(src2->m_valueLow);
+	uint8 lane = pattern & 3;
+
+	auto dstReg = PrepareSymbolRegisterDefMd(dst);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1);
+
+	if(pattern == (lane * 0x55))
+	{
+		m_assembler.Dup_4s(dstReg, src1Reg, lane);
+	}
+	else
+	{
+		auto maskReg = GetNextTempRegisterMd();
+		m_assembler.Ldr_Pc(maskReg, GetMdShuffleByteMask(statement));
+		m_assembler.Tbl(dstReg, src1Reg, maskReg);
+	}
+
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_Md_ShuffleB_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto dstReg = PrepareSymbolRegisterDefMd(dst);
+	auto src1Reg = PrepareSymbolRegisterUseMd(src1);
+	auto maskReg = GetNextTempRegisterMd();
+
+	m_assembler.Ldr_Pc(maskReg, GetMdShuffleByteMask(statement));
+	m_assembler.Tbl(dstReg, src1Reg, maskReg);
+
+	CommitSymbolRegisterMd(dst, dstReg);
+}
+
 void CCodeGen_AArch64::Emit_Md_PackHB_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -803,6 +942,8 @@ CCodeGen_AArch64::CONSTMATCHER CCodeGen_AArch64::g_mdConstMatchers[] =
 	{ OP_MD_SUB_S,              MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_NIL, &CCodeGen_AArch64::Emit_Md_VarVarVar<MDOP_SUBS>                  },
 	{ OP_MD_MUL_S,              MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_NIL, &CCodeGen_AArch64::Emit_Md_VarVarVar<MDOP_MULS>                  },
 	{ OP_MD_DIV_S,              MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_NIL, &CCodeGen_AArch64::Emit_Md_VarVarVar<MDOP_DIVS>                  },
+	{ OP_MD_MULADD_S,           MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_VARIABLE128, &CCodeGen_AArch64::Emit_Md_MulAddS_VarVarVarVar      },
+	{ OP_MD_FUSEDMULADD_S,      MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_VARIABLE128, &CCodeGen_AArch64::Emit_Md_FusedMulAddS_VarVarVarVar },
 
 	{ OP_MD_ABS_S,              MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_NIL,              MATCH_NIL, &CCodeGen_AArch64::Emit_Md_VarVar<MDOP_ABSS>                     },
 	{ OP_MD_NEG_S,              MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_NIL,              MATCH_NIL, &CCodeGen_AArch64::Emit_Md_VarVar<MDOP_NEGS>                     },
@@ -850,9 +991,17 @@ CCodeGen_AArch64::CONSTMATCHER CCodeGen_AArch64::g_mdConstMatchers[] =
 	{ OP_MD_EXPAND_W,           MATCH_VARIABLE128,    MATCH_CONSTANT,       MATCH_NIL,              MATCH_NIL, &CCodeGen_AArch64::Emit_Md_ExpandW_VarCst                        },
 	{ OP_MD_EXPAND_W,           MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_CONSTANT,         MATCH_NIL, &CCodeGen_AArch64::Emit_Md_ExpandW_VarVarCst                     },
 
+	{ OP_MD_LDCST,              MATCH_VARIABLE128,    MATCH_CONSTANT64,     MATCH_CONSTANT64,       MATCH_NIL, &CCodeGen_AArch64::Emit_Md_LdCst_VarCstCst                       },
+
+	{ OP_MD_EXTRACT_LANE_S,     MATCH_FP_VARIABLE32,  MATCH_VARIABLE128,    MATCH_CONSTANT,         MATCH_NIL, &CCodeGen_AArch64::Emit_Md_ExtractLaneS_VarVarCst                },
+	{ OP_MD_INSERT_LANE_S,      MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_FP_VARIABLE32,    MATCH_CONSTANT, &CCodeGen_AArch64::Emit_Md_InsertLaneS_VarVarVarCst        },
+
 	{ OP_MD_PACK_HB,            MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_NIL, &CCodeGen_AArch64::Emit_Md_PackHB_VarVarVar                      },
 	{ OP_MD_PACK_WH,            MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_NIL, &CCodeGen_AArch64::Emit_Md_PackWH_VarVarVar                      },
 
+	{ OP_MD_SHUFFLE_W,          MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_CONSTANT,         MATCH_NIL, &CCodeGen_AArch64::Emit_Md_ShuffleW_VarVarCst                    },
+	{ OP_MD_SHUFFLE_B,          MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_CONSTANT64,       MATCH_NIL, &CCodeGen_AArch64::Emit_Md_ShuffleB_VarVarCst                    },
+
 	{ OP_MD_UNPACK_LOWER_BH,    MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_NIL, &CCodeGen_AArch64::Emit_Md_VarVarVarRev<MDOP_UNPACK_LOWER_BH>    },
 	{ OP_MD_UNPACK_LOWER_HW,    MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_NIL, &CCodeGen_AArch64::Emit_Md_VarVarVarRev<MDOP_UNPACK_LOWER_HW>    },
 	{ OP_MD_UNPACK_LOWER_WD,    MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,      MATCH_NIL, &CCodeGen_AArch64::Emit_Md_VarVarVarRev<MDOP_UNPACK_LOWER_WD>    },
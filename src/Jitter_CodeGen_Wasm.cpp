@@ -1,5 +1,6 @@
 #include "Jitter_CodeGen_Wasm.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <set>
 
@@ -93,6 +94,7 @@ CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_constMatchers[] =
 	{ OP_BREAK,          MATCH_NIL,            MATCH_NIL,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Break                                  },
 
 	{ OP_MOV,            MATCH_VARIABLE,       MATCH_ANY,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Mov_VarAny                             },
+	{ OP_MOV,            MATCH_VAR_REF,        MATCH_VAR_REF,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Mov_VarAny                             },
 
 	{ OP_RELTOREF,       MATCH_VAR_REF,        MATCH_CONSTANT,       MATCH_ANY,           MATCH_NIL,      &CCodeGen_Wasm::Emit_RelToRef_VarCst                        },
 
@@ -125,6 +127,7 @@ CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_constMatchers[] =
 
 	{ OP_CALL,           MATCH_NIL,            MATCH_CONSTANTPTR,    MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Call                                   },
 	{ OP_RETVAL,         MATCH_TEMPORARY,      MATCH_NIL,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_RetVal_Tmp                             },
+	{ OP_RETVAL,         MATCH_REGISTER,       MATCH_NIL,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_RetVal_Reg                             },
 
 	{ OP_EXTERNJMP,      MATCH_NIL,            MATCH_CONSTANTPTR,    MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_ExternJmp                              },
 
@@ -197,9 +200,11 @@ EM_JS(int, RegisterExternFunction, (const char* functionName, const char* functi
 // clang-format on
 
 std::map<uintptr_t, CWasmFunctionRegistry::WASM_FUNCTION_INFO> CWasmFunctionRegistry::m_functions;
+std::shared_mutex CWasmFunctionRegistry::m_functionsMutex;
 
 void CWasmFunctionRegistry::RegisterFunction(uintptr_t functionPtr, const char* functionName, const char* functionSig)
 {
+	std::unique_lock<std::shared_mutex> lock(m_functionsMutex);
 	{
 		auto fctIterator = m_functions.find(functionPtr);
 		assert(fctIterator == m_functions.end());
@@ -212,6 +217,8 @@ void CWasmFunctionRegistry::RegisterFunction(uintptr_t functionPtr, const char*
 
 const CWasmFunctionRegistry::WASM_FUNCTION_INFO* CWasmFunctionRegistry::FindFunction(uintptr_t functionPtr)
 {
+	//Entries are never removed, returned pointer stays valid after the lock is released
+	std::shared_lock<std::shared_mutex> lock(m_functionsMutex);
 	auto fctIterator = m_functions.find(functionPtr);
 	if(fctIterator == std::end(m_functions)) return nullptr;
 	return &fctIterator->second;
@@ -256,25 +263,31 @@ CCodeGen_Wasm::CCodeGen_Wasm()
 
 void CCodeGen_Wasm::GenerateCode(const StatementList& statements, unsigned int stackSize)
 {
-	CWasmModuleBuilder moduleBuilder;
-
 	assert((stackSize & 0x3) == 0);
 
+	if(!m_isBuildingModule)
+	{
+		m_moduleBuilder = CWasmModuleBuilder();
+		m_signatures.clear();
+	}
+
 	m_functionStream.ResetBuffer();
-	m_signatures.clear();
 	m_labelFlows.clear();
 	m_temporaryLocations.clear();
 	m_localI32Count = 0;
 	m_localI64Count = 0;
 	m_localF32Count = 0;
 	m_localV128Count = 0;
+	m_registerI32Base = 0;
+	m_registerF32Base = 0;
+	m_registerV128Base = 0;
 	m_isInsideBlock = false;
 	m_isInsideLoop = false;
 	m_currentBlockDepth = 0;
 	m_loopBlock = -1;
 
 	BuildLabelFlows(statements);
-	PrepareSignatures(moduleBuilder, statements);
+	PrepareSignatures(m_moduleBuilder, statements);
 	PrepareLocalVars(statements);
 
 	for(const auto& statement : statements)
@@ -320,12 +333,46 @@ void CCodeGen_Wasm::GenerateCode(const StatementList& statements, unsigned int s
 	function.localF32Count = m_localF32Count;
 	function.localV128Count = m_localV128Count;
 
-	moduleBuilder.AddFunction(std::move(function));
-	moduleBuilder.WriteModule(*m_stream);
+	m_moduleBuilder.AddFunction(std::move(function));
+	if(!m_isBuildingModule)
+	{
+		m_moduleBuilder.WriteModule(*m_stream);
+	}
 
 	assert(m_params.empty());
 }
 
+void CCodeGen_Wasm::BeginModule()
+{
+	assert(!m_isBuildingModule);
+	m_isBuildingModule = true;
+	m_moduleBuilder = CWasmModuleBuilder();
+	m_moduleFunctions.clear();
+	m_signatures.clear();
+}
+
+void CCodeGen_Wasm::RegisterModuleFunction(uintptr_t fctId, uint32 fctIndex)
+{
+	//Calls to this function from inside the module will be direct calls
+	assert(m_isBuildingModule);
+	assert(m_moduleFunctions.find(fctId) == std::end(m_moduleFunctions));
+	m_moduleFunctions[fctId] = fctIndex;
+}
+
+void CCodeGen_Wasm::EndModule()
+{
+	assert(m_isBuildingModule);
+	m_isBuildingModule = false;
+#ifndef NDEBUG
+	for(const auto& moduleFunction : m_moduleFunctions)
+	{
+		assert(moduleFunction.second < m_moduleBuilder.GetFunctionCount());
+	}
+#endif
+	m_moduleBuilder.WriteModule(*m_stream);
+	m_moduleFunctions.clear();
+}
+
 void CCodeGen_Wasm::SetStream(Framework::CStream* stream)
 {
 	m_stream = stream;
@@ -337,12 +384,12 @@ void CCodeGen_Wasm::RegisterExternalSymbols(CObjectFile*) const
 
 unsigned int CCodeGen_Wasm::GetAvailableRegisterCount() const
 {
-	return 0;
+	return MAX_REGISTERS;
 }
 
 unsigned int CCodeGen_Wasm::GetAvailableMdRegisterCount() const
 {
-	return 0;
+	return MAX_MDREGISTERS;
 }
 
 bool CCodeGen_Wasm::Has128BitsCallOperands() const
@@ -365,6 +412,44 @@ bool CCodeGen_Wasm::SupportsCmpSelect() const
 	return false;
 }
 
+bool CCodeGen_Wasm::SupportsBitfieldOps() const
+{
+	return false;
+}
+
+bool CCodeGen_Wasm::SupportsPairedStores() const
+{
+	return false;
+}
+
+bool CCodeGen_Wasm::SupportsLoopRegisters() const
+{
+	return false;
+}
+
+bool CCodeGen_Wasm::SupportsMdLaneOps() const
+{
+	return true;
+}
+
+unsigned int CCodeGen_Wasm::GetOperationCost(OPERATION op) const
+{
+	switch(op)
+	{
+	case OP_MUL:
+	case OP_MULS:
+		//Operands need to be extended to 64-bits
+		return 3;
+	case OP_DIV:
+	case OP_DIVS:
+		return 10;
+	case OP_MERGETO64:
+		return 3;
+	default:
+		return 1;
+	}
+}
+
 uint32 CCodeGen_Wasm::GetPointerSize() const
 {
 	return 4;
@@ -524,8 +609,11 @@ void CCodeGen_Wasm::BuildLabelFlows(const StatementList& statements)
 
 void CCodeGen_Wasm::PrepareSignatures(CWasmModuleBuilder& moduleBuilder, const StatementList& statements)
 {
-	//Register this function's signature
-	RegisterSignature(moduleBuilder, "vi");
+	//Register this function's signature (first in the type section, shared by all functions of the module)
+	if(m_signatures.empty())
+	{
+		RegisterSignature(moduleBuilder, "vi");
+	}
 
 	for(const auto& statement : statements)
 	{
@@ -534,6 +622,8 @@ void CCodeGen_Wasm::PrepareSignatures(CWasmModuleBuilder& moduleBuilder, const S
 		auto src1 = statement.src1->GetSymbol().get();
 		assert(src1->m_type == SYM_CONSTANTPTR);
 
+		if(m_moduleFunctions.find(src1->GetConstantPtr()) != std::end(m_moduleFunctions)) continue;
+
 		auto fctInfo = CWasmFunctionRegistry::FindFunction(src1->m_valueLow);
 		assert(fctInfo);
 
@@ -589,11 +679,36 @@ void CCodeGen_Wasm::RegisterSignature(CWasmModuleBuilder& moduleBuilder, std::st
 
 void CCodeGen_Wasm::PrepareLocalVars(const StatementList& statements)
 {
+	uint32 registerI32Count = 0;
+	uint32 registerF32Count = 0;
+	uint32 registerV128Count = 0;
+
 	for(const auto& statement : statements)
 	{
 		statement.VisitOperands(
-		    [this](const SymbolRefPtr& symbolRef, bool isDef) {
+		    [&](const SymbolRefPtr& symbolRef, bool isDef) {
 			    auto symbol = symbolRef->GetSymbol();
+			    if(symbol->IsRegister())
+			    {
+				    uint32 registerCount = symbol->m_valueLow + 1;
+				    switch(symbol->m_type)
+				    {
+				    case SYM_REGISTER:
+				    case SYM_REG_REFERENCE:
+					    registerI32Count = std::max(registerI32Count, registerCount);
+					    break;
+				    case SYM_FP_REGISTER32:
+					    registerF32Count = std::max(registerF32Count, registerCount);
+					    break;
+				    case SYM_REGISTER128:
+					    registerV128Count = std::max(registerV128Count, registerCount);
+					    break;
+				    default:
+					    assert(false);
+					    break;
+				    }
+				    return;
+			    }
 			    if(!symbol->IsTemporary()) return;
 			    auto temporaryInstance = std::make_pair(symbol->m_type, symbol->m_stackLocation);
 			    if(m_temporaryLocations.find(temporaryInstance) != std::end(m_temporaryLocations)) return;
@@ -627,6 +742,16 @@ void CCodeGen_Wasm::PrepareLocalVars(const StatementList& statements)
 			    }
 		    });
 	}
+
+	//Registers come after temporaries of the same type
+	m_registerI32Base = m_localI32Count;
+	m_localI32Count += registerI32Count;
+
+	m_registerF32Base = m_localF32Count;
+	m_localF32Count += registerF32Count;
+
+	m_registerV128Base = m_localV128Count;
+	m_localV128Count += registerV128Count;
 }
 
 uint32 CCodeGen_Wasm::GetTemporaryLocation(CSymbol* symbol) const
@@ -663,6 +788,34 @@ uint32 CCodeGen_Wasm::GetTemporaryLocation(CSymbol* symbol) const
 	return localIdx;
 }
 
+uint32 CCodeGen_Wasm::GetRegisterLocation(CSymbol* symbol) const
+{
+	assert(symbol->IsRegister());
+	uint32 registerId = symbol->m_valueLow;
+
+	//First local is the function's parameter
+	uint32 localIdx = 0;
+
+	switch(symbol->m_type)
+	{
+	case SYM_REGISTER:
+	case SYM_REG_REFERENCE:
+		localIdx = m_registerI32Base + registerId + 1;
+		break;
+	case SYM_FP_REGISTER32:
+		localIdx = m_registerF32Base + registerId + m_localI32Count + m_localI64Count + 1;
+		break;
+	case SYM_REGISTER128:
+		localIdx = m_registerV128Base + registerId + m_localI32Count + m_localI64Count + m_localF32Count + 1;
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	return localIdx;
+}
+
 void CCodeGen_Wasm::PushContext()
 {
 	//Context is the first param
@@ -670,6 +823,22 @@ void CCodeGen_Wasm::PushContext()
 	m_functionStream.Write8(0x00);
 }
 
+void CCodeGen_Wasm::PushRegister(CSymbol* symbol)
+{
+	uint32 localIdx = GetRegisterLocation(symbol);
+
+	m_functionStream.Write8(Wasm::INST_LOCAL_GET);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
+}
+
+void CCodeGen_Wasm::PullRegister(CSymbol* symbol)
+{
+	uint32 localIdx = GetRegisterLocation(symbol);
+
+	m_functionStream.Write8(Wasm::INST_LOCAL_SET);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
+}
+
 void CCodeGen_Wasm::PushRelativeAddress(CSymbol* symbol)
 {
 	assert(
@@ -758,6 +927,12 @@ void CCodeGen_Wasm::PrepareSymbolUse(CSymbol* symbol)
 {
 	switch(symbol->m_type)
 	{
+	case SYM_REGISTER:
+	case SYM_REG_REFERENCE:
+	case SYM_FP_REGISTER32:
+	case SYM_REGISTER128:
+		PushRegister(symbol);
+		break;
 	case SYM_RELATIVE:
 		PushRelative(symbol);
 		break;
@@ -812,6 +987,13 @@ void CCodeGen_Wasm::PrepareSymbolDef(CSymbol* symbol)
 	case SYM_FP_RELATIVE32:
 		PushRelativeAddress(symbol);
 		break;
+	case SYM_REL_REFERENCE:
+		PushRelativeRefAddress(symbol);
+		break;
+	case SYM_REGISTER:
+	case SYM_REG_REFERENCE:
+	case SYM_FP_REGISTER32:
+	case SYM_REGISTER128:
 	case SYM_TEMPORARY:
 	case SYM_TEMPORARY64:
 	case SYM_TEMPORARY128:
@@ -828,7 +1010,14 @@ void CCodeGen_Wasm::CommitSymbol(CSymbol* symbol)
 {
 	switch(symbol->m_type)
 	{
+	case SYM_REGISTER:
+	case SYM_REG_REFERENCE:
+	case SYM_FP_REGISTER32:
+	case SYM_REGISTER128:
+		PullRegister(symbol);
+		break;
 	case SYM_RELATIVE:
+	case SYM_REL_REFERENCE:
 		m_functionStream.Write8(Wasm::INST_I32_STORE);
 		m_functionStream.Write8(0x02);
 		m_functionStream.Write8(0x00);
@@ -1111,6 +1300,16 @@ void CCodeGen_Wasm::Emit_Call(const STATEMENT& statement)
 		m_params.pop();
 	}
 
+	auto moduleFunctionIterator = m_moduleFunctions.find(src1->GetConstantPtr());
+	if(moduleFunctionIterator != std::end(m_moduleFunctions))
+	{
+		//Functions of the same module share our signature and can be called directly
+		assert(paramCount == 1);
+		m_functionStream.Write8(Wasm::INST_CALL);
+		CWasmModuleBuilder::WriteULeb128(m_functionStream, moduleFunctionIterator->second);
+		return;
+	}
+
 	auto fctInfo = CWasmFunctionRegistry::FindFunction(src1->m_valueLow);
 	auto sigIdxIterator = m_signatures.find(fctInfo->signature);
 	assert(sigIdxIterator != std::end(m_signatures));
@@ -1130,6 +1329,12 @@ void CCodeGen_Wasm::Emit_RetVal_Tmp(const STATEMENT& statement)
 	PullTemporary(dst);
 }
 
+void CCodeGen_Wasm::Emit_RetVal_Reg(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	PullRegister(dst);
+}
+
 void CCodeGen_Wasm::Emit_ExternJmp(const STATEMENT& statement)
 {
 	//Not really supported, but can be used with some caveats
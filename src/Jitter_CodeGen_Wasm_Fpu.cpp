@@ -95,6 +95,24 @@ void CCodeGen_Wasm::Emit_Fp_Cmp_AnyMemMem(const STATEMENT& statement)
 	CommitSymbol(dst);
 }
 
+void CCodeGen_Wasm::Emit_Fp_MulAdd_MemMemMemMem(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	PrepareSymbolDef(dst);
+	PrepareSymbolUse(src1);
+	PrepareSymbolUse(src2);
+	PrepareSymbolUse(src3);
+
+	m_functionStream.Write8(Wasm::INST_F32_MUL);
+	m_functionStream.Write8(Wasm::INST_F32_ADD);
+
+	CommitSymbol(dst);
+}
+
 void CCodeGen_Wasm::Emit_Fp_Rcpl_MemMem(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -181,15 +199,21 @@ void CCodeGen_Wasm::Emit_Fp_ToSingleI32_MemMem(const STATEMENT& statement)
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	assert(src1->m_type == SYM_FP_RELATIVE32);
-
 	PrepareSymbolDef(dst);
 
-	//Can't use PrepareSymbolUse here because src1 is a f32 and we need an i32
-	PushRelativeAddress(src1);
-	m_functionStream.Write8(Wasm::INST_I32_LOAD);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	//src1 is a f32 holding an i32
+	if(src1->m_type == SYM_FP_RELATIVE32)
+	{
+		PushRelativeAddress(src1);
+		m_functionStream.Write8(Wasm::INST_I32_LOAD);
+		m_functionStream.Write8(0x02);
+		m_functionStream.Write8(0x00);
+	}
+	else
+	{
+		PrepareSymbolUse(src1);
+		m_functionStream.Write8(Wasm::INST_I32_REINTERPRET_F32);
+	}
 
 	m_functionStream.Write8(Wasm::INST_F32_CONVERT_I32_S);
 
@@ -201,26 +225,31 @@ void CCodeGen_Wasm::Emit_Fp_ToInt32TruncS_MemMem(const STATEMENT& statement)
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	assert(dst->m_type == SYM_FP_RELATIVE32);
-
 	PrepareSymbolDef(dst);
 	PrepareSymbolUse(src1);
 
 	m_functionStream.Write8(Wasm::INST_PREFIX_FC);
 	m_functionStream.Write8(Wasm::INST_I32_TRUNC_SAT_F32_S);
 
-	//Can't use CommitSymbol here since we got a i32 on the stack and our dst symbol is a f32.
-	m_functionStream.Write8(Wasm::INST_I32_STORE);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	//We got a i32 on the stack and our dst symbol is a f32.
+	if(dst->m_type == SYM_FP_RELATIVE32)
+	{
+		m_functionStream.Write8(Wasm::INST_I32_STORE);
+		m_functionStream.Write8(0x02);
+		m_functionStream.Write8(0x00);
+	}
+	else
+	{
+		m_functionStream.Write8(Wasm::INST_F32_REINTERPRET_I32);
+		CommitSymbol(dst);
+	}
 }
 
-void CCodeGen_Wasm::Emit_Fp_LdCst_TmpCst(const STATEMENT& statement)
+void CCodeGen_Wasm::Emit_Fp_LdCst_VarCst(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	assert(dst->m_type == SYM_FP_TEMPORARY32);
 	assert(src1->m_type == SYM_CONSTANT);
 
 	PrepareSymbolDef(dst);
@@ -239,29 +268,35 @@ void CCodeGen_Wasm::Emit_Fp_SetRoundingMode_Cst(const STATEMENT& statement)
 // clang-format off
 CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_fpuConstMatchers[] =
 {
-	{ OP_FP_ADD_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_ADD>       },
-	{ OP_FP_SUB_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_SUB>       },
-	{ OP_FP_MUL_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MUL>       },
-	{ OP_FP_DIV_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_DIV>       },
+	{ OP_MOV,                MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Mov_VarAny                              },
+
+	{ OP_FP_ADD_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_ADD>       },
+	{ OP_FP_SUB_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_SUB>       },
+	{ OP_FP_MUL_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MUL>       },
+	{ OP_FP_DIV_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_DIV>       },
+
+	//WebAssembly has no fused multiply-add, computed with separate roundings
+	{ OP_FP_MULADD_S,        MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, &CCodeGen_Wasm::Emit_Fp_MulAdd_MemMemMemMem },
+	{ OP_FP_FUSEDMULADD_S,   MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, &CCodeGen_Wasm::Emit_Fp_MulAdd_MemMemMemMem },
 
-	{ OP_FP_CMP_S,           MATCH_ANY,              MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Cmp_AnyMemMem                        },
+	{ OP_FP_CMP_S,           MATCH_ANY,              MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Cmp_AnyMemMem                        },
 
-	{ OP_FP_MIN_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MIN>       },
-	{ OP_FP_MAX_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MAX>       },
+	{ OP_FP_MIN_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MIN>       },
+	{ OP_FP_MAX_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MAX>       },
 
-	{ OP_FP_RCPL_S,          MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Rcpl_MemMem                          },
-	{ OP_FP_SQRT_S,          MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_SQRT>         },
-	{ OP_FP_RSQRT_S,         MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Rsqrt_MemMem                         },
+	{ OP_FP_RCPL_S,          MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Rcpl_MemMem                          },
+	{ OP_FP_SQRT_S,          MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_SQRT>         },
+	{ OP_FP_RSQRT_S,         MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Rsqrt_MemMem                         },
 
-	{ OP_FP_CLAMP_S,         MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Clamp_MemMem                         },
+	{ OP_FP_CLAMP_S,         MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Clamp_MemMem                         },
 
-	{ OP_FP_ABS_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_ABS>          },
-	{ OP_FP_NEG_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_NEG>          },
+	{ OP_FP_ABS_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_ABS>          },
+	{ OP_FP_NEG_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_NEG>          },
 
-	{ OP_FP_TOSINGLE_I32,    MATCH_FP_MEMORY32,      MATCH_FP_RELATIVE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_ToSingleI32_MemMem                   },
-	{ OP_FP_TOINT32_TRUNC_S, MATCH_FP_RELATIVE32,    MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_ToInt32TruncS_MemMem                 },
+	{ OP_FP_TOSINGLE_I32,    MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_ToSingleI32_MemMem                   },
+	{ OP_FP_TOINT32_TRUNC_S, MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_ToInt32TruncS_MemMem                 },
 
-	{ OP_FP_LDCST,           MATCH_FP_TEMPORARY32,   MATCH_CONSTANT,      MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_LdCst_TmpCst                         },
+	{ OP_FP_LDCST,           MATCH_FP_VARIABLE32,    MATCH_CONSTANT,      MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_LdCst_VarCst                         },
 
 	{ OP_FP_SETROUNDINGMODE, MATCH_NIL,              MATCH_CONSTANT,      MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_SetRoundingMode_Cst                  },
 
@@ -37,9 +37,6 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_constMatchers[] =
 	{ OP_NOT, MATCH_MEMORY,   MATCH_REGISTER, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Not_MemReg },
 	{ OP_NOT, MATCH_MEMORY,   MATCH_MEMORY,   MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Not_MemMem },
 
-	{ OP_LZC, MATCH_REGISTER, MATCH_VARIABLE, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Lzc_RegVar },
-	{ OP_LZC, MATCH_MEMORY,   MATCH_VARIABLE, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Lzc_MemVar },
-
 	SHIFT_CONST_MATCHERS(OP_SRL, SHIFTOP_SRL)
 	SHIFT_CONST_MATCHERS(OP_SRA, SHIFTOP_SRA)
 	SHIFT_CONST_MATCHERS(OP_SLL, SHIFTOP_SLL)
@@ -83,6 +80,7 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_constMatchers[] =
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_REGISTER, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64RegCst },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_MEMORY,   MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64MemReg },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_MEMORY,   MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64MemMem },
+	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_MEMORY,   MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64MemCst },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_CONSTANT, MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64CstReg },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_CONSTANT, MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64CstMem },
 
@@ -113,6 +111,39 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_constMatchers[] =
 
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
+
+CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_noBmi2ConstMatchers[] =
+{
+	SHIFT_VAR_CONST_MATCHERS(OP_SRL, SHIFTOP_SRL)
+	SHIFT_VAR_CONST_MATCHERS(OP_SRA, SHIFTOP_SRA)
+	SHIFT_VAR_CONST_MATCHERS(OP_SLL, SHIFTOP_SLL)
+
+	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
+};
+
+CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_bmi2ConstMatchers[] =
+{
+	SHIFT_VAR_BMI2_CONST_MATCHERS(OP_SRL, SHIFTOP_SRL)
+	SHIFT_VAR_BMI2_CONST_MATCHERS(OP_SRA, SHIFTOP_SRA)
+	SHIFT_VAR_BMI2_CONST_MATCHERS(OP_SLL, SHIFTOP_SLL)
+
+	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
+};
+
+CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_noLzcntConstMatchers[] =
+{
+	{ OP_LZC, MATCH_REGISTER, MATCH_VARIABLE, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Lzc_RegVar },
+	{ OP_LZC, MATCH_MEMORY,   MATCH_VARIABLE, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Lzc_MemVar },
+
+	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
+};
+
+CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_lzcntConstMatchers[] =
+{
+	{ OP_LZC, MATCH_VARIABLE, MATCH_VARIABLE, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Lzc_Lzcnt_VarVar },
+
+	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
+};
 // clang-format on
 
 CCodeGen_x86::CCodeGen_x86(CX86CpuFeatures cpuFeatures)
@@ -121,6 +152,24 @@ CCodeGen_x86::CCodeGen_x86(CX86CpuFeatures cpuFeatures)
 	InsertMatchers(g_constMatchers);
 	InsertMatchers(g_fpuConstMatchers);
 
+	if(cpuFeatures.hasBmi2)
+	{
+		InsertMatchers(g_bmi2ConstMatchers);
+	}
+	else
+	{
+		InsertMatchers(g_noBmi2ConstMatchers);
+	}
+
+	if(cpuFeatures.hasLzcnt)
+	{
+		InsertMatchers(g_lzcntConstMatchers);
+	}
+	else
+	{
+		InsertMatchers(g_noLzcntConstMatchers);
+	}
+
 	if(cpuFeatures.hasAvx)
 	{
 		InsertMatchers(g_fpuAvxConstMatchers);
@@ -134,6 +183,17 @@ CCodeGen_x86::CCodeGen_x86(CX86CpuFeatures cpuFeatures)
 		{
 			InsertMatchers(g_mdNoAvx2ConstMatchers);
 		}
+
+		if(cpuFeatures.hasFma)
+		{
+			InsertMatchers(g_fpuFmaConstMatchers);
+			InsertMatchers(g_mdFmaConstMatchers);
+		}
+		else
+		{
+			InsertMatchers(g_fpuNoFmaConstMatchers);
+			InsertMatchers(g_mdNoFmaConstMatchers);
+		}
 	}
 	else
 	{
@@ -167,6 +227,7 @@ void CCodeGen_x86::GenerateCode(const StatementList& statements, unsigned int st
 	assert(m_labels.empty());
 
 	m_registerUsage = GetRegisterUsage(statements);
+	m_loopHeadLabels = GetLoopHeadLabels(statements);
 
 	//Align stacksize
 	stackSize = (stackSize + 0xF) & ~0xF;
@@ -212,12 +273,13 @@ void CCodeGen_x86::GenerateCode(const StatementList& statements, unsigned int st
 	{
 		for(const auto& symbolRefLabel : m_symbolReferenceLabels)
 		{
-			uint32 offset = m_assembler.GetLabelOffset(symbolRefLabel.second);
-			m_externalSymbolReferencedHandler(symbolRefLabel.first, offset, CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER);
+			uint32 offset = m_assembler.GetLabelOffset(symbolRefLabel.label);
+			m_externalSymbolReferencedHandler(symbolRefLabel.symbol, offset, symbolRefLabel.type);
 		}
 	}
 
 	m_labels.clear();
+	m_loopHeadLabels.clear();
 	m_symbolReferenceLabels.clear();
 }
 
@@ -261,6 +323,45 @@ bool CCodeGen_x86::SupportsCmpSelect() const
 	return true;
 }
 
+bool CCodeGen_x86::SupportsBitfieldOps() const
+{
+	return false;
+}
+
+bool CCodeGen_x86::SupportsPairedStores() const
+{
+	return false;
+}
+
+bool CCodeGen_x86::SupportsLoopRegisters() const
+{
+	return true;
+}
+
+bool CCodeGen_x86::SupportsMdLaneOps() const
+{
+	//Without insertps, lanes are shuffled in and out of position 0, which costs more than going through memory
+	return m_cpuFeatures.hasSse41 || m_cpuFeatures.hasAvx;
+}
+
+unsigned int CCodeGen_x86::GetOperationCost(OPERATION op) const
+{
+	switch(op)
+	{
+	case OP_MUL:
+	case OP_MULS:
+		//mov, mul and result stored to memory
+		return 5;
+	case OP_DIV:
+	case OP_DIVS:
+		return 25;
+	case OP_MERGETO64:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
 CX86Assembler::LABEL CCodeGen_x86::GetLabel(uint32 blockId)
 {
 	CX86Assembler::LABEL result;
@@ -486,7 +587,14 @@ CX86Assembler::CAddress CCodeGen_x86::MakeMemory64SymbolHiAddress(CSymbol* symbo
 void CCodeGen_x86::MarkLabel(const STATEMENT& statement)
 {
 	CX86Assembler::LABEL label = GetLabel(statement.jmpBlock);
-	m_assembler.MarkLabel(label);
+	if(m_loopHeadLabels.find(statement.jmpBlock) != std::end(m_loopHeadLabels))
+	{
+		m_assembler.MarkAlignedLabel(label, LOOP_ALIGNMENT);
+	}
+	else
+	{
+		m_assembler.MarkLabel(label);
+	}
 }
 
 void CCodeGen_x86::Emit_Nop(const STATEMENT& statement)
@@ -603,6 +711,25 @@ void CCodeGen_x86::Emit_Lzc_MemVar(const STATEMENT& statement)
 	m_assembler.MovGd(MakeMemorySymbolAddress(dst), dstRegister);
 }
 
+void CCodeGen_x86::Emit_Lzc_Lzcnt_VarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDef(dst, CX86Assembler::rAX);
+	auto tmpRegister = CX86Assembler::rDX;
+
+	//Invert negative values to count leading ones, lzcnt yields 32 for 0
+	m_assembler.MovEd(tmpRegister, MakeVariableSymbolAddress(src1));
+	m_assembler.MovEd(dstRegister, CX86Assembler::MakeRegisterAddress(tmpRegister));
+	m_assembler.SarEd(CX86Assembler::MakeRegisterAddress(dstRegister), 31);
+	m_assembler.XorEd(tmpRegister, CX86Assembler::MakeRegisterAddress(dstRegister));
+	m_assembler.LzcntEd(dstRegister, CX86Assembler::MakeRegisterAddress(tmpRegister));
+	m_assembler.SubId(CX86Assembler::MakeRegisterAddress(dstRegister), 1);
+
+	CommitSymbolRegister(dst, dstRegister);
+}
+
 void CCodeGen_x86::Emit_Mov_RegReg(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -738,6 +865,21 @@ void CCodeGen_x86::Emit_MergeTo64_Mem64MemMem(const STATEMENT& statement)
 	m_assembler.MovGd(MakeMemory64SymbolHiAddress(dst), CX86Assembler::rDX);
 }
 
+void CCodeGen_x86::Emit_MergeTo64_Mem64MemCst(const STATEMENT& statement)
+{
+	CSymbol* dst = statement.dst->GetSymbol().get();
+	CSymbol* src1 = statement.src1->GetSymbol().get();
+	CSymbol* src2 = statement.src2->GetSymbol().get();
+
+	assert(src2->m_type == SYM_CONSTANT);
+
+	m_assembler.MovEd(CX86Assembler::rAX, MakeMemorySymbolAddress(src1));
+	m_assembler.MovId(CX86Assembler::rDX, src2->m_valueLow);
+
+	m_assembler.MovGd(MakeMemory64SymbolLoAddress(dst), CX86Assembler::rAX);
+	m_assembler.MovGd(MakeMemory64SymbolHiAddress(dst), CX86Assembler::rDX);
+}
+
 void CCodeGen_x86::Emit_MergeTo64_Mem64CstReg(const STATEMENT& statement)
 {
 	CSymbol* dst = statement.dst->GetSymbol().get();
@@ -209,6 +209,9 @@ void CCodeGen_x86_32::Emit_Prolog(const StatementList& statements, unsigned int
 				}
 			}
 			break;
+			case OP_MD_LDCST:
+				m_literalOffsets.insert(std::make_pair(GetMdLiteral(statement), -1));
+				break;
 
 			default:
 				break;
@@ -453,7 +456,7 @@ void CCodeGen_x86_32::Emit_Call(const STATEMENT& statement)
 	m_assembler.MovId(CX86Assembler::rAX, src1->m_valueLow);
 	auto symbolRefLabel = m_assembler.CreateLabel();
 	m_assembler.MarkLabel(symbolRefLabel, -4);
-	m_symbolReferenceLabels.push_back(std::make_pair(src1->GetConstantPtr(), symbolRefLabel));
+	m_symbolReferenceLabels.push_back({src1->GetConstantPtr(), symbolRefLabel});
 	m_assembler.CallEd(CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX));
 
 	if(m_hasImplicitRetValueParam && m_implicitRetValueParamFixUpRequired)
@@ -498,7 +501,7 @@ void CCodeGen_x86_32::Emit_ExternJmp(const STATEMENT& statement)
 	m_assembler.MovId(CX86Assembler::rAX, src1->m_valueLow);
 	auto symbolRefLabel = m_assembler.CreateLabel();
 	m_assembler.MarkLabel(symbolRefLabel, -4);
-	m_symbolReferenceLabels.push_back(std::make_pair(src1->GetConstantPtr(), symbolRefLabel));
+	m_symbolReferenceLabels.push_back({src1->GetConstantPtr(), symbolRefLabel});
 	m_assembler.JmpEd(CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX));
 }
 
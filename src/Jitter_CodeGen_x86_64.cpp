@@ -310,6 +310,11 @@ void CCodeGen_x86_64::SetPlatformAbi(PLATFORM_ABI platformAbi)
 	}
 }
 
+void CCodeGen_x86_64::SetGenerateRelocatableCalls(bool generateRelocatableCalls)
+{
+	m_generateRelocatableCalls = generateRelocatableCalls;
+}
+
 unsigned int CCodeGen_x86_64::GetAvailableRegisterCount() const
 {
 	return m_maxRegisters;
@@ -548,10 +553,20 @@ void CCodeGen_x86_64::Emit_Call(const STATEMENT& statement)
 		paramSpillOffset += emitter(m_paramRegs[i], paramSpillOffset);
 	}
 
+	if(m_generateRelocatableCalls)
+	{
+		//Displacement is filled in by the linker
+		m_assembler.CallJd(0);
+		auto symbolRefLabel = m_assembler.CreateLabel();
+		m_assembler.MarkLabel(symbolRefLabel, -4);
+		m_symbolReferenceLabels.push_back({src1->GetConstantPtr(), symbolRefLabel, SYMBOL_REF_TYPE::X86_64_PCRELATIVE});
+		return;
+	}
+
 	m_assembler.MovIq(CX86Assembler::rAX, src1->GetConstantPtr());
 	auto symbolRefLabel = m_assembler.CreateLabel();
 	m_assembler.MarkLabel(symbolRefLabel, -8);
-	m_symbolReferenceLabels.push_back(std::make_pair(src1->GetConstantPtr(), symbolRefLabel));
+	m_symbolReferenceLabels.push_back({src1->GetConstantPtr(), symbolRefLabel});
 	m_assembler.CallEd(CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX));
 }
 
@@ -599,10 +614,19 @@ void CCodeGen_x86_64::Emit_ExternJmp(const STATEMENT& statement)
 
 	m_assembler.MovEq(m_paramRegs[0], CX86Assembler::MakeRegisterAddress(g_baseRegister));
 	Emit_Epilog();
+	if(m_generateRelocatableCalls)
+	{
+		m_assembler.JmpJd(0);
+		auto symbolRefLabel = m_assembler.CreateLabel();
+		m_assembler.MarkLabel(symbolRefLabel, -4);
+		m_symbolReferenceLabels.push_back({src1->GetConstantPtr(), symbolRefLabel, SYMBOL_REF_TYPE::X86_64_PCRELATIVE});
+		return;
+	}
+
 	m_assembler.MovIq(CX86Assembler::rAX, src1->GetConstantPtr());
 	auto symbolRefLabel = m_assembler.CreateLabel();
 	m_assembler.MarkLabel(symbolRefLabel, -8);
-	m_symbolReferenceLabels.push_back(std::make_pair(src1->GetConstantPtr(), symbolRefLabel));
+	m_symbolReferenceLabels.push_back({src1->GetConstantPtr(), symbolRefLabel});
 	m_assembler.JmpEd(CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX));
 }
 
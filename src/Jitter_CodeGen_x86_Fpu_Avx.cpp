@@ -67,6 +67,52 @@ void CCodeGen_x86::Emit_Fp32_Avx_VarVarVar(const STATEMENT& statement)
 	CommitSymbolRegisterFp32Avx(dst, dstRegister);
 }
 
+void CCodeGen_x86::Emit_Fp_Avx_MulAddS_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefFp32(dst, CX86Assembler::xMM0);
+	auto src1Register = PrepareSymbolRegisterUseFp32Avx(src1, CX86Assembler::xMM1);
+	auto src2Register = PrepareSymbolRegisterUseFp32Avx(src2, CX86Assembler::xMM2);
+	auto mulRegister = CX86Assembler::xMM2;
+
+	m_assembler.VmulssEd(mulRegister, src2Register, MakeVariableFp32SymbolAddress(src3));
+	m_assembler.VaddssEd(dstRegister, src1Register, CX86Assembler::MakeXmmRegisterAddress(mulRegister));
+
+	CommitSymbolRegisterFp32Avx(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Fp_Fma_MulAddS_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefFp32(dst, CX86Assembler::xMM0);
+	auto src2Register = PrepareSymbolRegisterUseFp32Avx(src2, CX86Assembler::xMM2);
+
+	//vfmadd231 accumulates in its destination, make sure we don't clobber a multiplicand
+	auto resultRegister = (dst->Equals(src2) || dst->Equals(src3)) ? CX86Assembler::xMM0 : dstRegister;
+	auto src1Register = PrepareSymbolRegisterUseFp32Avx(src1, resultRegister);
+	if(src1Register != resultRegister)
+	{
+		m_assembler.VmovapsVo(resultRegister, CX86Assembler::MakeXmmRegisterAddress(src1Register));
+	}
+
+	m_assembler.Vfmadd231ssEd(resultRegister, src2Register, MakeVariableFp32SymbolAddress(src3));
+
+	if(resultRegister != dstRegister)
+	{
+		m_assembler.VmovapsVo(dstRegister, CX86Assembler::MakeXmmRegisterAddress(resultRegister));
+	}
+
+	CommitSymbolRegisterFp32Avx(dst, dstRegister);
+}
+
 void CCodeGen_x86::Emit_Fp32_Avx_Mov_RegMem(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -311,6 +357,8 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_fpuAvxConstMatchers[] =
 	{ OP_FP_MAX_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_x86::Emit_Fp32_Avx_VarVarVar<FP32OP_MAX> },
 	{ OP_FP_MIN_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_x86::Emit_Fp32_Avx_VarVarVar<FP32OP_MIN> },
 
+	{ OP_FP_MULADD_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, &CCodeGen_x86::Emit_Fp_Avx_MulAddS_VarVarVarVar },
+
 	{ OP_FP_CMP_S, MATCH_VARIABLE, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_x86::Emit_Fp_Avx_CmpS_VarVarVar },
 
 	{ OP_FP_SQRT_S,  MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Fp32_Avx_VarVar<FP32OP_SQRT> },
@@ -336,4 +384,18 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_fpuAvxConstMatchers[] =
 
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
+
+CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_fpuNoFmaConstMatchers[] =
+{
+	{ OP_FP_FUSEDMULADD_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, &CCodeGen_x86::Emit_Fp_Avx_MulAddS_VarVarVarVar },
+
+	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
+};
+
+CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_fpuFmaConstMatchers[] =
+{
+	{ OP_FP_FUSEDMULADD_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, &CCodeGen_x86::Emit_Fp_Fma_MulAddS_VarVarVarVar },
+
+	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
+};
 // clang-format on
@@ -152,6 +152,24 @@ void CCodeGen_x86::Emit_Fp32_SingleOp_MemVar(const STATEMENT& statement)
 	m_assembler.MovssEd(MakeMemoryFp32SymbolAddress(dst), resultRegister);
 }
 
+void CCodeGen_x86::Emit_Fp_MulAddS_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefFp32(dst, CX86Assembler::xMM0);
+	auto mulRegister = CX86Assembler::xMM1;
+
+	m_assembler.MovssEd(mulRegister, MakeVariableFp32SymbolAddress(src2));
+	m_assembler.MulssEd(mulRegister, MakeVariableFp32SymbolAddress(src3));
+	m_assembler.MovssEd(dstRegister, MakeVariableFp32SymbolAddress(src1));
+	m_assembler.AddssEd(dstRegister, CX86Assembler::MakeXmmRegisterAddress(mulRegister));
+
+	CommitSymbolRegisterFp32Sse(dst, dstRegister);
+}
+
 void CCodeGen_x86::Emit_Fp32_Mov_RegMem(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -413,6 +431,10 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_fpuSseConstMatchers[] =
 	FP_CONST_MATCHERS_3OPS(OP_FP_MAX_S, FP32OP_MAX)
 	FP_CONST_MATCHERS_3OPS(OP_FP_MIN_S, FP32OP_MIN)
 
+	//Without FMA, fused multiply-add is computed with separate roundings
+	{ OP_FP_MULADD_S,      MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, &CCodeGen_x86::Emit_Fp_MulAddS_VarVarVarVar },
+	{ OP_FP_FUSEDMULADD_S, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, &CCodeGen_x86::Emit_Fp_MulAddS_VarVarVarVar },
+
 	{ OP_FP_CMP_S, MATCH_VARIABLE, MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32, MATCH_NIL, &CCodeGen_x86::Emit_Fp_CmpS_VarVarVar },
 	{ OP_FP_CMP_S, MATCH_VARIABLE, MATCH_FP_MEMORY32,   MATCH_CONSTANT,      MATCH_NIL, &CCodeGen_x86::Emit_Fp_CmpS_VarMemCst },
 
@@ -422,6 +422,52 @@ void CCodeGen_x86::Emit_Md_Avx_ClampS_VarVar(const STATEMENT& statement)
 	CommitSymbolRegisterMdAvx(dst, dstRegister);
 }
 
+void CCodeGen_x86::Emit_Md_Avx_MulAddS_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+	auto src1Register = PrepareSymbolRegisterUseMdAvx(src1, CX86Assembler::xMM1);
+	auto src2Register = PrepareSymbolRegisterUseMdAvx(src2, CX86Assembler::xMM2);
+	auto mulRegister = CX86Assembler::xMM2;
+
+	m_assembler.VmulpsVo(mulRegister, src2Register, MakeVariable128SymbolAddress(src3));
+	m_assembler.VaddpsVo(dstRegister, src1Register, CX86Assembler::MakeXmmRegisterAddress(mulRegister));
+
+	CommitSymbolRegisterMdAvx(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Md_Fma_MulAddS_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+	auto src2Register = PrepareSymbolRegisterUseMdAvx(src2, CX86Assembler::xMM2);
+
+	//vfmadd231 accumulates in its destination, make sure we don't clobber a multiplicand
+	auto resultRegister = (dst->Equals(src2) || dst->Equals(src3)) ? CX86Assembler::xMM0 : dstRegister;
+	auto src1Register = PrepareSymbolRegisterUseMdAvx(src1, resultRegister);
+	if(src1Register != resultRegister)
+	{
+		m_assembler.VmovapsVo(resultRegister, CX86Assembler::MakeXmmRegisterAddress(src1Register));
+	}
+
+	m_assembler.Vfmadd231psVo(resultRegister, src2Register, MakeVariable128SymbolAddress(src3));
+
+	if(resultRegister != dstRegister)
+	{
+		m_assembler.VmovapsVo(dstRegister, CX86Assembler::MakeXmmRegisterAddress(resultRegister));
+	}
+
+	CommitSymbolRegisterMdAvx(dst, dstRegister);
+}
+
 void CCodeGen_x86::Emit_Md_Avx_PackHB_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -624,6 +670,71 @@ void CCodeGen_x86::Emit_Md_Avx_ExpandW_VarVarCst(const STATEMENT& statement)
 	CommitSymbolRegisterMdAvx(dst, dstRegister);
 }
 
+void CCodeGen_x86::Emit_Md_Avx_LdCst_VarCstCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+
+	m_assembler.VmovapsVo(dstRegister, MakeConstant128Address(GetMdLiteral(statement)));
+
+	CommitSymbolRegisterMdAvx(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Md_Avx_ExtractLaneS_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	assert(src2->m_valueLow < 4);
+
+	auto dstRegister = PrepareSymbolRegisterDefFp32(dst, CX86Assembler::xMM0);
+
+	if(src1->IsRegister() && (src2->m_valueLow == 0))
+	{
+		//Upper lanes of a FP32 register are ignored
+		m_assembler.VmovapsVo(dstRegister, CX86Assembler::MakeXmmRegisterAddress(m_mdRegisters[src1->m_valueLow]));
+	}
+	else if(src1->IsRegister())
+	{
+		auto srcRegister = m_mdRegisters[src1->m_valueLow];
+		m_assembler.VshufpsVo(dstRegister, srcRegister, CX86Assembler::MakeXmmRegisterAddress(srcRegister), g_mdExpandShufPatterns[src2->m_valueLow]);
+	}
+	else
+	{
+		m_assembler.VmovssEd(dstRegister, MakeMemory128SymbolElementAddress(src1, src2->m_valueLow));
+	}
+
+	CommitSymbolRegisterFp32Avx(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Md_Avx_InsertLaneS_VarVarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	uint32 laneIndex = src3->m_valueLow;
+	assert(laneIndex < 4);
+
+	if(!dst->IsRegister() && dst->Equals(src1))
+	{
+		//Vector lives in memory, only the lane needs to be written
+		auto valueRegister = PrepareSymbolRegisterUseFp32Avx(src2, CX86Assembler::xMM1);
+		m_assembler.VmovssEd(MakeMemory128SymbolElementAddress(dst, laneIndex), valueRegister);
+		return;
+	}
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+	auto src1Register = PrepareSymbolRegisterUseMdAvx(src1, CX86Assembler::xMM1);
+
+	m_assembler.VinsertpsVo(dstRegister, src1Register, MakeVariableFp32SymbolAddress(src2), static_cast<uint8>(laneIndex << 4));
+
+	CommitSymbolRegisterMdAvx(dst, dstRegister);
+}
+
 void CCodeGen_x86::Emit_Md_Avx2_ExpandW_VarReg(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -721,6 +832,32 @@ void CCodeGen_x86::Emit_Avx_MergeTo256_MemVarVar(const STATEMENT& statement)
 	m_assembler.VmovdqaVo(MakeTemporary256SymbolElementAddress(dst, 0x10), src2Register);
 }
 
+void CCodeGen_x86::Emit_Md_Avx_ShuffleW_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+
+	m_assembler.VpshufdVo(dstRegister, MakeVariable128SymbolAddress(src1), static_cast<uint8>(src2->m_valueLow));
+
+	CommitSymbolRegisterMdAvx(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Md_Avx_ShuffleB_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+	auto src1Register = PrepareSymbolRegisterUseMdAvx(src1, CX86Assembler::xMM1);
+
+	m_assembler.VpshufbVo(dstRegister, src1Register, MakeConstant128Address(GetMdShuffleByteMask(statement)));
+
+	CommitSymbolRegisterMdAvx(dst, dstRegister);
+}
+
 void CCodeGen_x86::Emit_Md_Avx_Srl256_VarMemVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -909,6 +1046,8 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdAvxConstMatchers[] =
 	{ OP_MD_MUL_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_VarVarVar<MDOP_MULS> },
 	{ OP_MD_DIV_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_VarVarVar<MDOP_DIVS> },
 
+	{ OP_MD_MULADD_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_x86::Emit_Md_Avx_MulAddS_VarVarVarVar },
+
 	{ OP_MD_ABS_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_Abs_VarVar },
 	{ OP_MD_NEG_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_Neg_VarVar },
 
@@ -924,6 +1063,11 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdAvxConstMatchers[] =
 	{ OP_MD_PACK_HB, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_PackHB_VarVarVar, },
 	{ OP_MD_PACK_WH, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_PackWH_VarVarVar, },
 
+	{ OP_MD_SHUFFLE_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT,   MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_ShuffleW_VarVarCst },
+	{ OP_MD_SHUFFLE_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT64, MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_ShuffleB_VarVarCst },
+
+	{ OP_MD_LDCST, MATCH_VARIABLE128, MATCH_CONSTANT64, MATCH_CONSTANT64, MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_LdCst_VarCstCst },
+
 	{ OP_MD_MAKECLIP, MATCH_VARIABLE, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_x86::Emit_Md_Avx_MakeClip_VarVarVarVar },
 	{ OP_MD_MAKESZ,   MATCH_VARIABLE, MATCH_VARIABLE128, MATCH_NIL,         MATCH_NIL,         &CCodeGen_x86::Emit_Md_Avx_MakeSz_VarVar },
 
@@ -933,6 +1077,9 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdAvxConstMatchers[] =
 
 	{ OP_MD_MOV_MASKED, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_MovMasked_VarVarVar },
 
+	{ OP_MD_EXTRACT_LANE_S, MATCH_FP_VARIABLE32, MATCH_VARIABLE128, MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_x86::Emit_Md_Avx_ExtractLaneS_VarVarCst   },
+	{ OP_MD_INSERT_LANE_S,  MATCH_VARIABLE128,   MATCH_VARIABLE128, MATCH_FP_VARIABLE32, MATCH_CONSTANT, &CCodeGen_x86::Emit_Md_Avx_InsertLaneS_VarVarVarCst },
+
 	{ OP_MERGETO256, MATCH_MEMORY256,   MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_x86::Emit_Avx_MergeTo256_MemVarVar },
 	{ OP_MD_SRL256,  MATCH_VARIABLE128, MATCH_MEMORY256,   MATCH_VARIABLE,    MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_Srl256_VarMemVar  },
 	{ OP_MD_SRL256,  MATCH_VARIABLE128, MATCH_MEMORY256,   MATCH_CONSTANT,    MATCH_NIL, &CCodeGen_x86::Emit_Md_Avx_Srl256_VarMemCst  },
@@ -970,4 +1117,18 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdAvx2ConstMatchers[] =
 
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
+
+CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdNoFmaConstMatchers[] =
+{
+	{ OP_MD_FUSEDMULADD_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_x86::Emit_Md_Avx_MulAddS_VarVarVarVar },
+
+	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
+};
+
+CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdFmaConstMatchers[] =
+{
+	{ OP_MD_FUSEDMULADD_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_x86::Emit_Md_Fma_MulAddS_VarVarVarVar },
+
+	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
+};
 // clang-format on
@@ -537,6 +537,24 @@ void CCodeGen_x86::Emit_Md_SubUSW_VarVarVar(const STATEMENT& statement)
 	m_assembler.MovdqaVo(MakeVariable128SymbolAddress(dst), resRegister);
 }
 
+void CCodeGen_x86::Emit_Md_MulAddS_VarVarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+	auto mulRegister = CX86Assembler::xMM1;
+
+	m_assembler.MovapsVo(mulRegister, MakeVariable128SymbolAddress(src2));
+	m_assembler.MulpsVo(mulRegister, MakeVariable128SymbolAddress(src3));
+	m_assembler.MovapsVo(dstRegister, MakeVariable128SymbolAddress(src1));
+	m_assembler.AddpsVo(dstRegister, CX86Assembler::MakeXmmRegisterAddress(mulRegister));
+
+	CommitSymbolRegisterMdSse(dst, dstRegister);
+}
+
 void CCodeGen_x86::Emit_Md_MinW_VarVarVar(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -1017,6 +1035,163 @@ void CCodeGen_x86::Emit_Md_ExpandW_VarVarCst(const STATEMENT& statement)
 	CommitSymbolRegisterMdSse(dst, dstRegister);
 }
 
+void CCodeGen_x86::Emit_Md_LdCst_VarCstCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+
+	m_assembler.MovapsVo(dstRegister, MakeConstant128Address(GetMdLiteral(statement)));
+
+	CommitSymbolRegisterMdSse(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Md_ExtractLaneS_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	assert(src2->m_valueLow < 4);
+
+	auto dstRegister = PrepareSymbolRegisterDefFp32(dst, CX86Assembler::xMM0);
+
+	if(src1->IsRegister() && (src2->m_valueLow == 0))
+	{
+		//Upper lanes of a FP32 register are ignored
+		m_assembler.MovapsVo(dstRegister, CX86Assembler::MakeXmmRegisterAddress(m_mdRegisters[src1->m_valueLow]));
+	}
+	else if(src1->IsRegister())
+	{
+		m_assembler.PshufdVo(dstRegister, CX86Assembler::MakeXmmRegisterAddress(m_mdRegisters[src1->m_valueLow]), g_mdExpandShufPatterns[src2->m_valueLow]);
+	}
+	else
+	{
+		m_assembler.MovssEd(dstRegister, MakeMemory128SymbolElementAddress(src1, src2->m_valueLow));
+	}
+
+	CommitSymbolRegisterFp32Sse(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Md_InsertLaneS_MemVarCst(CSymbol* dst, CSymbol* src, unsigned int laneIndex)
+{
+	//Vector lives in memory, only the lane needs to be written
+	auto valueRegister = CX86Assembler::xMM1;
+	if(src->IsRegister())
+	{
+		valueRegister = m_mdRegisters[src->m_valueLow];
+	}
+	else
+	{
+		m_assembler.MovssEd(valueRegister, MakeMemoryFp32SymbolAddress(src));
+	}
+	m_assembler.MovssEd(MakeMemory128SymbolElementAddress(dst, laneIndex), valueRegister);
+}
+
+void CCodeGen_x86::Emit_Md_InsertLaneS_Sse41_VarVarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	uint32 laneIndex = src3->m_valueLow;
+	assert(laneIndex < 4);
+
+	if(!dst->IsRegister() && dst->Equals(src1))
+	{
+		Emit_Md_InsertLaneS_MemVarCst(dst, src2, laneIndex);
+		return;
+	}
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+
+	if(!dst->Equals(src1))
+	{
+		m_assembler.MovapsVo(dstRegister, MakeVariable128SymbolAddress(src1));
+	}
+
+	m_assembler.InsertpsVo(dstRegister, MakeVariableFp32SymbolAddress(src2), static_cast<uint8>(laneIndex << 4));
+
+	CommitSymbolRegisterMdSse(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Md_ShuffleW_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+
+	m_assembler.PshufdVo(dstRegister, MakeVariable128SymbolAddress(src1), static_cast<uint8>(src2->m_valueLow));
+
+	CommitSymbolRegisterMdSse(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Md_ShuffleB_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto mask = GetMdShuffleByteMask(statement);
+	auto srcRegister = CX86Assembler::xMM1;
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+	auto loRegister = CX86Assembler::rAX;
+	auto hiRegister = CX86Assembler::rDX;
+
+	//No pshufb, build every destination word from the source bytes it needs
+	m_assembler.MovdqaVo(srcRegister, MakeVariable128SymbolAddress(src1));
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		uint64 maskHalf = (i < 4) ? mask.lo : mask.hi;
+		uint8 loIndex = static_cast<uint8>(maskHalf >> ((i % 4) * 16));
+		uint8 hiIndex = static_cast<uint8>(maskHalf >> (((i % 4) * 16) + 8));
+		if(((loIndex & 1) == 0) && (hiIndex == (loIndex + 1)))
+		{
+			m_assembler.PextrwVo(loRegister, srcRegister, loIndex / 2);
+		}
+		else
+		{
+			m_assembler.PextrwVo(loRegister, srcRegister, loIndex / 2);
+			if(loIndex & 1)
+			{
+				m_assembler.ShrEd(CX86Assembler::MakeRegisterAddress(loRegister), 8);
+			}
+			else
+			{
+				m_assembler.AndId(CX86Assembler::MakeRegisterAddress(loRegister), 0xFF);
+			}
+			m_assembler.PextrwVo(hiRegister, srcRegister, hiIndex / 2);
+			if(hiIndex & 1)
+			{
+				m_assembler.AndId(CX86Assembler::MakeRegisterAddress(hiRegister), 0xFF00);
+			}
+			else
+			{
+				m_assembler.ShlEd(CX86Assembler::MakeRegisterAddress(hiRegister), 8);
+			}
+			m_assembler.OrEd(loRegister, CX86Assembler::MakeRegisterAddress(hiRegister));
+		}
+		m_assembler.PinsrwVo(dstRegister, CX86Assembler::MakeRegisterAddress(loRegister), i);
+	}
+
+	CommitSymbolRegisterMdSse(dst, dstRegister);
+}
+
+void CCodeGen_x86::Emit_Md_ShuffleB_Ssse3_VarVarCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
+
+	m_assembler.MovdqaVo(dstRegister, MakeVariable128SymbolAddress(src1));
+	m_assembler.PshufbVo(dstRegister, MakeConstant128Address(GetMdShuffleByteMask(statement)));
+
+	CommitSymbolRegisterMdSse(dst, dstRegister);
+}
+
 void CCodeGen_x86::Emit_Md_Srl256_VarMem(CSymbol* dst, CSymbol* src1, const CX86Assembler::CAddress& offsetAddress)
 {
 	auto offsetRegister = CX86Assembler::rAX;
@@ -1214,9 +1389,15 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdSseConstMatchers[] =
 
 	{ OP_MD_EXPAND_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Md_ExpandW_VarVarCst },
 
+	{ OP_MD_LDCST, MATCH_VARIABLE128, MATCH_CONSTANT64, MATCH_CONSTANT64, MATCH_NIL, &CCodeGen_x86::Emit_Md_LdCst_VarCstCst },
+
+	{ OP_MD_EXTRACT_LANE_S, MATCH_FP_VARIABLE32, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Md_ExtractLaneS_VarVarCst },
+
 	{ OP_MD_PACK_HB, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_x86::Emit_Md_PackHB_VarVarVar },
 	{ OP_MD_PACK_WH, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_x86::Emit_Md_PackWH_VarVarVar },
 
+	{ OP_MD_SHUFFLE_W, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Md_ShuffleW_VarVarCst },
+
 	MD_CONST_MATCHERS_3OPS_REV(OP_MD_UNPACK_LOWER_BH, MDOP_UNPACK_LOWER_BH)
 	MD_CONST_MATCHERS_3OPS_REV(OP_MD_UNPACK_LOWER_HW, MDOP_UNPACK_LOWER_HW)
 	MD_CONST_MATCHERS_3OPS_REV(OP_MD_UNPACK_LOWER_WD, MDOP_UNPACK_LOWER_WD)
@@ -1229,6 +1410,11 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdSseConstMatchers[] =
 	MD_CONST_MATCHERS_3OPS(OP_MD_SUB_S, MDOP_SUBS)
 	MD_CONST_MATCHERS_3OPS(OP_MD_MUL_S, MDOP_MULS)
 	MD_CONST_MATCHERS_3OPS(OP_MD_DIV_S, MDOP_DIVS)
+
+	//Without FMA, fused multiply-add is computed with separate roundings
+	{ OP_MD_MULADD_S,      MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_x86::Emit_Md_MulAddS_VarVarVarVar },
+	{ OP_MD_FUSEDMULADD_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_x86::Emit_Md_MulAddS_VarVarVarVar },
+
 	MD_CONST_MATCHERS_3OPS(OP_MD_CMPLT_S, MDOP_CMPLTS)
 	MD_CONST_MATCHERS_3OPS(OP_MD_CMPGT_S, MDOP_CMPGTS)
 
@@ -1280,6 +1466,8 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdSse41ConstMatchers[] =
 
 	{ OP_MD_MOV_MASKED, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_NIL, &CCodeGen_x86::Emit_Md_MovMasked_Sse41_VarVarVar },
 
+	{ OP_MD_INSERT_LANE_S, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_FP_VARIABLE32, MATCH_CONSTANT, &CCodeGen_x86::Emit_Md_InsertLaneS_Sse41_VarVarVarCst },
+
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
 
@@ -1288,6 +1476,8 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdNoSsse3ConstMatchers[] =
 	{ OP_MD_MAKECLIP,   MATCH_VARIABLE, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_x86::Emit_Md_MakeClip_VarVarVarVar },
 	{ OP_MD_MAKESZ,     MATCH_VARIABLE, MATCH_VARIABLE128, MATCH_NIL,         MATCH_NIL,         &CCodeGen_x86::Emit_Md_MakeSz_VarVar         },
 
+	{ OP_MD_SHUFFLE_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT64, MATCH_NIL, &CCodeGen_x86::Emit_Md_ShuffleB_VarVarCst },
+
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
 
@@ -1296,6 +1486,8 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_mdSsse3ConstMatchers[] =
 	{ OP_MD_MAKECLIP,   MATCH_VARIABLE, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_VARIABLE128, &CCodeGen_x86::Emit_Md_MakeClip_Ssse3_VarVarVarVar },
 	{ OP_MD_MAKESZ,     MATCH_VARIABLE, MATCH_VARIABLE128, MATCH_NIL,         MATCH_NIL,         &CCodeGen_x86::Emit_Md_MakeSz_Ssse3_VarVar         },
 	
+	{ OP_MD_SHUFFLE_B, MATCH_VARIABLE128, MATCH_VARIABLE128, MATCH_CONSTANT64, MATCH_NIL, &CCodeGen_x86::Emit_Md_ShuffleB_Ssse3_VarVarCst },
+
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
 // clang-format on
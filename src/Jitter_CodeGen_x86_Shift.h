@@ -276,25 +276,60 @@ void CCodeGen_x86::Emit_Shift_MemCstMem(const STATEMENT& statement)
 	m_assembler.MovGd(MakeMemorySymbolAddress(dst), CX86Assembler::rAX);
 }
 
+template <typename SHIFTOP>
+void CCodeGen_x86::Emit_Shift_Bmi2_VarVarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto dstRegister = PrepareSymbolRegisterDef(dst, CX86Assembler::rAX);
+	auto amountRegister = PrepareSymbolRegisterUse(src2, CX86Assembler::rDX);
+	((m_assembler).*(SHIFTOP::OpBmi()))(dstRegister, MakeVariableSymbolAddress(src1), amountRegister);
+	CommitSymbolRegister(dst, dstRegister);
+}
+
+template <typename SHIFTOP>
+void CCodeGen_x86::Emit_Shift_Bmi2_VarCstVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	assert(src1->m_type == SYM_CONSTANT);
+
+	auto dstRegister = PrepareSymbolRegisterDef(dst, CX86Assembler::rAX);
+	auto amountRegister = PrepareSymbolRegisterUse(src2, CX86Assembler::rDX);
+	m_assembler.MovId(CX86Assembler::rAX, src1->m_valueLow);
+	((m_assembler).*(SHIFTOP::OpBmi()))(dstRegister, CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX), amountRegister);
+	CommitSymbolRegister(dst, dstRegister);
+}
+
 // clang-format off
 #define SHIFT_CONST_MATCHERS(SHIFTOP_CST, SHIFTOP) \
+	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_REGISTER, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegRegCst<SHIFTOP> }, \
+	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_MEMORY,   MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegMemCst<SHIFTOP>	}, \
+	{ SHIFTOP_CST, MATCH_MEMORY,   MATCH_REGISTER, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemRegCst<SHIFTOP>	}, \
+	{ SHIFTOP_CST, MATCH_MEMORY,   MATCH_MEMORY,   MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemMemCst<SHIFTOP>	},
+
+#define SHIFT_VAR_CONST_MATCHERS(SHIFTOP_CST, SHIFTOP) \
 	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_REGISTER, MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegRegReg<SHIFTOP> }, \
 	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_REGISTER, MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegRegMem<SHIFTOP> }, \
-	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_REGISTER, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegRegCst<SHIFTOP> }, \
 	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_MEMORY,   MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegMemReg<SHIFTOP> }, \
 	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_MEMORY,   MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegMemMem<SHIFTOP>	}, \
-	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_MEMORY,   MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegMemCst<SHIFTOP>	}, \
 	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_CONSTANT, MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegCstReg<SHIFTOP>	}, \
 	{ SHIFTOP_CST, MATCH_REGISTER, MATCH_CONSTANT, MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_Shift_RegCstMem<SHIFTOP>	}, \
 \
 	{ SHIFTOP_CST, MATCH_MEMORY, MATCH_REGISTER, MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemRegReg<SHIFTOP>	}, \
-	{ SHIFTOP_CST, MATCH_MEMORY, MATCH_REGISTER, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemRegCst<SHIFTOP>	}, \
 	{ SHIFTOP_CST, MATCH_MEMORY, MATCH_REGISTER, MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemRegMem<SHIFTOP>	}, \
 	{ SHIFTOP_CST, MATCH_MEMORY, MATCH_MEMORY,   MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemMemReg<SHIFTOP>	}, \
 	{ SHIFTOP_CST, MATCH_MEMORY, MATCH_MEMORY,   MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemMemMem<SHIFTOP>	}, \
-	{ SHIFTOP_CST, MATCH_MEMORY, MATCH_MEMORY,   MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemMemCst<SHIFTOP>	}, \
 	{ SHIFTOP_CST, MATCH_MEMORY, MATCH_CONSTANT, MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemCstReg<SHIFTOP>	}, \
 	{ SHIFTOP_CST, MATCH_MEMORY, MATCH_CONSTANT, MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_Shift_MemCstMem<SHIFTOP>	},
+
+#define SHIFT_VAR_BMI2_CONST_MATCHERS(SHIFTOP_CST, SHIFTOP) \
+	{ SHIFTOP_CST, MATCH_VARIABLE, MATCH_VARIABLE, MATCH_VARIABLE, MATCH_NIL, &CCodeGen_x86::Emit_Shift_Bmi2_VarVarVar<SHIFTOP> }, \
+	{ SHIFTOP_CST, MATCH_VARIABLE, MATCH_CONSTANT, MATCH_VARIABLE, MATCH_NIL, &CCodeGen_x86::Emit_Shift_Bmi2_VarCstVar<SHIFTOP> },
 // clang-format on
 
 #endif
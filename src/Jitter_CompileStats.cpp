@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cassert>
+#include "Jitter_CompileStats.h"
+
+using namespace Jitter;
+
+void CCompileStats::CHistogram::Add(uint64 value)
+{
+	m_buckets[GetBucketIndex(value)]++;
+	m_count++;
+	m_sum += value;
+	m_min = std::min(m_min, value);
+	m_max = std::max(m_max, value);
+}
+
+void CCompileStats::CHistogram::Merge(const CHistogram& histogram)
+{
+	for(unsigned int i = 0; i < BUCKET_COUNT; i++)
+	{
+		m_buckets[i] += histogram.m_buckets[i];
+	}
+	m_count += histogram.m_count;
+	m_sum += histogram.m_sum;
+	m_min = std::min(m_min, histogram.m_min);
+	m_max = std::max(m_max, histogram.m_max);
+}
+
+uint64 CCompileStats::CHistogram::GetCount() const
+{
+	return m_count;
+}
+
+uint64 CCompileStats::CHistogram::GetSum() const
+{
+	return m_sum;
+}
+
+uint64 CCompileStats::CHistogram::GetMin() const
+{
+	return (m_count == 0) ? 0 : m_min;
+}
+
+uint64 CCompileStats::CHistogram::GetMax() const
+{
+	return m_max;
+}
+
+uint64 CCompileStats::CHistogram::GetBucket(unsigned int index) const
+{
+	assert(index < BUCKET_COUNT);
+	return m_buckets[index];
+}
+
+unsigned int CCompileStats::CHistogram::GetBucketIndex(uint64 value)
+{
+	unsigned int index = 0;
+	while(value != 0)
+	{
+		value >>= 1;
+		index++;
+	}
+	return index;
+}
+
+const char* CCompileStats::GetPassName(PASS pass)
+{
+	static const char* g_passNames[PASS_COUNT] =
+	    {
+	        "ClampingElimination",
+	        "MergeCmpSelectOps",
+	        "FoldRelativeReferences",
+	        "ConstantPropagation",
+	        "ConstantFolding",
+	        "MdConstantFolding",
+	        "SimplifyKnownBits",
+	        "StrengthReduceDivision",
+	        "StrengthReduceMultiplication",
+	        "MergeBitfieldOps",
+	        "ReorderAdd",
+	        "CopyPropagation",
+	        "MergeCmpCondJmp",
+	        "DeadcodeElimination",
+	        "CommonExpressionElimination",
+	        "FixFlowControl",
+	        "PruneBlocks",
+	        "MergeBlocks",
+	        "OptimizeLoops",
+	        "CoalesceTemporaries",
+	        "RemoveSelfAssignments",
+	        "CombineAdjacentStores",
+	        "PruneSymbols",
+	        "AllocateRegisters",
+	        "AllocateStack",
+	        "NormalizeStatements",
+	        "GenerateCode",
+	    };
+	assert(pass < PASS_COUNT);
+	return g_passNames[pass];
+}
+
+const char* CCompileStats::GetValueName(VALUE value)
+{
+	static const char* g_valueNames[VALUE_COUNT] =
+	    {
+	        "CompileTime",
+	        "InputStatements",
+	        "OutputStatements",
+	        "OptimizationIterations",
+	        "BlockOptimizationIterations",
+	        "RegisterLoads",
+	        "RegisterSpills",
+	        "StackSize",
+	        "CodeSize",
+	    };
+	assert(value < VALUE_COUNT);
+	return g_valueNames[value];
+}
+
+uint64 CCompileStats::GetCompileCount() const
+{
+	return m_compileCount;
+}
+
+const CCompileStats::PASS_STATS& CCompileStats::GetPassStats(PASS pass) const
+{
+	assert(pass < PASS_COUNT);
+	return m_passStats[pass];
+}
+
+const CCompileStats::CHistogram& CCompileStats::GetHistogram(VALUE value) const
+{
+	assert(value < VALUE_COUNT);
+	return m_histograms[value];
+}
+
+void CCompileStats::Merge(const CCompileStats& stats)
+{
+	m_compileCount += stats.m_compileCount;
+	for(unsigned int i = 0; i < PASS_COUNT; i++)
+	{
+		auto& passStats = m_passStats[i];
+		const auto& srcPassStats = stats.m_passStats[i];
+		passStats.runCount += srcPassStats.runCount;
+		passStats.changeCount += srcPassStats.changeCount;
+		passStats.statementsBefore += srcPassStats.statementsBefore;
+		passStats.statementsAfter += srcPassStats.statementsAfter;
+		passStats.time.Merge(srcPassStats.time);
+	}
+	for(unsigned int i = 0; i < VALUE_COUNT; i++)
+	{
+		m_histograms[i].Merge(stats.m_histograms[i]);
+	}
+}
+
+void CCompileStats::Reset()
+{
+	*this = CCompileStats();
+}
+
+void CCompileStats::BeginCompile()
+{
+	m_currentValues.fill(0);
+}
+
+void CCompileStats::EndCompile()
+{
+	m_compileCount++;
+	for(unsigned int i = 0; i < VALUE_COUNT; i++)
+	{
+		m_histograms[i].Add(m_currentValues[i]);
+	}
+}
+
+void CCompileStats::AddPassRun(PASS pass, uint64 statementsBefore, uint64 statementsAfter, bool changed, uint64 time)
+{
+	assert(pass < PASS_COUNT);
+	auto& passStats = m_passStats[pass];
+	passStats.runCount++;
+	passStats.changeCount += changed ? 1 : 0;
+	passStats.statementsBefore += statementsBefore;
+	passStats.statementsAfter += statementsAfter;
+	passStats.time.Add(time);
+}
+
+void CCompileStats::AddValue(VALUE value, uint64 amount)
+{
+	assert(value < VALUE_COUNT);
+	m_currentValues[value] += amount;
+}
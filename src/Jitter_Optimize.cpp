@@ -1,6 +1,12 @@
 #include <assert.h>
+#include <cstring>
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include "Jitter.h"
 #include "BitManip.h"
 
@@ -137,69 +143,157 @@ StatementList CJitter::CollapseVersionedStatementList(const VERSIONED_STATEMENT_
 	return result;
 }
 
+//Runs an optimization pass, measuring it if statistics are collected
+template <typename CountFunction, typename PassFunction>
+static auto RunPass(CCompileStats* compileStats, CCompileStats::PASS pass, const CountFunction& countStatements, const PassFunction& passFunction)
+{
+	typedef decltype(passFunction()) ResultType;
+	if(!compileStats)
+	{
+		return passFunction();
+	}
+	uint64 statementsBefore = countStatements();
+	auto startTime = std::chrono::steady_clock::now();
+	auto getElapsed = [&]() {
+		auto elapsed = std::chrono::steady_clock::now() - startTime;
+		return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	};
+	if constexpr(std::is_void_v<ResultType>)
+	{
+		passFunction();
+		compileStats->AddPassRun(pass, statementsBefore, countStatements(), false, getElapsed());
+	}
+	else
+	{
+		auto result = passFunction();
+		bool changed = false;
+		if constexpr(std::is_same_v<ResultType, bool>)
+		{
+			changed = result;
+		}
+		compileStats->AddPassRun(pass, statementsBefore, countStatements(), changed, getElapsed());
+		return result;
+	}
+}
+
+template <typename PassFunction>
+static auto RunPass(CCompileStats* compileStats, CCompileStats::PASS pass, const StatementList& statements, const PassFunction& passFunction)
+{
+	return RunPass(
+	    compileStats, pass, [&]() { return statements.size(); }, passFunction);
+}
+
 void CJitter::Compile()
 {
+	auto countStatements =
+	    [this]() {
+		    size_t statementCount = 0;
+		    for(const auto& basicBlock : m_basicBlocks)
+		    {
+			    statementCount += basicBlock.statements.size();
+		    }
+		    return statementCount;
+	    };
+
 	while(1)
 	{
+		ComputeDeadRelatives();
+
 		for(auto& basicBlock : m_basicBlocks)
 		{
 			if(!basicBlock.optimized)
 			{
 				m_currentBlock = &basicBlock;
+				auto& statements = basicBlock.statements;
 
 				//DumpStatementList(m_currentBlock->statements);
 
 				//These don't need to be run more than once
-				ClampingElimination(basicBlock.statements);
+				RunPass(m_compileStats, CCompileStats::PASS_CLAMPING_ELIMINATION, statements, [&]() { return ClampingElimination(statements); });
 				if(m_codeGenSupportsCmpSelect)
 				{
-					MergeCmpSelectOps(basicBlock.statements);
+					RunPass(m_compileStats, CCompileStats::PASS_MERGE_CMP_SELECT_OPS, statements, [&]() { return MergeCmpSelectOps(statements); });
 				}
+				RunPass(m_compileStats, CCompileStats::PASS_FOLD_RELATIVE_REFERENCES, statements, [&]() { return FoldRelativeReferences(statements); });
 
-				auto versionedStatements = GenerateVersionedStatementList(basicBlock.statements);
+				auto versionedStatements = GenerateVersionedStatementList(statements);
+				auto& vstatements = versionedStatements.statements;
 
 				while(1)
 				{
+					if(m_compileStats)
+					{
+						m_compileStats->AddValue(CCompileStats::VALUE_OPTIMIZATION_ITERATIONS, 1);
+					}
+
 					bool dirty = false;
-					dirty |= ConstantPropagation(versionedStatements.statements);
-					dirty |= ConstantFolding(versionedStatements.statements);
-					dirty |= ReorderAdd(versionedStatements.statements);
-					dirty |= CopyPropagation(versionedStatements.statements);
-					dirty |= DeadcodeElimination(versionedStatements);
-					dirty |= CommonExpressionElimination(versionedStatements);
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_CONSTANT_PROPAGATION, vstatements, [&]() { return ConstantPropagation(vstatements); });
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_CONSTANT_FOLDING, vstatements, [&]() { return ConstantFolding(vstatements); });
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_MD_CONSTANT_FOLDING, vstatements, [&]() { return MdConstantFolding(vstatements); });
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_SIMPLIFY_KNOWN_BITS, vstatements, [&]() { return SimplifyKnownBits(vstatements); });
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_STRENGTH_REDUCE_DIVISION, vstatements, [&]() { return StrengthReduceDivision(vstatements); });
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_STRENGTH_REDUCE_MULTIPLICATION, vstatements, [&]() { return StrengthReduceMultiplication(vstatements); });
+					if(m_codeGenSupportsBitfieldOps)
+					{
+						dirty |= RunPass(m_compileStats, CCompileStats::PASS_MERGE_BITFIELD_OPS, vstatements, [&]() { return MergeBitfieldOps(vstatements); });
+					}
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_REORDER_ADD, vstatements, [&]() { return ReorderAdd(vstatements); });
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_COPY_PROPAGATION, vstatements, [&]() { return CopyPropagation(vstatements); });
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_MERGE_CMP_CONDJMP, vstatements, [&]() { return MergeCmpCondJmp(vstatements); });
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_DEADCODE_ELIMINATION, vstatements, [&]() { return DeadcodeElimination(versionedStatements); });
+					dirty |= RunPass(m_compileStats, CCompileStats::PASS_COMMON_EXPRESSION_ELIMINATION, vstatements, [&]() { return CommonExpressionElimination(versionedStatements); });
 
 					if(!dirty) break;
 				}
 
-				basicBlock.statements = CollapseVersionedStatementList(versionedStatements);
-				FixFlowControl(basicBlock.statements);
+				statements = CollapseVersionedStatementList(versionedStatements);
+				RunPass(m_compileStats, CCompileStats::PASS_FIX_FLOW_CONTROL, statements, [&]() { return FixFlowControl(statements); });
 				basicBlock.optimized = true;
 			}
 		}
 
+		if(m_compileStats)
+		{
+			m_compileStats->AddValue(CCompileStats::VALUE_BLOCK_OPTIMIZATION_ITERATIONS, 1);
+		}
+
 		bool dirty = false;
-		dirty |= PruneBlocks();
-		dirty |= MergeBlocks();
+		dirty |= RunPass(m_compileStats, CCompileStats::PASS_PRUNE_BLOCKS, countStatements, [&]() { return PruneBlocks(); });
+		dirty |= RunPass(m_compileStats, CCompileStats::PASS_MERGE_BLOCKS, countStatements, [&]() { return MergeBlocks(); });
 
 		if(!dirty) break;
 	}
 
+	if(m_codeGenSupportsLoopRegisters)
+	{
+		RunPass(m_compileStats, CCompileStats::PASS_OPTIMIZE_LOOPS, countStatements, [&]() { return OptimizeLoops(); });
+	}
+
 	unsigned int stackSize = 0;
 
 	//Allocate registers
 	for(auto& basicBlock : m_basicBlocks)
 	{
 		m_currentBlock = &basicBlock;
+		const auto& statements = basicBlock.statements;
 
-		CoalesceTemporaries(basicBlock);
-		RemoveSelfAssignments(basicBlock);
-		PruneSymbols(basicBlock);
+		RunPass(m_compileStats, CCompileStats::PASS_COALESCE_TEMPORARIES, statements, [&]() { return CoalesceTemporaries(basicBlock); });
+		RunPass(m_compileStats, CCompileStats::PASS_REMOVE_SELF_ASSIGNMENTS, statements, [&]() { return RemoveSelfAssignments(basicBlock); });
+		RunPass(m_compileStats, CCompileStats::PASS_COMBINE_ADJACENT_STORES, statements, [&]() { return CombineAdjacentStores(basicBlock, false); });
+		RunPass(m_compileStats, CCompileStats::PASS_PRUNE_SYMBOLS, statements, [&]() { return PruneSymbols(basicBlock); });
 
-		AllocateRegisters(basicBlock);
-		unsigned int blockStackSize = AllocateStack(basicBlock);
+		if(!basicBlock.loopBoundary)
+		{
+			RunPass(m_compileStats, CCompileStats::PASS_ALLOCATE_REGISTERS, statements, [&]() { return AllocateRegisters(basicBlock); });
+		}
+		if(m_codeGenSupportsPairedStores)
+		{
+			RunPass(m_compileStats, CCompileStats::PASS_COMBINE_ADJACENT_STORES, statements, [&]() { return CombineAdjacentStores(basicBlock, true); });
+		}
+		unsigned int blockStackSize = RunPass(m_compileStats, CCompileStats::PASS_ALLOCATE_STACK, statements, [&]() { return AllocateStack(basicBlock); });
 		stackSize = std::max<unsigned int>(stackSize, blockStackSize);
 
-		NormalizeStatements(basicBlock);
+		RunPass(m_compileStats, CCompileStats::PASS_NORMALIZE_STATEMENTS, statements, [&]() { return NormalizeStatements(basicBlock); });
 	}
 
 	auto result = ConcatBlocks(m_basicBlocks);
@@ -209,7 +303,13 @@ void CJitter::Compile()
 	std::cout << std::endl;
 #endif
 
-	m_codeGen->GenerateCode(result.statements, stackSize);
+	RunPass(m_compileStats, CCompileStats::PASS_GENERATE_CODE, result.statements, [&]() { return m_codeGen->GenerateCode(result.statements, stackSize); });
+
+	if(m_compileStats)
+	{
+		m_compileStats->AddValue(CCompileStats::VALUE_OUTPUT_STATEMENTS, result.statements.size());
+		m_compileStats->AddValue(CCompileStats::VALUE_STACK_SIZE, stackSize);
+	}
 
 	m_labels.clear();
 }
@@ -478,6 +578,48 @@ bool CJitter::FoldConstantOperation(STATEMENT& statement)
 			changed = true;
 		}
 	}
+	else if((statement.op == OP_EXTRACTBITS) || (statement.op == OP_EXTRACTBITSS))
+	{
+		if(src1cst)
+		{
+			assert(src2cst && src3cst);
+			uint32 lsb = src2cst->m_valueLow;
+			uint32 width = src3cst->m_valueLow;
+			assert((width != 0) && ((lsb + width) <= 32));
+			uint32 result = src1cst->m_valueLow << (32 - lsb - width);
+			if(statement.op == OP_EXTRACTBITSS)
+			{
+				result = static_cast<int32>(result) >> (32 - width);
+			}
+			else
+			{
+				result = result >> (32 - width);
+			}
+			statement.op = OP_MOV;
+			statement.src1 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, result));
+			statement.src2.reset();
+			statement.src3.reset();
+			changed = true;
+		}
+	}
+	else if(statement.op == OP_INSERTBITS)
+	{
+		if(src1cst && src2cst)
+		{
+			assert(src3cst);
+			uint32 lsb = src3cst->m_valueLow & 0xFF;
+			uint32 width = (src3cst->m_valueLow >> 8) & 0xFF;
+			uint32 srcLsb = (src3cst->m_valueLow >> 16) & 0xFF;
+			uint32 mask = static_cast<uint32>((1ULL << width) - 1);
+			uint32 field = (src2cst->m_valueLow >> srcLsb) & mask;
+			uint32 result = (src1cst->m_valueLow & ~(mask << lsb)) | (field << lsb);
+			statement.op = OP_MOV;
+			statement.src1 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, result));
+			statement.src2.reset();
+			statement.src3.reset();
+			changed = true;
+		}
+	}
 	else if(statement.op == OP_MERGETO64)
 	{
 		if(src1cst && src2cst)
@@ -531,11 +673,6 @@ bool CJitter::FoldConstantOperation(STATEMENT& statement)
 			statement.src2.reset();
 			changed = true;
 		}
-		//else if(src2cst && IsPowerOfTwo(src2cst->m_valueLow))
-		//{
-		//	statement.op = OP_SRL;
-		//	src2cst->m_valueLow = GetPowerOf2(src2cst->m_valueLow);
-		//}
 	}
 	else if(statement.op == OP_DIVS)
 	{
@@ -634,6 +771,18 @@ bool CJitter::FoldConstantOperation(STATEMENT& statement)
 			case CONDITION_BL:
 				result = static_cast<uint32>(src1cst->m_valueLow) < static_cast<uint32>(src2cst->m_valueLow);
 				break;
+			case CONDITION_BE:
+				result = static_cast<uint32>(src1cst->m_valueLow) <= static_cast<uint32>(src2cst->m_valueLow);
+				break;
+			case CONDITION_AB:
+				result = static_cast<uint32>(src1cst->m_valueLow) > static_cast<uint32>(src2cst->m_valueLow);
+				break;
+			case CONDITION_AE:
+				result = static_cast<uint32>(src1cst->m_valueLow) >= static_cast<uint32>(src2cst->m_valueLow);
+				break;
+			case CONDITION_LT:
+				result = static_cast<int32>(src1cst->m_valueLow) < static_cast<int32>(src2cst->m_valueLow);
+				break;
 			case CONDITION_LE:
 				result = static_cast<int32>(src1cst->m_valueLow) <= static_cast<int32>(src2cst->m_valueLow);
 				break;
@@ -672,6 +821,9 @@ bool CJitter::FoldConstant64Operation(STATEMENT& statement)
 	//Nothing we can do
 	if(src1cst == NULL && src2cst == NULL) return false;
 
+	//128-bit constant loads keep their halves as operands
+	if(statement.op == OP_MD_LDCST) return false;
+
 	bool changed = false;
 
 	if(statement.op == OP_EXTLOW64)
@@ -873,704 +1025,3313 @@ bool CJitter::ConstantFolding(StatementList& statements)
 	return changed;
 }
 
-void CJitter::FixFlowControl(StatementList& statements)
+//Applies an operation to every lane of one or two 128-bit values
+template <typename LaneType, typename Operation>
+static LITERAL128 MdLaneOp(const LITERAL128& src1, const LITERAL128& src2, const Operation& operation)
 {
-	//Resolve GOTO instructions
-	for(auto& statement : statements)
-	{
-		if(statement.op == OP_GOTO)
-		{
-			LabelMapType::const_iterator labelIterator = m_labels.find(statement.jmpBlock);
-			assert(labelIterator != m_labels.end());
-			if(labelIterator == m_labels.end()) continue;
-
-			statement.op = OP_JMP;
-			statement.jmpBlock = labelIterator->second;
-		}
-	}
-
-	//Remove any excess flow control instructions
-	for(StatementList::iterator statementIterator(statements.begin());
-	    statementIterator != statements.end(); ++statementIterator)
+	static constexpr unsigned int LANE_COUNT = sizeof(LITERAL128) / sizeof(LaneType);
+	LaneType lanes1[LANE_COUNT];
+	LaneType lanes2[LANE_COUNT];
+	memcpy(lanes1, &src1, sizeof(LITERAL128));
+	memcpy(lanes2, &src2, sizeof(LITERAL128));
+	for(unsigned int i = 0; i < LANE_COUNT; i++)
 	{
-		const STATEMENT& statement(*statementIterator);
-
-		if(statement.op == OP_JMP || statement.op == OP_CONDJMP)
-		{
-			++statementIterator;
-			statements.erase(statementIterator, statements.end());
-			break;
-		}
+		lanes1[i] = static_cast<LaneType>(operation(lanes1[i], lanes2[i]));
 	}
+	LITERAL128 result(0, 0);
+	memcpy(&result, lanes1, sizeof(LITERAL128));
+	return result;
 }
 
-void CJitter::MergeBasicBlocks(BASIC_BLOCK& dstBlock, const BASIC_BLOCK& srcBlock)
+template <typename LaneType>
+static LaneType MdSaturate(int64 value)
 {
-	auto& dstSymbolTable = dstBlock.symbolTable;
+	value = std::max<int64>(value, std::numeric_limits<LaneType>::min());
+	value = std::min<int64>(value, std::numeric_limits<LaneType>::max());
+	return static_cast<LaneType>(value);
+}
 
-	for(auto statement : srcBlock.statements)
-	{
-		statement.VisitOperands(
-		    [&dstSymbolTable](SymbolRefPtr& symbolRef, bool) {
-			    auto symbol = symbolRef->GetSymbol();
-			    symbolRef = std::make_shared<CSymbolRef>(dstSymbolTable.MakeSymbol(symbol));
-		    });
-		dstBlock.statements.push_back(statement);
-	}
+template <typename LaneType>
+static LITERAL128 MdAddSat(const LITERAL128& src1, const LITERAL128& src2)
+{
+	return MdLaneOp<LaneType>(src1, src2, [](LaneType a, LaneType b) { return MdSaturate<LaneType>(static_cast<int64>(a) + static_cast<int64>(b)); });
+}
 
-	dstBlock.optimized = false;
+template <typename LaneType>
+static LITERAL128 MdSubSat(const LITERAL128& src1, const LITERAL128& src2)
+{
+	return MdLaneOp<LaneType>(src1, src2, [](LaneType a, LaneType b) { return MdSaturate<LaneType>(static_cast<int64>(a) - static_cast<int64>(b)); });
 }
 
-CJitter::BASIC_BLOCK CJitter::ConcatBlocks(const BasicBlockList& blocks)
+//Picks bytes from src2 (indices 0 to 15) and src1 (indices 16 to 31)
+static LITERAL128 MdSelectBytes(const LITERAL128& src1, const LITERAL128& src2, const uint8* indices)
 {
-	BASIC_BLOCK result;
-	for(const auto& basicBlock : blocks)
+	uint8 bytes[0x20];
+	memcpy(bytes, &src2, sizeof(LITERAL128));
+	memcpy(bytes + 0x10, &src1, sizeof(LITERAL128));
+	LITERAL128 result(0, 0);
+	auto resultBytes = reinterpret_cast<uint8*>(&result);
+	for(unsigned int i = 0; i < 0x10; i++)
 	{
-		//First, add a mark label statement
-		STATEMENT labelStatement;
-		labelStatement.op = OP_LABEL;
-		labelStatement.jmpBlock = basicBlock.id;
-		result.statements.push_back(labelStatement);
-
-		MergeBasicBlocks(result, basicBlock);
+		resultBytes[i] = bytes[indices[i]];
 	}
 	return result;
 }
 
-bool CJitter::PruneBlocks()
+//Computes the result of a MD operation whose operands are all known, returns false if the operation can't be evaluated
+static bool EvaluateMdOperation(const STATEMENT& statement, const LITERAL128& src1, const LITERAL128& src2, LITERAL128& result)
 {
-	bool changed = true;
-	int deletedBlocks = 0;
+	static const uint8 packHBIndices[0x10] = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30};
+	static const uint8 packWHIndices[0x10] = {0, 1, 4, 5, 8, 9, 12, 13, 16, 17, 20, 21, 24, 25, 28, 29};
+	static const uint8 unpackLowerBHIndices[0x10] = {0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23};
+	static const uint8 unpackLowerHWIndices[0x10] = {0, 1, 16, 17, 2, 3, 18, 19, 4, 5, 20, 21, 6, 7, 22, 23};
+	static const uint8 unpackLowerWDIndices[0x10] = {0, 1, 2, 3, 16, 17, 18, 19, 4, 5, 6, 7, 20, 21, 22, 23};
+	static const uint8 unpackUpperBHIndices[0x10] = {8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31};
+	static const uint8 unpackUpperHWIndices[0x10] = {8, 9, 24, 25, 10, 11, 26, 27, 12, 13, 28, 29, 14, 15, 30, 31};
+	static const uint8 unpackUpperWDIndices[0x10] = {8, 9, 10, 11, 24, 25, 26, 27, 12, 13, 14, 15, 28, 29, 30, 31};
 
-	while(changed)
-	{
-		changed = false;
+	auto src2cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+	//Shift amount, lane index or shuffle pattern
+	uint32 shiftAmount = src2cst ? src2cst->m_valueLow : 0;
+	auto makeMask = [](bool condition) { return condition ? ~0U : 0U; };
 
-		auto toDeleteIterator = m_basicBlocks.cend();
-		for(auto outerBlockIterator(m_basicBlocks.cbegin());
-		    outerBlockIterator != m_basicBlocks.cend(); outerBlockIterator++)
+	switch(statement.op)
+	{
+	case OP_MOV:
+		result = src1;
+		break;
+	case OP_MD_ADD_B:
+		result = MdLaneOp<uint8>(src1, src2, [](uint8 a, uint8 b) { return a + b; });
+		break;
+	case OP_MD_ADD_H:
+		result = MdLaneOp<uint16>(src1, src2, [](uint16 a, uint16 b) { return a + b; });
+		break;
+	case OP_MD_ADD_W:
+		result = MdLaneOp<uint32>(src1, src2, [](uint32 a, uint32 b) { return a + b; });
+		break;
+	case OP_MD_ADDSS_B:
+		result = MdAddSat<int8>(src1, src2);
+		break;
+	case OP_MD_ADDSS_H:
+		result = MdAddSat<int16>(src1, src2);
+		break;
+	case OP_MD_ADDSS_W:
+		result = MdAddSat<int32>(src1, src2);
+		break;
+	case OP_MD_ADDUS_B:
+		result = MdAddSat<uint8>(src1, src2);
+		break;
+	case OP_MD_ADDUS_H:
+		result = MdAddSat<uint16>(src1, src2);
+		break;
+	case OP_MD_ADDUS_W:
+		result = MdAddSat<uint32>(src1, src2);
+		break;
+	case OP_MD_SUB_B:
+		result = MdLaneOp<uint8>(src1, src2, [](uint8 a, uint8 b) { return a - b; });
+		break;
+	case OP_MD_SUB_H:
+		result = MdLaneOp<uint16>(src1, src2, [](uint16 a, uint16 b) { return a - b; });
+		break;
+	case OP_MD_SUB_W:
+		result = MdLaneOp<uint32>(src1, src2, [](uint32 a, uint32 b) { return a - b; });
+		break;
+	case OP_MD_SUBSS_B:
+		result = MdSubSat<int8>(src1, src2);
+		break;
+	case OP_MD_SUBSS_H:
+		result = MdSubSat<int16>(src1, src2);
+		break;
+	case OP_MD_SUBSS_W:
+		result = MdSubSat<int32>(src1, src2);
+		break;
+	case OP_MD_SUBUS_B:
+		result = MdSubSat<uint8>(src1, src2);
+		break;
+	case OP_MD_SUBUS_H:
+		result = MdSubSat<uint16>(src1, src2);
+		break;
+	case OP_MD_SUBUS_W:
+		result = MdSubSat<uint32>(src1, src2);
+		break;
+	case OP_MD_CMPEQ_B:
+		result = MdLaneOp<uint8>(src1, src2, [&](uint8 a, uint8 b) { return makeMask(a == b); });
+		break;
+	case OP_MD_CMPEQ_H:
+		result = MdLaneOp<uint16>(src1, src2, [&](uint16 a, uint16 b) { return makeMask(a == b); });
+		break;
+	case OP_MD_CMPEQ_W:
+		result = MdLaneOp<uint32>(src1, src2, [&](uint32 a, uint32 b) { return makeMask(a == b); });
+		break;
+	case OP_MD_CMPGT_B:
+		result = MdLaneOp<int8>(src1, src2, [&](int8 a, int8 b) { return makeMask(a > b); });
+		break;
+	case OP_MD_CMPGT_H:
+		result = MdLaneOp<int16>(src1, src2, [&](int16 a, int16 b) { return makeMask(a > b); });
+		break;
+	case OP_MD_CMPGT_W:
+		result = MdLaneOp<int32>(src1, src2, [&](int32 a, int32 b) { return makeMask(a > b); });
+		break;
+	case OP_MD_MIN_H:
+		result = MdLaneOp<int16>(src1, src2, [](int16 a, int16 b) { return std::min(a, b); });
+		break;
+	case OP_MD_MIN_W:
+		result = MdLaneOp<int32>(src1, src2, [](int32 a, int32 b) { return std::min(a, b); });
+		break;
+	case OP_MD_MAX_H:
+		result = MdLaneOp<int16>(src1, src2, [](int16 a, int16 b) { return std::max(a, b); });
+		break;
+	case OP_MD_MAX_W:
+		result = MdLaneOp<int32>(src1, src2, [](int32 a, int32 b) { return std::max(a, b); });
+		break;
+	case OP_MD_AND:
+		result = LITERAL128(src1.lo & src2.lo, src1.hi & src2.hi);
+		break;
+	case OP_MD_OR:
+		result = LITERAL128(src1.lo | src2.lo, src1.hi | src2.hi);
+		break;
+	case OP_MD_XOR:
+		result = LITERAL128(src1.lo ^ src2.lo, src1.hi ^ src2.hi);
+		break;
+	case OP_MD_NOT:
+		result = LITERAL128(~src1.lo, ~src1.hi);
+		break;
+	case OP_MD_ABS_S:
+		result = MdLaneOp<uint32>(src1, src1, [](uint32 a, uint32) { return a & 0x7FFFFFFF; });
+		break;
+	case OP_MD_NEG_S:
+		result = MdLaneOp<uint32>(src1, src1, [](uint32 a, uint32) { return a ^ 0x80000000; });
+		break;
+	case OP_MD_SRLH:
+		result = MdLaneOp<uint16>(src1, src1, [&](uint16 a, uint16) { return a >> (shiftAmount & 0x0F); });
+		break;
+	case OP_MD_SRAH:
+		result = MdLaneOp<int16>(src1, src1, [&](int16 a, int16) { return a >> (shiftAmount & 0x0F); });
+		break;
+	case OP_MD_SLLH:
+		result = MdLaneOp<uint16>(src1, src1, [&](uint16 a, uint16) { return a << (shiftAmount & 0x0F); });
+		break;
+	case OP_MD_SRLW:
+		result = MdLaneOp<uint32>(src1, src1, [&](uint32 a, uint32) { return a >> (shiftAmount & 0x1F); });
+		break;
+	case OP_MD_SRAW:
+		result = MdLaneOp<int32>(src1, src1, [&](int32 a, int32) { return a >> (shiftAmount & 0x1F); });
+		break;
+	case OP_MD_SLLW:
+		result = MdLaneOp<uint32>(src1, src1, [&](uint32 a, uint32) { return a << (shiftAmount & 0x1F); });
+		break;
+	case OP_MD_EXPAND_W:
+	{
+		assert(src2cst && (src2cst->m_valueLow < 4));
+		uint32 words[4];
+		memcpy(words, &src1, sizeof(LITERAL128));
+		uint32 value = words[src2cst->m_valueLow];
+		result = LITERAL128(value, value, value, value);
+	}
+	break;
+	case OP_MD_PACK_HB:
+		result = MdSelectBytes(src1, src2, packHBIndices);
+		break;
+	case OP_MD_PACK_WH:
+		result = MdSelectBytes(src1, src2, packWHIndices);
+		break;
+	case OP_MD_UNPACK_LOWER_BH:
+		result = MdSelectBytes(src1, src2, unpackLowerBHIndices);
+		break;
+	case OP_MD_UNPACK_LOWER_HW:
+		result = MdSelectBytes(src1, src2, unpackLowerHWIndices);
+		break;
+	case OP_MD_UNPACK_LOWER_WD:
+		result = MdSelectBytes(src1, src2, unpackLowerWDIndices);
+		break;
+	case OP_MD_UNPACK_UPPER_BH:
+		result = MdSelectBytes(src1, src2, unpackUpperBHIndices);
+		break;
+	case OP_MD_UNPACK_UPPER_HW:
+		result = MdSelectBytes(src1, src2, unpackUpperHWIndices);
+		break;
+	case OP_MD_UNPACK_UPPER_WD:
+		result = MdSelectBytes(src1, src2, unpackUpperWDIndices);
+		break;
+	case OP_MD_SHUFFLE_W:
+	{
+		uint8 indices[0x10];
+		for(unsigned int i = 0; i < 0x10; i++)
 		{
-			//First block is always referenced
-			if(outerBlockIterator == m_basicBlocks.begin()) continue;
+			indices[i] = 0x10 + (((shiftAmount >> ((i / 4) * 2)) & 0x03) * 4) + (i % 4);
+		}
+		result = MdSelectBytes(src1, src1, indices);
+	}
+	break;
+	case OP_MD_SHUFFLE_B:
+	{
+		auto pattern = dynamic_symbolref_cast(SYM_CONSTANT64, statement.src2)->GetConstant64();
+		uint8 indices[0x10];
+		for(unsigned int i = 0; i < 0x10; i++)
+		{
+			indices[i] = 0x10 + ((pattern >> (i * 4)) & 0x0F);
+		}
+		result = MdSelectBytes(src1, src1, indices);
+	}
+	break;
+	case OP_MD_MOV_MASKED:
+	{
+		uint32 words1[4];
+		uint32 words2[4];
+		memcpy(words1, &src1, sizeof(LITERAL128));
+		memcpy(words2, &src2, sizeof(LITERAL128));
+		for(unsigned int i = 0; i < 4; i++)
+		{
+			if(statement.jmpCondition & (1 << i))
+			{
+				words1[i] = words2[i];
+			}
+		}
+		memcpy(&result, words1, sizeof(LITERAL128));
+	}
+	break;
+	default:
+		//Floating point operations are left to the target since their results depend on its rounding and denormal handling
+		return false;
+	}
+	return true;
+}
 
-			auto candidateBlockIterator = outerBlockIterator;
-			bool referenced = false;
+bool CJitter::MdConstantFolding(StatementList& statements)
+{
+	bool changed = false;
 
-			//Check if there's a reference to this block in here
-			for(auto innerBlockIterator(m_basicBlocks.cbegin());
-			    innerBlockIterator != m_basicBlocks.cend(); innerBlockIterator++)
-			{
-				const auto& block(*innerBlockIterator);
-				bool referencesNext = false;
+	static const LITERAL128 zero(0, 0);
+	static const LITERAL128 ones(~0ULL, ~0ULL);
+
+	std::unordered_map<CSymbol*, LITERAL128> constantValues;
+
+	auto getConstantValue =
+	    [&](const SymbolRefPtr& symbolRef, LITERAL128& value) {
+		    if(!symbolRef || (symbolRef->GetSymbol()->m_type != SYM_TEMPORARY128)) return false;
+		    auto constantValueIterator = constantValues.find(symbolRef->GetSymbol().get());
+		    if(constantValueIterator == std::end(constantValues)) return false;
+		    value = constantValueIterator->second;
+		    return true;
+	    };
+
+	//Materializes a constant, using the cheaper word expansion when all words are equal
+	auto loadConstant =
+	    [&](STATEMENT& statement, const LITERAL128& value) {
+		    if((value.w0 == value.w1) && (value.w0 == value.w2) && (value.w0 == value.w3))
+		    {
+			    statement.op = OP_MD_EXPAND_W;
+			    statement.src1 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, value.w0));
+			    statement.src2.reset();
+		    }
+		    else
+		    {
+			    statement.op = OP_MD_LDCST;
+			    statement.src1 = MakeSymbolRef(MakeConstant64(value.lo));
+			    statement.src2 = MakeSymbolRef(MakeConstant64(value.hi));
+		    }
+		    statement.src3.reset();
+		    statement.jmpCondition = CONDITION_NEVER;
+		    changed = true;
+	    };
+
+	auto is128 =
+	    [](const SymbolRefPtr& symbolRef) {
+		    if(!symbolRef) return false;
+		    auto type = symbolRef->GetSymbol()->m_type;
+		    return (type == SYM_TEMPORARY128) || (type == SYM_RELATIVE128);
+	    };
+
+	auto replaceWithMov =
+	    [&](STATEMENT& statement, const SymbolRefPtr& value) {
+		    statement.op = OP_MOV;
+		    statement.src1 = value;
+		    statement.src2.reset();
+		    statement.src3.reset();
+		    statement.jmpCondition = CONDITION_NEVER;
+		    changed = true;
+	    };
 
-				if(block.statements.empty())
+	for(auto& statement : statements)
+	{
+		auto dst = statement.dst ? statement.dst->GetSymbol().get() : nullptr;
+		bool dstIs128 = is128(statement.dst);
+
+		LITERAL128 src1Value(0, 0);
+		LITERAL128 src2Value(0, 0);
+		bool src1Known = getConstantValue(statement.src1, src1Value);
+		bool src2Known = getConstantValue(statement.src2, src2Value);
+		bool src1Is128 = is128(statement.src1);
+		bool src2Is128 = is128(statement.src2);
+
+		if(dstIs128 && src1Known && (!src2Is128 || src2Known) && !statement.src3 &&
+		   (statement.op != OP_MD_LDCST) && (statement.op != OP_MD_EXPAND_W || src1Is128))
+		{
+			LITERAL128 result(0, 0);
+			if(EvaluateMdOperation(statement, src1Value, src2Value, result))
+			{
+				loadConstant(statement, result);
+			}
+		}
+		else if(dstIs128 && src1Is128 && src2Is128)
+		{
+			bool sameSources = statement.src1->Equals(statement.src2.get());
+			//Identities involving a known operand
+			auto isKnown =
+			    [&](bool known, const LITERAL128& value, const LITERAL128& expected) {
+				    return known && (value == expected);
+			    };
+			switch(statement.op)
+			{
+			case OP_MD_XOR:
+			case OP_MD_SUB_B:
+			case OP_MD_SUB_H:
+			case OP_MD_SUB_W:
+			case OP_MD_SUBSS_B:
+			case OP_MD_SUBSS_H:
+			case OP_MD_SUBSS_W:
+			case OP_MD_SUBUS_B:
+			case OP_MD_SUBUS_H:
+			case OP_MD_SUBUS_W:
+			case OP_MD_CMPGT_B:
+			case OP_MD_CMPGT_H:
+			case OP_MD_CMPGT_W:
+				if(sameSources)
 				{
-					//Empty blocks references next one
-					referencesNext = true;
+					loadConstant(statement, zero);
 				}
-				else
+				else if(isKnown(src2Known, src2Value, zero) && (statement.op != OP_MD_CMPGT_B) &&
+				        (statement.op != OP_MD_CMPGT_H) && (statement.op != OP_MD_CMPGT_W))
 				{
-					//Check if this block references the next one or if it jumps to another one
-					auto lastInstruction(block.statements.end());
-					lastInstruction--;
-					const auto& statement(*lastInstruction);
-
-					//It jumps to a block, so check if it references the one we're looking for
-					if(statement.op == OP_JMP || statement.op == OP_CONDJMP)
-					{
-						if(statement.jmpBlock == candidateBlockIterator->id)
-						{
-							referenced = true;
-							break;
-						}
-					}
-
-					//Otherwise, it references the next one if it's not a jump
-					if(statement.op != OP_JMP)
-					{
-						referencesNext = true;
-					}
+					replaceWithMov(statement, statement.src1);
 				}
-
-				if(referencesNext)
+				else if(isKnown(src1Known, src1Value, zero) && (statement.op == OP_MD_XOR))
 				{
-					auto nextBlockIterator(innerBlockIterator);
-					nextBlockIterator++;
-					if(nextBlockIterator != m_basicBlocks.end())
-					{
-						if(nextBlockIterator->id == candidateBlockIterator->id)
-						{
-							referenced = true;
-							break;
-						}
-					}
+					replaceWithMov(statement, statement.src2);
 				}
-			}
-
-			if(!referenced)
+				break;
+			case OP_MD_CMPEQ_B:
+			case OP_MD_CMPEQ_H:
+			case OP_MD_CMPEQ_W:
+				if(sameSources)
+				{
+					loadConstant(statement, ones);
+				}
+				break;
+			case OP_MD_AND:
+			case OP_MD_OR:
 			{
-				toDeleteIterator = candidateBlockIterator;
+				auto& absorbing = (statement.op == OP_MD_AND) ? zero : ones;
+				auto& identity = (statement.op == OP_MD_AND) ? ones : zero;
+				if(sameSources || isKnown(src2Known, src2Value, identity))
+				{
+					replaceWithMov(statement, statement.src1);
+				}
+				else if(isKnown(src1Known, src1Value, identity))
+				{
+					replaceWithMov(statement, statement.src2);
+				}
+				else if(isKnown(src1Known, src1Value, absorbing) || isKnown(src2Known, src2Value, absorbing))
+				{
+					loadConstant(statement, absorbing);
+				}
+			}
+			break;
+			case OP_MD_ADD_B:
+			case OP_MD_ADD_H:
+			case OP_MD_ADD_W:
+			case OP_MD_ADDSS_B:
+			case OP_MD_ADDSS_H:
+			case OP_MD_ADDSS_W:
+			case OP_MD_ADDUS_B:
+			case OP_MD_ADDUS_H:
+			case OP_MD_ADDUS_W:
+				if(isKnown(src2Known, src2Value, zero))
+				{
+					replaceWithMov(statement, statement.src1);
+				}
+				else if(isKnown(src1Known, src1Value, zero))
+				{
+					replaceWithMov(statement, statement.src2);
+				}
+				break;
+			case OP_MD_MIN_H:
+			case OP_MD_MIN_W:
+			case OP_MD_MAX_H:
+			case OP_MD_MAX_W:
+				if(sameSources)
+				{
+					replaceWithMov(statement, statement.src1);
+				}
+				break;
+			default:
 				break;
 			}
 		}
-		if(toDeleteIterator == m_basicBlocks.end()) continue;
+		else if(dstIs128 && (statement.op == OP_MD_SHUFFLE_W))
+		{
+			auto patternCst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+			if(patternCst && (patternCst->m_valueLow == 0xE4))
+			{
+				//Every word stays in place
+				replaceWithMov(statement, statement.src1);
+			}
+		}
 
-		m_basicBlocks.erase(toDeleteIterator);
-		deletedBlocks++;
-		changed = true;
+		if(!dst || (dst->m_type != SYM_TEMPORARY128)) continue;
+
+		//Keep track of temporaries holding a known value
+		auto expandCst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src1);
+		if((statement.op == OP_MD_EXPAND_W) && expandCst && !statement.src2)
+		{
+			constantValues.insert_or_assign(dst, LITERAL128(expandCst->m_valueLow, expandCst->m_valueLow, expandCst->m_valueLow, expandCst->m_valueLow));
+		}
+		else if(statement.op == OP_MD_LDCST)
+		{
+			auto src1Cst = dynamic_symbolref_cast(SYM_CONSTANT64, statement.src1);
+			auto src2Cst = dynamic_symbolref_cast(SYM_CONSTANT64, statement.src2);
+			constantValues.insert_or_assign(dst, LITERAL128(src1Cst->GetConstant64(), src2Cst->GetConstant64()));
+		}
+		else if((statement.op == OP_MOV) && getConstantValue(statement.src1, src1Value))
+		{
+			constantValues.insert_or_assign(dst, src1Value);
+		}
+		else
+		{
+			constantValues.erase(dst);
+		}
 	}
 
-	HarmonizeBlocks();
-	return deletedBlocks != 0;
+	return changed;
 }
 
-void CJitter::HarmonizeBlocks()
+//Bits known to be cleared or set in a 32-bit value, along with the number of
+//high order bits known to be copies of the sign bit
+struct KNOWN_BITS
 {
-	//Remove any jumps that jump to the next block
-	for(BasicBlockList::iterator blockIterator(m_basicBlocks.begin());
+	uint32 zeroes = 0;
+	uint32 ones = 0;
+	uint32 signBits = 1;
+
+	bool IsConstant() const
+	{
+		return (zeroes | ones) == ~0U;
+	}
+};
+
+static KNOWN_BITS MakeKnownBits(uint32 zeroes, uint32 ones, uint32 signBits = 1)
+{
+	KNOWN_BITS result;
+	result.zeroes = zeroes;
+	result.ones = ones;
+	uint32 knownSign = (zeroes & 0x80000000) ? zeroes : ((ones & 0x80000000) ? ones : 0);
+	uint32 knownSignBits = (knownSign == ~0U) ? 32 : __builtin_clz(~knownSign);
+	result.signBits = std::max<uint32>(std::max<uint32>(signBits, knownSignBits), 1);
+	return result;
+}
+
+//Checks if the result of comparing a value against a constant can be inferred from the value's known bits
+static bool EvaluateKnownComparison(CONDITION condition, const KNOWN_BITS& bits, uint32 value, bool& result)
+{
+	uint32 unsignedMin = bits.ones;
+	uint32 unsignedMax = ~bits.zeroes;
+	int32 signedMin = static_cast<int32>((bits.zeroes & 0x80000000) ? bits.ones : (bits.ones | 0x80000000));
+	int32 signedMax = static_cast<int32>((bits.ones & 0x80000000) ? ~bits.zeroes : (~bits.zeroes & 0x7FFFFFFF));
+	int32 signedValue = static_cast<int32>(value);
+
+	auto decide =
+	    [&](bool alwaysTrue, bool alwaysFalse) {
+		    if(!alwaysTrue && !alwaysFalse) return false;
+		    result = alwaysTrue;
+		    return true;
+	    };
+
+	switch(condition)
+	{
+	case CONDITION_EQ:
+		return decide(false, ((value & bits.zeroes) != 0) || ((~value & bits.ones) != 0));
+	case CONDITION_NE:
+		return decide(((value & bits.zeroes) != 0) || ((~value & bits.ones) != 0), false);
+	case CONDITION_BL:
+		return decide(unsignedMax < value, unsignedMin >= value);
+	case CONDITION_BE:
+		return decide(unsignedMax <= value, unsignedMin > value);
+	case CONDITION_AB:
+		return decide(unsignedMin > value, unsignedMax <= value);
+	case CONDITION_AE:
+		return decide(unsignedMin >= value, unsignedMax < value);
+	case CONDITION_LT:
+		return decide(signedMax < signedValue, signedMin >= signedValue);
+	case CONDITION_LE:
+		return decide(signedMax <= signedValue, signedMin > signedValue);
+	case CONDITION_GT:
+		return decide(signedMin > signedValue, signedMax <= signedValue);
+	case CONDITION_GE:
+		return decide(signedMin >= signedValue, signedMax < signedValue);
+	default:
+		return false;
+	}
+}
+
+bool CJitter::SimplifyKnownBits(StatementList& statements)
+{
+	bool changed = false;
+
+	typedef std::pair<CSymbol*, int> SymbolKey;
+	std::map<SymbolKey, KNOWN_BITS> knownBits;
+
+	//Temporaries holding a value shifted left, that a right shift by the same amount would restore
+	struct SHIFTED_VALUE
+	{
+		SymbolRefPtr source;
+		uint32 amount = 0;
+		bool signExtended = false;
+		bool zeroExtended = false;
+	};
+	std::map<CSymbol*, SHIFTED_VALUE> shiftedValues;
+
+	auto isTracked =
+	    [](const SymbolRefPtr& symbolRef) {
+		    auto type = symbolRef->GetSymbol()->m_type;
+		    return (type == SYM_TEMPORARY) || (type == SYM_RELATIVE);
+	    };
+
+	auto getKnownBits =
+	    [&](const SymbolRefPtr& symbolRef) {
+		    if(auto constant = dynamic_symbolref_cast(SYM_CONSTANT, symbolRef))
+		    {
+			    return MakeKnownBits(~constant->m_valueLow, constant->m_valueLow);
+		    }
+		    auto knownBitsIterator = knownBits.find(std::make_pair(symbolRef->GetSymbol().get(), symbolRef->GetVersion()));
+		    if(knownBitsIterator == std::end(knownBits)) return KNOWN_BITS();
+		    return knownBitsIterator->second;
+	    };
+
+	auto makeConstant =
+	    [&](uint32 value) {
+		    return MakeSymbolRef(MakeSymbol(SYM_CONSTANT, value));
+	    };
+
+	auto replaceWithMov =
+	    [&](STATEMENT& statement, const SymbolRefPtr& value) {
+		    statement.op = OP_MOV;
+		    statement.src1 = value;
+		    statement.src2.reset();
+		    statement.src3.reset();
+		    statement.jmpCondition = CONDITION_NEVER;
+		    changed = true;
+	    };
+
+	for(auto& statement : statements)
+	{
+		//Replace sources whose value is entirely known and give constant folding a chance
+		bool sourceReplaced = false;
+		statement.VisitSources(
+		    [&](SymbolRefPtr& symbolRef, bool) {
+			    if(!isTracked(symbolRef)) return;
+			    auto bits = getKnownBits(symbolRef);
+			    if(!bits.IsConstant()) return;
+			    symbolRef = makeConstant(bits.ones);
+			    sourceReplaced = true;
+		    });
+		if(sourceReplaced)
+		{
+			FoldConstantOperation(statement);
+			changed = true;
+		}
+
+		//Memory accessed through references or by called functions might overlap relatives
+		switch(statement.op)
+		{
+		case OP_CALL:
+		case OP_STOREATREF:
+		case OP_STORE8ATREF:
+		case OP_STORE16ATREF:
+		case OP_MD_STOREATREF_MASKED:
+			for(auto knownBitsIterator = knownBits.begin(); knownBitsIterator != knownBits.end();)
+			{
+				if(knownBitsIterator->first.first->IsTemporary())
+				{
+					++knownBitsIterator;
+				}
+				else
+				{
+					knownBitsIterator = knownBits.erase(knownBitsIterator);
+				}
+			}
+			for(auto shiftedValueIterator = shiftedValues.begin(); shiftedValueIterator != shiftedValues.end();)
+			{
+				if(shiftedValueIterator->second.source->GetSymbol()->IsTemporary())
+				{
+					++shiftedValueIterator;
+				}
+				else
+				{
+					shiftedValueIterator = shiftedValues.erase(shiftedValueIterator);
+				}
+			}
+			break;
+		default:
+			break;
+		}
+
+		auto src1cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src1);
+		auto src2cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		auto src3cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src3);
+
+		//Remove operations that don't change any bit that could be set
+		if((statement.op == OP_AND) && (src1cst || src2cst) && !(src1cst && src2cst))
+		{
+			auto value = src1cst ? statement.src2 : statement.src1;
+			uint32 mask = src1cst ? src1cst->m_valueLow : src2cst->m_valueLow;
+			if((~mask & ~getKnownBits(value).zeroes) == 0)
+			{
+				replaceWithMov(statement, value);
+			}
+		}
+		else if((statement.op == OP_OR) && (src1cst || src2cst) && !(src1cst && src2cst))
+		{
+			auto value = src1cst ? statement.src2 : statement.src1;
+			uint32 mask = src1cst ? src1cst->m_valueLow : src2cst->m_valueLow;
+			if((mask & ~getKnownBits(value).ones) == 0)
+			{
+				replaceWithMov(statement, value);
+			}
+		}
+		else if(((statement.op == OP_SRA) || (statement.op == OP_SRL)) && !src1cst && src2cst)
+		{
+			uint32 amount = src2cst->m_valueLow & 0x1F;
+			auto bits = getKnownBits(statement.src1);
+			auto shiftedValueIterator = shiftedValues.find(statement.src1->GetSymbol().get());
+			if(shiftedValueIterator != std::end(shiftedValues))
+			{
+				//Shifting left then right by the same amount might be a redundant sign or zero extension
+				const auto& shiftedValue = shiftedValueIterator->second;
+				if(
+				    (shiftedValue.amount == amount) &&
+				    ((statement.op == OP_SRA) ? shiftedValue.signExtended : shiftedValue.zeroExtended))
+				{
+					replaceWithMov(statement, shiftedValue.source);
+				}
+			}
+			if(statement.op == OP_SRA)
+			{
+				if(bits.signBits == 32)
+				{
+					replaceWithMov(statement, statement.src1);
+				}
+				else if(bits.zeroes & 0x80000000)
+				{
+					//Value is positive, no sign bits to shift in
+					statement.op = OP_SRL;
+					changed = true;
+				}
+			}
+		}
+		else if(((statement.op == OP_EXTRACTBITS) || (statement.op == OP_EXTRACTBITSS)) && !src1cst)
+		{
+			assert(src2cst && src3cst);
+			uint32 width = src3cst->m_valueLow;
+			auto bits = getKnownBits(statement.src1);
+			if((src2cst->m_valueLow == 0) && (width != 32))
+			{
+				uint32 highMask = ~((1U << width) - 1);
+				bool redundant = (statement.op == OP_EXTRACTBITSS) ? (bits.signBits >= (33 - width)) : ((bits.zeroes & highMask) == highMask);
+				if(redundant)
+				{
+					replaceWithMov(statement, statement.src1);
+				}
+			}
+		}
+		else if(((statement.op == OP_CMP) || (statement.op == OP_CONDJMP)) && !src1cst && src2cst)
+		{
+			bool result = false;
+			if(EvaluateKnownComparison(statement.jmpCondition, getKnownBits(statement.src1), src2cst->m_valueLow, result))
+			{
+				if(statement.op == OP_CMP)
+				{
+					replaceWithMov(statement, makeConstant(result ? 1 : 0));
+				}
+				else
+				{
+					statement.op = result ? OP_JMP : OP_NOP;
+					statement.src1.reset();
+					statement.src2.reset();
+					changed = true;
+				}
+			}
+		}
+
+		if(!statement.dst) continue;
+
+		//Values depending on the previous value of the destination aren't valid anymore
+		auto dstSymbol = statement.dst->GetSymbol().get();
+		for(auto shiftedValueIterator = shiftedValues.begin(); shiftedValueIterator != shiftedValues.end();)
+		{
+			auto sourceSymbol = shiftedValueIterator->second.source->GetSymbol().get();
+			if(
+			    (shiftedValueIterator->first == dstSymbol) ||
+			    sourceSymbol->Equals(dstSymbol) || sourceSymbol->Aliases(dstSymbol))
+			{
+				shiftedValueIterator = shiftedValues.erase(shiftedValueIterator);
+			}
+			else
+			{
+				++shiftedValueIterator;
+			}
+		}
+
+		if(!isTracked(statement.dst)) continue;
+
+		src1cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src1);
+		src2cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		src3cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src3);
+
+		KNOWN_BITS result;
+		switch(statement.op)
+		{
+		case OP_MOV:
+			result = getKnownBits(statement.src1);
+			break;
+		case OP_AND:
+		case OP_OR:
+		case OP_XOR:
+		{
+			auto bits1 = getKnownBits(statement.src1);
+			auto bits2 = getKnownBits(statement.src2);
+			uint32 signBits = std::min(bits1.signBits, bits2.signBits);
+			if(statement.op == OP_AND)
+			{
+				result = MakeKnownBits(bits1.zeroes | bits2.zeroes, bits1.ones & bits2.ones, signBits);
+			}
+			else if(statement.op == OP_OR)
+			{
+				result = MakeKnownBits(bits1.zeroes & bits2.zeroes, bits1.ones | bits2.ones, signBits);
+			}
+			else
+			{
+				result = MakeKnownBits(
+				    (bits1.zeroes & bits2.zeroes) | (bits1.ones & bits2.ones),
+				    (bits1.zeroes & bits2.ones) | (bits1.ones & bits2.zeroes), signBits);
+			}
+		}
+		break;
+		case OP_NOT:
+		{
+			auto bits = getKnownBits(statement.src1);
+			result = MakeKnownBits(bits.ones, bits.zeroes, bits.signBits);
+		}
+		break;
+		case OP_SLL:
+		case OP_SRL:
+		case OP_SRA:
+			if(src2cst)
+			{
+				uint32 amount = src2cst->m_valueLow & 0x1F;
+				auto bits = getKnownBits(statement.src1);
+				if(statement.op == OP_SLL)
+				{
+					uint32 lowMask = (1U << amount) - 1;
+					uint32 signBits = (bits.signBits > amount) ? (bits.signBits - amount) : 1;
+					result = MakeKnownBits((bits.zeroes << amount) | lowMask, bits.ones << amount, signBits);
+				}
+				else if(statement.op == OP_SRL)
+				{
+					uint32 highMask = ~(~0U >> amount);
+					result = MakeKnownBits((bits.zeroes >> amount) | highMask, bits.ones >> amount);
+				}
+				else
+				{
+					uint32 signBits = std::min<uint32>(bits.signBits + amount, 32);
+					result = MakeKnownBits(
+					    static_cast<int32>(bits.zeroes) >> amount,
+					    static_cast<int32>(bits.ones) >> amount, signBits);
+				}
+			}
+			break;
+		case OP_LOAD8FROMREF:
+			result = MakeKnownBits(0xFFFFFF00, 0);
+			break;
+		case OP_LOAD16FROMREF:
+			result = MakeKnownBits(0xFFFF0000, 0);
+			break;
+		case OP_EXTRACTBITS:
+		case OP_EXTRACTBITSS:
+			if(src3cst && (src3cst->m_valueLow != 32))
+			{
+				uint32 width = src3cst->m_valueLow;
+				if(statement.op == OP_EXTRACTBITS)
+				{
+					result = MakeKnownBits(~((1U << width) - 1), 0);
+				}
+				else
+				{
+					result = MakeKnownBits(0, 0, 33 - width);
+				}
+			}
+			break;
+		case OP_CMP:
+			result = MakeKnownBits(~1U, 0);
+			break;
+		case OP_LZC:
+			result = MakeKnownBits(~0x1FU, 0);
+			break;
+		case OP_SELECT:
+		{
+			auto bits2 = getKnownBits(statement.src2);
+			auto bits3 = getKnownBits(statement.src3);
+			result = MakeKnownBits(bits2.zeroes & bits3.zeroes, bits2.ones & bits3.ones, std::min(bits2.signBits, bits3.signBits));
+		}
+		break;
+		default:
+			break;
+		}
+
+		//Every bit of the result is known, let constant propagation take care of the rest
+		if(result.IsConstant() && !(statement.op == OP_MOV && src1cst))
+		{
+			replaceWithMov(statement, makeConstant(result.ones));
+		}
+
+		knownBits[std::make_pair(dstSymbol, statement.dst->GetVersion())] = result;
+
+		if((statement.op == OP_SLL) && src2cst && statement.dst->GetSymbol()->IsTemporary())
+		{
+			uint32 amount = src2cst->m_valueLow & 0x1F;
+			auto bits = getKnownBits(statement.src1);
+			uint32 highMask = ~(~0U >> amount);
+			SHIFTED_VALUE shiftedValue;
+			shiftedValue.source = statement.src1;
+			shiftedValue.amount = amount;
+			shiftedValue.signExtended = bits.signBits > amount;
+			shiftedValue.zeroExtended = (bits.zeroes & highMask) == highMask;
+			if((amount != 0) && (shiftedValue.signExtended || shiftedValue.zeroExtended))
+			{
+				shiftedValues[dstSymbol] = shiftedValue;
+			}
+		}
+	}
+
+	return changed;
+}
+
+void CJitter::FixFlowControl(StatementList& statements)
+{
+	//Resolve GOTO instructions
+	for(auto& statement : statements)
+	{
+		if(statement.op == OP_GOTO)
+		{
+			LabelMapType::const_iterator labelIterator = m_labels.find(statement.jmpBlock);
+			assert(labelIterator != m_labels.end());
+			if(labelIterator == m_labels.end()) continue;
+
+			statement.op = OP_JMP;
+			statement.jmpBlock = labelIterator->second;
+		}
+	}
+
+	//Remove any excess flow control instructions
+	for(StatementList::iterator statementIterator(statements.begin());
+	    statementIterator != statements.end(); ++statementIterator)
+	{
+		const STATEMENT& statement(*statementIterator);
+
+		if(statement.op == OP_JMP || statement.op == OP_CONDJMP)
+		{
+			++statementIterator;
+			statements.erase(statementIterator, statements.end());
+			break;
+		}
+	}
+}
+
+void CJitter::MergeBasicBlocks(BASIC_BLOCK& dstBlock, const BASIC_BLOCK& srcBlock)
+{
+	auto& dstSymbolTable = dstBlock.symbolTable;
+
+	for(auto statement : srcBlock.statements)
+	{
+		statement.VisitOperands(
+		    [&dstSymbolTable](SymbolRefPtr& symbolRef, bool) {
+			    auto symbol = symbolRef->GetSymbol();
+			    symbolRef = std::make_shared<CSymbolRef>(dstSymbolTable.MakeSymbol(symbol));
+		    });
+		dstBlock.statements.push_back(statement);
+	}
+
+	dstBlock.optimized = false;
+}
+
+CJitter::BASIC_BLOCK CJitter::ConcatBlocks(const BasicBlockList& blocks)
+{
+	BASIC_BLOCK result;
+	for(const auto& basicBlock : blocks)
+	{
+		//First, add a mark label statement
+		STATEMENT labelStatement;
+		labelStatement.op = OP_LABEL;
+		labelStatement.jmpBlock = basicBlock.id;
+		result.statements.push_back(labelStatement);
+
+		MergeBasicBlocks(result, basicBlock);
+	}
+	return result;
+}
+
+bool CJitter::PruneBlocks()
+{
+	bool changed = true;
+	int deletedBlocks = 0;
+
+	while(changed)
+	{
+		changed = false;
+
+		auto toDeleteIterator = m_basicBlocks.cend();
+		for(auto outerBlockIterator(m_basicBlocks.cbegin());
+		    outerBlockIterator != m_basicBlocks.cend(); outerBlockIterator++)
+		{
+			//First block is always referenced
+			if(outerBlockIterator == m_basicBlocks.begin()) continue;
+
+			auto candidateBlockIterator = outerBlockIterator;
+			bool referenced = false;
+
+			//Check if there's a reference to this block in here
+			for(auto innerBlockIterator(m_basicBlocks.cbegin());
+			    innerBlockIterator != m_basicBlocks.cend(); innerBlockIterator++)
+			{
+				const auto& block(*innerBlockIterator);
+				bool referencesNext = false;
+
+				if(block.statements.empty())
+				{
+					//Empty blocks references next one
+					referencesNext = true;
+				}
+				else
+				{
+					//Check if this block references the next one or if it jumps to another one
+					auto lastInstruction(block.statements.end());
+					lastInstruction--;
+					const auto& statement(*lastInstruction);
+
+					//It jumps to a block, so check if it references the one we're looking for
+					if(statement.op == OP_JMP || statement.op == OP_CONDJMP)
+					{
+						if(statement.jmpBlock == candidateBlockIterator->id)
+						{
+							referenced = true;
+							break;
+						}
+					}
+
+					//Otherwise, it references the next one if it's not a jump
+					if(statement.op != OP_JMP)
+					{
+						referencesNext = true;
+					}
+				}
+
+				if(referencesNext)
+				{
+					auto nextBlockIterator(innerBlockIterator);
+					nextBlockIterator++;
+					if(nextBlockIterator != m_basicBlocks.end())
+					{
+						if(nextBlockIterator->id == candidateBlockIterator->id)
+						{
+							referenced = true;
+							break;
+						}
+					}
+				}
+			}
+
+			if(!referenced)
+			{
+				toDeleteIterator = candidateBlockIterator;
+				break;
+			}
+		}
+		if(toDeleteIterator == m_basicBlocks.end()) continue;
+
+		m_basicBlocks.erase(toDeleteIterator);
+		deletedBlocks++;
+		changed = true;
+	}
+
+	HarmonizeBlocks();
+	return deletedBlocks != 0;
+}
+
+void CJitter::HarmonizeBlocks()
+{
+	//Remove any jumps that jump to the next block
+	for(BasicBlockList::iterator blockIterator(m_basicBlocks.begin());
 	    blockIterator != m_basicBlocks.end(); ++blockIterator)
 	{
-		BasicBlockList::iterator nextBlockIterator(blockIterator);
-		++nextBlockIterator;
-		if(nextBlockIterator == m_basicBlocks.end()) continue;
+		BasicBlockList::iterator nextBlockIterator(blockIterator);
+		++nextBlockIterator;
+		if(nextBlockIterator == m_basicBlocks.end()) continue;
+
+		auto& basicBlock(*blockIterator);
+		if(basicBlock.statements.size() == 0) continue;
+
+		StatementList::iterator lastStatementIterator(basicBlock.statements.end());
+		--lastStatementIterator;
+		const STATEMENT& statement(*lastStatementIterator);
+		if(statement.op != OP_JMP) continue;
+		if(statement.jmpBlock != nextBlockIterator->id) continue;
+
+		//Remove the jump
+		basicBlock.statements.erase(lastStatementIterator);
+	}
+
+	//Flag any block that have a reference from a jump
+	for(BasicBlockList::iterator outerBlockIterator(m_basicBlocks.begin());
+	    outerBlockIterator != m_basicBlocks.end(); ++outerBlockIterator)
+	{
+		auto& outerBlock(*outerBlockIterator);
+		outerBlock.hasJumpRef = false;
+
+		for(const auto& block : m_basicBlocks)
+		{
+			if(block.statements.size() == 0) continue;
+
+			//Check if this block references the next one or if it jumps to another one
+			StatementList::const_iterator lastInstruction(block.statements.end());
+			--lastInstruction;
+			const STATEMENT& statement(*lastInstruction);
+
+			//It jumps to a block, so check if it references the one we're looking for
+			if(statement.op == OP_JMP || statement.op == OP_CONDJMP)
+			{
+				if(statement.jmpBlock == outerBlockIterator->id)
+				{
+					outerBlock.hasJumpRef = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+bool CJitter::MergeBlocks()
+{
+	int deletedBlocks = 0;
+	bool changed = true;
+	while(changed)
+	{
+		changed = false;
+		for(BasicBlockList::iterator blockIterator(m_basicBlocks.begin());
+		    m_basicBlocks.end() != blockIterator; ++blockIterator)
+		{
+			BasicBlockList::iterator nextBlockIterator(blockIterator);
+			++nextBlockIterator;
+			if(nextBlockIterator == m_basicBlocks.end()) continue;
+
+			auto& basicBlock(*blockIterator);
+			auto& nextBlock(*nextBlockIterator);
+
+			if(nextBlock.hasJumpRef) continue;
+
+			//Check if the last statement is a jump
+			if(!basicBlock.statements.empty())
+			{
+				auto lastStatementIterator(basicBlock.statements.end());
+				--lastStatementIterator;
+				const auto& statement(*lastStatementIterator);
+				if(statement.op == OP_CONDJMP) continue;
+				if(statement.op == OP_JMP) continue;
+			}
+
+			//Blocks can be merged
+			MergeBasicBlocks(basicBlock, nextBlock);
+
+			m_basicBlocks.erase(nextBlockIterator);
+
+			++deletedBlocks;
+			changed = true;
+			break;
+		}
+	}
+	return deletedBlocks != 0;
+}
+
+bool CJitter::ConstantPropagation(StatementList& statements)
+{
+	bool changed = false;
+
+	for(StatementList::iterator outerStatementIterator(statements.begin());
+	    statements.end() != outerStatementIterator; ++outerStatementIterator)
+	{
+		STATEMENT& outerStatement(*outerStatementIterator);
+
+		if(outerStatement.op != OP_MOV) continue;
+
+		CSymbol* constant = dynamic_symbolref_cast(SYM_CONSTANT, outerStatement.src1);
+		if(constant == NULL)
+		{
+			constant = dynamic_symbolref_cast(SYM_CONSTANT64, outerStatement.src1);
+		}
+		if(!constant) continue;
+
+		//Find anything that uses this operand and replace it with the constant
+		for(StatementList::iterator innerStatementIterator(outerStatementIterator);
+		    statements.end() != innerStatementIterator; ++innerStatementIterator)
+		{
+			if(outerStatementIterator == innerStatementIterator) continue;
+
+			auto& innerStatement(*innerStatementIterator);
+
+			innerStatement.VisitSources(
+			    [&](SymbolRefPtr& symbol, bool) {
+				    if(symbol->Equals(outerStatement.dst.get()))
+				    {
+					    symbol = outerStatement.src1;
+					    changed = true;
+				    }
+			    });
+		}
+	}
+	return changed;
+}
+
+bool CJitter::ReorderAdd(StatementList& statements)
+{
+	bool changed = false;
+
+	for(auto statementIterator(statements.begin());
+	    statements.end() != statementIterator; ++statementIterator)
+	{
+		auto& statement(*statementIterator);
+
+		//We're only interested by additions
+		if(statement.op != OP_ADD) continue;
+
+		//Do some more checks
+		auto addDst = statement.dst.get();
+		assert(addDst);
+
+		auto addSrc2Cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+
+		//Don't mess with relatives
+		if(addDst->GetSymbol()->IsRelative() || !addSrc2Cst)
+		{
+			continue;
+		}
+
+		//Check for OP_SLL that uses the result of this operation and propagate the shift
+		auto nextStatementIterator = std::next(statementIterator);
+		auto& nextStatement(*nextStatementIterator);
+		if(nextStatement.op == OP_SLL && nextStatement.src1->Equals(addDst))
+		{
+			auto shiftSrc2Cst = dynamic_symbolref_cast(SYM_CONSTANT, nextStatement.src2);
+			if(shiftSrc2Cst)
+			{
+				uint32 result = addSrc2Cst->m_valueLow << shiftSrc2Cst->m_valueLow;
+
+				std::swap(statement, nextStatement);
+				std::swap(statement.src1, nextStatement.src1);
+				std::swap(statement.dst, nextStatement.dst);
+				nextStatement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, result));
+				changed = true;
+			}
+		}
+	}
+	return changed;
+}
+
+bool CJitter::CopyPropagation(StatementList& statements)
+{
+	bool changed = false;
+
+	struct USAGEINFO
+	{
+		uint32 count = 0;
+		StatementList::iterator lastUse;
+	};
+	std::map<SymbolPtr, USAGEINFO> usageInfos;
+
+	for(auto statementIterator(statements.begin());
+	    statements.end() != statementIterator; ++statementIterator)
+	{
+		auto& statement(*statementIterator);
+
+		statement.VisitSources(
+		    [&](const SymbolRefPtr& symbolRef, bool) {
+			    auto symbol = symbolRef->GetSymbol();
+			    if(symbol->IsRelative()) return;
+			    if(symbol->IsConstant()) return;
+			    auto& usageInfo = usageInfos[symbol];
+			    usageInfo.count++;
+			    usageInfo.lastUse = statementIterator;
+		    });
+	}
+
+	for(auto outerStatementIterator(statements.begin());
+	    statements.end() != outerStatementIterator; ++outerStatementIterator)
+	{
+		auto& outerStatement(*outerStatementIterator);
+
+		//Some operations we can't propagate
+		if(outerStatement.op == OP_RETVAL) continue;
+
+		CSymbolRef* outerDstSymbol = outerStatement.dst.get();
+		if(outerDstSymbol == NULL) continue;
+
+		//Don't mess with relatives
+		if(outerDstSymbol->GetSymbol()->IsRelative())
+		{
+			continue;
+		}
+
+		auto usageInfoIterator = usageInfos.find(outerDstSymbol->GetSymbol());
+		if(usageInfoIterator == std::end(usageInfos))
+		{
+			continue;
+		}
+
+		const auto& usageInfo = usageInfoIterator->second;
+		if(usageInfo.count != 1)
+		{
+			continue;
+		}
+
+		auto& innerStatement(*usageInfo.lastUse);
+		if(!innerStatement.src1->Equals(outerDstSymbol))
+		{
+			//Possibly excluding interesting optimization possibilities
+			continue;
+		}
+
+		//Substitute a OP_MOV statement that use outerDstSymbol with its definition (outerStatement)
+		//Example:
+		//outerDstSymbol -> t0
+		//Before:
+		// - t0 = r0 + r1   //outerStatement
+		// - t1 = t0        //innerStatement
+		//After:
+		// - t0 = r0 + r1   //outerStatement
+		// - t1 = r0 + r1   //innerStatement
+		//After substitution, t0 will not be used anymore making outerStatement eligible for removal
+		if(innerStatement.op == OP_MOV)
+		{
+			innerStatement.op = outerStatement.op;
+			innerStatement.src1 = outerStatement.src1;
+			innerStatement.src2 = outerStatement.src2;
+			innerStatement.src3 = outerStatement.src3;
+			innerStatement.jmpCondition = outerStatement.jmpCondition;
+			changed = true;
+		}
+		//Substitute src operand of a statement if our defining statement (outerStatement) is a OP_MOV
+		//Example:
+		//outerDstSymbol -> t0
+		//Before:
+		// - t0 = r0
+		// - r1 = t0 & r2
+		//After:
+		// - t0 = r0
+		// - r1 = r0 & r2
+		//After substitution, t0 will not be used anymore making outerStatement eligible for removal
+		else if(outerStatement.op == OP_MOV)
+		{
+			auto replacementSym = outerStatement.src1;
+			innerStatement.VisitSources(
+			    [&](SymbolRefPtr& symbol, bool) {
+				    if(symbol->Equals(outerDstSymbol))
+				    {
+					    symbol = replacementSym;
+					    changed = true;
+				    }
+			    });
+			assert(changed);
+		}
+		//Find all the add/sub constant and add them together
+		//Example
+		//outerDstSymbol -> t0
+		//Before:
+		// - t0 = r0 + 10   //outerStatement
+		// - t1 = t0 + 20   //innerStatement
+		//After:
+		// - t0 = r0 + 10   //outerStatement
+		// - t1 = r0 + 30   //innerStatement
+		//After substitution, t0 will not be used anymore making outerStatement eligible for removal
+		else if(
+		    (outerStatement.op == innerStatement.op) &&
+		    ((innerStatement.op == OP_ADD) || (innerStatement.op == OP_ADDREF)))
+		{
+			auto innerSrc2cst = dynamic_symbolref_cast(SYM_CONSTANT, innerStatement.src2);
+			auto outerSrc2cst = dynamic_symbolref_cast(SYM_CONSTANT, outerStatement.src2);
+			if(innerSrc2cst && outerSrc2cst)
+			{
+				uint32 result = innerSrc2cst->m_valueLow + outerSrc2cst->m_valueLow;
+				innerStatement.src1 = outerStatement.src1;
+				innerStatement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, result));
+				changed = true;
+			}
+		}
+	}
+
+	return changed;
+}
+
+bool CJitter::CommonExpressionElimination(VERSIONED_STATEMENT_LIST& versionedStatementList)
+{
+	bool changed = false;
+	std::vector<StatementList::const_iterator> tempDefs;
+	std::unordered_map<SymbolPtr, SymbolPtr> tempReplaceMap;
+	tempDefs.reserve(versionedStatementList.statements.size());
+
+	for(auto statementIterator(versionedStatementList.statements.begin());
+	    versionedStatementList.statements.end() != statementIterator; ++statementIterator)
+	{
+		auto& statement(*statementIterator);
 
-		auto& basicBlock(*blockIterator);
-		if(basicBlock.statements.size() == 0) continue;
+		//If this is a statement defining a temporary
+		if(
+		    (statement.op != OP_RETVAL) &&
+		    (statement.dst) &&
+		    (statement.dst->GetSymbol()->IsTemporary()))
+		{
+			const auto& newTemp = statement.dst->GetSymbol();
 
-		StatementList::iterator lastStatementIterator(basicBlock.statements.end());
-		--lastStatementIterator;
-		const STATEMENT& statement(*lastStatementIterator);
-		if(statement.op != OP_JMP) continue;
-		if(statement.jmpBlock != nextBlockIterator->id) continue;
+			bool found = false;
+			//Check if our temporary already has a similar definition
+			for(const auto& tempDef : tempDefs)
+			{
+				const auto& tempDefStatement = *tempDef;
+				assert(tempDefStatement.dst);
+				const auto& temp = tempDefStatement.dst;
+				if(statement.op != tempDefStatement.op) continue;
+				if(statement.jmpCondition != tempDefStatement.jmpCondition) continue;
+				if(statement.src1 && !statement.src1->Equals(tempDefStatement.src1.get())) continue;
+				if(statement.src2 && !statement.src2->Equals(tempDefStatement.src2.get())) continue;
+				if(statement.src3 && !statement.src3->Equals(tempDefStatement.src3.get())) continue;
+				auto [_, inserted] = tempReplaceMap.insert(std::make_pair(newTemp, temp->GetSymbol()));
+				assert(inserted);
+				found = true;
+				//We assume the first replacement we find is gonna be the best
+				break;
+			}
 
-		//Remove the jump
-		basicBlock.statements.erase(lastStatementIterator);
+			//We haven't found a replacement for our definition, assume it's new
+			if(!found)
+			{
+				tempDefs.push_back(statementIterator);
+			}
+		}
+
+		if(tempReplaceMap.empty())
+		{
+			continue;
+		}
+
+		statement.VisitSources(
+		    [&](SymbolRefPtr& innerSymbolRef, bool) {
+			    if(!innerSymbolRef->GetSymbol()->IsTemporary()) return;
+			    if(auto tempReplaceIterator = tempReplaceMap.find(innerSymbolRef->GetSymbol()); tempReplaceIterator != std::end(tempReplaceMap))
+			    {
+				    innerSymbolRef = MakeSymbolRef(tempReplaceIterator->second);
+				    changed = true;
+			    }
+		    });
 	}
 
-	//Flag any block that have a reference from a jump
-	for(BasicBlockList::iterator outerBlockIterator(m_basicBlocks.begin());
-	    outerBlockIterator != m_basicBlocks.end(); ++outerBlockIterator)
+	return changed;
+}
+
+bool CJitter::ClampingElimination(StatementList& statements)
+{
+	bool changed = false;
+
+	std::map<uint32, uint32> temporaryValues;
+
+	for(auto statementIterator(statements.begin());
+	    statements.end() != statementIterator; ++statementIterator)
 	{
-		auto& outerBlock(*outerBlockIterator);
-		outerBlock.hasJumpRef = false;
+		auto& statement = *statementIterator;
+
+		auto dstSymbol = dynamic_symbolref_cast(SYM_TEMPORARY128, statement.dst);
+
+		if((statement.op == OP_MD_EXPAND_W) &&
+		   dstSymbol &&
+		   statement.src1->GetSymbol()->IsConstant())
+		{
+			auto src1Symbol = dynamic_symbolref_cast(SYM_CONSTANT, statement.src1);
+			temporaryValues.insert(
+			    std::make_pair(dstSymbol->m_valueLow, src1Symbol->m_valueLow));
+		}
+		else if(dstSymbol)
+		{
+			//Make sure that our temporary value doesn't get modified
+			assert(temporaryValues.find(dstSymbol->m_valueLow) == std::end(temporaryValues));
+		}
+
+		if((statement.op == OP_MD_CLAMP_S) &&
+		   statement.src1->GetSymbol()->IsTemporary())
+		{
+			auto src1Symbol = dynamic_symbolref_cast(SYM_TEMPORARY128, statement.src1);
+			auto tempCstValue = temporaryValues.find(src1Symbol->m_valueLow);
+			if(tempCstValue != std::end(temporaryValues))
+			{
+				if((tempCstValue->second & 0x7F800000) != 0x7F800000)
+				{
+					//No clamping needed here
+					statement.op = OP_MOV;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	return changed;
+}
+
+static SYM_TYPE GetRelativeTypeForValue(const CSymbol* symbol)
+{
+	switch(symbol->m_type)
+	{
+	case SYM_CONSTANT:
+	case SYM_RELATIVE:
+	case SYM_TEMPORARY:
+		return SYM_RELATIVE;
+	case SYM_CONSTANT64:
+	case SYM_RELATIVE64:
+	case SYM_TEMPORARY64:
+		return SYM_RELATIVE64;
+	case SYM_RELATIVE128:
+	case SYM_TEMPORARY128:
+		return SYM_RELATIVE128;
+	default:
+		return SYM_CONTEXT;
+	}
+}
+
+static bool IsFoldableRelativeOffset(SYM_TYPE type, uint32 offset)
+{
+	//Relatives are accessed with an immediate offset from the context register,
+	//stay within what every code generator can encode (AArch32's LDR/LDRD immediates)
+	switch(type)
+	{
+	case SYM_RELATIVE:
+		return ((offset & 0x03) == 0) && (offset < 0x1000);
+	case SYM_RELATIVE64:
+		return ((offset & 0x07) == 0) && (offset < 0x100);
+	case SYM_RELATIVE128:
+		return ((offset & 0x0F) == 0) && (offset < 0x10000);
+	default:
+		return false;
+	}
+}
+
+bool CJitter::FoldRelativeReferences(StatementList& statements)
+{
+	//Loads and stores through references to known context addresses (OP_RELTOREF
+	//followed by constant OP_ADDREFs) are replaced by plain relative accesses.
+	//Those can then be versioned and register allocated like any other relative.
+	//8-bit and 16-bit accesses are kept as is, there are no relatives of those sizes.
+
+	//Accesses left in memory won't see relatives kept in registers. Nothing is folded
+	//if a reference is accessed at an unknown offset or escapes, and accesses overlapping
+	//with ones that can't be folded are kept as is.
+
+	bool changed = false;
+
+	//Maps temporary reference to the context offset it points to
+	std::map<uint32, uint32> referenceOffsets;
+
+	auto getReferenceOffset =
+	    [&](const SymbolRefPtr& symbolRef, uint32& offset) {
+		    auto symbol = dynamic_symbolref_cast(SYM_TMP_REFERENCE, symbolRef);
+		    if(!symbol) return false;
+		    auto offsetIterator = referenceOffsets.find(symbol->m_valueLow);
+		    if(offsetIterator == std::end(referenceOffsets)) return false;
+		    offset = offsetIterator->second;
+		    return true;
+	    };
+
+	auto trackReference =
+	    [&](const STATEMENT& statement) {
+		    auto dst = dynamic_symbolref_cast(SYM_TMP_REFERENCE, statement.dst);
+		    if(!dst) return;
+		    uint32 offset = 0;
+		    bool hasOffset = false;
+		    if(statement.op == OP_RELTOREF)
+		    {
+			    auto baseOffset = dynamic_symbolref_cast(SYM_CONSTANT, statement.src1);
+			    assert(baseOffset);
+			    offset = baseOffset->m_valueLow;
+			    hasOffset = true;
+		    }
+		    else if((statement.op == OP_ADDREF) && getReferenceOffset(statement.src1, offset))
+		    {
+			    if(auto addend = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2))
+			    {
+				    offset += addend->m_valueLow;
+				    hasOffset = true;
+			    }
+		    }
+		    referenceOffsets.erase(dst->m_valueLow);
+		    if(hasOffset)
+		    {
+			    referenceOffsets[dst->m_valueLow] = offset;
+		    }
+	    };
+
+	//Adds the constant index of an indexed access to the offset
+	auto addIndex =
+	    [](const SymbolRefPtr& indexRef, uint32 scale, uint32& offset) {
+		    if(!indexRef) return true;
+		    auto index = dynamic_symbolref_cast(SYM_CONSTANT, indexRef);
+		    if(!index) return false;
+		    offset += index->m_valueLow * scale;
+		    return true;
+	    };
+
+	//Finds the context range accessed through a tracked reference, false if unknown.
+	//relativeType is SYM_CONTEXT if the access can't be folded.
+	auto getAccess =
+	    [&](const STATEMENT& statement, uint32& offset, uint32& size, SYM_TYPE& relativeType) {
+		    if(!getReferenceOffset(statement.src1, offset)) return false;
+		    auto scale = static_cast<uint32>(statement.jmpCondition);
+		    //Indexed stores have the index in src2 and the value in src3
+		    auto storeIndexRef = statement.src3 ? statement.src2 : SymbolRefPtr();
+		    auto storeValueRef = statement.src3 ? statement.src3 : statement.src2;
+		    relativeType = SYM_CONTEXT;
+		    switch(statement.op)
+		    {
+		    case OP_LOADFROMREF:
+			    if(!addIndex(statement.src2, scale, offset)) return false;
+			    relativeType = GetRelativeTypeForValue(statement.dst->GetSymbol().get());
+			    break;
+		    case OP_LOAD8FROMREF:
+		    case OP_LOAD16FROMREF:
+			    if(!addIndex(statement.src2, scale, offset)) return false;
+			    size = (statement.op == OP_LOAD8FROMREF) ? 1 : 2;
+			    return true;
+		    case OP_STOREATREF:
+			    if(!addIndex(storeIndexRef, scale, offset)) return false;
+			    relativeType = GetRelativeTypeForValue(storeValueRef->GetSymbol().get());
+			    break;
+		    case OP_STORE8ATREF:
+		    case OP_STORE16ATREF:
+			    if(!addIndex(storeIndexRef, scale, offset)) return false;
+			    size = (statement.op == OP_STORE8ATREF) ? 1 : 2;
+			    return true;
+		    case OP_MD_LOADFROMREF_MASKED:
+		    case OP_MD_STOREATREF_MASKED:
+			    //Masked ops always have an index, scaled by 1
+			    if(!addIndex(statement.src2, 1, offset)) return false;
+			    relativeType = SYM_RELATIVE128;
+			    break;
+		    default:
+			    return false;
+		    }
+		    switch(relativeType)
+		    {
+		    case SYM_RELATIVE:
+			    size = 4;
+			    break;
+		    case SYM_RELATIVE64:
+			    size = 8;
+			    break;
+		    case SYM_RELATIVE128:
+			    size = 16;
+			    break;
+		    default:
+			    return false;
+		    }
+		    if(!IsFoldableRelativeOffset(relativeType, offset))
+		    {
+			    relativeType = SYM_CONTEXT;
+		    }
+		    return true;
+	    };
+
+	//Context ranges accessed through references that stay in memory
+	std::vector<std::pair<uint32, uint32>> memoryRanges;
+	bool hasFoldableAccess = false;
+
+	for(const auto& statement : statements)
+	{
+		uint32 offset = 0;
+		if(getReferenceOffset(statement.src2, offset) || getReferenceOffset(statement.src3, offset))
+		{
+			return false;
+		}
+		if(getReferenceOffset(statement.src1, offset))
+		{
+			if(statement.op == OP_ADDREF)
+			{
+				if(!dynamic_symbolref_cast(SYM_CONSTANT, statement.src2)) return false;
+			}
+			else
+			{
+				uint32 size = 0;
+				auto relativeType = SYM_CONTEXT;
+				if(!getAccess(statement, offset, size, relativeType)) return false;
+				if(relativeType == SYM_CONTEXT)
+				{
+					memoryRanges.emplace_back(offset, offset + size);
+				}
+				else
+				{
+					hasFoldableAccess = true;
+				}
+			}
+		}
+		trackReference(statement);
+	}
+
+	if(!hasFoldableAccess) return false;
+
+	auto overlapsMemoryRange =
+	    [&](uint32 offset, uint32 size) {
+		    return std::any_of(std::begin(memoryRanges), std::end(memoryRanges),
+		                       [&](const auto& range) { return (offset < range.second) && (range.first < (offset + size)); });
+	    };
+
+	referenceOffsets.clear();
+	for(auto statementIterator = std::begin(statements); statementIterator != std::end(statements); statementIterator++)
+	{
+		auto& statement = *statementIterator;
+		uint32 offset = 0;
+		uint32 size = 0;
+		auto relativeType = SYM_CONTEXT;
+		if(getAccess(statement, offset, size, relativeType) &&
+		   (relativeType != SYM_CONTEXT) && !overlapsMemoryRange(offset, size))
+		{
+			auto relativeSymbolRef = MakeSymbolRef(MakeSymbol(relativeType, offset));
+			switch(statement.op)
+			{
+			case OP_LOADFROMREF:
+				statement.op = OP_MOV;
+				statement.src1 = relativeSymbolRef;
+				statement.src2.reset();
+				statement.jmpCondition = CONDITION_NEVER;
+				break;
+			case OP_STOREATREF:
+				statement.op = OP_MOV;
+				statement.dst = relativeSymbolRef;
+				statement.src1 = statement.src3 ? statement.src3 : statement.src2;
+				statement.src2.reset();
+				statement.src3.reset();
+				statement.jmpCondition = CONDITION_NEVER;
+				break;
+			case OP_MD_LOADFROMREF_MASKED:
+			{
+				//Lanes selected by the mask come from memory, others from src3.
+				//OP_MD_MOV_MASKED requires dst == src1, copy src3 to dst first.
+				STATEMENT copyStatement;
+				copyStatement.op = OP_MOV;
+				copyStatement.dst = statement.dst;
+				copyStatement.src1 = statement.src3;
+				statements.insert(statementIterator, copyStatement);
+
+				statement.op = OP_MD_MOV_MASKED;
+				statement.src1 = statement.dst;
+				statement.src2 = relativeSymbolRef;
+				statement.src3.reset();
+			}
+			break;
+			case OP_MD_STOREATREF_MASKED:
+				statement.op = OP_MD_MOV_MASKED;
+				statement.dst = relativeSymbolRef;
+				statement.src1 = relativeSymbolRef;
+				statement.src2 = statement.src3;
+				statement.src3.reset();
+				break;
+			default:
+				assert(false);
+				break;
+			}
+			changed = true;
+		}
+		trackReference(statement);
+	}
+
+	return changed;
+}
+
+bool CJitter::MergeCmpSelectOps(StatementList& statements)
+{
+	bool changed = false;
+
+	for(auto statementIterator(statements.begin());
+	    statements.end() != statementIterator; ++statementIterator)
+	{
+		auto& statement = *statementIterator;
+		auto nextStatementIterator = statementIterator;
+		nextStatementIterator++;
+
+		if(nextStatementIterator == std::end(statements)) continue;
+		auto& nextStatement = *nextStatementIterator;
+
+		if(nextStatement.op != OP_SELECT) continue;
+		if(statement.op != OP_CMP) continue;
+
+		auto predicateSymbol = statement.dst;
+
+		if(!nextStatement.src1->Equals(predicateSymbol.get())) continue;
+
+		auto innerStatementIterator = nextStatementIterator;
+		innerStatementIterator++;
+
+		//Make sure predicate isn't used later
+		bool used = false;
+		for(; innerStatementIterator != statements.end(); ++innerStatementIterator)
+		{
+			const auto& innerStatement = *innerStatementIterator;
+			innerStatement.VisitSources([&](const SymbolRefPtr& src, bool isDst) { used |= src->Equals(predicateSymbol.get()); });
+			if(used) break;
+		}
+
+		if(used) continue;
+
+		nextStatement.op = OP_CMPSELECT_P2;
+		nextStatement.jmpCondition = statement.jmpCondition;
+		nextStatement.src1 = nextStatement.src2;
+		nextStatement.src2 = nextStatement.src3;
+		nextStatement.src3.reset();
+
+		statement.op = OP_CMPSELECT_P1;
+		statement.jmpCondition = Jitter::CONDITION_NEVER;
+		statement.dst.reset();
+
+		changed = true;
+	}
+
+	return changed;
+}
+
+bool CJitter::MergeCmpCondJmp(StatementList& statements)
+{
+	//Branches testing the result of a comparison against 0 are made to do the comparison
+	//themselves, which lets the comparison be removed if its result isn't used anymore.
+	//Example:
+	//Before:
+	// - t0 = r0 CMP(LT) r1
+	// - t0 JMP(EQ) 0
+	//After:
+	// - t0 = r0 CMP(LT) r1
+	// - r0 JMP(GE) r1
+	bool changed = false;
+
+	auto isMergeableOperand =
+	    [](const SymbolRefPtr& symbolRef) {
+		    switch(symbolRef->GetSymbol()->m_type)
+		    {
+		    case SYM_CONSTANT:
+		    case SYM_RELATIVE:
+		    case SYM_TEMPORARY:
+			    return true;
+		    default:
+			    return false;
+		    }
+	    };
+
+	for(auto statementIterator = statements.begin();
+	    statementIterator != statements.end(); ++statementIterator)
+	{
+		auto& statement = *statementIterator;
+		if(statement.op != OP_CONDJMP) continue;
+		if((statement.jmpCondition != CONDITION_EQ) && (statement.jmpCondition != CONDITION_NE)) continue;
+		if(statement.src1->GetSymbol()->m_type != SYM_TEMPORARY) continue;
+
+		auto src2cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		if(!src2cst || (src2cst->m_valueLow != 0)) continue;
 
-		for(const auto& block : m_basicBlocks)
+		auto predicate = statement.src1;
+
+		//Find the comparison that defines the predicate
+		auto cmpStatementIterator = statementIterator;
+		bool found = false;
+		while(cmpStatementIterator != statements.begin())
 		{
-			if(block.statements.size() == 0) continue;
+			--cmpStatementIterator;
+			const auto& cmpStatement = *cmpStatementIterator;
+			if(cmpStatement.dst && cmpStatement.dst->Equals(predicate.get()))
+			{
+				found = (cmpStatement.op == OP_CMP);
+				break;
+			}
+		}
+		if(!found) continue;
 
-			//Check if this block references the next one or if it jumps to another one
-			StatementList::const_iterator lastInstruction(block.statements.end());
-			--lastInstruction;
-			const STATEMENT& statement(*lastInstruction);
+		const auto& cmpStatement = *cmpStatementIterator;
+		if(!isMergeableOperand(cmpStatement.src1) || !isMergeableOperand(cmpStatement.src2)) continue;
 
-			//It jumps to a block, so check if it references the one we're looking for
-			if(statement.op == OP_JMP || statement.op == OP_CONDJMP)
+		//Make sure the comparison's operands still hold the same values at the branch
+		bool modified = false;
+		for(auto innerStatementIterator = std::next(cmpStatementIterator);
+		    innerStatementIterator != statementIterator; ++innerStatementIterator)
+		{
+			const auto& innerStatement = *innerStatementIterator;
+			if(!innerStatement.dst) continue;
+			auto dstSymbol = innerStatement.dst->GetSymbol();
+			for(const auto& src : {cmpStatement.src1, cmpStatement.src2})
 			{
-				if(statement.jmpBlock == outerBlockIterator->id)
-				{
-					outerBlock.hasJumpRef = true;
-					break;
-				}
+				auto srcSymbol = src->GetSymbol();
+				modified |= dstSymbol->Equals(srcSymbol.get()) || dstSymbol->Aliases(srcSymbol.get());
 			}
+			if(modified) break;
+		}
+		if(modified) continue;
+
+		//Make sure the predicate isn't needed by anything else
+		bool used = false;
+		for(const auto& otherStatement : statements)
+		{
+			if(&otherStatement == &statement) continue;
+			otherStatement.VisitSources([&](const SymbolRefPtr& src, bool) { used |= src->Equals(predicate.get()); });
+			if(used) break;
 		}
+		if(used) continue;
+
+		statement.jmpCondition = (statement.jmpCondition == CONDITION_NE) ? cmpStatement.jmpCondition : NegateCondition(cmpStatement.jmpCondition);
+		statement.src1 = cmpStatement.src1;
+		statement.src2 = cmpStatement.src2;
+		changed = true;
 	}
+
+	return changed;
 }
 
-bool CJitter::MergeBlocks()
+static bool IsPowerOfTwo(uint32 value)
 {
-	int deletedBlocks = 0;
-	bool changed = true;
-	while(changed)
+	return (value != 0) && ((value & (value - 1)) == 0);
+}
+
+//Returns ceil(log2(value))
+static uint32 GetCeilLog2(uint32 value)
+{
+	uint32 result = 0;
+	while((1ULL << result) < value)
 	{
-		changed = false;
-		for(BasicBlockList::iterator blockIterator(m_basicBlocks.begin());
-		    m_basicBlocks.end() != blockIterator; ++blockIterator)
-		{
-			BasicBlockList::iterator nextBlockIterator(blockIterator);
-			++nextBlockIterator;
-			if(nextBlockIterator == m_basicBlocks.end()) continue;
+		result++;
+	}
+	return result;
+}
 
-			auto& basicBlock(*blockIterator);
-			auto& nextBlock(*nextBlockIterator);
+static uint32 GetTrailingZeroCount(uint32 value)
+{
+	assert(value != 0);
+	uint32 result = 0;
+	while((value & 1) == 0)
+	{
+		value >>= 1;
+		result++;
+	}
+	return result;
+}
 
-			if(nextBlock.hasJumpRef) continue;
+//Magic numbers for division by a constant, see "Hacker's Delight", chapter 10
+struct UNSIGNED_DIV_MAGIC
+{
+	uint32 multiplier;
+	uint32 shift;
+	bool needsAdd;
+};
 
-			//Check if the last statement is a jump
-			if(!basicBlock.statements.empty())
-			{
-				auto lastStatementIterator(basicBlock.statements.end());
-				--lastStatementIterator;
-				const auto& statement(*lastStatementIterator);
-				if(statement.op == OP_CONDJMP) continue;
-				if(statement.op == OP_JMP) continue;
-			}
+struct SIGNED_DIV_MAGIC
+{
+	int32 multiplier;
+	uint32 shift;
+};
 
-			//Blocks can be merged
-			MergeBasicBlocks(basicBlock, nextBlock);
+static UNSIGNED_DIV_MAGIC GetUnsignedDivMagic(uint32 divisor)
+{
+	assert(divisor > 1);
+	assert(!IsPowerOfTwo(divisor));
 
-			m_basicBlocks.erase(nextBlockIterator);
+	uint32 log2 = GetCeilLog2(divisor);
 
-			++deletedBlocks;
-			changed = true;
-			break;
+	//Look for a 32-bit multiplier that gives the exact result for all dividends
+	for(uint32 shift = 0; shift < log2; shift++)
+	{
+		uint64 power = 1ULL << (32 + shift);
+		uint64 multiplier = (power + divisor - 1) / divisor;
+		if(multiplier > 0xFFFFFFFFULL) break;
+		uint64 error = (multiplier * divisor) - power;
+		if(error <= (1ULL << shift))
+		{
+			return {static_cast<uint32>(multiplier), shift, false};
 		}
 	}
-	return deletedBlocks != 0;
+
+	//Needs a 33-bit multiplier, the implicit high bit is handled by an add
+	uint64 multiplier = ((((1ULL << log2) - divisor) << 32) / divisor) + 1;
+	assert(multiplier <= 0xFFFFFFFFULL);
+	return {static_cast<uint32>(multiplier), log2 - 1, true};
 }
 
-bool CJitter::ConstantPropagation(StatementList& statements)
+static SIGNED_DIV_MAGIC GetSignedDivMagic(int32 divisor)
 {
-	bool changed = false;
+	assert((divisor < -1) || (divisor > 1));
+
+	const uint32 two31 = 0x80000000;
+	uint32 absDivisor = (divisor < 0) ? (0 - static_cast<uint32>(divisor)) : static_cast<uint32>(divisor);
+	uint32 t = two31 + (static_cast<uint32>(divisor) >> 31);
+	uint32 absNc = t - 1 - (t % absDivisor);
+	uint32 p = 31;
+	uint32 q1 = two31 / absNc;
+	uint32 r1 = two31 - (q1 * absNc);
+	uint32 q2 = two31 / absDivisor;
+	uint32 r2 = two31 - (q2 * absDivisor);
+	uint32 delta = 0;
+	do
+	{
+		p++;
+		q1 = 2 * q1;
+		r1 = 2 * r1;
+		if(r1 >= absNc)
+		{
+			q1++;
+			r1 -= absNc;
+		}
+		q2 = 2 * q2;
+		r2 = 2 * r2;
+		if(r2 >= absDivisor)
+		{
+			q2++;
+			r2 -= absDivisor;
+		}
+		delta = absDivisor - r2;
+	} while((q1 < delta) || ((q1 == delta) && (r1 == 0)));
 
-	for(StatementList::iterator outerStatementIterator(statements.begin());
-	    statements.end() != outerStatementIterator; ++outerStatementIterator)
+	uint32 multiplier = q2 + 1;
+	if(divisor < 0)
 	{
-		STATEMENT& outerStatement(*outerStatementIterator);
+		multiplier = 0 - multiplier;
+	}
+	return {static_cast<int32>(multiplier), p - 32};
+}
 
-		if(outerStatement.op != OP_MOV) continue;
+bool CJitter::StrengthReduceDivision(StatementList& statements)
+{
+	bool changed = false;
 
-		CSymbol* constant = dynamic_symbolref_cast(SYM_CONSTANT, outerStatement.src1);
-		if(constant == NULL)
+	for(auto statementIterator(statements.begin());
+	    statements.end() != statementIterator; ++statementIterator)
+	{
+		auto& statement = *statementIterator;
+
+		if((statement.op != OP_DIV) && (statement.op != OP_DIVS)) continue;
+
+		auto src2cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		if(!src2cst) continue;
+		//Division by zero keeps its native behavior
+		if(src2cst->m_valueLow == 0) continue;
+		//Constant dividends are handled by constant folding
+		if(statement.src1->GetSymbol()->IsConstant()) continue;
+
+		auto makeConstant =
+		    [&](uint32 value) {
+			    return MakeSymbolRef(MakeSymbol(SYM_CONSTANT, value));
+		    };
+
+		auto insertStatement =
+		    [&](OPERATION op, const SymbolRefPtr& src1, const SymbolRefPtr& src2, SYM_TYPE dstType = SYM_TEMPORARY) {
+			    auto dst = MakeSymbolRef(MakeSymbol(dstType, m_nextTemporary++));
+			    STATEMENT newStatement;
+			    newStatement.op = op;
+			    newStatement.src1 = src1;
+			    newStatement.src2 = src2;
+			    newStatement.dst = dst;
+			    statements.insert(statementIterator, newStatement);
+			    return dst;
+		    };
+
+		auto insertMulHigh =
+		    [&](OPERATION op, const SymbolRefPtr& src1, uint32 value) {
+			    auto product = insertStatement(op, src1, makeConstant(value), SYM_TEMPORARY64);
+			    return insertStatement(OP_EXTHIGH64, product, SymbolRefPtr());
+		    };
+
+		auto insertRemainder =
+		    [&](const SymbolRefPtr& dividend, const SymbolRefPtr& quotient, uint32 divisor) {
+			    auto product = insertStatement(OP_MUL, quotient, makeConstant(divisor), SYM_TEMPORARY64);
+			    auto productLow = insertStatement(OP_EXTLOW64, product, SymbolRefPtr());
+			    return insertStatement(OP_SUB, dividend, productLow);
+		    };
+
+		auto dividend = statement.src1;
+		SymbolRefPtr quotient;
+		SymbolRefPtr remainder;
+
+		if(statement.op == OP_DIV)
 		{
-			constant = dynamic_symbolref_cast(SYM_CONSTANT64, outerStatement.src1);
+			uint32 divisor = src2cst->m_valueLow;
+			if(divisor == 1)
+			{
+				quotient = dividend;
+				remainder = makeConstant(0);
+			}
+			else if(IsPowerOfTwo(divisor))
+			{
+				quotient = insertStatement(OP_SRL, dividend, makeConstant(GetCeilLog2(divisor)));
+				remainder = insertStatement(OP_AND, dividend, makeConstant(divisor - 1));
+			}
+			else
+			{
+				auto magic = GetUnsignedDivMagic(divisor);
+				auto high = insertMulHigh(OP_MUL, dividend, magic.multiplier);
+				if(magic.needsAdd)
+				{
+					//high + ((dividend - high) >> 1) can't overflow
+					auto difference = insertStatement(OP_SUB, dividend, high);
+					auto half = insertStatement(OP_SRL, difference, makeConstant(1));
+					high = insertStatement(OP_ADD, high, half);
+				}
+				if(magic.shift != 0)
+				{
+					high = insertStatement(OP_SRL, high, makeConstant(magic.shift));
+				}
+				quotient = high;
+				remainder = insertRemainder(dividend, quotient, divisor);
+			}
 		}
-		if(!constant) continue;
-
-		//Find anything that uses this operand and replace it with the constant
-		for(StatementList::iterator innerStatementIterator(outerStatementIterator);
-		    statements.end() != innerStatementIterator; ++innerStatementIterator)
+		else
 		{
-			if(outerStatementIterator == innerStatementIterator) continue;
-
-			auto& innerStatement(*innerStatementIterator);
-
-			innerStatement.VisitSources(
-			    [&](SymbolRefPtr& symbol, bool) {
-				    if(symbol->Equals(outerStatement.dst.get()))
-				    {
-					    symbol = outerStatement.src1;
-					    changed = true;
-				    }
-			    });
+			int32 divisor = static_cast<int32>(src2cst->m_valueLow);
+			uint32 absDivisor = (divisor < 0) ? (0 - static_cast<uint32>(divisor)) : static_cast<uint32>(divisor);
+			if(divisor == 1)
+			{
+				quotient = dividend;
+				remainder = makeConstant(0);
+			}
+			else if(divisor == -1)
+			{
+				quotient = insertStatement(OP_SUB, makeConstant(0), dividend);
+				remainder = makeConstant(0);
+			}
+			else if(IsPowerOfTwo(absDivisor))
+			{
+				//Bias negative dividends to round towards zero
+				uint32 shift = GetCeilLog2(absDivisor);
+				auto sign = insertStatement(OP_SRA, dividend, makeConstant(31));
+				auto bias = insertStatement(OP_SRL, sign, makeConstant(32 - shift));
+				auto biased = insertStatement(OP_ADD, dividend, bias);
+				auto absQuotient = insertStatement(OP_SRA, biased, makeConstant(shift));
+				auto truncated = insertStatement(OP_AND, biased, makeConstant(~(absDivisor - 1)));
+				quotient = (divisor < 0) ? insertStatement(OP_SUB, makeConstant(0), absQuotient) : absQuotient;
+				remainder = insertStatement(OP_SUB, dividend, truncated);
+			}
+			else
+			{
+				auto magic = GetSignedDivMagic(divisor);
+				auto high = insertMulHigh(OP_MULS, dividend, static_cast<uint32>(magic.multiplier));
+				if((divisor > 0) && (magic.multiplier < 0))
+				{
+					high = insertStatement(OP_ADD, high, dividend);
+				}
+				else if((divisor < 0) && (magic.multiplier > 0))
+				{
+					high = insertStatement(OP_SUB, high, dividend);
+				}
+				if(magic.shift != 0)
+				{
+					high = insertStatement(OP_SRA, high, makeConstant(magic.shift));
+				}
+				//Add one if the result is negative to round towards zero
+				auto sign = insertStatement(OP_SRL, high, makeConstant(31));
+				quotient = insertStatement(OP_ADD, high, sign);
+				remainder = insertRemainder(dividend, quotient, static_cast<uint32>(divisor));
+			}
 		}
+
+		statement.op = OP_MERGETO64;
+		statement.src1 = quotient;
+		statement.src2 = remainder;
+		changed = true;
 	}
+
 	return changed;
 }
 
-bool CJitter::ReorderAdd(StatementList& statements)
+bool CJitter::StrengthReduceMultiplication(StatementList& statements)
 {
 	bool changed = false;
 
 	for(auto statementIterator(statements.begin());
 	    statements.end() != statementIterator; ++statementIterator)
 	{
-		auto& statement(*statementIterator);
+		auto& statement = *statementIterator;
 
-		//We're only interested by additions
-		if(statement.op != OP_ADD) continue;
+		if((statement.op != OP_MUL) && (statement.op != OP_MULS)) continue;
 
-		//Do some more checks
-		auto addDst = statement.dst.get();
-		assert(addDst);
+		auto src1cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src1);
+		auto src2cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		//Constant operations are handled by constant folding
+		if((src1cst != nullptr) == (src2cst != nullptr)) continue;
 
-		auto addSrc2Cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		auto multiplicand = src2cst ? statement.src1 : statement.src2;
+		uint32 multiplier = src2cst ? src2cst->m_valueLow : src1cst->m_valueLow;
+		bool isSigned = (statement.op == OP_MULS);
 
-		//Don't mess with relatives
-		if(addDst->GetSymbol()->IsRelative() || !addSrc2Cst)
+		//Check if only the low part of the result is used
+		bool used = false;
+		bool lowOnly = (statement.dst->GetSymbol()->m_type == SYM_TEMPORARY64);
+		for(auto innerStatementIterator = std::next(statementIterator);
+		    lowOnly && (statements.end() != innerStatementIterator); ++innerStatementIterator)
 		{
-			continue;
+			const auto& innerStatement = *innerStatementIterator;
+			innerStatement.VisitSources(
+			    [&](const SymbolRefPtr& symbolRef, bool) {
+				    if(!symbolRef->Equals(statement.dst.get())) return;
+				    used = true;
+				    lowOnly &= (innerStatement.op == OP_EXTLOW64);
+			    });
 		}
 
-		//Check for OP_SLL that uses the result of this operation and propagate the shift
-		auto nextStatementIterator = std::next(statementIterator);
-		auto& nextStatement(*nextStatementIterator);
-		if(nextStatement.op == OP_SLL && nextStatement.src1->Equals(addDst))
+		//Unused results are handled by dead code elimination
+		if(lowOnly && !used) continue;
+
+		auto makeConstant =
+		    [&](uint32 value) {
+			    return MakeSymbolRef(MakeSymbol(SYM_CONSTANT, value));
+		    };
+
+		//Build a shift sequence using the provided emitter, returns false if none is suitable
+		typedef std::function<SymbolRefPtr(OPERATION, const SymbolRefPtr&, uint32)> ShiftEmitter;
+		auto buildSequence =
+		    [&](const ShiftEmitter& emitShift, SymbolRefPtr& lo, SymbolRefPtr& hi) {
+			    if(multiplier == 0)
+			    {
+				    lo = makeConstant(0);
+				    hi = makeConstant(0);
+				    return true;
+			    }
+			    if(!lowOnly)
+			    {
+				    //Only powers of two are simple enough when the high part is needed
+				    if(!IsPowerOfTwo(multiplier)) return false;
+				    uint32 shift = GetCeilLog2(multiplier);
+				    if(isSigned && (shift == 31)) return false;
+				    if(shift == 0)
+				    {
+					    lo = multiplicand;
+					    hi = isSigned ? emitShift(OP_SRA, multiplicand, 31) : makeConstant(0);
+				    }
+				    else
+				    {
+					    lo = emitShift(OP_SLL, multiplicand, shift);
+					    hi = emitShift(isSigned ? OP_SRA : OP_SRL, multiplicand, 32 - shift);
+				    }
+				    return true;
+			    }
+			    //Low part of the result is the same for signed and unsigned multiplications
+			    if(multiplier == 1)
+			    {
+				    lo = multiplicand;
+				    return true;
+			    }
+			    if(IsPowerOfTwo(multiplier))
+			    {
+				    lo = emitShift(OP_SLL, multiplicand, GetCeilLog2(multiplier));
+				    return true;
+			    }
+			    //Other multipliers need at least two operations (shift and add/sub/neg) that the
+			    //backends don't fuse, a single imul/mul is cheaper than those
+			    return false;
+		    };
+
+		//Evaluate the cost of the sequence first
+		unsigned int sequenceCost = 0;
 		{
-			auto shiftSrc2Cst = dynamic_symbolref_cast(SYM_CONSTANT, nextStatement.src2);
-			if(shiftSrc2Cst)
-			{
-				uint32 result = addSrc2Cst->m_valueLow << shiftSrc2Cst->m_valueLow;
+			SymbolRefPtr lo, hi;
+			bool sequenceFound = buildSequence(
+			    [&](OPERATION op, const SymbolRefPtr& src, uint32) {
+				    sequenceCost += m_codeGen->GetOperationCost(op);
+				    return src;
+			    },
+			    lo, hi);
+			if(!sequenceFound) continue;
+		}
 
-				std::swap(statement, nextStatement);
-				std::swap(statement.src1, nextStatement.src1);
-				std::swap(statement.dst, nextStatement.dst);
-				nextStatement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, result));
-				changed = true;
+		unsigned int mulCost = m_codeGen->GetOperationCost(statement.op);
+		if(lowOnly)
+		{
+			mulCost += m_codeGen->GetOperationCost(OP_EXTLOW64);
+		}
+		else
+		{
+			sequenceCost += m_codeGen->GetOperationCost(OP_MERGETO64);
+		}
+		if(sequenceCost >= mulCost) continue;
+
+		auto insertStatement =
+		    [&](OPERATION op, const SymbolRefPtr& src1, const SymbolRefPtr& src2) {
+			    auto dst = MakeSymbolRef(MakeSymbol(SYM_TEMPORARY, m_nextTemporary++));
+			    STATEMENT newStatement;
+			    newStatement.op = op;
+			    newStatement.src1 = src1;
+			    newStatement.src2 = src2;
+			    newStatement.dst = dst;
+			    statements.insert(statementIterator, newStatement);
+			    return dst;
+		    };
+
+		SymbolRefPtr lo, hi;
+		buildSequence(
+		    [&](OPERATION op, const SymbolRefPtr& src, uint32 shift) {
+			    return insertStatement(op, src, makeConstant(shift));
+		    },
+		    lo, hi);
+
+		if(lowOnly)
+		{
+			//Replace uses of the low part, the multiplication will be removed by dead code elimination
+			for(auto innerStatementIterator = std::next(statementIterator);
+			    statements.end() != innerStatementIterator; ++innerStatementIterator)
+			{
+				auto& innerStatement = *innerStatementIterator;
+				if((innerStatement.op == OP_EXTLOW64) && innerStatement.src1->Equals(statement.dst.get()))
+				{
+					innerStatement.op = OP_MOV;
+					innerStatement.src1 = lo;
+				}
 			}
 		}
+		else
+		{
+			statement.op = OP_MERGETO64;
+			statement.src1 = lo;
+			statement.src2 = hi;
+		}
+		changed = true;
 	}
+
 	return changed;
 }
 
-bool CJitter::CopyPropagation(StatementList& statements)
+//Returns true if value is a non empty mask of consecutive bits starting at bit 0, not covering all bits
+static bool IsLowBitMask(uint32 value, uint32& width)
+{
+	if((value == 0) || (value == ~0U)) return false;
+	if((value & (value + 1)) != 0) return false;
+	width = GetTrailingZeroCount(~value);
+	return true;
+}
+
+bool CJitter::MergeBitfieldOps(StatementList& statements)
 {
 	bool changed = false;
 
-	struct USAGEINFO
+	auto makeConstant =
+	    [&](uint32 value) {
+		    return MakeSymbolRef(MakeSymbol(SYM_CONSTANT, value));
+	    };
+
+	//Find the statement defining a temporary that is only used by the statement at useIterator
+	auto findSingleUseDefinition =
+	    [&](const StatementList::iterator& useIterator, const SymbolRefPtr& symbolRef) {
+		    if(!symbolRef->GetSymbol()->IsTemporary()) return statements.end();
+		    auto defIterator = statements.end();
+		    for(auto statementIterator(statements.begin());
+		        statementIterator != useIterator; ++statementIterator)
+		    {
+			    const auto& statement = *statementIterator;
+			    if(statement.dst && statement.dst->Equals(symbolRef.get()))
+			    {
+				    defIterator = statementIterator;
+			    }
+		    }
+		    unsigned int useCount = 0;
+		    for(const auto& statement : statements)
+		    {
+			    statement.VisitSources(
+			        [&](const SymbolRefPtr& srcRef, bool) {
+				        if(srcRef->Equals(symbolRef.get())) useCount++;
+			        });
+		    }
+		    return (useCount == 1) ? defIterator : statements.end();
+	    };
+
+	//Check that the value of a symbol read at defIterator is still the same at useIterator
+	auto isSymbolStable =
+	    [&](const SymbolRefPtr& symbolRef, StatementList::iterator defIterator, const StatementList::iterator& useIterator) {
+		    auto symbol = symbolRef->GetSymbol().get();
+		    if(symbol->IsConstant()) return true;
+		    for(++defIterator; defIterator != useIterator; ++defIterator)
+		    {
+			    const auto& statement = *defIterator;
+			    if(statement.dst)
+			    {
+				    auto dstSymbol = statement.dst->GetSymbol().get();
+				    if(dstSymbol->Equals(symbol) || dstSymbol->Aliases(symbol)) return false;
+			    }
+			    if(symbol->IsTemporary()) continue;
+			    switch(statement.op)
+			    {
+			    case OP_CALL:
+			    case OP_STOREATREF:
+			    case OP_STORE8ATREF:
+			    case OP_STORE16ATREF:
+			    case OP_MD_STOREATREF_MASKED:
+				    return false;
+			    default:
+				    break;
+			    }
+		    }
+		    return true;
+	    };
+
+	//Get the constant operand of a commutative statement, along with the other operand
+	auto getConstantOperand =
+	    [](const STATEMENT& statement, SymbolRefPtr& valueRef) -> CSymbol* {
+		    if(auto src2cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2))
+		    {
+			    valueRef = statement.src1;
+			    return src2cst;
+		    }
+		    if(auto src1cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src1))
+		    {
+			    valueRef = statement.src2;
+			    return src1cst;
+		    }
+		    return nullptr;
+	    };
+
+	struct BITFIELD
 	{
-		uint32 count = 0;
-		StatementList::iterator lastUse;
+		SymbolRefPtr src;
+		StatementList::iterator srcIterator;
+		uint32 lsb = 0;
+		uint32 srcLsb = 0;
+		uint32 width = 0;
 	};
-	std::map<SymbolPtr, USAGEINFO> usageInfos;
+
+	//Check if symbol holds a field extracted from a value (bits [srcLsb, srcLsb + width) moved to bit 0)
+	auto getExtractedField =
+	    [&](const StatementList::iterator& useIterator, const SymbolRefPtr& symbolRef, BITFIELD& field) {
+		    auto defIterator = findSingleUseDefinition(useIterator, symbolRef);
+		    if(defIterator == statements.end()) return false;
+		    const auto& defStatement = *defIterator;
+		    if(defStatement.op == OP_AND)
+		    {
+			    auto maskCst = getConstantOperand(defStatement, field.src);
+			    if(!maskCst || !IsLowBitMask(maskCst->m_valueLow, field.width)) return false;
+			    field.srcLsb = 0;
+		    }
+		    else if(defStatement.op == OP_EXTRACTBITS)
+		    {
+			    field.src = defStatement.src1;
+			    field.srcLsb = dynamic_symbolref_cast(SYM_CONSTANT, defStatement.src2)->m_valueLow;
+			    field.width = dynamic_symbolref_cast(SYM_CONSTANT, defStatement.src3)->m_valueLow;
+		    }
+		    else
+		    {
+			    return false;
+		    }
+		    field.srcIterator = defIterator;
+		    return true;
+	    };
 
 	for(auto statementIterator(statements.begin());
 	    statements.end() != statementIterator; ++statementIterator)
 	{
-		auto& statement(*statementIterator);
+		auto& statement = *statementIterator;
 
-		statement.VisitSources(
-		    [&](const SymbolRefPtr& symbolRef, bool) {
-			    auto symbol = symbolRef->GetSymbol();
-			    if(symbol->IsRelative()) return;
-			    if(symbol->IsConstant()) return;
-			    auto& usageInfo = usageInfos[symbol];
-			    usageInfo.count++;
-			    usageInfo.lastUse = statementIterator;
-		    });
+		if(statement.op == OP_AND)
+		{
+			//(x >> n) & ((1 << width) - 1) -> EXTRACTBITS(x, n, width)
+			SymbolRefPtr valueRef;
+			auto maskCst = getConstantOperand(statement, valueRef);
+			uint32 width = 0;
+			if(!maskCst || !IsLowBitMask(maskCst->m_valueLow, width)) continue;
+
+			auto defIterator = findSingleUseDefinition(statementIterator, valueRef);
+			if(defIterator == statements.end()) continue;
+			const auto& defStatement = *defIterator;
+			if((defStatement.op != OP_SRL) && (defStatement.op != OP_SRA)) continue;
+			auto shiftCst = dynamic_symbolref_cast(SYM_CONSTANT, defStatement.src2);
+			if(!shiftCst) continue;
+			uint32 shift = shiftCst->m_valueLow & 0x1F;
+			if((shift == 0) || ((shift + width) > 32)) continue;
+			if(!isSymbolStable(defStatement.src1, defIterator, statementIterator)) continue;
+
+			statement.op = OP_EXTRACTBITS;
+			statement.src1 = defStatement.src1;
+			statement.src2 = makeConstant(shift);
+			statement.src3 = makeConstant(width);
+			changed = true;
+		}
+		else if((statement.op == OP_SRL) || (statement.op == OP_SRA))
+		{
+			//(x << a) >> b, with b >= a -> EXTRACTBITS(x, b - a, 32 - b)
+			auto rightShiftCst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+			if(!rightShiftCst) continue;
+			uint32 rightShift = rightShiftCst->m_valueLow & 0x1F;
+
+			auto defIterator = findSingleUseDefinition(statementIterator, statement.src1);
+			if(defIterator == statements.end()) continue;
+			const auto& defStatement = *defIterator;
+			if(defStatement.op != OP_SLL) continue;
+			auto leftShiftCst = dynamic_symbolref_cast(SYM_CONSTANT, defStatement.src2);
+			if(!leftShiftCst) continue;
+			uint32 leftShift = leftShiftCst->m_valueLow & 0x1F;
+			if((leftShift == 0) || (rightShift < leftShift)) continue;
+			if(!isSymbolStable(defStatement.src1, defIterator, statementIterator)) continue;
+
+			statement.op = (statement.op == OP_SRA) ? OP_EXTRACTBITSS : OP_EXTRACTBITS;
+			statement.src1 = defStatement.src1;
+			statement.src2 = makeConstant(rightShift - leftShift);
+			statement.src3 = makeConstant(32 - rightShift);
+			changed = true;
+		}
+		else if(statement.op == OP_OR)
+		{
+			//(x & ~(mask << lsb)) | (field << lsb) -> INSERTBITS(x, field, lsb, width)
+			for(unsigned int i = 0; i < 2; i++)
+			{
+				const auto& baseRef = (i == 0) ? statement.src1 : statement.src2;
+				const auto& fieldRef = (i == 0) ? statement.src2 : statement.src1;
+
+				auto baseIterator = findSingleUseDefinition(statementIterator, baseRef);
+				if(baseIterator == statements.end()) continue;
+				const auto& baseStatement = *baseIterator;
+				if(baseStatement.op != OP_AND) continue;
+				SymbolRefPtr baseSrc;
+				auto keepMaskCst = getConstantOperand(baseStatement, baseSrc);
+				if(!keepMaskCst) continue;
+
+				BITFIELD field;
+				if(!getExtractedField(statementIterator, fieldRef, field))
+				{
+					auto shiftIterator = findSingleUseDefinition(statementIterator, fieldRef);
+					if(shiftIterator == statements.end()) continue;
+					const auto& shiftStatement = *shiftIterator;
+					if(shiftStatement.op != OP_SLL) continue;
+					auto shiftCst = dynamic_symbolref_cast(SYM_CONSTANT, shiftStatement.src2);
+					if(!shiftCst) continue;
+					uint32 lsb = shiftCst->m_valueLow & 0x1F;
+					if(lsb == 0) continue;
+					if(!getExtractedField(shiftIterator, shiftStatement.src1, field))
+					{
+						//Bits shifted out don't need to be masked
+						field.src = shiftStatement.src1;
+						field.srcIterator = shiftIterator;
+						field.srcLsb = 0;
+						field.width = 32 - lsb;
+					}
+					field.lsb = lsb;
+				}
+
+				if((field.lsb + field.width) > 32) continue;
+				uint32 fieldMask = static_cast<uint32>(((1ULL << field.width) - 1) << field.lsb);
+				if(keepMaskCst->m_valueLow != ~fieldMask) continue;
+				if(!isSymbolStable(baseSrc, baseIterator, statementIterator)) continue;
+				if(!isSymbolStable(field.src, field.srcIterator, statementIterator)) continue;
+
+				statement.op = OP_INSERTBITS;
+				statement.src1 = baseSrc;
+				statement.src2 = field.src;
+				statement.src3 = makeConstant(field.lsb | (field.width << 8) | (field.srcLsb << 16));
+				changed = true;
+				break;
+			}
+		}
 	}
 
-	for(auto outerStatementIterator(statements.begin());
-	    statements.end() != outerStatementIterator; ++outerStatementIterator)
+	return changed;
+}
+
+//Checks if a statement might read relatives that aren't among its operands
+bool CJitter::MayReadAnyRelative(OPERATION op)
+{
+	switch(op)
 	{
-		auto& outerStatement(*outerStatementIterator);
+	case OP_CALL:
+	case OP_LOADFROMREF:
+	case OP_LOAD8FROMREF:
+	case OP_LOAD16FROMREF:
+	case OP_MD_LOADFROMREF_MASKED:
+		return true;
+	default:
+		return false;
+	}
+}
 
-		//Some operations we can't propagate
-		if(outerStatement.op == OP_RETVAL) continue;
+bool CJitter::DeadcodeElimination(VERSIONED_STATEMENT_LIST& versionedStatementList)
+{
+	bool changed = false;
 
-		CSymbolRef* outerDstSymbol = outerStatement.dst.get();
-		if(outerDstSymbol == NULL) continue;
+	typedef std::list<StatementList::iterator> ToDeleteList;
+	ToDeleteList toDelete;
 
-		//Don't mess with relatives
-		if(outerDstSymbol->GetSymbol()->IsRelative())
-		{
-			continue;
-		}
+	for(auto outerStatementIterator(versionedStatementList.statements.begin());
+	    versionedStatementList.statements.end() != outerStatementIterator; ++outerStatementIterator)
+	{
+		auto& outerStatement(*outerStatementIterator);
+		const auto& symbolRef(outerStatement.dst);
 
-		auto usageInfoIterator = usageInfos.find(outerDstSymbol->GetSymbol());
-		if(usageInfoIterator == std::end(usageInfos))
+		CSymbol* candidate = nullptr;
+		bool finalValue = false;
+		if(symbolRef && symbolRef->GetSymbol()->IsTemporary())
 		{
-			continue;
+			candidate = symbolRef->GetSymbol().get();
 		}
-
-		const auto& usageInfo = usageInfoIterator->second;
-		if(usageInfo.count != 1)
+		else if(auto relativeSymbol = dynamic_symbolref_cast(SYM_RELATIVE, symbolRef))
 		{
-			continue;
+			assert(symbolRef->IsVersioned());
+			if(symbolRef->GetVersion() != versionedStatementList.relativeVersions.GetRelativeVersion(relativeSymbol->m_valueLow))
+			{
+				candidate = relativeSymbol;
+			}
+			else if(IsRelativeDeadOnBlockExit(*m_currentBlock, relativeSymbol->m_valueLow))
+			{
+				candidate = relativeSymbol;
+				finalValue = true;
+			}
 		}
 
-		auto& innerStatement(*usageInfo.lastUse);
-		if(!innerStatement.src1->Equals(outerDstSymbol))
-		{
-			//Possibly excluding interesting optimization possibilities
-			continue;
-		}
+		if(!candidate) continue;
 
-		//Substitute a OP_MOV statement that use outerDstSymbol with its definition (outerStatement)
-		//Example:
-		//outerDstSymbol -> t0
-		//Before:
-		// - t0 = r0 + r1   //outerStatement
-		// - t1 = t0        //innerStatement
-		//After:
-		// - t0 = r0 + r1   //outerStatement
-		// - t1 = r0 + r1   //innerStatement
-		//After substitution, t0 will not be used anymore making outerStatement eligible for removal
-		if(innerStatement.op == OP_MOV)
-		{
-			innerStatement.op = outerStatement.op;
-			innerStatement.src1 = outerStatement.src1;
-			innerStatement.src2 = outerStatement.src2;
-			innerStatement.src3 = outerStatement.src3;
-			innerStatement.jmpCondition = outerStatement.jmpCondition;
-			changed = true;
-		}
-		//Substitute src operand of a statement if our defining statement (outerStatement) is a OP_MOV
-		//Example:
-		//outerDstSymbol -> t0
-		//Before:
-		// - t0 = r0
-		// - r1 = t0 & r2
-		//After:
-		// - t0 = r0
-		// - r1 = r0 & r2
-		//After substitution, t0 will not be used anymore making outerStatement eligible for removal
-		else if(outerStatement.op == OP_MOV)
+		//Look for any possible use of this symbol
+		bool used = false;
+		for(auto innerStatementIterator(outerStatementIterator);
+		    versionedStatementList.statements.end() != innerStatementIterator; ++innerStatementIterator)
 		{
-			auto replacementSym = outerStatement.src1;
+			if(outerStatementIterator == innerStatementIterator) continue;
+
+			const auto& innerStatement(*innerStatementIterator);
+
+			//Value stored in the context might be read by the callee or through a reference
+			if(finalValue && MayReadAnyRelative(innerStatement.op))
+			{
+				used = true;
+				break;
+			}
+
 			innerStatement.VisitSources(
-			    [&](SymbolRefPtr& symbol, bool) {
-				    if(symbol->Equals(outerDstSymbol))
+			    [&](const SymbolRefPtr& innerSymbolRef, bool) {
+				    if(innerSymbolRef->Equals(symbolRef.get()))
 				    {
-					    symbol = replacementSym;
-					    changed = true;
+					    used = true;
+					    return;
+				    }
+
+				    auto symbol(innerSymbolRef->GetSymbol());
+				    if(!symbol->Equals(candidate) && symbol->Aliases(candidate))
+				    {
+					    used = true;
+					    return;
 				    }
 			    });
-			assert(changed);
+
+			if(used) break;
 		}
-		//Find all the add/sub constant and add them together
-		//Example
-		//outerDstSymbol -> t0
-		//Before:
-		// - t0 = r0 + 10   //outerStatement
-		// - t1 = t0 + 20   //innerStatement
-		//After:
-		// - t0 = r0 + 10   //outerStatement
-		// - t1 = r0 + 30   //innerStatement
-		//After substitution, t0 will not be used anymore making outerStatement eligible for removal
-		else if(
-		    (outerStatement.op == innerStatement.op) &&
-		    ((innerStatement.op == OP_ADD) || (innerStatement.op == OP_ADDREF)))
+
+		if(!used)
 		{
-			auto innerSrc2cst = dynamic_symbolref_cast(SYM_CONSTANT, innerStatement.src2);
-			auto outerSrc2cst = dynamic_symbolref_cast(SYM_CONSTANT, outerStatement.src2);
-			if(innerSrc2cst && outerSrc2cst)
-			{
-				uint32 result = innerSrc2cst->m_valueLow + outerSrc2cst->m_valueLow;
-				innerStatement.src1 = outerStatement.src1;
-				innerStatement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, result));
-				changed = true;
-			}
+			//Kill it!
+			toDelete.push_back(outerStatementIterator);
 		}
 	}
 
+	for(ToDeleteList::const_iterator deleteIterator(toDelete.begin());
+	    toDelete.end() != deleteIterator; ++deleteIterator)
+	{
+		versionedStatementList.statements.erase(*deleteIterator);
+		changed = true;
+	}
+
 	return changed;
 }
 
-bool CJitter::CommonExpressionElimination(VERSIONED_STATEMENT_LIST& versionedStatementList)
+void CJitter::ComputeDeadRelatives()
 {
-	bool changed = false;
-	std::vector<StatementList::const_iterator> tempDefs;
-	std::unordered_map<SymbolPtr, SymbolPtr> tempReplaceMap;
-	tempDefs.reserve(versionedStatementList.statements.size());
-
-	for(auto statementIterator(versionedStatementList.statements.begin());
-	    versionedStatementList.statements.end() != statementIterator; ++statementIterator)
+	if(m_deadOnExitRelatives.empty()) return;
+
+	typedef std::vector<bool> RelativeSet;
+	size_t relativeCount = m_deadOnExitRelatives.size();
+
+	//Visits the tracked relatives overlapping a range, or only those fully covered by it
+	auto visitRelatives =
+	    [&](uint32 start, uint32 size, bool fullyCovered, RelativeSet& relatives, bool value) {
+		    uint32 firstOffset = fullyCovered ? start : ((start >= 3) ? (start - 3) : 0);
+		    auto relativeIterator = std::lower_bound(m_deadOnExitRelatives.begin(), m_deadOnExitRelatives.end(), firstOffset);
+		    for(; relativeIterator != m_deadOnExitRelatives.end(); relativeIterator++)
+		    {
+			    uint32 offset = *relativeIterator;
+			    if(fullyCovered ? ((offset + 4) > (start + size)) : (offset >= (start + size))) break;
+			    relatives[std::distance(m_deadOnExitRelatives.begin(), relativeIterator)] = value;
+		    }
+	    };
+
+	std::vector<BASIC_BLOCK*> blocks;
+	std::unordered_map<uint32, size_t> blockIndices;
+	for(auto& basicBlock : m_basicBlocks)
 	{
-		auto& statement(*statementIterator);
+		blockIndices.insert(std::make_pair(basicBlock.id, blocks.size()));
+		blocks.push_back(&basicBlock);
+	}
 
-		//If this is a statement defining a temporary
-		if(
-		    (statement.op != OP_RETVAL) &&
-		    (statement.dst) &&
-		    (statement.dst->GetSymbol()->IsTemporary()))
+	std::vector<RelativeSet> liveIns(blocks.size(), RelativeSet(relativeCount, false));
+	std::vector<RelativeSet> liveOuts(blocks.size(), RelativeSet(relativeCount, false));
+
+	//Gotos haven't been resolved yet if the block wasn't optimized
+	auto getJumpTargetLiveIn =
+	    [&](const STATEMENT& statement) -> const RelativeSet& {
+		    uint32 blockId = statement.jmpBlock;
+		    if(statement.op == OP_GOTO)
+		    {
+			    auto labelIterator = m_labels.find(statement.jmpBlock);
+			    assert(labelIterator != std::end(m_labels));
+			    blockId = labelIterator->second;
+		    }
+		    auto blockIndexIterator = blockIndices.find(blockId);
+		    assert(blockIndexIterator != std::end(blockIndices));
+		    return liveIns[blockIndexIterator->second];
+	    };
+
+	auto addLive =
+	    [&](RelativeSet& live, const RelativeSet& other) {
+		    for(size_t i = 0; i < relativeCount; i++)
+		    {
+			    if(other[i]) live[i] = true;
+		    }
+	    };
+
+	bool changed = true;
+	while(changed)
+	{
+		changed = false;
+		for(size_t blockIndex = blocks.size(); blockIndex-- != 0;)
 		{
-			const auto& newTemp = statement.dst->GetSymbol();
+			const auto& statements = blocks[blockIndex]->statements;
 
-			bool found = false;
-			//Check if our temporary already has a similar definition
-			for(const auto& tempDef : tempDefs)
+			//Nothing is live once the function exits, which happens past the last block
+			RelativeSet live(relativeCount, false);
+			if((blockIndex + 1) != blocks.size())
 			{
-				const auto& tempDefStatement = *tempDef;
-				assert(tempDefStatement.dst);
-				const auto& temp = tempDefStatement.dst;
-				if(statement.op != tempDefStatement.op) continue;
-				if(statement.jmpCondition != tempDefStatement.jmpCondition) continue;
-				if(statement.src1 && !statement.src1->Equals(tempDefStatement.src1.get())) continue;
-				if(statement.src2 && !statement.src2->Equals(tempDefStatement.src2.get())) continue;
-				if(statement.src3 && !statement.src3->Equals(tempDefStatement.src3.get())) continue;
-				auto [_, inserted] = tempReplaceMap.insert(std::make_pair(newTemp, temp->GetSymbol()));
-				assert(inserted);
-				found = true;
-				//We assume the first replacement we find is gonna be the best
-				break;
+				live = liveIns[blockIndex + 1];
 			}
 
-			//We haven't found a replacement for our definition, assume it's new
-			if(!found)
+			//Relatives live when leaving the block through any of its jumps
+			RelativeSet liveOut = live;
+			if(!statements.empty() && ((statements.back().op == OP_JMP) || (statements.back().op == OP_GOTO)))
 			{
-				tempDefs.push_back(statementIterator);
+				std::fill(liveOut.begin(), liveOut.end(), false);
+			}
+
+			//Go through the block backwards
+			for(auto statementIterator = statements.rbegin(); statementIterator != statements.rend(); statementIterator++)
+			{
+				const auto& statement = *statementIterator;
+				switch(statement.op)
+				{
+				case OP_EXTERNJMP:
+				case OP_EXTERNJMP_DYN:
+					std::fill(live.begin(), live.end(), false);
+					continue;
+				case OP_JMP:
+				case OP_GOTO:
+					live = getJumpTargetLiveIn(statement);
+					addLive(liveOut, live);
+					continue;
+				case OP_CONDJMP:
+					addLive(live, getJumpTargetLiveIn(statement));
+					addLive(liveOut, getJumpTargetLiveIn(statement));
+					break;
+				default:
+					break;
+				}
+				if(MayReadAnyRelative(statement.op))
+				{
+					std::fill(live.begin(), live.end(), true);
+					continue;
+				}
+				auto dst = statement.dst ? statement.dst->GetSymbol().get() : nullptr;
+				if(dst && dst->IsRelative() && (statement.op != OP_MD_MOV_MASKED))
+				{
+					visitRelatives(dst->m_valueLow, dst->GetSize(), true, live, false);
+				}
+				statement.VisitSources(
+				    [&](const SymbolRefPtr& symbolRef, bool) {
+					    auto symbol = symbolRef->GetSymbol();
+					    if(!symbol->IsRelative()) return;
+					    visitRelatives(symbol->m_valueLow, symbol->GetSize(), false, live, true);
+				    });
+			}
+
+			if(live != liveIns[blockIndex])
+			{
+				liveIns[blockIndex] = std::move(live);
+				changed = true;
 			}
+			liveOuts[blockIndex] = std::move(liveOut);
 		}
+	}
 
-		if(tempReplaceMap.empty())
+	for(size_t blockIndex = 0; blockIndex < blocks.size(); blockIndex++)
+	{
+		auto& deadRelatives = blocks[blockIndex]->deadRelatives;
+		deadRelatives.resize(relativeCount);
+		for(size_t i = 0; i < relativeCount; i++)
 		{
-			continue;
+			deadRelatives[i] = !liveOuts[blockIndex][i];
 		}
+	}
+}
 
-		statement.VisitSources(
-		    [&](SymbolRefPtr& innerSymbolRef, bool) {
-			    if(!innerSymbolRef->GetSymbol()->IsTemporary()) return;
-			    if(auto tempReplaceIterator = tempReplaceMap.find(innerSymbolRef->GetSymbol()); tempReplaceIterator != std::end(tempReplaceMap))
-			    {
-				    innerSymbolRef = MakeSymbolRef(tempReplaceIterator->second);
-				    changed = true;
-			    }
-		    });
+bool CJitter::IsRelativeDeadOnBlockExit(const BASIC_BLOCK& basicBlock, uint32 offset) const
+{
+	auto relativeIterator = std::lower_bound(m_deadOnExitRelatives.begin(), m_deadOnExitRelatives.end(), offset);
+	if((relativeIterator == m_deadOnExitRelatives.end()) || (*relativeIterator != offset)) return false;
+	size_t index = std::distance(m_deadOnExitRelatives.begin(), relativeIterator);
+	const auto& deadRelatives = basicBlock.deadRelatives;
+	return (index < deadRelatives.size()) && deadRelatives[index];
+}
+
+bool CJitter::OptimizeLoops()
+{
+	//Temporaries don't live past the end of their block, values carried across a loop's blocks
+	//are kept in registers reserved for the whole loop instead. Half of the registers are left
+	//for the loop's blocks to allocate on their own.
+	unsigned int maxLoopRegisterCount = m_codeGen->GetAvailableRegisterCount() / 2;
+	if(maxLoopRegisterCount == 0) return false;
+
+	bool changed = false;
+	for(const auto& loop : FindInnermostLoops())
+	{
+		changed |= OptimizeLoop(loop, maxLoopRegisterCount);
+	}
+
+	if(changed)
+	{
+		HarmonizeBlocks();
 	}
 
 	return changed;
 }
 
-bool CJitter::ClampingElimination(StatementList& statements)
+CJitter::LoopArray CJitter::FindInnermostLoops() const
 {
-	bool changed = false;
+	typedef std::vector<bool> BlockSet;
 
-	std::map<uint32, uint32> temporaryValues;
+	std::vector<const BASIC_BLOCK*> blocks;
+	std::unordered_map<uint32, size_t> blockIndices;
+	for(const auto& basicBlock : m_basicBlocks)
+	{
+		blockIndices.insert(std::make_pair(basicBlock.id, blocks.size()));
+		blocks.push_back(&basicBlock);
+	}
 
-	for(auto statementIterator(statements.begin());
-	    statements.end() != statementIterator; ++statementIterator)
+	size_t blockCount = blocks.size();
+	std::vector<std::vector<size_t>> successors(blockCount);
+	std::vector<std::vector<size_t>> predecessors(blockCount);
+	bool hasBackwardJump = false;
+	for(size_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
 	{
-		auto& statement = *statementIterator;
+		const auto& statements = blocks[blockIndex]->statements;
+		bool fallsThrough = true;
+		if(!statements.empty())
+		{
+			const auto& statement = statements.back();
+			if((statement.op == OP_JMP) || (statement.op == OP_CONDJMP))
+			{
+				auto blockIndexIterator = blockIndices.find(statement.jmpBlock);
+				assert(blockIndexIterator != std::end(blockIndices));
+				successors[blockIndex].push_back(blockIndexIterator->second);
+				hasBackwardJump |= (blockIndexIterator->second <= blockIndex);
+			}
+			fallsThrough = (statement.op != OP_JMP) && (statement.op != OP_EXTERNJMP) && (statement.op != OP_EXTERNJMP_DYN);
+		}
+		if(fallsThrough && ((blockIndex + 1) != blockCount))
+		{
+			successors[blockIndex].push_back(blockIndex + 1);
+		}
+		for(auto successor : successors[blockIndex])
+		{
+			predecessors[successor].push_back(blockIndex);
+		}
+	}
 
-		auto dstSymbol = dynamic_symbolref_cast(SYM_TEMPORARY128, statement.dst);
+	//Any cycle needs to go back up at some point
+	if(!hasBackwardJump) return LoopArray();
 
-		if((statement.op == OP_MD_EXPAND_W) &&
-		   dstSymbol &&
-		   statement.src1->GetSymbol()->IsConstant())
+	BlockSet reachable(blockCount, false);
+	{
+		std::vector<size_t> workList = {0};
+		reachable[0] = true;
+		while(!workList.empty())
 		{
-			auto src1Symbol = dynamic_symbolref_cast(SYM_CONSTANT, statement.src1);
-			temporaryValues.insert(
-			    std::make_pair(dstSymbol->m_valueLow, src1Symbol->m_valueLow));
+			size_t blockIndex = workList.back();
+			workList.pop_back();
+			for(auto successor : successors[blockIndex])
+			{
+				if(reachable[successor]) continue;
+				reachable[successor] = true;
+				workList.push_back(successor);
+			}
 		}
-		else if(dstSymbol)
+	}
+
+	//A block dominates another if every path from the function's entry to the latter goes through it
+	std::vector<BlockSet> dominators(blockCount, BlockSet(blockCount, true));
+	dominators[0] = BlockSet(blockCount, false);
+	dominators[0][0] = true;
+	bool changed = true;
+	while(changed)
+	{
+		changed = false;
+		for(size_t blockIndex = 1; blockIndex < blockCount; blockIndex++)
 		{
-			//Make sure that our temporary value doesn't get modified
-			assert(temporaryValues.find(dstSymbol->m_valueLow) == std::end(temporaryValues));
+			if(!reachable[blockIndex]) continue;
+			BlockSet blockDominators(blockCount, true);
+			for(auto predecessor : predecessors[blockIndex])
+			{
+				if(!reachable[predecessor]) continue;
+				const auto& predecessorDominators = dominators[predecessor];
+				for(size_t i = 0; i < blockCount; i++)
+				{
+					blockDominators[i] = blockDominators[i] && predecessorDominators[i];
+				}
+			}
+			blockDominators[blockIndex] = true;
+			if(blockDominators != dominators[blockIndex])
+			{
+				dominators[blockIndex] = std::move(blockDominators);
+				changed = true;
+			}
 		}
+	}
 
-		if((statement.op == OP_MD_CLAMP_S) &&
-		   statement.src1->GetSymbol()->IsTemporary())
+	//A back edge jumps to a block dominating its source, the loop's header. The loop
+	//is made of its header and of the blocks reaching the back edge without going through it.
+	std::map<size_t, BlockSet> loopBodies;
+	for(size_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+	{
+		if(!reachable[blockIndex]) continue;
+		for(auto successor : successors[blockIndex])
 		{
-			auto src1Symbol = dynamic_symbolref_cast(SYM_TEMPORARY128, statement.src1);
-			auto tempCstValue = temporaryValues.find(src1Symbol->m_valueLow);
-			if(tempCstValue != std::end(temporaryValues))
+			if(!dominators[blockIndex][successor]) continue;
+			auto& loopBody = loopBodies[successor];
+			loopBody.resize(blockCount, false);
+			loopBody[successor] = true;
+			if(loopBody[blockIndex]) continue;
+			std::vector<size_t> workList = {blockIndex};
+			loopBody[blockIndex] = true;
+			while(!workList.empty())
 			{
-				if((tempCstValue->second & 0x7F800000) != 0x7F800000)
+				size_t bodyIndex = workList.back();
+				workList.pop_back();
+				for(auto predecessor : predecessors[bodyIndex])
 				{
-					//No clamping needed here
-					statement.op = OP_MOV;
-					changed = true;
+					if(!reachable[predecessor] || loopBody[predecessor]) continue;
+					loopBody[predecessor] = true;
+					workList.push_back(predecessor);
 				}
 			}
 		}
 	}
 
-	return changed;
+	LoopArray loops;
+	for(const auto& loopBodyPair : loopBodies)
+	{
+		size_t headerIndex = loopBodyPair.first;
+		const auto& loopBody = loopBodyPair.second;
+		bool innermost = std::none_of(std::begin(loopBodies), std::end(loopBodies),
+		                              [&](const std::pair<const size_t, BlockSet>& otherLoopBodyPair) {
+			                              return (otherLoopBodyPair.first != headerIndex) && loopBody[otherLoopBodyPair.first];
+		                              });
+		if(!innermost) continue;
+		LOOP loop;
+		loop.headerId = blocks[headerIndex]->id;
+		for(size_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+		{
+			if(loopBody[blockIndex])
+			{
+				loop.blockIds.insert(blocks[blockIndex]->id);
+			}
+		}
+		loops.push_back(std::move(loop));
+	}
+	return loops;
 }
 
-bool CJitter::MergeCmpSelectOps(StatementList& statements)
+bool CJitter::OptimizeLoop(const LOOP& loop, unsigned int maxRegisterCount)
 {
-	bool changed = false;
-
-	for(auto statementIterator(statements.begin());
-	    statements.end() != statementIterator; ++statementIterator)
+	//- Invariant statements, computing temporaries out of constants, relatives not written by the
+	//  loop or other invariant temporaries, are moved to a preheader block executed before entering the loop.
+	//- Relatives used by the loop and invariant temporaries still used in it get registers reserved for
+	//  the whole loop. Relatives are loaded by the preheader and saved by blocks added on the loop's exits.
+
+	typedef std::unordered_map<SymbolPtr, unsigned int, SymbolHasher, SymbolComparator> SymbolCountMap;
+	typedef std::unordered_set<SymbolPtr, SymbolHasher, SymbolComparator> SymbolSet;
+
+	auto isInLoop =
+	    [&](const BASIC_BLOCK& basicBlock) {
+		    return loop.blockIds.find(basicBlock.id) != std::end(loop.blockIds);
+	    };
+
+	auto fallsThrough =
+	    [](const BASIC_BLOCK& basicBlock) {
+		    if(basicBlock.statements.empty()) return true;
+		    auto op = basicBlock.statements.back().op;
+		    return (op != OP_JMP) && (op != OP_EXTERNJMP) && (op != OP_EXTERNJMP_DYN);
+	    };
+
+	auto getJumpTarget =
+	    [](BASIC_BLOCK& basicBlock) -> uint32* {
+		    if(basicBlock.statements.empty()) return nullptr;
+		    auto& statement = basicBlock.statements.back();
+		    if((statement.op != OP_JMP) && (statement.op != OP_CONDJMP)) return nullptr;
+		    return &statement.jmpBlock;
+	    };
+
+	auto findBlock =
+	    [&](uint32 blockId) {
+		    return std::find_if(std::begin(m_basicBlocks), std::end(m_basicBlocks),
+		                        [&](const BASIC_BLOCK& basicBlock) { return basicBlock.id == blockId; });
+	    };
+
+	std::vector<BASIC_BLOCK*> loopBlocks;
+	std::set<uint32> exitIds;
+	bool exitsFunction = false;
+	for(auto blockIterator = std::begin(m_basicBlocks); blockIterator != std::end(m_basicBlocks); blockIterator++)
 	{
-		auto& statement = *statementIterator;
-		auto nextStatementIterator = statementIterator;
-		nextStatementIterator++;
-
-		if(nextStatementIterator == std::end(statements)) continue;
-		auto& nextStatement = *nextStatementIterator;
-
-		if(nextStatement.op != OP_SELECT) continue;
-		if(statement.op != OP_CMP) continue;
-
-		auto predicateSymbol = statement.dst;
-
-		if(!nextStatement.src1->Equals(predicateSymbol.get())) continue;
-
-		auto innerStatementIterator = nextStatementIterator;
-		innerStatementIterator++;
+		auto& basicBlock = *blockIterator;
+		if(!isInLoop(basicBlock)) continue;
+		loopBlocks.push_back(&basicBlock);
 
-		//Make sure predicate isn't used later
-		bool used = false;
-		for(; innerStatementIterator != statements.end(); ++innerStatementIterator)
+		for(const auto& statement : basicBlock.statements)
 		{
-			const auto& innerStatement = *innerStatementIterator;
-			innerStatement.VisitSources([&](const SymbolRefPtr& src, bool isDst) { used |= src->Equals(predicateSymbol.get()); });
-			if(used) break;
+			//Registers are saved around calls and can't be saved when leaving the function
+			if((statement.op == OP_CALL) || (statement.op == OP_EXTERNJMP) || (statement.op == OP_EXTERNJMP_DYN)) return false;
 		}
 
-		if(used) continue;
-
-		nextStatement.op = OP_CMPSELECT_P2;
-		nextStatement.jmpCondition = statement.jmpCondition;
-		nextStatement.src1 = nextStatement.src2;
-		nextStatement.src2 = nextStatement.src3;
-		nextStatement.src3.reset();
-
-		statement.op = OP_CMPSELECT_P1;
-		statement.jmpCondition = Jitter::CONDITION_NEVER;
-		statement.dst.reset();
-
-		changed = true;
+		auto jumpTarget = getJumpTarget(basicBlock);
+		if(jumpTarget && (loop.blockIds.find(*jumpTarget) == std::end(loop.blockIds)))
+		{
+			exitIds.insert(*jumpTarget);
+		}
+		if(fallsThrough(basicBlock))
+		{
+			auto nextBlockIterator = std::next(blockIterator);
+			if(nextBlockIterator == std::end(m_basicBlocks))
+			{
+				exitsFunction = true;
+			}
+			else if(!isInLoop(*nextBlockIterator))
+			{
+				exitIds.insert(nextBlockIterator->id);
+			}
+		}
 	}
 
-	return changed;
-}
+	//The preheader goes right before the header, loop blocks can't fall into it
+	auto headerIterator = findBlock(loop.headerId);
+	assert(headerIterator != std::end(m_basicBlocks));
+	if((headerIterator != std::begin(m_basicBlocks)) && isInLoop(*std::prev(headerIterator)) && fallsThrough(*std::prev(headerIterator)))
+	{
+		return false;
+	}
 
-bool CJitter::DeadcodeElimination(VERSIONED_STATEMENT_LIST& versionedStatementList)
-{
-	bool changed = false;
+	//Same goes for exit blocks, those go right before the block they lead to
+	bool canSaveOnExit = true;
+	for(auto exitId : exitIds)
+	{
+		auto exitIterator = findBlock(exitId);
+		if((exitIterator == std::begin(m_basicBlocks)) || (!isInLoop(*std::prev(exitIterator)) && fallsThrough(*std::prev(exitIterator))))
+		{
+			canSaveOnExit = false;
+		}
+	}
 
-	typedef std::list<StatementList::iterator> ToDeleteList;
-	ToDeleteList toDelete;
+	std::vector<SymbolPtr> loopSymbols;
+	std::vector<SymbolPtr> writtenSymbols;
+	SymbolCountMap temporaryDefCounts;
+	for(const auto& basicBlock : loopBlocks)
+	{
+		for(const auto& statement : basicBlock->statements)
+		{
+			statement.VisitOperands(
+			    [&](const SymbolRefPtr& symbolRef, bool) {
+				    loopSymbols.push_back(symbolRef->GetSymbol());
+			    });
+			statement.VisitDestination(
+			    [&](const SymbolRefPtr& symbolRef, bool) {
+				    auto symbol = symbolRef->GetSymbol();
+				    writtenSymbols.push_back(symbol);
+				    if(symbol->IsTemporary())
+				    {
+					    temporaryDefCounts[symbol]++;
+				    }
+			    });
+		}
+	}
 
-	for(auto outerStatementIterator(versionedStatementList.statements.begin());
-	    versionedStatementList.statements.end() != outerStatementIterator; ++outerStatementIterator)
+	auto isWritten =
+	    [&](const SymbolPtr& symbol) {
+		    return std::any_of(std::begin(writtenSymbols), std::end(writtenSymbols),
+		                       [&](const SymbolPtr& writtenSymbol) { return writtenSymbol->Equals(symbol.get()) || writtenSymbol->Aliases(symbol.get()); });
+	    };
+
+	auto isAliased =
+	    [&](const SymbolPtr& symbol) {
+		    return std::any_of(std::begin(loopSymbols), std::end(loopSymbols),
+		                       [&](const SymbolPtr& loopSymbol) { return !loopSymbol->Equals(symbol.get()) && loopSymbol->Aliases(symbol.get()); });
+	    };
+
+	auto isHoistableOperation =
+	    [](OPERATION op) {
+		    switch(op)
+		    {
+		    case OP_MOV:
+		    case OP_ADD:
+		    case OP_SUB:
+		    case OP_CMP:
+		    case OP_AND:
+		    case OP_OR:
+		    case OP_XOR:
+		    case OP_NOT:
+		    case OP_SRA:
+		    case OP_SRL:
+		    case OP_SLL:
+		    case OP_LZC:
+		    case OP_EXTRACTBITS:
+		    case OP_EXTRACTBITSS:
+		    case OP_INSERTBITS:
+		    case OP_MUL:
+		    case OP_MULS:
+		    case OP_EXTLOW64:
+		    case OP_EXTHIGH64:
+		    case OP_RELTOREF:
+		    case OP_ADDREF:
+			    return true;
+		    default:
+			    return false;
+		    }
+	    };
+
+	//Invariant temporaries that didn't get a register need to stay in the loop
+	SymbolSet pinnedTemporaries;
+	SymbolSet invariantTemporaries;
+	std::set<const STATEMENT*> hoistedStatements;
+	std::vector<SymbolPtr> loopRegisterSymbols;
+	while(1)
 	{
-		auto& outerStatement(*outerStatementIterator);
-		const auto& symbolRef(outerStatement.dst);
+		invariantTemporaries.clear();
+		hoistedStatements.clear();
 
-		CSymbol* candidate = nullptr;
-		if(symbolRef && symbolRef->GetSymbol()->IsTemporary())
+		auto isInvariant =
+		    [&](const SymbolPtr& symbol) {
+			    switch(symbol->m_type)
+			    {
+			    case SYM_CONTEXT:
+			    case SYM_CONSTANT:
+			    case SYM_CONSTANT64:
+			    case SYM_CONSTANTPTR:
+				    return true;
+			    default:
+				    break;
+			    }
+			    if(symbol->IsRelative()) return !isWritten(symbol);
+			    return invariantTemporaries.find(symbol) != std::end(invariantTemporaries);
+		    };
+
+		for(const auto& basicBlock : loopBlocks)
 		{
-			candidate = symbolRef->GetSymbol().get();
+			for(const auto& statement : basicBlock->statements)
+			{
+				if(!isHoistableOperation(statement.op)) continue;
+				auto dst = statement.dst->GetSymbol();
+				if((dst->m_type != SYM_TEMPORARY) && (dst->m_type != SYM_TEMPORARY64) && (dst->m_type != SYM_TMP_REFERENCE)) continue;
+				if(temporaryDefCounts[dst] != 1) continue;
+				if(pinnedTemporaries.find(dst) != std::end(pinnedTemporaries)) continue;
+				bool invariant = true;
+				statement.VisitSources(
+				    [&](const SymbolRefPtr& symbolRef, bool) {
+					    invariant = invariant && isInvariant(symbolRef->GetSymbol());
+				    });
+				if(!invariant) continue;
+				invariantTemporaries.insert(dst);
+				hoistedStatements.insert(&statement);
+			}
 		}
-		else if(auto relativeSymbol = dynamic_symbolref_cast(SYM_RELATIVE, symbolRef))
+
+		//Count accesses left in the loop to symbols that could be kept in registers
+		SymbolCountMap accessCounts;
+		for(const auto& basicBlock : loopBlocks)
 		{
-			assert(symbolRef->IsVersioned());
-			if(symbolRef->GetVersion() != versionedStatementList.relativeVersions.GetRelativeVersion(relativeSymbol->m_valueLow))
+			for(const auto& statement : basicBlock->statements)
 			{
-				candidate = relativeSymbol;
+				if(hoistedStatements.find(&statement) != std::end(hoistedStatements)) continue;
+				statement.VisitOperands(
+				    [&](const SymbolRefPtr& symbolRef, bool) {
+					    auto symbol = symbolRef->GetSymbol();
+					    if((invariantTemporaries.find(symbol) != std::end(invariantTemporaries)) ||
+					       ((symbol->m_type == SYM_RELATIVE) && !isAliased(symbol) && (canSaveOnExit || !isWritten(symbol))))
+					    {
+						    accessCounts[symbol]++;
+					    }
+				    });
 			}
 		}
 
-		if(!candidate) continue;
+		std::vector<std::pair<SymbolPtr, unsigned int>> candidates(std::begin(accessCounts), std::end(accessCounts));
+		std::sort(std::begin(candidates), std::end(candidates),
+		          [](const std::pair<SymbolPtr, unsigned int>& candidate1, const std::pair<SymbolPtr, unsigned int>& candidate2) {
+			          if(candidate1.second != candidate2.second) return candidate1.second > candidate2.second;
+			          if(candidate1.first->m_type != candidate2.first->m_type) return candidate1.first->m_type < candidate2.first->m_type;
+			          return candidate1.first->m_valueLow < candidate2.first->m_valueLow;
+		          });
+
+		//64-bit temporaries can only be used by other hoisted statements
+		bool pinned = false;
+		for(size_t i = 0; i < candidates.size(); i++)
+		{
+			const auto& symbol = candidates[i].first;
+			if((i >= maxRegisterCount) ? symbol->IsTemporary() : (symbol->m_type == SYM_TEMPORARY64))
+			{
+				pinnedTemporaries.insert(symbol);
+				pinned = true;
+			}
+		}
+		if(pinned) continue;
 
-		//Look for any possible use of this symbol
-		bool used = false;
-		for(auto innerStatementIterator(outerStatementIterator);
-		    versionedStatementList.statements.end() != innerStatementIterator; ++innerStatementIterator)
+		candidates.resize(std::min<size_t>(candidates.size(), maxRegisterCount));
+		for(const auto& candidate : candidates)
 		{
-			if(outerStatementIterator == innerStatementIterator) continue;
+			loopRegisterSymbols.push_back(candidate.first);
+		}
+		break;
+	}
 
-			const auto& innerStatement(*innerStatementIterator);
+	if(loopRegisterSymbols.empty()) return false;
+
+	unsigned int registerCount = m_codeGen->GetAvailableRegisterCount();
+	unsigned int loopRegisterCount = static_cast<unsigned int>(loopRegisterSymbols.size());
+
+	auto makeLoopRegister =
+	    [&](CSymbolTable& symbolTable, const SymbolPtr& symbol) {
+		    auto symbolIterator = std::find_if(std::begin(loopRegisterSymbols), std::end(loopRegisterSymbols),
+		                                       [&](const SymbolPtr& loopRegisterSymbol) { return loopRegisterSymbol->Equals(symbol.get()); });
+		    if(symbolIterator == std::end(loopRegisterSymbols)) return SymbolPtr();
+		    uint32 registerId = registerCount - 1 - static_cast<uint32>(std::distance(std::begin(loopRegisterSymbols), symbolIterator));
+		    return symbolTable.MakeSymbol((symbol->m_type == SYM_TMP_REFERENCE) ? SYM_REG_REFERENCE : SYM_REGISTER, registerId);
+	    };
+
+	auto makeBoundaryBlock =
+	    [&](BasicBlockList::iterator position) -> BASIC_BLOCK& {
+		    auto& basicBlock = *m_basicBlocks.emplace(position, BASIC_BLOCK());
+		    basicBlock.id = m_nextBlockId++;
+		    basicBlock.optimized = true;
+		    basicBlock.loopBoundary = true;
+		    return basicBlock;
+	    };
+
+	auto makeMove =
+	    [&](const SymbolPtr& dst, const SymbolPtr& src) {
+		    STATEMENT statement;
+		    statement.op = OP_MOV;
+		    statement.dst = MakeSymbolRef(dst);
+		    statement.src1 = MakeSymbolRef(src);
+		    return statement;
+	    };
+
+	//The preheader is register allocated like loop blocks, around the loop registers
+	auto& preheader = makeBoundaryBlock(headerIterator);
+	preheader.loopBoundary = false;
+	preheader.loopRegisterCount = loopRegisterCount;
+
+	//Relatives are loaded first, hoisted statements might read them through their loop register
+	std::vector<SymbolPtr> savedRelatives;
+	for(const auto& symbol : loopRegisterSymbols)
+	{
+		if(symbol->m_type != SYM_RELATIVE) continue;
+		auto relative = preheader.symbolTable.MakeSymbol(symbol);
+		preheader.statements.push_back(makeMove(makeLoopRegister(preheader.symbolTable, symbol), relative));
+		if(isWritten(symbol))
+		{
+			savedRelatives.push_back(symbol);
+		}
+	}
 
-			innerStatement.VisitSources(
-			    [&](const SymbolRefPtr& innerSymbolRef, bool) {
-				    if(innerSymbolRef->Equals(symbolRef.get()))
+	for(auto& basicBlock : loopBlocks)
+	{
+		for(auto statementIterator = std::begin(basicBlock->statements); statementIterator != std::end(basicBlock->statements);)
+		{
+			auto& statement = *statementIterator;
+			bool hoisted = hoistedStatements.find(&statement) != std::end(hoistedStatements);
+			auto& symbolTable = hoisted ? preheader.symbolTable : basicBlock->symbolTable;
+			statement.VisitOperands(
+			    [&](SymbolRefPtr& symbolRef, bool) {
+				    auto symbol = symbolRef->GetSymbol();
+				    if(auto loopRegister = makeLoopRegister(symbolTable, symbol))
 				    {
-					    used = true;
-					    return;
+					    symbolRef = MakeSymbolRef(loopRegister);
 				    }
-
-				    auto symbol(innerSymbolRef->GetSymbol());
-				    if(!symbol->Equals(candidate) && symbol->Aliases(candidate))
+				    else if(hoisted)
 				    {
-					    used = true;
-					    return;
+					    symbolRef = MakeSymbolRef(symbolTable.MakeSymbol(symbol));
 				    }
 			    });
-
-			if(used) break;
+			if(hoisted)
+			{
+				preheader.statements.push_back(statement);
+				statementIterator = basicBlock->statements.erase(statementIterator);
+			}
+			else
+			{
+				statementIterator++;
+			}
 		}
+		basicBlock->loopRegisterCount = loopRegisterCount;
+	}
 
-		if(!used)
+	//Entering the loop goes through the preheader
+	for(auto& basicBlock : m_basicBlocks)
+	{
+		if(isInLoop(basicBlock)) continue;
+		auto jumpTarget = getJumpTarget(basicBlock);
+		if(jumpTarget && (*jumpTarget == loop.headerId))
 		{
-			//Kill it!
-			toDelete.push_back(outerStatementIterator);
+			*jumpTarget = preheader.id;
 		}
 	}
 
-	for(ToDeleteList::const_iterator deleteIterator(toDelete.begin());
-	    toDelete.end() != deleteIterator; ++deleteIterator)
+	if(!savedRelatives.empty())
 	{
-		versionedStatementList.statements.erase(*deleteIterator);
-		changed = true;
+		assert(canSaveOnExit);
+
+		auto makeExitBlock =
+		    [&](BasicBlockList::iterator position) -> BASIC_BLOCK& {
+			    auto& exitBlock = makeBoundaryBlock(position);
+			    for(const auto& symbol : savedRelatives)
+			    {
+				    auto relative = exitBlock.symbolTable.MakeSymbol(symbol);
+				    exitBlock.statements.push_back(makeMove(relative, makeLoopRegister(exitBlock.symbolTable, symbol)));
+			    }
+			    return exitBlock;
+		    };
+
+		for(auto exitId : exitIds)
+		{
+			const auto& exitBlock = makeExitBlock(findBlock(exitId));
+			for(const auto& basicBlock : loopBlocks)
+			{
+				auto jumpTarget = getJumpTarget(*basicBlock);
+				if(jumpTarget && (*jumpTarget == exitId))
+				{
+					*jumpTarget = exitBlock.id;
+				}
+			}
+		}
+
+		if(exitsFunction)
+		{
+			makeExitBlock(std::end(m_basicBlocks));
+		}
 	}
 
-	return changed;
+	return true;
 }
 
 void CJitter::CoalesceTemporaries(BASIC_BLOCK& basicBlock)
@@ -1695,6 +4456,247 @@ void CJitter::RemoveSelfAssignments(BASIC_BLOCK& basicBlock)
 	}
 }
 
+void CJitter::CombineAdjacentStores(BASIC_BLOCK& basicBlock, bool registersAllocated)
+{
+	//Combines stores to consecutive 32-bit relatives into a single wider store:
+	//- Copies from consecutive relatives become 64-bit or 128-bit copies
+	//- Constant pairs become a single 64-bit constant store
+	//- Other pairs become OP_MERGETO64 if the code generator can store them together
+	//Before register allocation, only relatives that are not referenced anywhere else in the block
+	//are considered, otherwise the wider access would prevent them from being allocated to registers.
+	//After register allocation, this catches spills of registers at the end of allocation ranges.
+
+	auto& statements = basicBlock.statements;
+	std::vector<StatementList::iterator> removedStatements;
+
+	SymbolUseCountMap symbolUseCount;
+	if(!registersAllocated)
+	{
+		for(const auto& statement : statements)
+		{
+			statement.VisitOperands(
+			    [&](const SymbolRefPtr& symbolRef, bool) {
+				    symbolUseCount[symbolRef->GetSymbol().get()]++;
+			    });
+		}
+	}
+
+	auto isCombinableRelative =
+	    [&](CSymbol* symbol) {
+		    if(symbol->m_type != SYM_RELATIVE) return false;
+		    return registersAllocated || (symbolUseCount[symbol] == 1);
+	    };
+
+	auto isCandidate =
+	    [&](const STATEMENT& statement) {
+		    if(statement.op != OP_MOV) return false;
+		    if(!isCombinableRelative(statement.dst->GetSymbol().get())) return false;
+		    auto src = statement.src1->GetSymbol().get();
+		    switch(src->m_type)
+		    {
+		    case SYM_RELATIVE:
+			    return isCombinableRelative(src);
+		    case SYM_CONSTANT:
+		    case SYM_TEMPORARY:
+		    case SYM_REGISTER:
+			    return true;
+		    default:
+			    return false;
+		    }
+	    };
+
+	//Statements that can access the context in ways we can't see
+	auto isBarrier =
+	    [](const STATEMENT& statement) {
+		    switch(statement.op)
+		    {
+		    case OP_PARAM:
+		    case OP_PARAM_RET:
+		    case OP_CALL:
+		    case OP_RETVAL:
+		    case OP_JMP:
+		    case OP_CONDJMP:
+		    case OP_EXTERNJMP:
+		    case OP_EXTERNJMP_DYN:
+		    case OP_LABEL:
+		    case OP_BREAK:
+			    return true;
+		    default:
+			    break;
+		    }
+		    bool result = false;
+		    statement.VisitOperands(
+		        [&](const SymbolRefPtr& symbolRef, bool) {
+			        switch(symbolRef->GetSymbol()->m_type)
+			        {
+			        case SYM_CONTEXT:
+			        case SYM_REL_REFERENCE:
+			        case SYM_TMP_REFERENCE:
+			        case SYM_REG_REFERENCE:
+				        result = true;
+				        break;
+			        default:
+				        break;
+			        }
+		        });
+		    return result;
+	    };
+
+	for(auto statementIterator = std::begin(statements); statementIterator != std::end(statements); statementIterator++)
+	{
+		auto& statement = *statementIterator;
+		if(!isCandidate(statement)) continue;
+
+		auto dst = statement.dst->GetSymbol().get();
+		auto src = statement.src1->GetSymbol().get();
+		bool isCopy = (src->m_type == SYM_RELATIVE);
+
+		uint32 dstOffset = dst->m_valueLow;
+		uint32 srcOffset = isCopy ? src->m_valueLow : 0;
+
+		//Copies can be combined in 128-bit stores if source and destination have the same alignment
+		unsigned int partCount = 2;
+		if(isCopy && ((dstOffset & 0x0F) == (srcOffset & 0x0F)))
+		{
+			partCount = 4;
+		}
+		else if(isCopy && ((dstOffset & 0x07) != (srcOffset & 0x07)))
+		{
+			continue;
+		}
+
+		uint32 rangeSize = partCount * 4;
+		uint32 dstBase = dstOffset & ~(rangeSize - 1);
+		uint32 srcBase = srcOffset - (dstOffset - dstBase);
+		auto rangeType = (partCount == 4) ? SYM_RELATIVE128 : SYM_RELATIVE64;
+		CSymbol dstRange(rangeType, dstBase, 0);
+		CSymbol srcRange(rangeType, srcBase, 0);
+		if(isCopy && dstRange.Aliases(&srcRange)) continue;
+
+		StatementList::iterator parts[4];
+		unsigned int partPositions[4] = {};
+		bool found[4] = {};
+
+		unsigned int firstPart = (dstOffset - dstBase) / 4;
+		parts[firstPart] = statementIterator;
+		found[firstPart] = true;
+
+		unsigned int scanPosition = 0;
+		for(auto scanIterator = std::next(statementIterator); scanIterator != std::end(statements); scanIterator++)
+		{
+			const auto& scanStatement = *scanIterator;
+			scanPosition++;
+			if(isBarrier(scanStatement)) break;
+
+			if(isCandidate(scanStatement))
+			{
+				auto scanDst = scanStatement.dst->GetSymbol().get();
+				auto scanSrc = scanStatement.src1->GetSymbol().get();
+				uint32 partIndex = (scanDst->m_valueLow - dstBase) / 4;
+				bool matches =
+				    (scanDst->m_valueLow >= dstBase) &&
+				    (scanDst->m_valueLow < dstBase + rangeSize) &&
+				    !found[partIndex] &&
+				    (isCopy == (scanSrc->m_type == SYM_RELATIVE)) &&
+				    (!isCopy || (scanSrc->m_valueLow == srcBase + (partIndex * 4)));
+				if(matches)
+				{
+					parts[partIndex] = scanIterator;
+					partPositions[partIndex] = scanPosition;
+					found[partIndex] = true;
+					continue;
+				}
+			}
+
+			//Stop if something else touches the memory we're combining or changes a value we store
+			bool conflicts = false;
+			scanStatement.VisitOperands(
+			    [&](const SymbolRefPtr& symbolRef, bool isDst) {
+				    auto symbol = symbolRef->GetSymbol().get();
+				    if(dstRange.Aliases(symbol)) conflicts = true;
+				    if(isCopy && srcRange.Aliases(symbol)) conflicts = true;
+				    if(isDst && !isCopy)
+				    {
+					    for(unsigned int i = 0; i < partCount; i++)
+					    {
+						    if(found[i] && parts[i]->src1->GetSymbol()->Equals(symbol)) conflicts = true;
+					    }
+				    }
+			    });
+			if(conflicts) break;
+		}
+
+		//Fall back to the 64-bit half containing the first store if we couldn't get all 4 parts
+		unsigned int firstIndex = 0;
+		if((partCount == 4) && !(found[0] && found[1] && found[2] && found[3]))
+		{
+			partCount = 2;
+			firstIndex = firstPart & ~1;
+		}
+		if(!found[firstIndex] || !found[firstIndex + 1]) continue;
+
+		uint32 combinedDstOffset = dstBase + (firstIndex * 4);
+		uint32 combinedSrcOffset = srcBase + (firstIndex * 4);
+
+		STATEMENT combinedStatement;
+		if(isCopy)
+		{
+			auto symbolType = (partCount == 4) ? SYM_RELATIVE128 : SYM_RELATIVE64;
+			combinedStatement.op = OP_MOV;
+			combinedStatement.dst = MakeSymbolRef(MakeSymbol(symbolType, combinedDstOffset));
+			combinedStatement.src1 = MakeSymbolRef(MakeSymbol(symbolType, combinedSrcOffset));
+		}
+		else
+		{
+			auto loSymbol = parts[firstIndex + 0]->src1->GetSymbol();
+			auto hiSymbol = parts[firstIndex + 1]->src1->GetSymbol();
+			if((loSymbol->m_type == SYM_CONSTANT) && (hiSymbol->m_type == SYM_CONSTANT))
+			{
+				uint64 constant = static_cast<uint64>(loSymbol->m_valueLow) | (static_cast<uint64>(hiSymbol->m_valueLow) << 32);
+				combinedStatement.op = OP_MOV;
+				combinedStatement.dst = MakeSymbolRef(MakeSymbol(SYM_RELATIVE64, combinedDstOffset));
+				combinedStatement.src1 = MakeSymbolRef(MakeConstant64(constant));
+			}
+			else if(m_codeGenSupportsPairedStores)
+			{
+				combinedStatement.op = OP_MERGETO64;
+				combinedStatement.dst = MakeSymbolRef(MakeSymbol(SYM_RELATIVE64, combinedDstOffset));
+				combinedStatement.src1 = parts[firstIndex + 0]->src1;
+				combinedStatement.src2 = parts[firstIndex + 1]->src1;
+			}
+			else
+			{
+				continue;
+			}
+		}
+
+		//The combined store takes the place of the last part
+		unsigned int lastPart = firstIndex;
+		for(unsigned int i = firstIndex; i < firstIndex + partCount; i++)
+		{
+			if(partPositions[i] > partPositions[lastPart]) lastPart = i;
+		}
+
+		for(unsigned int i = firstIndex; i < firstIndex + partCount; i++)
+		{
+			if(i == lastPart)
+			{
+				*parts[i] = combinedStatement;
+			}
+			else
+			{
+				*parts[i] = STATEMENT();
+				removedStatements.push_back(parts[i]);
+			}
+		}
+	}
+
+	for(const auto& removedStatement : removedStatements)
+	{
+		statements.erase(removedStatement);
+	}
+}
+
 void CJitter::PruneSymbols(BASIC_BLOCK& basicBlock) const
 {
 	auto& symbolTable(basicBlock.symbolTable);
@@ -1,4 +1,5 @@
 #include "Jitter.h"
+#include <algorithm>
 #include <iostream>
 #include <set>
 
@@ -16,6 +17,11 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 {
 	auto& symbolTable = basicBlock.symbolTable;
 
+	if(m_codeGenSupportsMdLaneOps)
+	{
+		LowerAliasedLaneAccesses(basicBlock);
+	}
+
 	std::multimap<unsigned int, STATEMENT> loadStatements;
 	std::multimap<unsigned int, STATEMENT> spillStatements;
 #ifdef DUMP_STATEMENTS
@@ -28,21 +34,58 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 	//because changes to relative symbols might need to be visible by functions
 	//called by the block.
 
-	//There's a downside to this which is that temporaries also get the same treatment
-	//and are spilled at the end of a range which might not always be useful.
-	//Keep in mind that a temporary can remain live across a OP_CALL.
+	//Within a range, registers are loaded right before a symbol's first access and
+	//saved right after its last access. A register can thus be shared by symbols whose
+	//accesses don't overlap.
+
+	//Temporaries get the same treatment, but only need to be spilled if they are accessed
+	//in a later range. Keep in mind that a temporary can remain live across a OP_CALL.
+
+	std::unordered_map<SymbolPtr, unsigned int, SymbolHasher, SymbolComparator> temporaryLastAccesses;
+	unsigned int lastRelativeRead = -1;
+	for(const auto& statementInfo : ConstIndexedStatementList(basicBlock.statements))
+	{
+		if(MayReadAnyRelative(statementInfo.statement.op))
+		{
+			lastRelativeRead = statementInfo.index;
+		}
+		statementInfo.statement.VisitOperands(
+		    [&](const SymbolRefPtr& symbolRef, bool) {
+			    auto symbol = symbolRef->GetSymbol();
+			    if(symbol->IsTemporary())
+			    {
+				    temporaryLastAccesses[symbol] = statementInfo.index;
+			    }
+		    });
+	}
 
 	auto allocRanges = ComputeAllocationRanges(basicBlock);
 	for(const auto& allocRange : allocRanges)
 	{
-		bool isLastRange = (allocRange.second + 1) == basicBlock.statements.size();
-
 		SymbolRegAllocInfo symbolRegAllocs;
 		ComputeLivenessForRange(basicBlock, allocRange, symbolRegAllocs);
 
 		MarkAliasedSymbols(basicBlock, allocRange, symbolRegAllocs);
 
-		AssociateSymbolsToRegisters(symbolRegAllocs);
+		//Relatives only moved from or into a loop register don't need a register of their own
+		for(const auto& statementInfo : ConstIndexedStatementList(basicBlock.statements))
+		{
+			const auto& statement(statementInfo.statement);
+			if(statementInfo.index < allocRange.first) continue;
+			if(statementInfo.index > allocRange.second) break;
+			if(statement.op != OP_MOV) continue;
+			auto dst = statement.dst->GetSymbol();
+			auto src = statement.src1->GetSymbol();
+			auto relative = (dst->m_type == SYM_REGISTER) ? src : ((src->m_type == SYM_REGISTER) ? dst : SymbolPtr());
+			if(!relative || (relative->m_type != SYM_RELATIVE)) continue;
+			auto symbolRegAllocIterator = symbolRegAllocs.find(relative);
+			if(symbolRegAllocIterator->second.useCount == 1)
+			{
+				symbolRegAllocs.erase(symbolRegAllocIterator);
+			}
+		}
+
+		AssociateSymbolsToRegisters(symbolRegAllocs, basicBlock.loopRegisterCount);
 
 		//Replace all references to symbols by references to allocated registers
 		for(const auto& statementInfo : IndexedStatementList(basicBlock.statements))
@@ -89,13 +132,17 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 				    symbolTable.MakeSymbol(symbolRegAlloc.registerType, symbolRegAlloc.registerId));
 				statement.src1 = std::make_shared<CSymbolRef>(symbol);
 
-				loadStatements.insert(std::make_pair(allocRange.first, statement));
+				loadStatements.insert(std::make_pair(symbolRegAlloc.firstUse, statement));
 			}
 
 			//If symbol is defined, we need to save it at the end
-			//Exception: Temporaries can be discarded if we're in the last range of the block
-			bool deadTemporary = symbol->IsTemporary() && isLastRange;
-			if(!deadTemporary && (symbolRegAlloc.firstDef != -1))
+			//Exception: Temporaries can be discarded if they're not accessed after this range
+			bool deadTemporary = symbol->IsTemporary() && (temporaryLastAccesses[symbol] <= allocRange.second);
+			//Same goes for relatives overwritten before being read once the block exits
+			bool deadRelative = (symbol->m_type == SYM_RELATIVE) && (allocRange.second == (basicBlock.statements.size() - 1)) &&
+			                    ((lastRelativeRead == -1) || (lastRelativeRead < GetLastAccess(symbolRegAlloc))) &&
+			                    IsRelativeDeadOnBlockExit(basicBlock, symbol->m_valueLow);
+			if(!deadTemporary && !deadRelative && (symbolRegAlloc.firstDef != -1))
 			{
 				STATEMENT statement;
 				statement.op = OP_MOV;
@@ -103,7 +150,7 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 				statement.src1 = std::make_shared<CSymbolRef>(
 				    symbolTable.MakeSymbol(symbolRegAlloc.registerType, symbolRegAlloc.registerId));
 
-				spillStatements.insert(std::make_pair(allocRange.second, statement));
+				spillStatements.insert(std::make_pair(GetLastAccess(symbolRegAlloc), statement));
 			}
 		}
 	}
@@ -147,29 +194,36 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 		}
 	}
 
-	//Loads
-	for(const auto& loadPoint : loadPoints)
+	//Spills
+	for(const auto& spillPoint : spillPoints)
 	{
-		unsigned int statementIndex = loadPoint.first;
-		for(auto statementIterator = loadStatements.lower_bound(statementIndex);
-		    statementIterator != loadStatements.upper_bound(statementIndex);
+		unsigned int statementIndex = spillPoint.first;
+		for(auto statementIterator = spillStatements.lower_bound(statementIndex);
+		    statementIterator != spillStatements.upper_bound(statementIndex);
 		    statementIterator++)
 		{
 			const auto& statement(statementIterator->second);
-			basicBlock.statements.insert(loadPoint.second, statement);
+			basicBlock.statements.insert(spillPoint.second, statement);
 		}
 	}
 
-	//Spills
-	for(const auto& spillPoint : spillPoints)
+	if(m_compileStats)
 	{
-		unsigned int statementIndex = spillPoint.first;
-		for(auto statementIterator = spillStatements.lower_bound(statementIndex);
-		    statementIterator != spillStatements.upper_bound(statementIndex);
+		m_compileStats->AddValue(CCompileStats::VALUE_REGISTER_LOADS, loadStatements.size());
+		m_compileStats->AddValue(CCompileStats::VALUE_REGISTER_SPILLS, spillStatements.size());
+	}
+
+	//Loads
+	//Inserted after spills, a register might be saved and loaded with another symbol between two statements
+	for(const auto& loadPoint : loadPoints)
+	{
+		unsigned int statementIndex = loadPoint.first;
+		for(auto statementIterator = loadStatements.lower_bound(statementIndex);
+		    statementIterator != loadStatements.upper_bound(statementIndex);
 		    statementIterator++)
 		{
 			const auto& statement(statementIterator->second);
-			basicBlock.statements.insert(spillPoint.second, statement);
+			basicBlock.statements.insert(loadPoint.second, statement);
 		}
 	}
 
@@ -179,18 +233,221 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 #endif
 }
 
-void CJitter::AssociateSymbolsToRegisters(SymbolRegAllocInfo& symbolRegAllocs) const
+void CJitter::LowerAliasedLaneAccesses(BASIC_BLOCK& basicBlock)
+{
+	//FP32 relatives that are lanes of a 128-bit relative used in the same block would make both
+	//symbols aliased and keep them in memory. Rewrite lane accesses as extracts/inserts on the
+	//128-bit symbol so that it can live in a register:
+	//- FP_REL32 reads become 'tmp = EXTRACT_LANE(REL128, lane)' followed by a read of tmp
+	//- FP_REL32 writes become a write to tmp followed by 'REL128 = INSERT_LANE(REL128, tmp, lane)'
+	//- Moves from or to a lane don't need the temporary
+
+	if(m_codeGen->GetAvailableMdRegisterCount() == 0) return;
+
+	auto& symbolTable = basicBlock.symbolTable;
+
+	std::set<uint32> vectorOffsets;
+	std::vector<SymbolPtr> otherRelatives;
+	for(const auto& statement : basicBlock.statements)
+	{
+		statement.VisitOperands(
+		    [&](const SymbolRefPtr& symbolRef, bool) {
+			    auto symbol = symbolRef->GetSymbol();
+			    if(symbol->m_type == SYM_RELATIVE128)
+			    {
+				    vectorOffsets.insert(symbol->m_valueLow);
+			    }
+			    else if(symbol->IsRelative())
+			    {
+				    otherRelatives.push_back(symbol);
+			    }
+		    });
+	}
+
+	if(vectorOffsets.empty()) return;
+
+	auto isLaneOf =
+	    [](const CSymbol* symbol, uint32 vectorOffset) {
+		    return (symbol->m_type == SYM_FP_RELATIVE32) &&
+		           (symbol->m_valueLow >= vectorOffset) && (symbol->m_valueLow < (vectorOffset + 16)) &&
+		           ((symbol->m_valueLow & 3) == (vectorOffset & 3));
+	    };
+
+	//Maps lane symbol offset to the offset of its 128-bit relative
+	std::map<uint32, uint32> laneVectors;
+	for(auto vectorOffset : vectorOffsets)
+	{
+		CSymbol vectorSymbol(SYM_RELATIVE128, vectorOffset, 0);
+		bool canLower = true;
+		bool hasLanes = false;
+		for(auto vectorOffset2 : vectorOffsets)
+		{
+			if(vectorOffset2 == vectorOffset) continue;
+			CSymbol vectorSymbol2(SYM_RELATIVE128, vectorOffset2, 0);
+			if(vectorSymbol.Aliases(&vectorSymbol2))
+			{
+				canLower = false;
+			}
+		}
+		for(const auto& symbol : otherRelatives)
+		{
+			if(!symbol->Aliases(&vectorSymbol)) continue;
+			if(isLaneOf(symbol.get(), vectorOffset))
+			{
+				hasLanes = true;
+			}
+			else
+			{
+				canLower = false;
+			}
+		}
+		for(const auto& statement : basicBlock.statements)
+		{
+			//The callee writes the return value, can't be followed by an insert
+			if((statement.op == OP_PARAM_RET) && statement.src1->GetSymbol()->Aliases(&vectorSymbol))
+			{
+				canLower = false;
+			}
+		}
+		if(!canLower || !hasLanes) continue;
+		for(const auto& symbol : otherRelatives)
+		{
+			if(isLaneOf(symbol.get(), vectorOffset))
+			{
+				laneVectors[symbol->m_valueLow] = vectorOffset;
+			}
+		}
+	}
+
+	if(laneVectors.empty()) return;
+
+	auto getLaneVector =
+	    [&](const SymbolRefPtr& symbolRef) {
+		    auto symbol = symbolRef->GetSymbol();
+		    if(symbol->m_type != SYM_FP_RELATIVE32) return std::end(laneVectors);
+		    return laneVectors.find(symbol->m_valueLow);
+	    };
+
+	auto isFpVariable =
+	    [](const SymbolPtr& symbol) {
+		    return (symbol->m_type == SYM_FP_RELATIVE32) || (symbol->m_type == SYM_FP_TEMPORARY32);
+	    };
+
+	auto makeExtractStatement =
+	    [&](const SymbolPtr& dst, uint32 laneOffset) {
+		    uint32 vectorOffset = laneVectors[laneOffset];
+		    STATEMENT statement;
+		    statement.op = OP_MD_EXTRACT_LANE_S;
+		    statement.dst = MakeSymbolRef(dst);
+		    statement.src1 = MakeSymbolRef(symbolTable.MakeSymbol(SYM_RELATIVE128, vectorOffset));
+		    statement.src2 = MakeSymbolRef(symbolTable.MakeSymbol(SYM_CONSTANT, (laneOffset - vectorOffset) / 4));
+		    return statement;
+	    };
+
+	auto makeInsertStatement =
+	    [&](const SymbolPtr& src, uint32 laneOffset) {
+		    uint32 vectorOffset = laneVectors[laneOffset];
+		    auto vectorSymbol = symbolTable.MakeSymbol(SYM_RELATIVE128, vectorOffset);
+		    STATEMENT statement;
+		    statement.op = OP_MD_INSERT_LANE_S;
+		    statement.dst = MakeSymbolRef(vectorSymbol);
+		    statement.src1 = MakeSymbolRef(vectorSymbol);
+		    statement.src2 = MakeSymbolRef(src);
+		    statement.src3 = MakeSymbolRef(symbolTable.MakeSymbol(SYM_CONSTANT, (laneOffset - vectorOffset) / 4));
+		    return statement;
+	    };
+
+	for(auto statementIterator = basicBlock.statements.begin();
+	    statementIterator != basicBlock.statements.end(); statementIterator++)
+	{
+		auto& statement = *statementIterator;
+
+		//Moves from or to a lane become a single extract or insert
+		if(statement.op == OP_MOV)
+		{
+			bool srcIsLane = getLaneVector(statement.src1) != std::end(laneVectors);
+			bool dstIsLane = getLaneVector(statement.dst) != std::end(laneVectors);
+			auto src = statement.src1->GetSymbol();
+			auto dst = statement.dst->GetSymbol();
+			if(srcIsLane && dstIsLane)
+			{
+				auto temporary = symbolTable.MakeSymbol(SYM_FP_TEMPORARY32, m_nextTemporary++);
+				statement = makeExtractStatement(temporary, src->m_valueLow);
+				statementIterator = basicBlock.statements.insert(std::next(statementIterator), makeInsertStatement(temporary, dst->m_valueLow));
+				continue;
+			}
+			else if(srcIsLane && isFpVariable(dst))
+			{
+				statement = makeExtractStatement(dst, src->m_valueLow);
+				continue;
+			}
+			else if(dstIsLane && isFpVariable(src))
+			{
+				statement = makeInsertStatement(src, dst->m_valueLow);
+				continue;
+			}
+		}
+
+		struct LANE_ACCESS
+		{
+			SymbolPtr temporary;
+			bool used = false;
+			bool defined = false;
+		};
+		std::map<uint32, LANE_ACCESS> laneAccesses;
+
+		statement.VisitOperands(
+		    [&](SymbolRefPtr& symbolRef, bool isDef) {
+			    if(getLaneVector(symbolRef) == std::end(laneVectors)) return;
+			    auto& laneAccess = laneAccesses[symbolRef->GetSymbol()->m_valueLow];
+			    if(!laneAccess.temporary)
+			    {
+				    laneAccess.temporary = symbolTable.MakeSymbol(SYM_FP_TEMPORARY32, m_nextTemporary++);
+			    }
+			    (isDef ? laneAccess.defined : laneAccess.used) = true;
+			    symbolRef = MakeSymbolRef(laneAccess.temporary);
+		    });
+
+		auto nextIterator = std::next(statementIterator);
+		for(const auto& laneAccessPair : laneAccesses)
+		{
+			const auto& laneAccess = laneAccessPair.second;
+			if(laneAccess.used)
+			{
+				basicBlock.statements.insert(statementIterator, makeExtractStatement(laneAccess.temporary, laneAccessPair.first));
+			}
+			if(laneAccess.defined)
+			{
+				basicBlock.statements.insert(nextIterator, makeInsertStatement(laneAccess.temporary, laneAccessPair.first));
+			}
+		}
+		statementIterator = std::prev(nextIterator);
+	}
+}
+
+unsigned int CJitter::GetLastAccess(const SYMBOL_REGALLOCINFO& symbolRegAlloc)
+{
+	if(symbolRegAlloc.lastUse == -1) return symbolRegAlloc.lastDef;
+	if(symbolRegAlloc.lastDef == -1) return symbolRegAlloc.lastUse;
+	return std::max(symbolRegAlloc.lastUse, symbolRegAlloc.lastDef);
+}
+
+void CJitter::AssociateSymbolsToRegisters(SymbolRegAllocInfo& symbolRegAllocs, unsigned int loopRegisterCount) const
 {
 	//Some notes:
 	//- MD and FP registers are lumped together since MD registers are used for both
 	//  MD and FP operations on all of our target platforms.
+	//- Symbols with accesses that don't overlap can share a register. Intervals sharing a
+	//  statement are considered overlapping, a statement never sees one of its operands
+	//  replaced by another.
+	//- Registers holding values that live across a loop are at the end and aren't available.
 
-	std::multimap<SYM_TYPE, unsigned int> availableRegisters;
+	std::multimap<SYM_TYPE, unsigned int> allocatableRegisters;
 	{
-		unsigned int regCount = m_codeGen->GetAvailableRegisterCount();
+		unsigned int regCount = m_codeGen->GetAvailableRegisterCount() - loopRegisterCount;
 		for(unsigned int i = 0; i < regCount; i++)
 		{
-			availableRegisters.insert(std::make_pair(SYM_REGISTER, i));
+			allocatableRegisters.insert(std::make_pair(SYM_REGISTER, i));
 		}
 	}
 
@@ -198,7 +455,7 @@ void CJitter::AssociateSymbolsToRegisters(SymbolRegAllocInfo& symbolRegAllocs) c
 		unsigned int regCount = m_codeGen->GetAvailableMdRegisterCount();
 		for(unsigned int i = 0; i < regCount; i++)
 		{
-			availableRegisters.insert(std::make_pair(SYM_REGISTER128, i));
+			allocatableRegisters.insert(std::make_pair(SYM_REGISTER128, i));
 		}
 	}
 
@@ -243,46 +500,57 @@ void CJitter::AssociateSymbolsToRegisters(SymbolRegAllocInfo& symbolRegAllocs) c
 		    }
 	    });
 
+	typedef std::pair<unsigned int, unsigned int> LiveInterval;
+	std::map<std::pair<SYM_TYPE, unsigned int>, std::vector<LiveInterval>> registerIntervals;
+
 	for(auto& symbolRegAllocPair : sortedSymbols)
 	{
-		if(availableRegisters.empty()) break;
-
 		const auto& symbol = symbolRegAllocPair->first;
 		auto& symbolRegAlloc = symbolRegAllocPair->second;
 
+		auto liveInterval = LiveInterval(std::min(symbolRegAlloc.firstUse, symbolRegAlloc.firstDef), GetLastAccess(symbolRegAlloc));
+
 		//Find suitable register for this symbol
-		auto registerIterator = std::end(availableRegisters);
-		auto registerIteratorEnd = std::end(availableRegisters);
+		auto registerIterator = std::end(allocatableRegisters);
+		auto registerIteratorEnd = std::end(allocatableRegisters);
 		auto registerSymbolType = SYM_REGISTER;
 		if((symbol->m_type == SYM_RELATIVE) || (symbol->m_type == SYM_TEMPORARY))
 		{
-			registerIterator = availableRegisters.lower_bound(SYM_REGISTER);
-			registerIteratorEnd = availableRegisters.upper_bound(SYM_REGISTER);
+			registerIterator = allocatableRegisters.lower_bound(SYM_REGISTER);
+			registerIteratorEnd = allocatableRegisters.upper_bound(SYM_REGISTER);
 			registerSymbolType = SYM_REGISTER;
 		}
 		else if((symbol->m_type == SYM_REL_REFERENCE) || (symbol->m_type == SYM_TMP_REFERENCE))
 		{
-			registerIterator = availableRegisters.lower_bound(SYM_REGISTER);
-			registerIteratorEnd = availableRegisters.upper_bound(SYM_REGISTER);
+			registerIterator = allocatableRegisters.lower_bound(SYM_REGISTER);
+			registerIteratorEnd = allocatableRegisters.upper_bound(SYM_REGISTER);
 			registerSymbolType = SYM_REG_REFERENCE;
 		}
 		else if((symbol->m_type == SYM_FP_RELATIVE32) || (symbol->m_type == SYM_FP_TEMPORARY32))
 		{
-			registerIterator = availableRegisters.lower_bound(SYM_REGISTER128);
-			registerIteratorEnd = availableRegisters.upper_bound(SYM_REGISTER128);
+			registerIterator = allocatableRegisters.lower_bound(SYM_REGISTER128);
+			registerIteratorEnd = allocatableRegisters.upper_bound(SYM_REGISTER128);
 			registerSymbolType = SYM_FP_REGISTER32;
 		}
 		else if((symbol->m_type == SYM_RELATIVE128) || (symbol->m_type == SYM_TEMPORARY128))
 		{
-			registerIterator = availableRegisters.lower_bound(SYM_REGISTER128);
-			registerIteratorEnd = availableRegisters.upper_bound(SYM_REGISTER128);
+			registerIterator = allocatableRegisters.lower_bound(SYM_REGISTER128);
+			registerIteratorEnd = allocatableRegisters.upper_bound(SYM_REGISTER128);
 			registerSymbolType = SYM_REGISTER128;
 		}
-		if(registerIterator != registerIteratorEnd)
+		for(; registerIterator != registerIteratorEnd; registerIterator++)
 		{
+			auto& intervals = registerIntervals[*registerIterator];
+			bool overlaps = std::any_of(std::begin(intervals), std::end(intervals),
+			                            [&](const LiveInterval& interval) {
+				                            return (interval.first <= liveInterval.second) && (liveInterval.first <= interval.second);
+			                            });
+			if(overlaps) continue;
+
 			symbolRegAlloc.registerType = registerSymbolType;
 			symbolRegAlloc.registerId = registerIterator->second;
-			availableRegisters.erase(registerIterator);
+			intervals.push_back(liveInterval);
+			break;
 		}
 	}
 }
@@ -330,6 +598,9 @@ void CJitter::ComputeLivenessForRange(const BASIC_BLOCK& basicBlock, const Alloc
 			    }
 		    });
 
+		//Code generators only read parameters when emitting the call that ends the range
+		unsigned int useEndIdx = ((statement.op == OP_PARAM) || (statement.op == OP_PARAM_RET)) ? allocRange.second : statementIdx;
+
 		statement.VisitSources(
 		    [&](const SymbolRefPtr& symbolRef, bool) {
 			    auto symbol(symbolRef->GetSymbol());
@@ -339,9 +610,9 @@ void CJitter::ComputeLivenessForRange(const BASIC_BLOCK& basicBlock, const Alloc
 			    {
 				    symbolRegAlloc.firstUse = statementIdx;
 			    }
-			    if((symbolRegAlloc.lastUse == -1) || (statementIdx > symbolRegAlloc.lastUse))
+			    if((symbolRegAlloc.lastUse == -1) || (useEndIdx > symbolRegAlloc.lastUse))
 			    {
-				    symbolRegAlloc.lastUse = statementIdx;
+				    symbolRegAlloc.lastUse = useEndIdx;
 			    }
 		    });
 	}
@@ -1,6 +1,15 @@
+#include <array>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
 #include "Jitter_Statement.h"
 
+#define STATEMENTLIST_MAGIC 0x4C54534A //'JSTL'
+#define STATEMENTLIST_VERSION 4
+
+//Operand type has this bit set when the symbol's high value is stored
+#define OPERAND_HAS_VALUEHIGH 0x80
+
 using namespace Jitter;
 
 std::string Jitter::ConditionToString(CONDITION condition)
@@ -113,6 +122,12 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 		case OP_FP_DIV_S:
 			outputStream << " / ";
 			break;
+		case OP_FP_MULADD_S:
+			outputStream << " MULADD ";
+			break;
+		case OP_FP_FUSEDMULADD_S:
+			outputStream << " FMULADD ";
+			break;
 		case OP_AND:
 		case OP_AND64:
 		case OP_MD_AND:
@@ -121,6 +136,15 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 		case OP_LZC:
 			outputStream << " LZC";
 			break;
+		case OP_EXTRACTBITS:
+			outputStream << " EXTRACTBITS ";
+			break;
+		case OP_EXTRACTBITSS:
+			outputStream << " EXTRACTBITSS ";
+			break;
+		case OP_INSERTBITS:
+			outputStream << " INSERTBITS ";
+			break;
 		case OP_OR:
 		case OP_MD_OR:
 			outputStream << " | ";
@@ -230,6 +254,7 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 			outputStream << " INT32(TRUNC)";
 			break;
 		case OP_FP_LDCST:
+		case OP_MD_LDCST:
 			outputStream << " LOAD ";
 			break;
 		case OP_MD_MOV_MASKED:
@@ -241,6 +266,12 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 		case OP_MD_PACK_WH:
 			outputStream << " PACK_WH ";
 			break;
+		case OP_MD_SHUFFLE_W:
+			outputStream << " SHUFFLE_W ";
+			break;
+		case OP_MD_SHUFFLE_B:
+			outputStream << " SHUFFLE_B ";
+			break;
 		case OP_MD_UNPACK_LOWER_BH:
 			outputStream << " UNPACK_LOWER_BH ";
 			break;
@@ -343,6 +374,12 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 		case OP_MD_DIV_S:
 			outputStream << " /(S) ";
 			break;
+		case OP_MD_MULADD_S:
+			outputStream << " MULADD(S) ";
+			break;
+		case OP_MD_FUSEDMULADD_S:
+			outputStream << " FMULADD(S) ";
+			break;
 		case OP_MD_MIN_H:
 			outputStream << " MIN(H) ";
 			break;
@@ -376,6 +413,12 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 		case OP_MD_EXPAND_W:
 			outputStream << " EXPAND(W)";
 			break;
+		case OP_MD_EXTRACT_LANE_S:
+			outputStream << " EXTRACT_LANE(S)";
+			break;
+		case OP_MD_INSERT_LANE_S:
+			outputStream << " INSERT_LANE(S)";
+			break;
 		case OP_MD_TOSINGLE_I32:
 			outputStream << " TOSINGLE_I32";
 			break;
@@ -401,3 +444,230 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 		outputStream << std::endl;
 	}
 }
+
+//Serialized statement lists refer to operations and symbol types by their index in these
+//tables instead of their enum value, new values must only be appended to them
+// clang-format off
+static constexpr OPERATION g_serializedOperations[] =
+{
+	OP_NOP, OP_MOV,
+
+	OP_ADD, OP_SUB, OP_CMP, OP_SELECT,
+
+	OP_CMPSELECT_P1, OP_CMPSELECT_P2,
+
+	OP_AND, OP_OR, OP_XOR, OP_NOT,
+
+	OP_SRA, OP_SRL, OP_SLL,
+
+	OP_MUL, OP_MULS, OP_DIV, OP_DIVS,
+
+	OP_LZC,
+
+	OP_EXTRACTBITS, OP_EXTRACTBITSS, OP_INSERTBITS,
+
+	OP_RELTOREF, OP_ADDREF, OP_ISREFNULL, OP_LOADFROMREF, OP_LOAD8FROMREF, OP_LOAD16FROMREF, OP_STOREATREF, OP_STORE8ATREF, OP_STORE16ATREF,
+
+	OP_ADD64, OP_SUB64, OP_AND64, OP_CMP64, OP_MERGETO64, OP_EXTLOW64, OP_EXTHIGH64, OP_SRA64, OP_SRL64, OP_SLL64,
+
+	OP_MERGETO256,
+
+	OP_MD_MOV_MASKED, OP_MD_LOADFROMREF_MASKED, OP_MD_STOREATREF_MASKED,
+
+	OP_MD_ADD_B, OP_MD_ADD_H, OP_MD_ADD_W,
+
+	OP_MD_ADDSS_B, OP_MD_ADDSS_H, OP_MD_ADDSS_W,
+
+	OP_MD_ADDUS_B, OP_MD_ADDUS_H, OP_MD_ADDUS_W,
+
+	OP_MD_SUB_B, OP_MD_SUB_H, OP_MD_SUB_W,
+
+	OP_MD_SUBSS_B, OP_MD_SUBSS_H, OP_MD_SUBSS_W,
+
+	OP_MD_SUBUS_B, OP_MD_SUBUS_H, OP_MD_SUBUS_W,
+
+	OP_MD_CLAMP_S,
+
+	OP_MD_CMPEQ_B, OP_MD_CMPEQ_H, OP_MD_CMPEQ_W, OP_MD_CMPGT_B, OP_MD_CMPGT_H, OP_MD_CMPGT_W,
+
+	OP_MD_MIN_H, OP_MD_MIN_W, OP_MD_MAX_H, OP_MD_MAX_W,
+
+	OP_MD_AND, OP_MD_OR, OP_MD_XOR, OP_MD_NOT,
+
+	OP_MD_SRLH, OP_MD_SRAH, OP_MD_SLLH,
+
+	OP_MD_SRLW, OP_MD_SRAW, OP_MD_SLLW,
+
+	OP_MD_SRL256,
+
+	OP_MD_MAKECLIP, OP_MD_MAKESZ,
+
+	OP_MD_TOINT32_TRUNC_S, OP_MD_TOSINGLE_I32,
+
+	OP_MD_EXPAND_W, OP_MD_LDCST,
+
+	OP_MD_EXTRACT_LANE_S, OP_MD_INSERT_LANE_S,
+
+	OP_MD_UNPACK_LOWER_BH, OP_MD_UNPACK_LOWER_HW, OP_MD_UNPACK_LOWER_WD,
+
+	OP_MD_UNPACK_UPPER_BH, OP_MD_UNPACK_UPPER_HW, OP_MD_UNPACK_UPPER_WD,
+
+	OP_MD_PACK_HB, OP_MD_PACK_WH,
+
+	OP_MD_SHUFFLE_W, OP_MD_SHUFFLE_B,
+
+	OP_MD_ADD_S, OP_MD_SUB_S, OP_MD_MUL_S, OP_MD_DIV_S, OP_MD_MULADD_S, OP_MD_FUSEDMULADD_S, OP_MD_ABS_S, OP_MD_NEG_S, OP_MD_MIN_S, OP_MD_MAX_S,
+
+	OP_MD_CMPLT_S, OP_MD_CMPGT_S,
+
+	OP_FP_ADD_S, OP_FP_SUB_S, OP_FP_MUL_S, OP_FP_DIV_S, OP_FP_MULADD_S, OP_FP_FUSEDMULADD_S, OP_FP_SQRT_S, OP_FP_RSQRT_S, OP_FP_RCPL_S, OP_FP_ABS_S, OP_FP_NEG_S, OP_FP_MAX_S, OP_FP_MIN_S, OP_FP_CMP_S, OP_FP_CLAMP_S,
+
+	OP_FP_TOINT32_TRUNC_S, OP_FP_TOSINGLE_I32,
+
+	OP_FP_SETROUNDINGMODE,
+
+	OP_FP_LDCST,
+
+	OP_PARAM, OP_PARAM_RET, OP_CALL, OP_RETVAL, OP_JMP, OP_CONDJMP, OP_EXTERNJMP, OP_EXTERNJMP_DYN, OP_GOTO, OP_BREAK,
+
+	OP_LABEL,
+};
+
+static constexpr SYM_TYPE g_serializedSymbolTypes[] =
+{
+	SYM_CONTEXT,
+
+	SYM_CONSTANT, SYM_CONSTANTPTR, SYM_RELATIVE, SYM_TEMPORARY, SYM_REGISTER,
+
+	SYM_REL_REFERENCE, SYM_TMP_REFERENCE, SYM_REG_REFERENCE,
+
+	SYM_RELATIVE64, SYM_TEMPORARY64, SYM_CONSTANT64,
+
+	SYM_RELATIVE128, SYM_TEMPORARY128, SYM_REGISTER128,
+
+	SYM_TEMPORARY256,
+
+	SYM_FP_RELATIVE32, SYM_FP_TEMPORARY32, SYM_FP_REGISTER32,
+};
+// clang-format on
+
+//Checks that every enum value below count is listed exactly once
+template <typename EnumType, size_t count>
+static constexpr bool IsSerializationTableComplete(const EnumType (&table)[count])
+{
+	bool found[count] = {};
+	for(auto value : table)
+	{
+		if((static_cast<size_t>(value) >= count) || found[value]) return false;
+		found[value] = true;
+	}
+	return true;
+}
+
+static_assert((std::size(g_serializedOperations) == (OP_LABEL + 1)) && IsSerializationTableComplete(g_serializedOperations), "Serialized operation table is incomplete.");
+static_assert((std::size(g_serializedSymbolTypes) == (SYM_FP_REGISTER32 + 1)) && IsSerializationTableComplete(g_serializedSymbolTypes), "Serialized symbol type table is incomplete.");
+static_assert(std::size(g_serializedSymbolTypes) <= OPERAND_HAS_VALUEHIGH, "Too many symbol types.");
+
+template <typename EnumType, size_t count>
+static constexpr std::array<uint16, count> MakeSerializedIds(const EnumType (&table)[count])
+{
+	std::array<uint16, count> ids = {};
+	for(size_t i = 0; i < count; i++)
+	{
+		ids[table[i]] = static_cast<uint16>(i);
+	}
+	return ids;
+}
+
+static constexpr auto g_operationIds = MakeSerializedIds(g_serializedOperations);
+static constexpr auto g_symbolTypeIds = MakeSerializedIds(g_serializedSymbolTypes);
+
+template <typename EnumType, size_t count>
+static EnumType GetSerializedValue(const EnumType (&table)[count], uint32 id, const char* errorMessage)
+{
+	if(id >= count)
+	{
+		throw std::runtime_error(errorMessage);
+	}
+	return table[id];
+}
+
+void Jitter::SerializeStatementList(Framework::CStream& stream, const StatementList& statements)
+{
+	stream.Write32(STATEMENTLIST_MAGIC);
+	stream.Write16(STATEMENTLIST_VERSION);
+	stream.Write32(static_cast<uint32>(statements.size()));
+	for(const auto& statement : statements)
+	{
+		uint8 operandMask = 0;
+		operandMask |= statement.dst ? (1 << 0) : 0;
+		operandMask |= statement.src1 ? (1 << 1) : 0;
+		operandMask |= statement.src2 ? (1 << 2) : 0;
+		operandMask |= statement.src3 ? (1 << 3) : 0;
+
+		stream.Write16(g_operationIds[statement.op]);
+		//Some operations store a scale or a mask instead of a condition, value is kept as is
+		stream.Write8(static_cast<uint8>(statement.jmpCondition));
+		stream.Write32(statement.jmpBlock);
+		stream.Write8(operandMask);
+
+		for(const auto& symbolRef : {statement.dst, statement.src1, statement.src2, statement.src3})
+		{
+			if(!symbolRef) continue;
+			assert(!symbolRef->IsVersioned());
+			auto symbol = symbolRef->GetSymbol();
+			uint8 type = static_cast<uint8>(g_symbolTypeIds[symbol->m_type]);
+			if(symbol->m_valueHigh != 0)
+			{
+				type |= OPERAND_HAS_VALUEHIGH;
+			}
+			stream.Write8(type);
+			stream.Write32(symbol->m_valueLow);
+			if(symbol->m_valueHigh != 0)
+			{
+				stream.Write32(symbol->m_valueHigh);
+			}
+		}
+	}
+}
+
+StatementList Jitter::DeserializeStatementList(Framework::CStream& stream, CSymbolTable& symbolTable)
+{
+	uint32 magic = stream.Read32();
+	uint16 version = stream.Read16();
+	if((magic != STATEMENTLIST_MAGIC) || (version != STATEMENTLIST_VERSION))
+	{
+		throw std::runtime_error("Invalid statement list header.");
+	}
+
+	auto readOperand = [&]() {
+		uint8 type = stream.Read8();
+		uint32 valueLow = stream.Read32();
+		uint32 valueHigh = (type & OPERAND_HAS_VALUEHIGH) ? stream.Read32() : 0;
+		auto symbolType = GetSerializedValue(g_serializedSymbolTypes, type & ~OPERAND_HAS_VALUEHIGH, "Invalid symbol type in statement list.");
+		auto symbol = symbolTable.MakeSymbol(symbolType, valueLow, valueHigh);
+		return std::make_shared<CSymbolRef>(symbol);
+	};
+
+	StatementList statements;
+	uint32 statementCount = stream.Read32();
+	for(uint32 i = 0; i < statementCount; i++)
+	{
+		if(stream.IsEOF())
+		{
+			throw std::runtime_error("Truncated statement list.");
+		}
+		STATEMENT statement;
+		statement.op = GetSerializedValue(g_serializedOperations, stream.Read16(), "Invalid operation in statement list.");
+		statement.jmpCondition = static_cast<CONDITION>(stream.Read8());
+		statement.jmpBlock = stream.Read32();
+		uint8 operandMask = stream.Read8();
+		if(operandMask & (1 << 0)) statement.dst = readOperand();
+		if(operandMask & (1 << 1)) statement.src1 = readOperand();
+		if(operandMask & (1 << 2)) statement.src2 = readOperand();
+		if(operandMask & (1 << 3)) statement.src3 = readOperand();
+		statements.push_back(statement);
+	}
+
+	return statements;
+}
@@ -54,7 +54,7 @@ extern "C" {
 #include <pthread.h>
 #elif defined(MEMFUNC_USE_WASM)
 EM_JS_DEPS(WasmMemoryFunction, "$addFunction,$removeFunction");
-EM_JS(int, WasmCreateFunction, (emscripten::EM_VAL moduleHandle),
+EM_JS(int, WasmCreateFunction, (emscripten::EM_VAL moduleHandle, int fctIndex),
 {
 	let module = Emval.toValue(moduleHandle);
 	let moduleInstance = new WebAssembly.Instance(module, {
@@ -63,10 +63,26 @@ EM_JS(int, WasmCreateFunction, (emscripten::EM_VAL moduleHandle),
 			fctTable : Module.codeGenImportTable
 		}
 	});
-	let fct = moduleInstance.exports.codeGenFunc;
+	let fct = moduleInstance.exports[(fctIndex == 0) ? 'codeGenFunc' : ('codeGenFunc' + fctIndex)];
 	let fctId = addFunction(fct, 'vi');
 	return fctId;
 });
+EM_JS(void, WasmCreateFunctions, (emscripten::EM_VAL moduleHandle, uintptr_t fctIds, int fctCount),
+{
+	//Single instantiation for all functions of the module
+	let module = Emval.toValue(moduleHandle);
+	let moduleInstance = new WebAssembly.Instance(module, {
+		env: {
+			memory: wasmMemory,
+			fctTable : Module.codeGenImportTable
+		}
+	});
+	for(let fctIndex = 0; fctIndex < fctCount; fctIndex++)
+	{
+		let fct = moduleInstance.exports[(fctIndex == 0) ? 'codeGenFunc' : ('codeGenFunc' + fctIndex)];
+		HEAP32[(fctIds >> 2) + fctIndex] = addFunction(fct, 'vi');
+	}
+});
 EM_JS(void, WasmDeleteFunction, (int fctId),
 {
 	removeFunction(fctId);
@@ -222,7 +238,7 @@ CMemoryFunction::CMemoryFunction(const void* code, size_t size)
 #elif defined(MEMFUNC_USE_WASM)
 	m_wasmModule = emscripten::val::take_ownership(WasmCreateModule(reinterpret_cast<uintptr_t>(code), size));
 	m_size = size;
-	m_code = reinterpret_cast<void*>(WasmCreateFunction(m_wasmModule.as_handle()));
+	m_code = reinterpret_cast<void*>(WasmCreateFunction(m_wasmModule.as_handle(), 0));
 #endif
 	ClearCache();
 #if !defined(MEMFUNC_USE_WASM)
@@ -230,6 +246,13 @@ CMemoryFunction::CMemoryFunction(const void* code, size_t size)
 #endif
 }
 
+CMemoryFunction::CMemoryFunction(CMemoryFunction&& rhs)
+: m_code(nullptr)
+, m_size(0)
+{
+	(*this) = std::move(rhs);
+}
+
 CMemoryFunction::~CMemoryFunction()
 {
 	Reset();
@@ -279,6 +302,7 @@ void CMemoryFunction::Reset()
     
 #if defined(MEMFUNC_USE_WASM)
     m_wasmModule = emscripten::val();
+    m_wasmFunctionIndex = 0;
 #endif
 }
 
@@ -294,6 +318,7 @@ CMemoryFunction& CMemoryFunction::operator =(CMemoryFunction&& rhs)
 	std::swap(m_size, rhs.m_size);
 #if defined(MEMFUNC_USE_WASM)
 	std::swap(m_wasmModule, rhs.m_wasmModule);
+	std::swap(m_wasmFunctionIndex, rhs.m_wasmFunctionIndex);
 #endif
 	return (*this);
 }
@@ -370,10 +395,32 @@ CMemoryFunction CMemoryFunction::CreateInstance()
 #if defined(MEMFUNC_USE_WASM)
 	CMemoryFunction result;
 	result.m_wasmModule = m_wasmModule;
+	result.m_wasmFunctionIndex = m_wasmFunctionIndex;
 	result.m_size = m_size;
-	result.m_code = reinterpret_cast<void*>(WasmCreateFunction(m_wasmModule.as_handle()));
+	result.m_code = reinterpret_cast<void*>(WasmCreateFunction(m_wasmModule.as_handle(), m_wasmFunctionIndex));
 	return result;
 #else
 	return CMemoryFunction(GetCode(), GetSize());
 #endif
 }
+
+#if defined(MEMFUNC_USE_WASM)
+std::vector<CMemoryFunction> CMemoryFunction::CreateModuleFunctions(const void* code, size_t size, uint32 functionCount)
+{
+	auto wasmModule = emscripten::val::take_ownership(WasmCreateModule(reinterpret_cast<uintptr_t>(code), size));
+	std::vector<int> fctIds(functionCount);
+	WasmCreateFunctions(wasmModule.as_handle(), reinterpret_cast<uintptr_t>(fctIds.data()), functionCount);
+	std::vector<CMemoryFunction> result;
+	result.reserve(functionCount);
+	for(uint32 i = 0; i < functionCount; i++)
+	{
+		CMemoryFunction function;
+		function.m_wasmModule = wasmModule;
+		function.m_wasmFunctionIndex = i;
+		function.m_size = size;
+		function.m_code = reinterpret_cast<void*>(fctIds[i]);
+		result.push_back(std::move(function));
+	}
+	return result;
+}
+#endif
@@ -75,10 +75,27 @@ void CWasmModuleBuilder::AddFunction(FUNCTION function)
 	m_functions.push_back(std::move(function));
 }
 
+uint32 CWasmModuleBuilder::GetFunctionCount() const
+{
+	return static_cast<uint32>(m_functions.size());
+}
+
+std::string CWasmModuleBuilder::GetFunctionExportName(uint32 functionIndex)
+{
+	//First function keeps the name used by single function modules
+	std::string name = "codeGenFunc";
+	if(functionIndex != 0)
+	{
+		name += std::to_string(functionIndex);
+	}
+	return name;
+}
+
 void CWasmModuleBuilder::WriteModule(Framework::CStream& stream)
 {
-	//We only support a single function at the moment
-	assert(m_functions.size() == 1);
+	assert(!m_functions.empty());
+
+	uint32 functionCount = static_cast<uint32>(m_functions.size());
 
 	stream.Write32(Wasm::BINARY_MAGIC);
 	stream.Write32(Wasm::BINARY_VERSION);
@@ -145,77 +162,109 @@ void CWasmModuleBuilder::WriteModule(Framework::CStream& stream)
 
 	//Section "Function"
 	{
-		WriteSectionHeader(stream, Wasm::SECTION_ID_FUNCTION, 0x02);
+		uint32 sectionSize = GetULeb128Size(functionCount) + functionCount;
 
-		stream.Write8(1); //Function vector size
+		WriteSectionHeader(stream, Wasm::SECTION_ID_FUNCTION, sectionSize);
 
-		//Function 0
-		stream.Write8(0); //Signature index
+		WriteULeb128(stream, functionCount); //Function vector size
+
+		for(uint32 i = 0; i < functionCount; i++)
+		{
+			stream.Write8(0); //Signature index
+		}
 	}
 
 	//Section "Export"
 	{
-		WriteSectionHeader(stream, Wasm::SECTION_ID_EXPORT, 15);
+		uint32 sectionSize = GetULeb128Size(functionCount);
+		for(uint32 i = 0; i < functionCount; i++)
+		{
+			auto exportName = GetFunctionExportName(i);
+			sectionSize +=
+			    1 + //Name length
+			    static_cast<uint32>(exportName.size()) +
+			    1 + //Export type
+			    GetULeb128Size(i);
+		}
+
+		WriteSectionHeader(stream, Wasm::SECTION_ID_EXPORT, sectionSize);
 
-		stream.Write8(1); //Export vector size
+		WriteULeb128(stream, functionCount); //Export vector size
 
-		//Export 0
-		WriteName(stream, "codeGenFunc");
-		stream.Write8(Wasm::IMPORT_EXPORT_TYPE_FUNCTION);
-		stream.Write8(0); //Function index
+		for(uint32 i = 0; i < functionCount; i++)
+		{
+			WriteName(stream, GetFunctionExportName(i).c_str());
+			stream.Write8(Wasm::IMPORT_EXPORT_TYPE_FUNCTION);
+			WriteULeb128(stream, i); //Function index
+		}
 	}
 
 	//Section "Code"
 	{
-		const auto& function = m_functions[0];
-
-		assert(function.localI32Count < 0x80);
-		assert(function.localI64Count < 0x80);
-		assert(function.localF32Count < 0x80);
-		assert(function.localV128Count < 0x80);
-
-		uint32 localDeclCount = 0;
-		if(function.localI32Count != 0) localDeclCount++;
-		if(function.localI64Count != 0) localDeclCount++;
-		if(function.localF32Count != 0) localDeclCount++;
-		if(function.localV128Count != 0) localDeclCount++;
-		uint32 localDeclSize = (localDeclCount * 2) + 1;
-		uint32 functionBodySize = function.code.size() + localDeclSize;
-
-		uint32 sectionSize =
-		    1 + //Vector size
-		    GetULeb128Size(functionBodySize) +
-		    functionBodySize;
+		std::vector<uint32> functionBodySizes;
+		functionBodySizes.reserve(functionCount);
 
-		WriteSectionHeader(stream, Wasm::SECTION_ID_CODE, sectionSize);
+		uint32 sectionSize = GetULeb128Size(functionCount);
+		for(const auto& function : m_functions)
+		{
+			//Each declaration is a local count followed by a type byte
+			uint32 localDeclCount = 0;
+			uint32 localDeclSize = 0;
+			for(auto localCount : {function.localI32Count, function.localI64Count, function.localF32Count, function.localV128Count})
+			{
+				if(localCount == 0) continue;
+				localDeclCount++;
+				localDeclSize += GetULeb128Size(localCount) + 1;
+			}
+			localDeclSize += GetULeb128Size(localDeclCount);
+			uint32 functionBodySize = function.code.size() + localDeclSize;
 
-		stream.Write8(1); //Function vector size
+			sectionSize +=
+			    GetULeb128Size(functionBodySize) +
+			    functionBodySize;
 
-		//Function 0
-		WriteULeb128(stream, functionBodySize); //Function body size
-		WriteULeb128(stream, localDeclCount);   //Local declaration count
-		if(function.localI32Count != 0)
-		{
-			WriteULeb128(stream, function.localI32Count); //Local type count
-			stream.Write8(Wasm::TYPE_I32);
-		}
-		if(function.localI64Count != 0)
-		{
-			WriteULeb128(stream, function.localI64Count);
-			stream.Write8(Wasm::TYPE_I64);
-		}
-		if(function.localF32Count != 0)
-		{
-			WriteULeb128(stream, function.localF32Count);
-			stream.Write8(Wasm::TYPE_F32);
+			functionBodySizes.push_back(functionBodySize);
 		}
-		if(function.localV128Count != 0)
+
+		WriteSectionHeader(stream, Wasm::SECTION_ID_CODE, sectionSize);
+
+		WriteULeb128(stream, functionCount); //Function vector size
+
+		for(uint32 i = 0; i < functionCount; i++)
 		{
-			WriteULeb128(stream, function.localV128Count);
-			stream.Write8(Wasm::TYPE_V128);
-		}
+			const auto& function = m_functions[i];
 
-		stream.Write(function.code.data(), function.code.size());
+			uint32 localDeclCount = 0;
+			if(function.localI32Count != 0) localDeclCount++;
+			if(function.localI64Count != 0) localDeclCount++;
+			if(function.localF32Count != 0) localDeclCount++;
+			if(function.localV128Count != 0) localDeclCount++;
+
+			WriteULeb128(stream, functionBodySizes[i]); //Function body size
+			WriteULeb128(stream, localDeclCount);       //Local declaration count
+			if(function.localI32Count != 0)
+			{
+				WriteULeb128(stream, function.localI32Count); //Local type count
+				stream.Write8(Wasm::TYPE_I32);
+			}
+			if(function.localI64Count != 0)
+			{
+				WriteULeb128(stream, function.localI64Count);
+				stream.Write8(Wasm::TYPE_I64);
+			}
+			if(function.localF32Count != 0)
+			{
+				WriteULeb128(stream, function.localF32Count);
+				stream.Write8(Wasm::TYPE_F32);
+			}
+			if(function.localV128Count != 0)
+			{
+				WriteULeb128(stream, function.localV128Count);
+				stream.Write8(Wasm::TYPE_V128);
+			}
+
+			stream.Write(function.code.data(), function.code.size());
+		}
 	}
 }
 
@@ -1,4 +1,5 @@
 #include "X86Assembler.h"
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 #include "LiteralPool.h"
@@ -83,6 +84,8 @@ void CX86Assembler::End()
 			}
 		}
 
+		changed |= UpdateLabelPaddings();
+
 		if(!changed) break;
 	}
 
@@ -97,6 +100,8 @@ void CX86Assembler::End()
 		unsigned int currentProjectedPos = label.projectedStart;
 		unsigned int endPos = label.start + label.size;
 
+		WriteNops(m_outputStream, label.padding);
+
 		for(const auto& labelRef : label.labelRefs)
 		{
 			const auto& referencedLabel(m_labels[labelRef.label]);
@@ -130,6 +135,33 @@ void CX86Assembler::End()
 	ResolveLiteralReferences();
 }
 
+bool CX86Assembler::UpdateLabelPaddings()
+{
+	bool changed = false;
+
+	for(LabelArray::const_iterator labelIterator(m_labelOrder.begin());
+	    labelIterator != m_labelOrder.end(); ++labelIterator)
+	{
+		auto& label = m_labels[*labelIterator];
+		if(label.alignment == 1) continue;
+
+		uint32 unpaddedStart = label.projectedStart - label.padding;
+		uint32 padding = (0 - unpaddedStart) & (label.alignment - 1);
+		if(padding == label.padding) continue;
+
+		//Padding can shrink when jumps before the label grow, offsets are
+		//unsigned and wrap around when decremented this way
+		uint32 amount = padding - label.padding;
+		label.padding = padding;
+		label.projectedStart += amount;
+		IncrementJumpOffsetsLocal(label, label.labelRefs.begin(), amount);
+		IncrementJumpOffsets(labelIterator + 1, amount);
+		changed = true;
+	}
+
+	return changed;
+}
+
 void CX86Assembler::IncrementJumpOffsets(LabelArray::const_iterator startLabel, unsigned int amount)
 {
 	for(LabelArray::const_iterator labelIterator(startLabel);
@@ -357,6 +389,13 @@ CX86Assembler::LABEL CX86Assembler::CreateLabel()
 	return newLabelId;
 }
 
+void CX86Assembler::MarkAlignedLabel(LABEL label, uint32 alignment)
+{
+	assert((alignment != 0) && ((alignment & (alignment - 1)) == 0));
+	MarkLabel(label);
+	m_labels[label].alignment = alignment;
+}
+
 void CX86Assembler::MarkLabel(LABEL label, int32 offset)
 {
 	uint32 currentPos = static_cast<uint32>(m_tmpStream.Tell()) + offset;
@@ -501,6 +540,12 @@ void CX86Assembler::CallEd(const CAddress& address)
 	WriteEvOp(0xFF, 0x02, false, address);
 }
 
+void CX86Assembler::CallJd(uint32 displacement)
+{
+	WriteByte(0xE8);
+	WriteDWord(displacement);
+}
+
 void CX86Assembler::CmoveEd(REGISTER registerId, const CAddress& address)
 {
 	WriteEvGvOp0F(0x44, false, address, registerId);
@@ -628,6 +673,12 @@ void CX86Assembler::JmpEd(const CAddress& address)
 	WriteEvOp(0xFF, 0x04, false, address);
 }
 
+void CX86Assembler::JmpJd(uint32 displacement)
+{
+	WriteByte(0xE9);
+	WriteDWord(displacement);
+}
+
 void CX86Assembler::JmpJx(LABEL label)
 {
 	CreateLabelReference(label, JMP_ALWAYS);
@@ -668,6 +719,12 @@ void CX86Assembler::LeaGq(REGISTER registerId, const CAddress& address)
 	WriteEvGvOp(0x8D, true, address, registerId);
 }
 
+void CX86Assembler::LzcntEd(REGISTER registerId, const CAddress& address)
+{
+	WriteByte(0xF3);
+	WriteEvGvOp0F(0xBD, false, address, registerId);
+}
+
 void CX86Assembler::MovEw(REGISTER registerId, const CAddress& address)
 {
 	WriteByte(0x66);
@@ -813,6 +870,11 @@ void CX86Assembler::Nop()
 	WriteByte(0x90);
 }
 
+void CX86Assembler::Nop(unsigned int size)
+{
+	WriteNops(&m_tmpStream, size);
+}
+
 void CX86Assembler::NotEd(const CAddress& address)
 {
 	WriteEvOp(0xF7, 0x02, false, address);
@@ -835,6 +897,12 @@ void CX86Assembler::Pop(REGISTER registerId)
 	WriteByte(0x58 | Address.ModRm.nRM);
 }
 
+void CX86Assembler::PopcntEd(REGISTER registerId, const CAddress& address)
+{
+	WriteByte(0xF3);
+	WriteEvGvOp0F(0xB8, false, address, registerId);
+}
+
 void CX86Assembler::Push(REGISTER registerId)
 {
 	CAddress Address(MakeRegisterAddress(registerId));
@@ -1061,6 +1129,12 @@ void CX86Assembler::TestEq(REGISTER registerId, const CAddress& address)
 	WriteEvGvOp(0x85, true, address, registerId);
 }
 
+void CX86Assembler::TzcntEd(REGISTER registerId, const CAddress& address)
+{
+	WriteByte(0xF3);
+	WriteEvGvOp0F(0xBC, false, address, registerId);
+}
+
 void CX86Assembler::XorEd(REGISTER registerId, const CAddress& address)
 {
 	WriteEvGvOp(0x33, false, address, registerId);
@@ -1323,6 +1397,33 @@ void CX86Assembler::WriteJump(Framework::CStream* stream, JMP_TYPE type, JMP_LEN
 	}
 }
 
+void CX86Assembler::WriteNops(Framework::CStream* stream, unsigned int size)
+{
+	//Recommended multi-byte NOP sequences (Intel Optimization Reference Manual)
+	// clang-format off
+	static const uint8 nopSequences[9][9] =
+	{
+		{ 0x90 },
+		{ 0x66, 0x90 },
+		{ 0x0F, 0x1F, 0x00 },
+		{ 0x0F, 0x1F, 0x40, 0x00 },
+		{ 0x0F, 0x1F, 0x44, 0x00, 0x00 },
+		{ 0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00 },
+		{ 0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00 },
+		{ 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+		{ 0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+	};
+	// clang-format on
+	static const unsigned int maxNopSize = 9;
+
+	while(size != 0)
+	{
+		unsigned int nopSize = std::min(size, maxNopSize);
+		stream->Write(nopSequences[nopSize - 1], nopSize);
+		size -= nopSize;
+	}
+}
+
 void CX86Assembler::WriteByte(uint8 nByte)
 {
 	m_tmpStream.Write8(nByte);
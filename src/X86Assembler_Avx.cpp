@@ -127,6 +127,11 @@ void CX86Assembler::VminssEd(XMMREGISTER dst, XMMREGISTER src1, const CAddress&
 	WriteVexVoOp(VEX_OPCODE_MAP_F3, 0x5D, dst, src1, src2);
 }
 
+void CX86Assembler::Vfmadd231ssEd(XMMREGISTER dst, XMMREGISTER src1, const CAddress& src2)
+{
+	WriteVexVoOp(VEX_OPCODE_MAP_66_38, 0xB9, dst, src1, src2);
+}
+
 void CX86Assembler::VcmpssEd(XMMREGISTER dst, XMMREGISTER src1, const CAddress& src2, SSE_CMP_TYPE condition)
 {
 	WriteVexVoOp(VEX_OPCODE_MAP_F3, 0xC2, dst, src1, src2);
@@ -388,6 +393,12 @@ void CX86Assembler::VpshufbVo(XMMREGISTER dst, XMMREGISTER src1, const CAddress&
 	WriteVexVoOp(VEX_OPCODE_MAP_66_38, 0x00, dst, src1, src2);
 }
 
+void CX86Assembler::VpshufdVo(XMMREGISTER dst, const CAddress& src, uint8 shuffleByte)
+{
+	WriteVexVoOp(VEX_OPCODE_MAP_66, 0x70, dst, CX86Assembler::xMM0, src);
+	WriteByte(shuffleByte);
+}
+
 void CX86Assembler::VpmovmskbVo(REGISTER dst, XMMREGISTER src)
 {
 	WriteVexVoOp(VEX_OPCODE_MAP_66, 0xD7, static_cast<XMMREGISTER>(dst), CX86Assembler::xMM0, CX86Assembler::MakeXmmRegisterAddress(src));
@@ -418,6 +429,11 @@ void CX86Assembler::VdivpsVo(XMMREGISTER dst, XMMREGISTER src1, const CAddress&
 	WriteVexVoOp(VEX_OPCODE_MAP_NONE, 0x5E, dst, src1, src2);
 }
 
+void CX86Assembler::Vfmadd231psVo(XMMREGISTER dst, XMMREGISTER src1, const CAddress& src2)
+{
+	WriteVexVoOp(VEX_OPCODE_MAP_66_38, 0xB8, dst, src1, src2);
+}
+
 void CX86Assembler::VcmpltpsVo(XMMREGISTER dst, XMMREGISTER src1, const CAddress& src2)
 {
 	VcmppsVo(dst, src1, src2, SSE_CMP_LT);
@@ -460,6 +476,12 @@ void CX86Assembler::VblendpsVo(XMMREGISTER dst, XMMREGISTER src1, const CAddress
 	WriteByte(mask);
 }
 
+void CX86Assembler::VinsertpsVo(XMMREGISTER dst, XMMREGISTER src1, const CAddress& src2, uint8 control)
+{
+	WriteVexVoOp(VEX_OPCODE_MAP_66_3A, 0x21, dst, src1, src2);
+	WriteByte(control);
+}
+
 void CX86Assembler::VshufpsVo(XMMREGISTER dst, XMMREGISTER src1, const CAddress& src2, uint8 shuffleByte)
 {
 	WriteVexVoOp(VEX_OPCODE_MAP_NONE, 0xC6, dst, src1, src2);
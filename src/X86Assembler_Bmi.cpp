@@ -0,0 +1,44 @@
+#include <cassert>
+#include "X86Assembler.h"
+
+void CX86Assembler::AndnEd(REGISTER dst, REGISTER src1, const CAddress& src2)
+{
+	WriteVexGvEvOp(VEX_OPCODE_MAP_NONE_38, 0xF2, dst, src1, src2);
+}
+
+void CX86Assembler::BzhiEd(REGISTER dst, const CAddress& src, REGISTER index)
+{
+	WriteVexGvEvOp(VEX_OPCODE_MAP_NONE_38, 0xF5, dst, index, src);
+}
+
+void CX86Assembler::RorxEd(REGISTER dst, const CAddress& src, uint8 amount)
+{
+	WriteVexGvEvOp(VEX_OPCODE_MAP_F2_3A, 0xF0, dst, rAX, src);
+	WriteByte(amount);
+}
+
+void CX86Assembler::SarxEd(REGISTER dst, const CAddress& src, REGISTER amount)
+{
+	WriteVexGvEvOp(VEX_OPCODE_MAP_F3_38, 0xF7, dst, amount, src);
+}
+
+void CX86Assembler::ShlxEd(REGISTER dst, const CAddress& src, REGISTER amount)
+{
+	WriteVexGvEvOp(VEX_OPCODE_MAP_66_38, 0xF7, dst, amount, src);
+}
+
+void CX86Assembler::ShrxEd(REGISTER dst, const CAddress& src, REGISTER amount)
+{
+	WriteVexGvEvOp(VEX_OPCODE_MAP_F2_38, 0xF7, dst, amount, src);
+}
+
+void CX86Assembler::WriteVexGvEvOp(VEX_OPCODE_MAP opMap, uint8 op, REGISTER dst, REGISTER src1, const CAddress& src2)
+{
+	//VEX encoded GPR instructions share the VEX layout of vector instructions (VEX.vvvv holds src1)
+	auto vexDst = static_cast<XMMREGISTER>(dst);
+	WriteVex(opMap, vexDst, static_cast<XMMREGISTER>(src1), src2);
+	WriteByte(op);
+	CAddress newAddress(src2);
+	newAddress.ModRm.nFnReg = vexDst;
+	newAddress.Write(&m_tmpStream);
+}
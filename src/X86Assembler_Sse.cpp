@@ -211,6 +211,18 @@ void CX86Assembler::PandnVo(XMMREGISTER registerId, const CAddress& address)
 	WriteEdVdOp_66_0F(0xDF, address, registerId);
 }
 
+void CX86Assembler::PextrwVo(REGISTER dstReg, XMMREGISTER srcReg, uint8 index)
+{
+	WriteEdVdOp_66_0F(0xC5, CX86Assembler::MakeRegisterAddress(static_cast<REGISTER>(srcReg)), static_cast<XMMREGISTER>(dstReg));
+	WriteByte(index);
+}
+
+void CX86Assembler::PinsrwVo(XMMREGISTER registerId, const CAddress& address, uint8 index)
+{
+	WriteEdVdOp_66_0F(0xC4, address, registerId);
+	WriteByte(index);
+}
+
 void CX86Assembler::PcmpeqbVo(XMMREGISTER registerId, const CAddress& address)
 {
 	WriteEdVdOp_66_0F(0x74, address, registerId);
@@ -409,6 +421,12 @@ void CX86Assembler::DivpsVo(XMMREGISTER registerId, const CAddress& address)
 	WriteEdVdOp_0F(0x5E, address, registerId);
 }
 
+void CX86Assembler::InsertpsVo(XMMREGISTER registerId, const CAddress& address, uint8 control)
+{
+	WriteEdVdOp_66_0F_3A(0x21, address, registerId);
+	WriteByte(control);
+}
+
 void CX86Assembler::Cvtdq2psVo(XMMREGISTER registerId, const CAddress& address)
 {
 	WriteEdVdOp_0F(0x5B, address, registerId);
@@ -35,25 +35,39 @@ CX86CpuFeatures CX86CpuFeatures::AutoDetect()
 	static const uint32 CPUID_FLAG_SSE41 = 0x080000;
 	static const uint32 CPUID_FLAG_AVX = 0x10000000;
 	static const uint32 CPUID_FLAG_AVX2 = 0x20;
+	static const uint32 CPUID_FLAG_FMA = 0x1000;
+	static const uint32 CPUID_FLAG_POPCNT = 0x800000;
+	static const uint32 CPUID_FLAG_LZCNT = 0x20;
+	static const uint32 CPUID_FLAG_BMI1 = 0x08;
+	static const uint32 CPUID_FLAG_BMI2 = 0x100;
 
 #ifdef HAS_CPUID_MSVC
 	std::array<int, 4> cpuInfo1;
 	std::array<int, 4> cpuInfo7;
+	std::array<int, 4> cpuInfoExt1;
 	__cpuid(cpuInfo1.data(), 1);
-	__cpuid(cpuInfo7.data(), 7);
+	__cpuidex(cpuInfo7.data(), 7, 0);
+	__cpuid(cpuInfoExt1.data(), 0x80000001);
 #endif //HAS_CPUID_MSVC
 
 #ifdef HAS_CPUID_GCC
 	std::array<unsigned int, 4> cpuInfo1;
 	std::array<unsigned int, 4> cpuInfo7;
+	std::array<unsigned int, 4> cpuInfoExt1 = {};
 	__get_cpuid(1, &cpuInfo1[0], &cpuInfo1[1], &cpuInfo1[2], &cpuInfo1[3]);
 	__get_cpuid_count(7, 0, &cpuInfo7[0], &cpuInfo7[1], &cpuInfo7[2], &cpuInfo7[3]);
+	__get_cpuid(0x80000001, &cpuInfoExt1[0], &cpuInfoExt1[1], &cpuInfoExt1[2], &cpuInfoExt1[3]);
 #endif //HAS_CPUID_GCC
 
 	features.hasSsse3 = (cpuInfo1[2] & CPUID_FLAG_SSSE3) != 0;
 	features.hasSse41 = (cpuInfo1[2] & CPUID_FLAG_SSE41) != 0;
 	features.hasAvx = (cpuInfo1[2] & CPUID_FLAG_AVX) != 0;
 	features.hasAvx2 = (cpuInfo7[1] & CPUID_FLAG_AVX2) != 0;
+	features.hasFma = (cpuInfo1[2] & CPUID_FLAG_FMA) != 0;
+	features.hasPopcnt = (cpuInfo1[2] & CPUID_FLAG_POPCNT) != 0;
+	features.hasLzcnt = (cpuInfoExt1[2] & CPUID_FLAG_LZCNT) != 0;
+	features.hasBmi1 = (cpuInfo7[1] & CPUID_FLAG_BMI1) != 0;
+	features.hasBmi2 = (cpuInfo7[1] & CPUID_FLAG_BMI2) != 0;
 
 #endif //HAS_CPUID
 
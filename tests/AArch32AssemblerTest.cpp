@@ -0,0 +1,42 @@
+#include "AArch32AssemblerTest.h"
+#include "AArch32Assembler.h"
+#include "MemStream.h"
+
+void CAArch32AssemblerTest::Run()
+{
+	//Reference encodings obtained from llvm-mc (armv7a, +neon)
+	// clang-format off
+	static const uint8 expectedCode[] =
+	{
+		0x10, 0x8B, 0x2D, 0xED, //vpush {d8-d15}
+		0x04, 0x8B, 0x2D, 0xED, //vpush {d8-d9}
+		0x10, 0x8B, 0xBD, 0xEC, //vpop {d8-d15}
+		0x08, 0x0B, 0xFD, 0xEC, //vpop {d16-d19}
+		0x64, 0x0A, 0xB0, 0xEE, //vmov.f32 s0, s9
+		0x41, 0xFA, 0xF0, 0xEE, //vmov.f32 s31, s2
+		0xB1, 0x21, 0x21, 0xF2, //vmov d2, d17
+		0x14, 0xE1, 0x64, 0xF2, //vmov d30, d4
+	};
+	// clang-format on
+
+	TEST_VERIFY(m_code.size() == sizeof(expectedCode));
+	TEST_VERIFY(!memcmp(m_code.data(), expectedCode, sizeof(expectedCode)));
+}
+
+void CAArch32AssemblerTest::Compile(Jitter::CJitter&)
+{
+	Framework::CMemStream codeStream;
+	CAArch32Assembler assembler;
+	assembler.SetStream(&codeStream);
+
+	assembler.Vpush(CAArch32Assembler::d8, 8);
+	assembler.Vpush(CAArch32Assembler::d8, 2);
+	assembler.Vpop(CAArch32Assembler::d8, 8);
+	assembler.Vpop(CAArch32Assembler::d16, 4);
+	assembler.Vmov(CAArch32Assembler::s0, CAArch32Assembler::s9);
+	assembler.Vmov(CAArch32Assembler::s31, CAArch32Assembler::s2);
+	assembler.Vmov(CAArch32Assembler::d2, CAArch32Assembler::d17);
+	assembler.Vmov(CAArch32Assembler::d30, CAArch32Assembler::d4);
+
+	m_code = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+
+class CAArch32AssemblerTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	std::vector<uint8> m_code;
+};
@@ -0,0 +1,228 @@
+#include "AArch32CodeGenTest.h"
+#include "Jitter_CodeGen_AArch32.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+
+//Checks code generated for values kept in NEON registers. q4-q7 are callee saved and pushed by
+//the prolog, q8-q15 are not. Single precision values in q8-q15 have no S alias and go through
+//a core register.
+
+void CAArch32CodeGenTest::Run()
+{
+	//Disassembly obtained from llvm-mc (armv7a, +neon)
+	// clang-format off
+	static const uint8 expectedMdCode[] =
+	{
+		0x30, 0x48, 0x2D, 0xE9, //push {r4, r5, r11, lr}
+		0x0C, 0x8B, 0x2D, 0xED, //vpush {d8, d9, d10, d11, d12, d13}
+		0x00, 0xB0, 0xA0, 0xE1, //mov r11, r0
+		0x0D, 0x00, 0xA0, 0xE1, //mov r0, sp
+		0x0F, 0xD0, 0xCD, 0xE3, //bic sp, sp, #15
+		0x0C, 0xD0, 0x4D, 0xE2, //sub sp, sp, #12
+		0x01, 0x00, 0x2D, 0xE9, //stmdb sp!, {r0}
+		0x10, 0xD0, 0x4D, 0xE2, //sub sp, sp, #16
+		0x10, 0xC0, 0x8B, 0xE2, //add r12, r11, #16
+		0xAF, 0xCA, 0x2C, 0xF4, //vld1.32 {d12, d13}, [r12:128]
+		0x00, 0xC0, 0x8B, 0xE2, //add r12, r11, #0
+		0xAF, 0xAA, 0x2C, 0xF4, //vld1.32 {d10, d11}, [r12:128]
+		0x4C, 0x88, 0x2A, 0xF2, //vadd.i32 q4, q5, q6
+		0x5A, 0xC1, 0x08, 0xF2, //vand q6, q4, q5
+		0x60, 0xC0, 0x8B, 0xE2, //add r12, r11, #96
+		0xAF, 0xCA, 0x0C, 0xF4, //vst1.32 {d12, d13}, [r12:128]
+		0x10, 0xD0, 0x8D, 0xE2, //add sp, sp, #16
+		0x08, 0x00, 0xBD, 0xE8, //ldm sp!, {r3}
+		0x03, 0xD0, 0xA0, 0xE1, //mov sp, r3
+		0x0C, 0x8B, 0xBD, 0xEC, //vpop {d8, d9, d10, d11, d12, d13}
+		0x30, 0x48, 0xBD, 0xE8, //pop {r4, r5, r11, lr}
+		0x1E, 0xFF, 0x2F, 0xE1, //bx lr
+	};
+
+	static const uint8 expectedMdHighCode[] =
+	{
+		0x30, 0x48, 0x2D, 0xE9, //push {r4, r5, r11, lr}
+		0x10, 0x8B, 0x2D, 0xED, //vpush {d8, d9, d10, d11, d12, d13, d14, d15}
+		0x00, 0xB0, 0xA0, 0xE1, //mov r11, r0
+		0x0D, 0x00, 0xA0, 0xE1, //mov r0, sp
+		0x0F, 0xD0, 0xCD, 0xE3, //bic sp, sp, #15
+		0x0C, 0xD0, 0x4D, 0xE2, //sub sp, sp, #12
+		0x01, 0x00, 0x2D, 0xE9, //stmdb sp!, {r0}
+		0x10, 0xD0, 0x4D, 0xE2, //sub sp, sp, #16
+		0x10, 0xC0, 0x8B, 0xE2, //add r12, r11, #16
+		0xAF, 0x2A, 0x6C, 0xF4, //vld1.32 {d18, d19}, [r12:128]
+		0x00, 0xC0, 0x8B, 0xE2, //add r12, r11, #0
+		0xAF, 0x4A, 0x6C, 0xF4, //vld1.32 {d20, d21}, [r12:128]
+		0xE2, 0x88, 0x24, 0xF2, //vadd.i32 q4, q10, q9
+		0x20, 0xC0, 0x8B, 0xE2, //add r12, r11, #32
+		0xAF, 0x0A, 0x6C, 0xF4, //vld1.32 {d16, d17}, [r12:128]
+		0x60, 0x88, 0x28, 0xF2, //vadd.i32 q4, q4, q8
+		0x30, 0xC0, 0x8B, 0xE2, //add r12, r11, #48
+		0xAF, 0xEA, 0x2C, 0xF4, //vld1.32 {d14, d15}, [r12:128]
+		0x4E, 0x88, 0x28, 0xF2, //vadd.i32 q4, q4, q7
+		0x40, 0xC0, 0x8B, 0xE2, //add r12, r11, #64
+		0xAF, 0xCA, 0x2C, 0xF4, //vld1.32 {d12, d13}, [r12:128]
+		0x4C, 0x88, 0x28, 0xF2, //vadd.i32 q4, q4, q6
+		0x50, 0xC0, 0x8B, 0xE2, //add r12, r11, #80
+		0xAF, 0xAA, 0x2C, 0xF4, //vld1.32 {d10, d11}, [r12:128]
+		0x4A, 0x68, 0x68, 0xF2, //vadd.i32 q11, q4, q5
+		0x60, 0xC0, 0x8B, 0xE2, //add r12, r11, #96
+		0xAF, 0x6A, 0x4C, 0xF4, //vst1.32 {d22, d23}, [r12:128]
+		0xF2, 0x81, 0x04, 0xF3, //veor q4, q10, q9
+		0x70, 0x81, 0x08, 0xF3, //veor q4, q4, q8
+		0x5E, 0x81, 0x08, 0xF3, //veor q4, q4, q7
+		0x5C, 0x81, 0x08, 0xF3, //veor q4, q4, q6
+		0x5A, 0xC1, 0x08, 0xF3, //veor q6, q4, q5
+		0x70, 0xC0, 0x8B, 0xE2, //add r12, r11, #112
+		0xAF, 0xCA, 0x0C, 0xF4, //vst1.32 {d12, d13}, [r12:128]
+		0x10, 0xD0, 0x8D, 0xE2, //add sp, sp, #16
+		0x08, 0x00, 0xBD, 0xE8, //ldm sp!, {r3}
+		0x03, 0xD0, 0xA0, 0xE1, //mov sp, r3
+		0x10, 0x8B, 0xBD, 0xEC, //vpop {d8, d9, d10, d11, d12, d13, d14, d15}
+		0x30, 0x48, 0xBD, 0xE8, //pop {r4, r5, r11, lr}
+		0x1E, 0xFF, 0x2F, 0xE1, //bx lr
+	};
+
+	static const uint8 expectedFpuCode[] =
+	{
+		0x30, 0x48, 0x2D, 0xE9, //push {r4, r5, r11, lr}
+		0x10, 0x8B, 0x2D, 0xED, //vpush {d8, d9, d10, d11, d12, d13, d14, d15}
+		0x00, 0xB0, 0xA0, 0xE1, //mov r11, r0
+		0x0D, 0x00, 0xA0, 0xE1, //mov r0, sp
+		0x0F, 0xD0, 0xCD, 0xE3, //bic sp, sp, #15
+		0x0C, 0xD0, 0x4D, 0xE2, //sub sp, sp, #12
+		0x01, 0x00, 0x2D, 0xE9, //stmdb sp!, {r0}
+		0x10, 0xD0, 0x4D, 0xE2, //sub sp, sp, #16
+		0x20, 0x0A, 0x9B, 0xED, //vldr s0, [r11, #128]
+		0x10, 0x0B, 0x10, 0xEE, //vmov.32 r0, d0[0]
+		0x90, 0x0B, 0x02, 0xEE, //vmov.32 d18[0], r0
+		0x21, 0x0A, 0x9B, 0xED, //vldr s0, [r11, #132]
+		0x10, 0x0B, 0x10, 0xEE, //vmov.32 r0, d0[0]
+		0x90, 0x0B, 0x00, 0xEE, //vmov.32 d16[0], r0
+		0x90, 0x0B, 0x12, 0xEE, //vmov.32 r0, d18[0]
+		0x10, 0x0B, 0x00, 0xEE, //vmov.32 d0[0], r0
+		0x90, 0x0B, 0x10, 0xEE, //vmov.32 r0, d16[0]
+		0x10, 0x0B, 0x20, 0xEE, //vmov.32 d0[1], r0
+		0x20, 0x8A, 0x30, 0xEE, //vadd.f32 s16, s0, s1
+		0x22, 0xEA, 0x9B, 0xED, //vldr s28, [r11, #136]
+		0x0E, 0x8A, 0x38, 0xEE, //vadd.f32 s16, s16, s28
+		0x23, 0xCA, 0x9B, 0xED, //vldr s24, [r11, #140]
+		0x0C, 0x8A, 0x38, 0xEE, //vadd.f32 s16, s16, s24
+		0x24, 0xAA, 0x9B, 0xED, //vldr s20, [r11, #144]
+		0x0A, 0x1A, 0x38, 0xEE, //vadd.f32 s2, s16, s20
+		0x10, 0x0B, 0x11, 0xEE, //vmov.32 r0, d1[0]
+		0x90, 0x0B, 0x04, 0xEE, //vmov.32 d20[0], r0
+		0x90, 0x0B, 0x14, 0xEE, //vmov.32 r0, d20[0]
+		0x10, 0x0B, 0x00, 0xEE, //vmov.32 d0[0], r0
+		0x25, 0x0A, 0x8B, 0xED, //vstr s0, [r11, #148]
+		0x90, 0x0B, 0x12, 0xEE, //vmov.32 r0, d18[0]
+		0x10, 0x0B, 0x00, 0xEE, //vmov.32 d0[0], r0
+		0x90, 0x0B, 0x10, 0xEE, //vmov.32 r0, d16[0]
+		0x10, 0x0B, 0x20, 0xEE, //vmov.32 d0[1], r0
+		0x20, 0x8A, 0x20, 0xEE, //vmul.f32 s16, s0, s1
+		0x0E, 0x8A, 0x28, 0xEE, //vmul.f32 s16, s16, s28
+		0x0C, 0x8A, 0x28, 0xEE, //vmul.f32 s16, s16, s24
+		0x0A, 0xCA, 0x28, 0xEE, //vmul.f32 s24, s16, s20
+		0x26, 0xCA, 0x8B, 0xED, //vstr s24, [r11, #152]
+		0x10, 0xD0, 0x8D, 0xE2, //add sp, sp, #16
+		0x08, 0x00, 0xBD, 0xE8, //ldm sp!, {r3}
+		0x03, 0xD0, 0xA0, 0xE1, //mov sp, r3
+		0x10, 0x8B, 0xBD, 0xEC, //vpop {d8, d9, d10, d11, d12, d13, d14, d15}
+		0x30, 0x48, 0xBD, 0xE8, //pop {r4, r5, r11, lr}
+		0x1E, 0xFF, 0x2F, 0xE1, //bx lr
+	};
+	// clang-format on
+
+	TEST_VERIFY(m_mdCode.size() == sizeof(expectedMdCode));
+	TEST_VERIFY(!memcmp(m_mdCode.data(), expectedMdCode, sizeof(expectedMdCode)));
+
+	TEST_VERIFY(m_mdHighCode.size() == sizeof(expectedMdHighCode));
+	TEST_VERIFY(!memcmp(m_mdHighCode.data(), expectedMdHighCode, sizeof(expectedMdHighCode)));
+
+	TEST_VERIFY(m_fpuCode.size() == sizeof(expectedFpuCode));
+	TEST_VERIFY(!memcmp(m_fpuCode.data(), expectedFpuCode, sizeof(expectedFpuCode)));
+}
+
+void CAArch32CodeGenTest::Compile(Jitter::CJitter&)
+{
+	Jitter::CJitter jitter(new Jitter::CCodeGen_AArch32());
+
+	CompileMdFunction(jitter);
+	CompileMdHighFunction(jitter);
+	CompileFpuFunction(jitter);
+}
+
+void CAArch32CodeGenTest::CompileMdFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	//Operations between registers, results stay in q4-q7
+	jitter.Begin();
+	{
+		jitter.MD_PushRel(offsetof(CONTEXT, mdValues[0]));
+		jitter.MD_PushRel(offsetof(CONTEXT, mdValues[1]));
+		jitter.MD_AddW();
+		jitter.MD_PushRel(offsetof(CONTEXT, mdValues[0]));
+		jitter.MD_And();
+		jitter.MD_PullRel(offsetof(CONTEXT, mdResults[0]));
+	}
+	jitter.End();
+
+	m_mdCode = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+}
+
+void CAArch32CodeGenTest::CompileMdHighFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	//All values are live at once, some of them need to go in q8-q15
+	jitter.Begin();
+	{
+		jitter.MD_PushRel(offsetof(CONTEXT, mdValues[0]));
+		for(unsigned int i = 1; i < 6; i++)
+		{
+			jitter.MD_PushRel(offsetof(CONTEXT, mdValues[0]) + (i * 16));
+			jitter.MD_AddW();
+		}
+		jitter.MD_PullRel(offsetof(CONTEXT, mdResults[0]));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, mdValues[0]));
+		for(unsigned int i = 1; i < 6; i++)
+		{
+			jitter.MD_PushRel(offsetof(CONTEXT, mdValues[0]) + (i * 16));
+			jitter.MD_Xor();
+		}
+		jitter.MD_PullRel(offsetof(CONTEXT, mdResults[1]));
+	}
+	jitter.End();
+
+	m_mdHighCode = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+}
+
+void CAArch32CodeGenTest::CompileFpuFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		jitter.FP_PushRel32(offsetof(CONTEXT, fpValues[0]));
+		for(unsigned int i = 1; i < 5; i++)
+		{
+			jitter.FP_PushRel32(offsetof(CONTEXT, fpValues[0]) + (i * 4));
+			jitter.FP_AddS();
+		}
+		jitter.FP_PullRel32(offsetof(CONTEXT, fpResults[0]));
+
+		jitter.FP_PushRel32(offsetof(CONTEXT, fpValues[0]));
+		for(unsigned int i = 1; i < 5; i++)
+		{
+			jitter.FP_PushRel32(offsetof(CONTEXT, fpValues[0]) + (i * 4));
+			jitter.FP_MulS();
+		}
+		jitter.FP_PullRel32(offsetof(CONTEXT, fpResults[1]));
+	}
+	jitter.End();
+
+	m_fpuCode = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+#include "Align16.h"
+
+class CAArch32CodeGenTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	struct CONTEXT
+	{
+		ALIGN16
+
+		uint8 mdValues[6][16];
+		uint8 mdResults[2][16];
+		float fpValues[5];
+		float fpResults[2];
+	};
+
+	void CompileMdFunction(Jitter::CJitter&);
+	void CompileMdHighFunction(Jitter::CJitter&);
+	void CompileFpuFunction(Jitter::CJitter&);
+
+	std::vector<uint8> m_mdCode;
+	std::vector<uint8> m_mdHighCode;
+	std::vector<uint8> m_fpuCode;
+};
@@ -0,0 +1,57 @@
+#include "AArch64AssemblerTest.h"
+#include "AArch64Assembler.h"
+#include "MemStream.h"
+
+void CAArch64AssemblerTest::Run()
+{
+	//Reference encodings obtained from llvm-mc (aarch64)
+	// clang-format off
+	static const uint8 expectedCode[] =
+	{
+		0x20, 0x3C, 0x08, 0x53, //ubfx w0, w1, #8, #8
+		0x93, 0x7F, 0x00, 0x53, //ubfx w19, w28, #0, #32
+		0x62, 0x3C, 0x08, 0x13, //sbfx w2, w3, #8, #8
+		0xA4, 0x7C, 0x1F, 0x13, //sbfx w4, w5, #31, #1
+		0xE6, 0x1C, 0x18, 0x33, //bfi w6, w7, #8, #8
+		0x49, 0x3D, 0x10, 0x33, //bfi w9, w10, #16, #16
+		0x8B, 0x3D, 0x04, 0x33, //bfxil w11, w12, #4, #12
+		0xCD, 0x01, 0x00, 0x33, //bfxil w13, w14, #0, #1
+		0xFF, 0x1D, 0x00, 0x72, //tst w15, #0xFF
+		0x1F, 0x3E, 0x10, 0x72, //tst w16, #0xFFFF0000
+		0x1F, 0x20, 0x03, 0xD5, //nop
+		0x1F, 0x20, 0x03, 0xD5, //nop (loop alignment padding)
+		0x1F, 0x20, 0x03, 0xD5, //loop: nop
+		0xFF, 0xFF, 0xFF, 0x17, //b loop
+	};
+	// clang-format on
+
+	TEST_VERIFY(m_code.size() == sizeof(expectedCode));
+	TEST_VERIFY(!memcmp(m_code.data(), expectedCode, sizeof(expectedCode)));
+}
+
+void CAArch64AssemblerTest::Compile(Jitter::CJitter&)
+{
+	Framework::CMemStream codeStream;
+	CAArch64Assembler assembler;
+	assembler.SetStream(&codeStream);
+
+	assembler.Ubfx(CAArch64Assembler::w0, CAArch64Assembler::w1, 8, 8);
+	assembler.Ubfx(CAArch64Assembler::w19, CAArch64Assembler::w28, 0, 32);
+	assembler.Sbfx(CAArch64Assembler::w2, CAArch64Assembler::w3, 8, 8);
+	assembler.Sbfx(CAArch64Assembler::w4, CAArch64Assembler::w5, 31, 1);
+	assembler.Bfi(CAArch64Assembler::w6, CAArch64Assembler::w7, 8, 8);
+	assembler.Bfi(CAArch64Assembler::w9, CAArch64Assembler::w10, 16, 16);
+	assembler.Bfxil(CAArch64Assembler::w11, CAArch64Assembler::w12, 4, 12);
+	assembler.Bfxil(CAArch64Assembler::w13, CAArch64Assembler::w14, 0, 1);
+	assembler.Tst(CAArch64Assembler::w15, 0, 0, 7);
+	assembler.Tst(CAArch64Assembler::w16, 0, 16, 15);
+
+	auto loopLabel = assembler.CreateLabel();
+	assembler.Nop();
+	assembler.MarkAlignedLabel(loopLabel, 0x10);
+	assembler.Nop();
+	assembler.B(loopLabel);
+	assembler.ResolveLabelReferences();
+
+	m_code = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+}
@@ -0,0 +1,104 @@
+#include "AdjacentStoreTest.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+//Context starts with the values written around the call, followed by the call result
+extern "C" void CAdjacentStoreTest_ReadValue(uint32* context)
+{
+	context[2] = context[0];
+}
+
+void CAdjacentStoreTest::PrepareExternalFunctions()
+{
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CAdjacentStoreTest_ReadValue), "_CAdjacentStoreTest_ReadValue", "vi");
+}
+
+void CAdjacentStoreTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Copy of 4 consecutive words
+		for(unsigned int i = 0; i < 4; i++)
+		{
+			jitter.PushRel(offsetof(CONTEXT, copySrc[i]));
+			jitter.PullRel(offsetof(CONTEXT, copyResult[i]));
+		}
+
+		//Pair of constants, written in reverse order
+		jitter.PushCst(0x89ABCDEF);
+		jitter.PullRel(offsetof(CONTEXT, constantResult[1]));
+		jitter.PushCst(0x01234567);
+		jitter.PullRel(offsetof(CONTEXT, constantResult[0]));
+
+		//Pair of computed values
+		jitter.PushRel(offsetof(CONTEXT, src[0]));
+		jitter.PushCst(0x100);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, valueResult[0]));
+
+		jitter.PushRel(offsetof(CONTEXT, src[1]));
+		jitter.PushCst(0x200);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, valueResult[1]));
+
+		//First value is read back before the second one is written
+		jitter.PushRel(offsetof(CONTEXT, src[2]));
+		jitter.PushCst(1);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, readValues[0]));
+
+		jitter.PushRel(offsetof(CONTEXT, readValues[0]));
+		jitter.Shl(1);
+		jitter.PullRel(offsetof(CONTEXT, readResult));
+
+		jitter.PushRel(offsetof(CONTEXT, src[3]));
+		jitter.PullRel(offsetof(CONTEXT, readValues[1]));
+
+		//Callee reads the first value before the second one is written
+		jitter.PushRel(offsetof(CONTEXT, src[3]));
+		jitter.PullRel(offsetof(CONTEXT, callValues[0]));
+
+		jitter.PushCtx();
+		jitter.Call(reinterpret_cast<void*>(&CAdjacentStoreTest_ReadValue), 1, Jitter::CJitter::RETURN_VALUE_NONE);
+
+		jitter.PushRel(offsetof(CONTEXT, src[2]));
+		jitter.PullRel(offsetof(CONTEXT, callValues[1]));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CAdjacentStoreTest::Run()
+{
+	memset(&m_context, 0, sizeof(m_context));
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		m_context.copySrc[i] = 0x01010101 * (i + 1);
+	}
+	m_context.src[0] = 0x11111111;
+	m_context.src[1] = 0x22222222;
+	m_context.src[2] = 0x33333333;
+	m_context.src[3] = 0x44444444;
+
+	m_function(&m_context);
+
+	TEST_VERIFY(m_context.copyResult[0] == 0x01010101);
+	TEST_VERIFY(m_context.copyResult[1] == 0x02020202);
+	TEST_VERIFY(m_context.copyResult[2] == 0x03030303);
+	TEST_VERIFY(m_context.copyResult[3] == 0x04040404);
+	TEST_VERIFY(m_context.constantResult[0] == 0x01234567);
+	TEST_VERIFY(m_context.constantResult[1] == 0x89ABCDEF);
+	TEST_VERIFY(m_context.valueResult[0] == 0x11111211);
+	TEST_VERIFY(m_context.valueResult[1] == 0x22222422);
+	TEST_VERIFY(m_context.readValues[0] == 0x33333334);
+	TEST_VERIFY(m_context.readValues[1] == 0x44444444);
+	TEST_VERIFY(m_context.readResult == 0x66666668);
+	TEST_VERIFY(m_context.callValues[0] == 0x44444444);
+	TEST_VERIFY(m_context.callValues[1] == 0x33333333);
+	TEST_VERIFY(m_context.callResult == 0x44444444);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Test.h"
+#include "Align16.h"
+
+class CAdjacentStoreTest : public CTest
+{
+public:
+	static void PrepareExternalFunctions();
+
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		ALIGN16
+
+		uint32 callValues[2];
+		uint32 callResult;
+		uint32 readResult;
+		uint32 copySrc[4];
+		uint32 copyResult[4];
+		uint32 src[4];
+		uint32 constantResult[2];
+		uint32 valueResult[2];
+		uint32 readValues[2];
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,226 @@
+#include "AotCompilerTest.h"
+#include <stdexcept>
+#include <string>
+#include "MemStream.h"
+#include "AotCompiler.h"
+#include "Jitter_CodeGenFactory.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include "Jitter_CodeGen_AArch64.h"
+#elif defined(__x86_64__) || defined(_M_X64)
+#include "Jitter_CodeGen_x86_64.h"
+#endif
+
+#define FUNCTION_COUNT 32
+#define SHARD_COUNT 3
+#define TEST_VALUE 0x12345678
+
+extern "C" void CAotCompilerTest_Accumulate(void* context, uint32 value)
+{
+	reinterpret_cast<CAotCompilerTest::CONTEXT*>(context)->result0 += value;
+}
+
+//Gives access to symbols gathered by the compiler
+class CAotCompilerTestObjectFile : public Jitter::CObjectFile
+{
+public:
+	CAotCompilerTestObjectFile()
+	    : CObjectFile(CPU_ARCH_X64)
+	{
+	}
+
+	const InternalSymbolArray& GetInternalSymbols() const
+	{
+		return m_internalSymbols;
+	}
+
+	void Write(Framework::CStream& stream) override
+	{
+		stream.Write32(static_cast<uint32>(m_externalSymbols.size()));
+		for(const auto& externalSymbol : m_externalSymbols)
+		{
+			stream.Write(externalSymbol.name.c_str(), externalSymbol.name.size() + 1);
+		}
+		stream.Write32(static_cast<uint32>(m_internalSymbols.size()));
+		for(const auto& internalSymbol : m_internalSymbols)
+		{
+			stream.Write(internalSymbol.name.c_str(), internalSymbol.name.size() + 1);
+			stream.Write32(static_cast<uint32>(internalSymbol.data.size()));
+			stream.Write(internalSymbol.data.data(), internalSymbol.data.size());
+			for(const auto& symbolReference : internalSymbol.symbolReferences)
+			{
+				stream.Write32(symbolReference.symbolIndex);
+				stream.Write32(symbolReference.offset);
+				stream.Write8(static_cast<uint8>(symbolReference.refType));
+			}
+		}
+	}
+};
+
+static void EmitFunction(Jitter::CJitter& jitter, uint32 index)
+{
+	jitter.Begin();
+	{
+		jitter.PushCtx();
+		jitter.PushRel(offsetof(CAotCompilerTest::CONTEXT, value));
+		jitter.PushCst(index);
+		jitter.Add();
+		jitter.Call(reinterpret_cast<void*>(&CAotCompilerTest_Accumulate), 2, Jitter::CJitter::RETURN_VALUE_NONE);
+
+		jitter.PushRel(offsetof(CAotCompilerTest::CONTEXT, value));
+		jitter.PushCst(index);
+		jitter.Xor();
+		jitter.PullRel(offsetof(CAotCompilerTest::CONTEXT, result1));
+	}
+	jitter.End();
+}
+
+static std::unique_ptr<Jitter::CObjectFile> CreateObjectFile()
+{
+	return std::make_unique<CAotCompilerTestObjectFile>();
+}
+
+static Jitter::CAotCompiler::ObjectFileArray CompileFunctions(unsigned int threadCount)
+{
+	Jitter::CAotCompiler compiler(&Jitter::CreateCodeGen, threadCount);
+	compiler.AddExternalSymbol("AotCompilerTest_Accumulate", reinterpret_cast<uintptr_t>(&CAotCompilerTest_Accumulate));
+
+	for(uint32 i = 0; i < FUNCTION_COUNT; i++)
+	{
+		compiler.AddFunction("AotCompilerTest_Function" + std::to_string(i),
+		                     [i](Jitter::CJitter& jitter) {
+			                     EmitFunction(jitter, i);
+		                     });
+	}
+
+	return compiler.Compile(&CreateObjectFile, SHARD_COUNT);
+}
+
+//Calls are made relocatable where supported, references then have another type than NATIVE_POINTER
+static Jitter::CCodeGen* CreateRelocatableCodeGen()
+{
+	auto codeGen = Jitter::CreateCodeGen();
+#if defined(__aarch64__) || defined(_M_ARM64)
+	static_cast<Jitter::CCodeGen_AArch64*>(codeGen)->SetGenerateRelocatableCalls(true);
+#elif defined(__x86_64__) || defined(_M_X64)
+	static_cast<Jitter::CCodeGen_x86_64*>(codeGen)->SetGenerateRelocatableCalls(true);
+#endif
+	return codeGen;
+}
+
+//Returns true if references in object files have the types reported by the code generator
+static bool CheckReferenceTypes()
+{
+	std::vector<Jitter::CCodeGen::SYMBOL_REF_TYPE> refTypes;
+	{
+		Jitter::CJitter jitter(CreateRelocatableCodeGen());
+		jitter.GetCodeGen()->SetExternalSymbolReferencedHandler(
+		    [&](uintptr_t, uint32, Jitter::CCodeGen::SYMBOL_REF_TYPE refType) {
+			    refTypes.push_back(refType);
+		    });
+		Framework::CMemStream codeStream;
+		jitter.SetStream(&codeStream);
+		EmitFunction(jitter, 0);
+	}
+
+	Jitter::CAotCompiler compiler(&CreateRelocatableCodeGen, 1);
+	compiler.AddExternalSymbol("AotCompilerTest_Accumulate", reinterpret_cast<uintptr_t>(&CAotCompilerTest_Accumulate));
+	compiler.AddFunction("AotCompilerTest_Function0",
+	                     [](Jitter::CJitter& jitter) {
+		                     EmitFunction(jitter, 0);
+	                     });
+	auto objectFiles = compiler.Compile(&CreateObjectFile);
+
+	const auto& internalSymbols = static_cast<const CAotCompilerTestObjectFile*>(objectFiles[0].get())->GetInternalSymbols();
+	const auto& symbolReferences = internalSymbols[0].symbolReferences;
+	if(symbolReferences.size() != refTypes.size()) return false;
+	for(unsigned int i = 0; i < refTypes.size(); i++)
+	{
+		if(symbolReferences[i].refType != refTypes[i]) return false;
+	}
+	return true;
+}
+
+//Returns true if the error of a failed function is reported and the function compiled after it
+//on the same worker is not affected by the state left behind
+static bool CompileFailingFunction()
+{
+	Jitter::CAotCompiler compiler(&Jitter::CreateCodeGen, 1);
+	compiler.AddExternalSymbol("AotCompilerTest_Accumulate", reinterpret_cast<uintptr_t>(&CAotCompilerTest_Accumulate));
+	compiler.AddFunction("AotCompilerTest_Failing",
+	                     [](Jitter::CJitter& jitter) {
+		                     jitter.Begin();
+		                     jitter.PushCst(0);
+		                     throw std::runtime_error("AotCompilerTest_Failing");
+	                     });
+	compiler.AddFunction("AotCompilerTest_Function0",
+	                     [](Jitter::CJitter& jitter) {
+		                     EmitFunction(jitter, 0);
+	                     });
+
+	try
+	{
+		compiler.Compile(&CreateObjectFile);
+	}
+	catch(const std::runtime_error& error)
+	{
+		return strcmp(error.what(), "AotCompilerTest_Failing") == 0;
+	}
+	return false;
+}
+
+void CAotCompilerTest::PrepareExternalFunctions()
+{
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CAotCompilerTest_Accumulate), "_CAotCompilerTest_Accumulate", "vii");
+}
+
+void CAotCompilerTest::Compile(Jitter::CJitter&)
+{
+	auto serialObjectFiles = CompileFunctions(1);
+	auto parallelObjectFiles = CompileFunctions(4);
+
+	TEST_VERIFY(serialObjectFiles.size() == SHARD_COUNT);
+	TEST_VERIFY(parallelObjectFiles.size() == SHARD_COUNT);
+
+	//Object files must not depend on the number of threads used
+	for(unsigned int i = 0; i < SHARD_COUNT; i++)
+	{
+		Framework::CMemStream serialStream;
+		Framework::CMemStream parallelStream;
+		serialObjectFiles[i]->Write(serialStream);
+		parallelObjectFiles[i]->Write(parallelStream);
+		TEST_VERIFY(serialStream.GetSize() == parallelStream.GetSize());
+		TEST_VERIFY(memcmp(serialStream.GetBuffer(), parallelStream.GetBuffer(), serialStream.GetSize()) == 0);
+	}
+
+	uint32 functionIndex = 0;
+	for(const auto& objectFile : parallelObjectFiles)
+	{
+		const auto& internalSymbols = static_cast<const CAotCompilerTestObjectFile*>(objectFile.get())->GetInternalSymbols();
+		for(const auto& internalSymbol : internalSymbols)
+		{
+			TEST_VERIFY(internalSymbol.name == "AotCompilerTest_Function" + std::to_string(functionIndex));
+			m_functions.push_back(FunctionType(internalSymbol.data.data(), internalSymbol.data.size()));
+			functionIndex++;
+		}
+	}
+	TEST_VERIFY(functionIndex == FUNCTION_COUNT);
+
+	TEST_VERIFY(CheckReferenceTypes());
+	TEST_VERIFY(CompileFailingFunction());
+}
+
+void CAotCompilerTest::Run()
+{
+	for(uint32 i = 0; i < m_functions.size(); i++)
+	{
+		CONTEXT context;
+		memset(&context, 0, sizeof(CONTEXT));
+		context.value = TEST_VALUE;
+
+		m_functions[i](&context);
+		TEST_VERIFY(context.result0 == (TEST_VALUE + i));
+		TEST_VERIFY(context.result1 == (TEST_VALUE ^ i));
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+
+class CAotCompilerTest : public CTest
+{
+public:
+	static void PrepareExternalFunctions();
+
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+	struct CONTEXT
+	{
+		uint32 value;
+
+		uint32 result0;
+		uint32 result1;
+	};
+
+private:
+	std::vector<FunctionType> m_functions;
+};
@@ -0,0 +1,123 @@
+#include "BitfieldTest.h"
+#include "MemStream.h"
+
+static const uint32 g_input0 = 0x12345678;
+static const uint32 g_input1 = 0xCAFEBABE;
+
+void CBitfieldTest::Run()
+{
+	memset(&m_context, 0, sizeof(m_context));
+
+	m_context.input0 = g_input0;
+	m_context.input1 = g_input1;
+
+	m_function(&m_context);
+
+	TEST_VERIFY(m_context.extractResult0 == ((g_input0 >> 8) & 0xFF));
+	TEST_VERIFY(m_context.extractResult1 == ((g_input0 >> 20) & 0xFFF));
+	TEST_VERIFY(m_context.extractResult2 == static_cast<uint32>(static_cast<int32>(g_input1 << 16) >> 24));
+	TEST_VERIFY(m_context.extractResult3 == ((g_input1 << 8) >> 20));
+	TEST_VERIFY(m_context.extractResult4 == ((static_cast<uint32>(static_cast<int32>(g_input1) >> 4)) & 0x7));
+	TEST_VERIFY(m_context.extractResult5 == static_cast<uint32>(static_cast<int32>(g_input1) >> 4));
+
+	TEST_VERIFY(m_context.insertResult0 == ((g_input0 & ~0xFF00) | ((g_input1 & 0xFF) << 8)));
+	TEST_VERIFY(m_context.insertResult1 == ((g_input0 & ~0xFFF) | ((g_input1 >> 4) & 0xFFF)));
+	TEST_VERIFY(m_context.insertResult2 == ((g_input0 & ~0xF000) | (((g_input1 >> 20) & 0xF) << 12)));
+	TEST_VERIFY(m_context.insertResult3 == ((g_input0 & 0xFFFF) | (g_input1 << 16)));
+	//Mask doesn't match the field, can't be merged
+	TEST_VERIFY(m_context.insertResult4 == ((g_input0 & ~0xFF0) | ((g_input1 & 0xFF) << 8)));
+}
+
+void CBitfieldTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Extract
+		jitter.PushRel(offsetof(CONTEXT, input0));
+		jitter.Srl(8);
+		jitter.PushCst(0xFF);
+		jitter.And();
+		jitter.PullRel(offsetof(CONTEXT, extractResult0));
+
+		jitter.PushRel(offsetof(CONTEXT, input0));
+		jitter.Srl(20);
+		jitter.PushCst(0xFFF);
+		jitter.And();
+		jitter.PullRel(offsetof(CONTEXT, extractResult1));
+
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.Shl(16);
+		jitter.Sra(24);
+		jitter.PullRel(offsetof(CONTEXT, extractResult2));
+
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.Shl(8);
+		jitter.Srl(20);
+		jitter.PullRel(offsetof(CONTEXT, extractResult3));
+
+		//Shifted value is used more than once
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.Sra(4);
+		jitter.PushTop();
+		jitter.PushCst(0x7);
+		jitter.And();
+		jitter.PullRel(offsetof(CONTEXT, extractResult4));
+		jitter.PullRel(offsetof(CONTEXT, extractResult5));
+
+		//Insert
+		jitter.PushRel(offsetof(CONTEXT, input0));
+		jitter.PushCst(~0xFF00);
+		jitter.And();
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.PushCst(0xFF);
+		jitter.And();
+		jitter.Shl(8);
+		jitter.Or();
+		jitter.PullRel(offsetof(CONTEXT, insertResult0));
+
+		jitter.PushRel(offsetof(CONTEXT, input0));
+		jitter.PushCst(~0xFFF);
+		jitter.And();
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.Srl(4);
+		jitter.PushCst(0xFFF);
+		jitter.And();
+		jitter.Or();
+		jitter.PullRel(offsetof(CONTEXT, insertResult1));
+
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.Srl(20);
+		jitter.PushCst(0xF);
+		jitter.And();
+		jitter.Shl(12);
+		jitter.PushRel(offsetof(CONTEXT, input0));
+		jitter.PushCst(~0xF000);
+		jitter.And();
+		jitter.Or();
+		jitter.PullRel(offsetof(CONTEXT, insertResult2));
+
+		jitter.PushRel(offsetof(CONTEXT, input0));
+		jitter.PushCst(0xFFFF);
+		jitter.And();
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.Shl(16);
+		jitter.Or();
+		jitter.PullRel(offsetof(CONTEXT, insertResult3));
+
+		jitter.PushRel(offsetof(CONTEXT, input0));
+		jitter.PushCst(~0xFF0);
+		jitter.And();
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.PushCst(0xFF);
+		jitter.And();
+		jitter.Shl(8);
+		jitter.Or();
+		jitter.PullRel(offsetof(CONTEXT, insertResult4));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Test.h"
+
+class CBitfieldTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 input0;
+		uint32 input1;
+
+		uint32 extractResult0;
+		uint32 extractResult1;
+		uint32 extractResult2;
+		uint32 extractResult3;
+		uint32 extractResult4;
+		uint32 extractResult5;
+
+		uint32 insertResult0;
+		uint32 insertResult1;
+		uint32 insertResult2;
+		uint32 insertResult3;
+		uint32 insertResult4;
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
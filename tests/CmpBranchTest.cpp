@@ -0,0 +1,181 @@
+#include "CmpBranchTest.h"
+#include "MemStream.h"
+
+//Branches on the result of a comparison are turned into a branch doing the comparison.
+//Predicates used by anything else and operands modified before the branch prevent this.
+
+static const Jitter::CONDITION g_conditions[] =
+    {
+        Jitter::CONDITION_EQ,
+        Jitter::CONDITION_NE,
+        Jitter::CONDITION_BL,
+        Jitter::CONDITION_BE,
+        Jitter::CONDITION_AB,
+        Jitter::CONDITION_AE,
+        Jitter::CONDITION_LT,
+        Jitter::CONDITION_LE,
+        Jitter::CONDITION_GT,
+        Jitter::CONDITION_GE,
+};
+
+static bool EvaluateCondition(Jitter::CONDITION condition, uint32 value0, uint32 value1)
+{
+	switch(condition)
+	{
+	case Jitter::CONDITION_EQ:
+		return value0 == value1;
+	case Jitter::CONDITION_NE:
+		return value0 != value1;
+	case Jitter::CONDITION_BL:
+		return value0 < value1;
+	case Jitter::CONDITION_BE:
+		return value0 <= value1;
+	case Jitter::CONDITION_AB:
+		return value0 > value1;
+	case Jitter::CONDITION_AE:
+		return value0 >= value1;
+	case Jitter::CONDITION_LT:
+		return static_cast<int32>(value0) < static_cast<int32>(value1);
+	case Jitter::CONDITION_LE:
+		return static_cast<int32>(value0) <= static_cast<int32>(value1);
+	case Jitter::CONDITION_GT:
+		return static_cast<int32>(value0) > static_cast<int32>(value1);
+	case Jitter::CONDITION_GE:
+		return static_cast<int32>(value0) >= static_cast<int32>(value1);
+	default:
+		assert(false);
+		return false;
+	}
+}
+
+CCmpBranchTest::CCmpBranchTest(bool useConstant, uint32 value0, uint32 value1)
+    : m_useConstant(useConstant)
+    , m_value0(value0)
+    , m_value1(value1)
+{
+}
+
+void CCmpBranchTest::Run()
+{
+	TEST_VERIFY(m_merged);
+
+	memset(&m_context, 0, sizeof(m_context));
+	m_context.value0 = m_value0;
+	m_context.value1 = m_value1;
+	m_context.value2 = m_value0;
+
+	for(unsigned int i = 0; i < CONDITION_COUNT; i++)
+	{
+		m_context.results[i] = 0xDEADBEEF;
+		m_context.negatedResults[i] = 0xDEADBEEF;
+	}
+	m_context.storedPredicateResult = 0xDEADBEEF;
+	m_context.modifiedOperandResult = 0xDEADBEEF;
+
+	m_function(&m_context);
+
+	for(unsigned int i = 0; i < CONDITION_COUNT; i++)
+	{
+		uint32 result = EvaluateCondition(g_conditions[i], m_value0, m_value1) ? 1 : 0;
+		TEST_VERIFY(m_context.results[i] == result);
+		TEST_VERIFY(m_context.negatedResults[i] == (result ^ 1));
+	}
+
+	uint32 ltResult = EvaluateCondition(Jitter::CONDITION_LT, m_value0, m_value1) ? 1 : 0;
+	TEST_VERIFY(m_context.predicate == ltResult);
+	TEST_VERIFY(m_context.storedPredicateResult == ltResult);
+
+	uint32 blResult = EvaluateCondition(Jitter::CONDITION_BL, m_value0, m_value1) ? 1 : 0;
+	TEST_VERIFY(m_context.value2 == (m_value0 + 1));
+	TEST_VERIFY(m_context.modifiedOperandResult == blResult);
+}
+
+void CCmpBranchTest::MakeBranchCase(Jitter::CJitter& jitter, Jitter::CONDITION cmpCondition, Jitter::CONDITION branchCondition, size_t result)
+{
+	jitter.PushRel(offsetof(CONTEXT, value0));
+	if(m_useConstant)
+	{
+		jitter.PushCst(m_value1);
+	}
+	else
+	{
+		jitter.PushRel(offsetof(CONTEXT, value1));
+	}
+	jitter.Cmp(cmpCondition);
+
+	jitter.PushCst(0);
+	jitter.BeginIf(branchCondition);
+	{
+		jitter.PushCst(1);
+		jitter.PullRel(result);
+	}
+	jitter.Else();
+	{
+		jitter.PushCst(0);
+		jitter.PullRel(result);
+	}
+	jitter.EndIf();
+}
+
+void CCmpBranchTest::Compile(Jitter::CJitter& jitter)
+{
+	Jitter::CCompileStats compileStats;
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+	jitter.SetCompileStats(&compileStats);
+
+	jitter.Begin();
+	{
+		for(unsigned int i = 0; i < CONDITION_COUNT; i++)
+		{
+			MakeBranchCase(jitter, g_conditions[i], Jitter::CONDITION_NE, offsetof(CONTEXT, results) + (i * 4));
+			MakeBranchCase(jitter, g_conditions[i], Jitter::CONDITION_EQ, offsetof(CONTEXT, negatedResults) + (i * 4));
+		}
+
+		//Predicate is also stored
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Cmp(Jitter::CONDITION_LT);
+		jitter.PushTop();
+		jitter.PullRel(offsetof(CONTEXT, predicate));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.PushCst(1);
+			jitter.PullRel(offsetof(CONTEXT, storedPredicateResult));
+		}
+		jitter.Else();
+		{
+			jitter.PushCst(0);
+			jitter.PullRel(offsetof(CONTEXT, storedPredicateResult));
+		}
+		jitter.EndIf();
+
+		//Operand is modified between the comparison and the branch
+		jitter.PushRel(offsetof(CONTEXT, value2));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Cmp(Jitter::CONDITION_BL);
+		jitter.PushRel(offsetof(CONTEXT, value2));
+		jitter.PushCst(1);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, value2));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.PushCst(1);
+			jitter.PullRel(offsetof(CONTEXT, modifiedOperandResult));
+		}
+		jitter.Else();
+		{
+			jitter.PushCst(0);
+			jitter.PullRel(offsetof(CONTEXT, modifiedOperandResult));
+		}
+		jitter.EndIf();
+	}
+	jitter.End();
+
+	jitter.SetCompileStats(nullptr);
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+	m_merged = compileStats.GetPassStats(Jitter::CCompileStats::PASS_MERGE_CMP_CONDJMP).changeCount != 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Test.h"
+
+class CCmpBranchTest : public CTest
+{
+public:
+	CCmpBranchTest(bool, uint32, uint32);
+
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	enum
+	{
+		CONDITION_COUNT = 10,
+	};
+
+	void MakeBranchCase(Jitter::CJitter&, Jitter::CONDITION, Jitter::CONDITION, size_t);
+
+	struct CONTEXT
+	{
+		uint32 value0;
+		uint32 value1;
+		uint32 value2;
+
+		uint32 results[CONDITION_COUNT];
+		uint32 negatedResults[CONDITION_COUNT];
+		uint32 predicate;
+		uint32 storedPredicateResult;
+		uint32 modifiedOperandResult;
+	};
+
+	bool m_useConstant = false;
+	uint32 m_value0 = 0;
+	uint32 m_value1 = 0;
+	bool m_merged = false;
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,195 @@
+#include "CodeCacheTest.h"
+#include <filesystem>
+#include "MemStream.h"
+#include "CodeCache.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+#define VALUE_0 0x12345678
+#define VALUE_1 0x0000FFFF
+
+//Code isn't generated at the start of the stream, symbol references must account for it
+#define CODE_OFFSET 0x10
+
+extern "C" uint32 CCodeCacheTest_Add(uint32 v1, uint32 v2)
+{
+	return v1 + v2;
+}
+
+extern "C" uint32 CCodeCacheTest_Sub(uint32 v1, uint32 v2)
+{
+	return v1 - v2;
+}
+
+static uint64 GetFileSize(const std::filesystem::path& path)
+{
+	std::error_code errorCode;
+	auto size = std::filesystem::file_size(path, errorCode);
+	return errorCode ? 0 : size;
+}
+
+void CCodeCacheTest::PrepareExternalFunctions()
+{
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CCodeCacheTest_Add), "_CCodeCacheTest_Add", "iii");
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CCodeCacheTest_Sub), "_CCodeCacheTest_Sub", "iii");
+}
+
+void CCodeCacheTest::CompileFunction(Jitter::CJitter& jitter, void* helper, Framework::CMemStream& codeStream, SymbolReferenceArray& symbolReferences)
+{
+	for(uint32 i = 0; i < CODE_OFFSET; i++)
+	{
+		codeStream.Write8(0);
+	}
+
+	jitter.SetStream(&codeStream);
+	jitter.GetCodeGen()->SetExternalSymbolReferencedHandler(
+	    [&](uintptr_t value, uint32 offset, Jitter::CCodeGen::SYMBOL_REF_TYPE type) {
+		    SYMBOL_REFERENCE symbolReference;
+		    symbolReference.value = value;
+		    if(type == Jitter::CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER)
+		    {
+			    symbolReference.locationValid = ((offset + sizeof(uintptr_t)) <= codeStream.GetSize()) &&
+			                                    (memcmp(codeStream.GetBuffer() + offset, &value, sizeof(uintptr_t)) == 0);
+		    }
+		    else
+		    {
+			    symbolReference.locationValid = (offset >= CODE_OFFSET) && (offset < codeStream.GetSize());
+		    }
+		    symbolReferences.push_back(symbolReference);
+	    });
+
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Call(helper, 2, Jitter::CJitter::RETURN_VALUE_32);
+		jitter.PullRel(offsetof(CONTEXT, result0));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Xor();
+		jitter.PullRel(offsetof(CONTEXT, result1));
+	}
+	jitter.End();
+
+	jitter.GetCodeGen()->SetExternalSymbolReferencedHandler(Jitter::CCodeGen::ExternalSymbolReferencedHandler());
+}
+
+void CCodeCacheTest::Compile(Jitter::CJitter& jitter)
+{
+	auto cachePath = std::filesystem::temp_directory_path() / "CodeCacheTest.bin";
+	std::error_code errorCode;
+	std::filesystem::remove(cachePath, errorCode);
+
+	//First run, the cache is empty and gets filled
+	{
+		Jitter::CCodeCache codeCache(cachePath.string(), "test");
+		codeCache.RegisterExternalSymbol("helper", reinterpret_cast<uintptr_t>(&CCodeCacheTest_Add));
+		jitter.SetCodeCache(&codeCache);
+
+		Framework::CMemStream codeStream;
+		CompileFunction(jitter, reinterpret_cast<void*>(&CCodeCacheTest_Add), codeStream, m_symbolReferences);
+		m_function = FunctionType(codeStream.GetBuffer() + CODE_OFFSET, codeStream.GetSize() - CODE_OFFSET);
+
+		jitter.SetCodeCache(nullptr);
+	}
+
+	m_cacheSizeAfterFirstCompile = GetFileSize(cachePath);
+
+	//Second run, the helper lives at another address and the code needs to be relocated
+	{
+		Jitter::CCodeCache codeCache(cachePath.string(), "test");
+		codeCache.RegisterExternalSymbol("helper", reinterpret_cast<uintptr_t>(&CCodeCacheTest_Sub));
+		jitter.SetCodeCache(&codeCache);
+
+		Framework::CMemStream codeStream;
+		CompileFunction(jitter, reinterpret_cast<void*>(&CCodeCacheTest_Sub), codeStream, m_cachedSymbolReferences);
+		m_cachedFunction = FunctionType(codeStream.GetBuffer() + CODE_OFFSET, codeStream.GetSize() - CODE_OFFSET);
+		m_cacheHitCount = codeCache.GetHitCount();
+
+		jitter.SetCodeCache(nullptr);
+	}
+
+	m_cacheSizeAfterSecondCompile = GetFileSize(cachePath);
+
+	//Damage the last byte of the record, it must not be used and gets replaced
+	if(FILE* file = fopen(cachePath.string().c_str(), "r+b"))
+	{
+		if(fseek(file, -1, SEEK_END) == 0)
+		{
+			int value = fgetc(file);
+			fseek(file, -1, SEEK_END);
+			fputc(value ^ 0xFF, file);
+		}
+		fclose(file);
+	}
+
+	{
+		Jitter::CCodeCache codeCache(cachePath.string(), "test");
+		codeCache.RegisterExternalSymbol("helper", reinterpret_cast<uintptr_t>(&CCodeCacheTest_Add));
+		jitter.SetCodeCache(&codeCache);
+
+		Framework::CMemStream codeStream;
+		SymbolReferenceArray symbolReferences;
+		CompileFunction(jitter, reinterpret_cast<void*>(&CCodeCacheTest_Add), codeStream, symbolReferences);
+		m_rebuiltFunction = FunctionType(codeStream.GetBuffer() + CODE_OFFSET, codeStream.GetSize() - CODE_OFFSET);
+		m_damagedCacheHitCount = codeCache.GetHitCount();
+
+		jitter.SetCodeCache(nullptr);
+	}
+
+	m_cacheSizeAfterRebuild = GetFileSize(cachePath);
+
+	std::filesystem::remove(cachePath, errorCode);
+}
+
+void CCodeCacheTest::Run()
+{
+	//Nothing should have been appended if the code was found in the cache
+	TEST_VERIFY(m_cacheSizeAfterFirstCompile == m_cacheSizeAfterSecondCompile);
+#ifndef __EMSCRIPTEN__
+	//Wasm backend doesn't report its call targets, code referencing helpers can't be cached
+	TEST_VERIFY(m_cacheSizeAfterFirstCompile != 0);
+	TEST_VERIFY(m_cacheHitCount == 1);
+	TEST_VERIFY(m_damagedCacheHitCount == 0);
+	TEST_VERIFY(m_cacheSizeAfterRebuild == m_cacheSizeAfterFirstCompile);
+
+	//References are reported on hits as well, with the values registered in that session
+	TEST_VERIFY(!m_symbolReferences.empty());
+	TEST_VERIFY(m_symbolReferences.size() == m_cachedSymbolReferences.size());
+	for(const auto& symbolReference : m_symbolReferences)
+	{
+		TEST_VERIFY(symbolReference.value == reinterpret_cast<uintptr_t>(&CCodeCacheTest_Add));
+		TEST_VERIFY(symbolReference.locationValid);
+	}
+	for(const auto& symbolReference : m_cachedSymbolReferences)
+	{
+		TEST_VERIFY(symbolReference.value == reinterpret_cast<uintptr_t>(&CCodeCacheTest_Sub));
+		TEST_VERIFY(symbolReference.locationValid);
+	}
+#endif
+
+	CONTEXT context;
+	memset(&context, 0, sizeof(CONTEXT));
+	context.value0 = VALUE_0;
+	context.value1 = VALUE_1;
+
+	m_function(&context);
+	TEST_VERIFY(context.result0 == (VALUE_0 + VALUE_1));
+	TEST_VERIFY(context.result1 == (VALUE_0 ^ VALUE_1));
+
+	memset(&context, 0, sizeof(CONTEXT));
+	context.value0 = VALUE_0;
+	context.value1 = VALUE_1;
+
+	m_cachedFunction(&context);
+	TEST_VERIFY(context.result0 == (VALUE_0 - VALUE_1));
+	TEST_VERIFY(context.result1 == (VALUE_0 ^ VALUE_1));
+
+	memset(&context, 0, sizeof(CONTEXT));
+	context.value0 = VALUE_0;
+	context.value1 = VALUE_1;
+
+	m_rebuiltFunction(&context);
+	TEST_VERIFY(context.result0 == (VALUE_0 + VALUE_1));
+	TEST_VERIFY(context.result1 == (VALUE_0 ^ VALUE_1));
+}
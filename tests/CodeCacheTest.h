@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Test.h"
+#include "MemStream.h"
+
+class CCodeCacheTest : public CTest
+{
+public:
+	static void PrepareExternalFunctions();
+
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 value0;
+		uint32 value1;
+
+		uint32 result0;
+		uint32 result1;
+	};
+
+	struct SYMBOL_REFERENCE
+	{
+		uintptr_t value = 0;
+		//Whether the reported offset points to the symbol's value in the stream
+		bool locationValid = false;
+	};
+	typedef std::vector<SYMBOL_REFERENCE> SymbolReferenceArray;
+
+	void CompileFunction(Jitter::CJitter&, void*, Framework::CMemStream&, SymbolReferenceArray&);
+
+	uint64 m_cacheSizeAfterFirstCompile = 0;
+	uint64 m_cacheSizeAfterSecondCompile = 0;
+	uint64 m_cacheSizeAfterRebuild = 0;
+	uint32 m_cacheHitCount = 0;
+	uint32 m_damagedCacheHitCount = 0;
+
+	SymbolReferenceArray m_symbolReferences;
+	SymbolReferenceArray m_cachedSymbolReferences;
+
+	FunctionType m_function;
+	FunctionType m_cachedFunction;
+	FunctionType m_rebuiltFunction;
+};
@@ -0,0 +1,82 @@
+#include "CompileServiceTest.h"
+#include <vector>
+#include "CompileService.h"
+#include "Jitter_CodeGenFactory.h"
+
+#define FUNCTION_COUNT 16
+#define TEST_VALUE 8
+
+static bool IsCancelledFunction(uint64 tag)
+{
+	return (tag % 4) == 3;
+}
+
+void CCompileServiceTest::Compile(Jitter::CJitter& jitter)
+{
+	Jitter::CCompileService compileService(&Jitter::CreateCodeGen, 2);
+
+	std::vector<Jitter::CCompileService::JobPtr> jobs;
+	for(uint32 i = 0; i < FUNCTION_COUNT; i++)
+	{
+		jitter.Begin();
+		{
+			jitter.PushRel(offsetof(CONTEXT, value));
+			jitter.PushCst(i);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, result0));
+
+			jitter.PushRel(offsetof(CONTEXT, value));
+			jitter.PushCst(i);
+			jitter.BeginIf(Jitter::CONDITION_GT);
+			{
+				jitter.PushCst(1);
+				jitter.PullRel(offsetof(CONTEXT, result1));
+			}
+			jitter.Else();
+			{
+				jitter.PushCst(2);
+				jitter.PullRel(offsetof(CONTEXT, result1));
+			}
+			jitter.EndIf();
+		}
+		auto statements = jitter.EndCapture();
+		jobs.push_back(compileService.Submit(i, statements));
+	}
+
+	for(const auto& job : jobs)
+	{
+		if(IsCancelledFunction(job->GetTag()))
+		{
+			job->Cancel();
+		}
+	}
+
+	compileService.WaitForIdle();
+	compileService.CollectResults(
+	    [this](Jitter::CCompileService::RESULT& result) {
+		    TEST_VERIFY(m_functions.find(result.tag) == std::end(m_functions));
+		    m_functions[result.tag] = std::move(result.function);
+	    });
+}
+
+void CCompileServiceTest::Run()
+{
+	for(uint32 i = 0; i < FUNCTION_COUNT; i++)
+	{
+		auto functionIterator = m_functions.find(i);
+		if(IsCancelledFunction(i))
+		{
+			TEST_VERIFY(functionIterator == std::end(m_functions));
+			continue;
+		}
+		TEST_VERIFY(functionIterator != std::end(m_functions));
+
+		CONTEXT context;
+		memset(&context, 0, sizeof(CONTEXT));
+		context.value = TEST_VALUE;
+
+		functionIterator->second(&context);
+		TEST_VERIFY(context.result0 == (TEST_VALUE + i));
+		TEST_VERIFY(context.result1 == ((TEST_VALUE > i) ? 1 : 2));
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <map>
+#include "Test.h"
+
+class CCompileServiceTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 value;
+
+		uint32 result0;
+		uint32 result1;
+	};
+
+	std::map<uint64, FunctionType> m_functions;
+};
@@ -0,0 +1,101 @@
+#include "CompileStatsTest.h"
+#include "MemStream.h"
+
+#define VALUE_0 0x12345678
+#define VALUE_1 0x0000FFFF
+
+static void TestHistogram()
+{
+	Jitter::CCompileStats::CHistogram histogram;
+	TEST_VERIFY(histogram.GetCount() == 0);
+	TEST_VERIFY(histogram.GetMin() == 0);
+
+	histogram.Add(0);
+	histogram.Add(1);
+	histogram.Add(5);
+	histogram.Add(7);
+	histogram.Add(8);
+
+	TEST_VERIFY(histogram.GetCount() == 5);
+	TEST_VERIFY(histogram.GetSum() == 21);
+	TEST_VERIFY(histogram.GetMin() == 0);
+	TEST_VERIFY(histogram.GetMax() == 8);
+	TEST_VERIFY(histogram.GetBucket(0) == 1);
+	TEST_VERIFY(histogram.GetBucket(1) == 1);
+	TEST_VERIFY(histogram.GetBucket(3) == 2);
+	TEST_VERIFY(histogram.GetBucket(4) == 1);
+	TEST_VERIFY(Jitter::CCompileStats::CHistogram::GetBucketIndex(UINT64_MAX) == 64);
+}
+
+void CCompileStatsTest::Compile(Jitter::CJitter& jitter)
+{
+	TestHistogram();
+
+	Jitter::CCompileStats compileStats;
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+	jitter.SetCompileStats(&compileStats);
+
+	jitter.Begin();
+	{
+		//Gets folded
+		jitter.PushCst(2);
+		jitter.PushCst(3);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, result0));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Xor();
+		jitter.PullRel(offsetof(CONTEXT, result1));
+	}
+	jitter.End();
+
+	jitter.SetCompileStats(nullptr);
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+
+	typedef Jitter::CCompileStats CCompileStats;
+	TEST_VERIFY(compileStats.GetCompileCount() == 1);
+
+	const auto& constantFolding = compileStats.GetPassStats(CCompileStats::PASS_CONSTANT_FOLDING);
+	TEST_VERIFY(constantFolding.runCount != 0);
+	TEST_VERIFY(constantFolding.changeCount != 0);
+	TEST_VERIFY(constantFolding.time.GetCount() == constantFolding.runCount);
+
+	const auto& generateCode = compileStats.GetPassStats(CCompileStats::PASS_GENERATE_CODE);
+	TEST_VERIFY(generateCode.runCount == 1);
+
+	for(unsigned int i = 0; i < CCompileStats::VALUE_COUNT; i++)
+	{
+		TEST_VERIFY(compileStats.GetHistogram(static_cast<CCompileStats::VALUE>(i)).GetCount() == 1);
+	}
+
+	TEST_VERIFY(compileStats.GetHistogram(CCompileStats::VALUE_CODE_SIZE).GetSum() == codeStream.GetSize());
+	TEST_VERIFY(compileStats.GetHistogram(CCompileStats::VALUE_INPUT_STATEMENTS).GetSum() != 0);
+	TEST_VERIFY(compileStats.GetHistogram(CCompileStats::VALUE_OPTIMIZATION_ITERATIONS).GetSum() >= 2);
+	TEST_VERIFY(compileStats.GetHistogram(CCompileStats::VALUE_REGISTER_SPILLS).GetSum() != 0);
+
+	//Merging doubles everything
+	CCompileStats mergedStats;
+	mergedStats.Merge(compileStats);
+	mergedStats.Merge(compileStats);
+	TEST_VERIFY(mergedStats.GetCompileCount() == 2);
+	TEST_VERIFY(mergedStats.GetPassStats(CCompileStats::PASS_CONSTANT_FOLDING).runCount == (constantFolding.runCount * 2));
+	TEST_VERIFY(mergedStats.GetHistogram(CCompileStats::VALUE_CODE_SIZE).GetSum() == (codeStream.GetSize() * 2));
+
+	mergedStats.Reset();
+	TEST_VERIFY(mergedStats.GetCompileCount() == 0);
+}
+
+void CCompileStatsTest::Run()
+{
+	CONTEXT context;
+	memset(&context, 0, sizeof(CONTEXT));
+	context.value0 = VALUE_0;
+	context.value1 = VALUE_1;
+
+	m_function(&context);
+	TEST_VERIFY(context.result0 == 5);
+	TEST_VERIFY(context.result1 == (VALUE_0 ^ VALUE_1));
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Test.h"
+
+class CCompileStatsTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 value0;
+		uint32 value1;
+
+		uint32 result0;
+		uint32 result1;
+	};
+
+	FunctionType m_function;
+};
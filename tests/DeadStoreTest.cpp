@@ -0,0 +1,140 @@
+#include "DeadStoreTest.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+//Flags declared dead on exit are left untouched when nothing reads them before the function exits.
+//Context starts with the value read by the callee, followed by the call result
+extern "C" void CDeadStoreTest_ReadValue(uint32* context)
+{
+	context[1] = context[0];
+}
+
+static const uint32 g_input = 0x1234;
+static const uint32 g_untouched = 0xCCCCCCCC;
+
+void CDeadStoreTest::PrepareExternalFunctions()
+{
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CDeadStoreTest_ReadValue), "_CDeadStoreTest_ReadValue", "vi");
+}
+
+void CDeadStoreTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.SetDeadOnExitRelatives(
+	    {
+	        offsetof(CONTEXT, callValue),
+	        offsetof(CONTEXT, unreadFlag),
+	        offsetof(CONTEXT, readFlag),
+	        offsetof(CONTEXT, successorReadFlag),
+	        offsetof(CONTEXT, overwrittenFlag),
+	        offsetof(CONTEXT, loopFlag),
+	    });
+
+	jitter.Begin();
+	{
+		//Read by the callee
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(0x55);
+		jitter.Xor();
+		jitter.PullRel(offsetof(CONTEXT, callValue));
+
+		jitter.PushCtx();
+		jitter.Call(reinterpret_cast<void*>(&CDeadStoreTest_ReadValue), 1, Jitter::CJitter::RETURN_VALUE_NONE);
+
+		//Never read
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(1);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, unreadFlag));
+
+		//Only read in the same block
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PullRel(offsetof(CONTEXT, readFlag));
+
+		jitter.PushRel(offsetof(CONTEXT, readFlag));
+		jitter.Shl(1);
+		jitter.PullRel(offsetof(CONTEXT, readResult));
+
+		//Read by a successor block
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(2);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, successorReadFlag));
+
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.PushRel(offsetof(CONTEXT, successorReadFlag));
+			jitter.PullRel(offsetof(CONTEXT, successorReadResult));
+
+			//Overwritten by the successor block
+			jitter.PushCst(1);
+			jitter.PullRel(offsetof(CONTEXT, overwrittenFlag));
+		}
+		jitter.EndIf();
+
+		jitter.PushCst(2);
+		jitter.PullRel(offsetof(CONTEXT, overwrittenFlag));
+
+		//Not declared, always stored
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PullRel(offsetof(CONTEXT, liveResult));
+
+		//Read by the next iteration of a loop
+		auto loopLabel = jitter.CreateLabel();
+		jitter.MarkLabel(loopLabel);
+
+		jitter.PushRel(offsetof(CONTEXT, loopResult));
+		jitter.PushRel(offsetof(CONTEXT, loopFlag));
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, loopResult));
+
+		jitter.PushRel(offsetof(CONTEXT, loopCounter));
+		jitter.PullRel(offsetof(CONTEXT, loopFlag));
+
+		jitter.PushRel(offsetof(CONTEXT, loopCounter));
+		jitter.PushCst(1);
+		jitter.Sub();
+		jitter.PullRel(offsetof(CONTEXT, loopCounter));
+
+		jitter.PushRel(offsetof(CONTEXT, loopCounter));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.Goto(loopLabel);
+		}
+		jitter.EndIf();
+	}
+	jitter.End();
+
+	jitter.SetDeadOnExitRelatives(Jitter::CJitter::RelativeOffsetArray());
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CDeadStoreTest::Run()
+{
+	memset(&m_context, 0, sizeof(m_context));
+	m_context.input = g_input;
+	m_context.unreadFlag = g_untouched;
+	m_context.readFlag = g_untouched;
+	m_context.overwrittenFlag = g_untouched;
+	m_context.loopCounter = 3;
+
+	m_function(&m_context);
+
+	TEST_VERIFY(m_context.unreadFlag == g_untouched);
+	TEST_VERIFY(m_context.readFlag == g_untouched);
+	TEST_VERIFY(m_context.readResult == (g_input << 1));
+	TEST_VERIFY(m_context.callValue == (g_input ^ 0x55));
+	TEST_VERIFY(m_context.callResult == (g_input ^ 0x55));
+	TEST_VERIFY(m_context.successorReadFlag == (g_input + 2));
+	TEST_VERIFY(m_context.successorReadResult == (g_input + 2));
+	TEST_VERIFY(m_context.overwrittenFlag == g_untouched);
+	TEST_VERIFY(m_context.liveResult == g_input);
+	TEST_VERIFY(m_context.loopResult == (3 + 2));
+}
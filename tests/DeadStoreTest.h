@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Test.h"
+
+class CDeadStoreTest : public CTest
+{
+public:
+	static void PrepareExternalFunctions();
+
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 callValue;
+		uint32 callResult;
+
+		uint32 input;
+		uint32 unreadFlag;
+		uint32 readFlag;
+		uint32 successorReadFlag;
+		uint32 overwrittenFlag;
+		uint32 loopFlag;
+
+		uint32 readResult;
+		uint32 successorReadResult;
+		uint32 liveResult;
+		uint32 loopCounter;
+		uint32 loopResult;
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
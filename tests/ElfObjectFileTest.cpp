@@ -0,0 +1,188 @@
+#include "ElfObjectFileTest.h"
+
+#if defined(__linux__) && !defined(__ANDROID__) && (defined(__x86_64__) || defined(__aarch64__))
+#define ELF_OBJECT_FILE_TEST_ENABLED
+#endif
+
+#ifdef ELF_OBJECT_FILE_TEST_ENABLED
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sys/wait.h>
+#include "MemStream.h"
+#include "ElfObjectFile.h"
+#include "Jitter_CodeGen_AArch64.h"
+#include "Jitter_CodeGen_x86_64.h"
+
+#define VALUE_0 0x12345678
+#define VALUE_1 0x0000FFFF
+
+#define FUNCTION_NAME "ElfObjectFileTest_Function"
+#define TABLE_NAME "ElfObjectFileTest_Table"
+#define HELPER_NAME "ElfObjectFileTest_Helper"
+
+//Only used to identify the helper in symbol references, the linked program provides its own
+static uint32 ElfObjectFileTest_Helper(uint32 v1, uint32 v2)
+{
+	return (v1 * 3) + v2;
+}
+
+//Calls the compiled function through the function table stored in the data section
+static const char* g_driverSource =
+    "#include <stdint.h>\n"
+    "struct CONTEXT { uint32_t value0, value1, result0, result1; };\n"
+    "typedef void (*FunctionType)(struct CONTEXT*);\n"
+    "extern FunctionType " TABLE_NAME "[];\n"
+    "uint32_t " HELPER_NAME "(uint32_t v1, uint32_t v2) { return (v1 * 3) + v2; }\n"
+    "int main(void)\n"
+    "{\n"
+    "	struct CONTEXT context = { 0x12345678, 0x0000FFFF, 0, 0 };\n"
+    "	" TABLE_NAME "[0](&context);\n"
+    "	if(context.result0 != " HELPER_NAME "(context.value0, context.value1)) return 1;\n"
+    "	if(context.result1 != (context.value0 ^ context.value1)) return 2;\n"
+    "	return 0;\n"
+    "}\n";
+
+static int RunCommand(const std::string& command)
+{
+	int status = system(command.c_str());
+	if((status == -1) || !WIFEXITED(status)) return -1;
+	return WEXITSTATUS(status);
+}
+
+void CElfObjectFileTest::Compile(Jitter::CJitter& jitter)
+{
+	if(RunCommand("cc --version > /dev/null 2>&1") != 0)
+	{
+		printf("Warning: No C compiler available, skipping ELF object file test.\n");
+		return;
+	}
+
+#ifdef __aarch64__
+	auto objectFile = Jitter::CElfObjectFile(Jitter::CObjectFile::CPU_ARCH_ARM64);
+#else
+	auto objectFile = Jitter::CElfObjectFile(Jitter::CObjectFile::CPU_ARCH_X64);
+#endif
+
+	auto codeGen = jitter.GetCodeGen();
+	codeGen->RegisterExternalSymbols(&objectFile);
+	objectFile.AddExternalSymbol(HELPER_NAME, reinterpret_cast<uintptr_t>(&ElfObjectFileTest_Helper));
+
+	Jitter::CObjectFile::INTERNAL_SYMBOL functionSymbol;
+	functionSymbol.name = FUNCTION_NAME;
+	functionSymbol.location = Jitter::CObjectFile::INTERNAL_SYMBOL_LOCATION_TEXT;
+
+	//Calls are PC relative, the linked executable doesn't need text relocations
+	auto setGenerateRelocatableCalls =
+	    [codeGen](bool generateRelocatableCalls) {
+		    if(auto aarch64CodeGen = dynamic_cast<Jitter::CCodeGen_AArch64*>(codeGen))
+		    {
+			    aarch64CodeGen->SetGenerateRelocatableCalls(generateRelocatableCalls);
+		    }
+		    if(auto x86_64CodeGen = dynamic_cast<Jitter::CCodeGen_x86_64*>(codeGen))
+		    {
+			    x86_64CodeGen->SetGenerateRelocatableCalls(generateRelocatableCalls);
+		    }
+	    };
+
+	{
+		setGenerateRelocatableCalls(true);
+
+		codeGen->SetExternalSymbolReferencedHandler(
+		    [&](uintptr_t symbol, uint32 offset, Jitter::CCodeGen::SYMBOL_REF_TYPE refType) {
+			    Jitter::CObjectFile::SYMBOL_REFERENCE ref;
+			    ref.offset = offset;
+			    ref.type = Jitter::CObjectFile::SYMBOL_TYPE_EXTERNAL;
+			    ref.refType = refType;
+			    ref.symbolIndex = objectFile.GetExternalSymbolIndexByValue(symbol);
+			    functionSymbol.symbolReferences.push_back(ref);
+		    });
+
+		Framework::CMemStream codeStream;
+		jitter.SetStream(&codeStream);
+
+		jitter.Begin();
+		{
+			jitter.PushRel(offsetof(CONTEXT, value0));
+			jitter.PushRel(offsetof(CONTEXT, value1));
+			jitter.Call(reinterpret_cast<void*>(&ElfObjectFileTest_Helper), 2, Jitter::CJitter::RETURN_VALUE_32);
+			jitter.PullRel(offsetof(CONTEXT, result0));
+
+			jitter.PushRel(offsetof(CONTEXT, value0));
+			jitter.PushRel(offsetof(CONTEXT, value1));
+			jitter.Xor();
+			jitter.PullRel(offsetof(CONTEXT, result1));
+		}
+		jitter.End();
+
+		codeGen->SetExternalSymbolReferencedHandler(Jitter::CCodeGen::ExternalSymbolReferencedHandler());
+		setGenerateRelocatableCalls(false);
+
+		functionSymbol.data = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+	}
+
+	TEST_VERIFY(!functionSymbol.symbolReferences.empty());
+	auto functionSymbolIndex = objectFile.AddInternalSymbol(functionSymbol);
+
+	{
+		Jitter::CObjectFile::INTERNAL_SYMBOL tableSymbol;
+		tableSymbol.name = TABLE_NAME;
+		tableSymbol.location = Jitter::CObjectFile::INTERNAL_SYMBOL_LOCATION_DATA;
+		tableSymbol.data = std::vector<uint8>(8);
+
+		Jitter::CObjectFile::SYMBOL_REFERENCE ref;
+		ref.offset = 0;
+		ref.type = Jitter::CObjectFile::SYMBOL_TYPE_INTERNAL;
+		ref.symbolIndex = functionSymbolIndex;
+		tableSymbol.symbolReferences.push_back(ref);
+
+		objectFile.AddInternalSymbol(tableSymbol);
+	}
+
+	auto basePath = std::filesystem::temp_directory_path();
+	auto objectPath = basePath / "ElfObjectFileTest.o";
+	auto driverPath = basePath / "ElfObjectFileTest_Driver.c";
+	auto executablePath = basePath / "ElfObjectFileTest";
+
+	{
+		Framework::CMemStream objectStream;
+		objectFile.Write(objectStream);
+
+		std::ofstream objectOutput(objectPath, std::ios::binary);
+		objectOutput.write(reinterpret_cast<const char*>(objectStream.GetBuffer()), objectStream.GetSize());
+
+		std::ofstream driverOutput(driverPath);
+		driverOutput << g_driverSource;
+	}
+
+	//Link as a position independent executable and fail if text relocations are needed
+	auto buildCommand = "cc -fPIE -pie -Wl,-z,text " + driverPath.string() + " " + objectPath.string() + " -o " + executablePath.string();
+	TEST_VERIFY(RunCommand(buildCommand) == 0);
+
+	m_exitCode = RunCommand(executablePath.string());
+	m_executed = true;
+
+	std::error_code errorCode;
+	std::filesystem::remove(objectPath, errorCode);
+	std::filesystem::remove(driverPath, errorCode);
+	std::filesystem::remove(executablePath, errorCode);
+}
+
+void CElfObjectFileTest::Run()
+{
+	if(!m_executed) return;
+	TEST_VERIFY(m_exitCode == 0);
+}
+
+#else
+
+void CElfObjectFileTest::Compile(Jitter::CJitter&)
+{
+}
+
+void CElfObjectFileTest::Run()
+{
+}
+
+#endif
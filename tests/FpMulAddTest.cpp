@@ -0,0 +1,98 @@
+#include "FpMulAddTest.h"
+#include "MemStream.h"
+#include <cmath>
+
+void CFpMulAddTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		jitter.FP_PushRel32(offsetof(CONTEXT, addend));
+		jitter.FP_PushRel32(offsetof(CONTEXT, factor));
+		jitter.FP_PushRel32(offsetof(CONTEXT, factor));
+		jitter.FP_MulAddS();
+		jitter.FP_PullRel32(offsetof(CONTEXT, resMulAdd));
+
+		jitter.FP_PushRel32(offsetof(CONTEXT, addend));
+		jitter.FP_PushRel32(offsetof(CONTEXT, factor));
+		jitter.FP_PushRel32(offsetof(CONTEXT, factor));
+		jitter.FP_FusedMulAddS();
+		jitter.FP_PullRel32(offsetof(CONTEXT, resFusedMulAdd));
+
+		//Accumulate in place, destination aliases sources
+		for(unsigned int i = 0; i < 3; i++)
+		{
+			jitter.FP_PushRel32(offsetof(CONTEXT, accum));
+			jitter.FP_PushRel32(offsetof(CONTEXT, accum));
+			jitter.FP_PushCst32(2.0f);
+			jitter.FP_FusedMulAddS();
+			jitter.FP_PullRel32(offsetof(CONTEXT, accum));
+		}
+
+		jitter.MD_PushRel(offsetof(CONTEXT, mdAddend));
+		jitter.MD_PushRel(offsetof(CONTEXT, mdFactor));
+		jitter.MD_PushRel(offsetof(CONTEXT, mdFactor));
+		jitter.MD_MulAddS();
+		jitter.MD_PullRel(offsetof(CONTEXT, mdResMulAdd));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, mdAddend));
+		jitter.MD_PushRel(offsetof(CONTEXT, mdFactor));
+		jitter.MD_PushRel(offsetof(CONTEXT, mdFactor));
+		jitter.MD_FusedMulAddS();
+		jitter.MD_PullRel(offsetof(CONTEXT, mdResFusedMulAdd));
+
+		for(unsigned int i = 0; i < 3; i++)
+		{
+			jitter.MD_PushRel(offsetof(CONTEXT, mdAccum));
+			jitter.MD_PushRel(offsetof(CONTEXT, mdAccum));
+			jitter.MD_PushRel(offsetof(CONTEXT, mdAccum));
+			jitter.MD_MulAddS();
+			jitter.MD_PullRel(offsetof(CONTEXT, mdAccum));
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CFpMulAddTest::Run()
+{
+	CONTEXT ALIGN16 context;
+	memset(&context, 0, sizeof(CONTEXT));
+
+	//(1 + 2^-12)^2 - 1 loses its last bit (2^-24) if the product is rounded before the addition
+	const float factor = 1.0f + std::ldexp(1.0f, -12);
+	const float separateResult = std::ldexp(1.0f, -11);
+	const float fusedResult = std::ldexp(1.0f, -11) + std::ldexp(1.0f, -24);
+
+	context.addend = -1.0f;
+	context.factor = factor;
+	context.accum = 1.0f;
+
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		context.mdAddend[i] = -1.0f;
+		context.mdFactor[i] = factor;
+		context.mdAccum[i] = static_cast<float>(i) * 0.5f;
+	}
+
+	m_function(&context);
+
+	TEST_VERIFY(context.resMulAdd == separateResult);
+	TEST_VERIFY((context.resFusedMulAdd == fusedResult) || (context.resFusedMulAdd == separateResult));
+	TEST_VERIFY(context.accum == 27.0f);
+
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		TEST_VERIFY(context.mdResMulAdd[i] == separateResult);
+		TEST_VERIFY((context.mdResFusedMulAdd[i] == fusedResult) || (context.mdResFusedMulAdd[i] == separateResult));
+	}
+
+	//x + x * x, applied 3 times
+	TEST_VERIFY(context.mdAccum[0] == 0.0f);
+	TEST_VERIFY(context.mdAccum[1] == 3.03515625f);
+	TEST_VERIFY(context.mdAccum[2] == 42.0f);
+	TEST_VERIFY(context.mdAccum[3] == 335.09765625f);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Test.h"
+#include "Align16.h"
+
+class CFpMulAddTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		ALIGN16
+
+		float mdAddend[4];
+		float mdFactor[4];
+		float mdAccum[4];
+
+		float mdResMulAdd[4];
+		float mdResFusedMulAdd[4];
+
+		float addend;
+		float factor;
+		float accum;
+
+		float resMulAdd;
+		float resFusedMulAdd;
+	};
+
+	FunctionType m_function;
+};
@@ -0,0 +1,126 @@
+#include "KnownBitsTest.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+
+//Masks, extensions and comparisons that are made redundant by what is known about the bits of their operand.
+//Similar operations that are still needed are mixed in to make sure they aren't removed.
+
+static const uint32 g_input0 = 0x12345678;
+static const uint32 g_input1 = 0x9ABCDEF0;
+
+void CKnownBitsTest::Run()
+{
+	memset(&m_context, 0, sizeof(m_context));
+
+	m_context.bytes[0] = 0xF0;
+	m_context.halves[0] = 0x8421;
+	m_context.input0 = g_input0;
+	m_context.input1 = g_input1;
+
+	m_function(&m_context);
+
+	TEST_VERIFY(m_context.maskedByteResult == 0xF0);
+	TEST_VERIFY(m_context.signExtResult == 0xFFFFFFF0);
+	TEST_VERIFY(m_context.signExtByteResult == 0xFFFFFFF0);
+	TEST_VERIFY(m_context.signExtUnsignedResult == 0xF0);
+	TEST_VERIFY(m_context.zeroExtHalfResult == 0x8421);
+	TEST_VERIFY(m_context.shiftMaskResult == 0x12);
+	TEST_VERIFY(m_context.sraPositiveResult == ((g_input1 & 0x7FFFFFFF) >> 4));
+	TEST_VERIFY(m_context.signOfPositiveResult == 0);
+	TEST_VERIFY(m_context.cmpInRangeResult == 1);
+	TEST_VERIFY(m_context.cmpOutOfRangeResult == 0);
+	TEST_VERIFY(m_context.cmpSignedResult == 1);
+	TEST_VERIFY(m_context.ifOutOfRangeResult == 0);
+}
+
+void CKnownBitsTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Mask after byte load
+		jitter.PushRelAddrRef(offsetof(CONTEXT, bytes[0]));
+		jitter.Load8FromRef();
+		jitter.PushCst(0xFF);
+		jitter.And();
+		jitter.PullRel(offsetof(CONTEXT, maskedByteResult));
+
+		//Sign extending a value that is already sign extended
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.SignExt8();
+		jitter.SignExt16();
+		jitter.PullRel(offsetof(CONTEXT, signExtResult));
+
+		//Sign extending a loaded byte is still needed
+		jitter.PushRelAddrRef(offsetof(CONTEXT, bytes[0]));
+		jitter.Load8FromRef();
+		jitter.SignExt8();
+		jitter.PullRel(offsetof(CONTEXT, signExtByteResult));
+
+		//Upper half of a loaded byte is known to be clear
+		jitter.PushRelAddrRef(offsetof(CONTEXT, bytes[0]));
+		jitter.Load8FromRef();
+		jitter.SignExt16();
+		jitter.PullRel(offsetof(CONTEXT, signExtUnsignedResult));
+
+		//Zero extending a loaded half
+		jitter.PushRelAddrRef(offsetof(CONTEXT, halves[0]));
+		jitter.Load16FromRef();
+		jitter.Shl(16);
+		jitter.Srl(16);
+		jitter.PullRel(offsetof(CONTEXT, zeroExtHalfResult));
+
+		//Mask after shift
+		jitter.PushRel(offsetof(CONTEXT, input0));
+		jitter.Srl(24);
+		jitter.PushCst(0xFF);
+		jitter.And();
+		jitter.PullRel(offsetof(CONTEXT, shiftMaskResult));
+
+		//Arithmetic shift of a positive value
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.PushCst(0x7FFFFFFF);
+		jitter.And();
+		jitter.Sra(4);
+		jitter.PullRel(offsetof(CONTEXT, sraPositiveResult));
+
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.Srl(1);
+		jitter.SignExt();
+		jitter.PullRel(offsetof(CONTEXT, signOfPositiveResult));
+
+		//Comparisons
+		jitter.PushRelAddrRef(offsetof(CONTEXT, bytes[0]));
+		jitter.Load8FromRef();
+		jitter.PushCst(0x100);
+		jitter.Cmp(Jitter::CONDITION_BL);
+		jitter.PullRel(offsetof(CONTEXT, cmpInRangeResult));
+
+		jitter.PushRelAddrRef(offsetof(CONTEXT, halves[0]));
+		jitter.Load16FromRef();
+		jitter.PushCst(0x10000);
+		jitter.Cmp(Jitter::CONDITION_EQ);
+		jitter.PullRel(offsetof(CONTEXT, cmpOutOfRangeResult));
+
+		jitter.PushRel(offsetof(CONTEXT, input1));
+		jitter.Srl(28);
+		jitter.PushCst(16);
+		jitter.Cmp(Jitter::CONDITION_LT);
+		jitter.PullRel(offsetof(CONTEXT, cmpSignedResult));
+
+		jitter.PushRelAddrRef(offsetof(CONTEXT, bytes[0]));
+		jitter.Load8FromRef();
+		jitter.PushCst(0x100);
+		jitter.BeginIf(Jitter::CONDITION_AE);
+		{
+			jitter.PushCst(~0U);
+			jitter.PullRel(offsetof(CONTEXT, ifOutOfRangeResult));
+		}
+		jitter.EndIf();
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
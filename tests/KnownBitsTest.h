@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Test.h"
+
+class CKnownBitsTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	struct CONTEXT
+	{
+		uint8 bytes[8];
+		uint16 halves[4];
+
+		uint32 input0;
+		uint32 input1;
+
+		uint32 maskedByteResult;
+		uint32 signExtResult;
+		uint32 signExtByteResult;
+		uint32 signExtUnsignedResult;
+		uint32 zeroExtHalfResult;
+		uint32 shiftMaskResult;
+		uint32 sraPositiveResult;
+		uint32 signOfPositiveResult;
+		uint32 cmpInRangeResult;
+		uint32 cmpOutOfRangeResult;
+		uint32 cmpSignedResult;
+		uint32 ifOutOfRangeResult;
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
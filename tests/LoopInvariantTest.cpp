@@ -0,0 +1,207 @@
+#include "LoopInvariantTest.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+
+//Values computed out of relatives not written by the loop are moved before it. Relatives
+//the loop works on stay in registers until it exits, on either of its exits. A relative
+//can be read by both hoisted values and the loop itself.
+
+static const uint32 g_value = 0x100;
+static const uint32 g_scale = 0x30;
+static const uint32 g_counter = 5;
+
+void CLoopInvariantTest::Compile(Jitter::CJitter& jitter)
+{
+	CompileExitFunction(jitter);
+	CompileSharedFunction(jitter);
+}
+
+void CLoopInvariantTest::CompileExitFunction(Jitter::CJitter& jitter)
+{
+	Jitter::CCompileStats compileStats;
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+	jitter.SetCompileStats(&compileStats);
+
+	jitter.Begin();
+	{
+		auto loopLabel = jitter.CreateLabel();
+		auto doneLabel = jitter.CreateLabel();
+
+		jitter.PushCst(0);
+		jitter.PullRel(offsetof(CONTEXT, sum));
+
+		jitter.MarkLabel(loopLabel);
+
+		//Invariant load through a reference
+		jitter.PushRel(offsetof(CONTEXT, sum));
+		jitter.PushRelAddrRef(offsetof(CONTEXT, values));
+		jitter.PushRel(offsetof(CONTEXT, index));
+		jitter.Shl(2);
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.Add();
+
+		//Invariant arithmetic
+		jitter.PushRel(offsetof(CONTEXT, scale));
+		jitter.PushCst(3);
+		jitter.Xor();
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, sum));
+
+		jitter.PushRel(offsetof(CONTEXT, sum));
+		jitter.PushRel(offsetof(CONTEXT, limit));
+		jitter.BeginIf(Jitter::CONDITION_AB);
+		{
+			jitter.PushCst(1);
+			jitter.PullRel(offsetof(CONTEXT, earlyExit));
+			jitter.Goto(doneLabel);
+		}
+		jitter.EndIf();
+
+		jitter.PushRel(offsetof(CONTEXT, counter));
+		jitter.PushCst(1);
+		jitter.Sub();
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		jitter.PushRel(offsetof(CONTEXT, counter));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.Goto(loopLabel);
+		}
+		jitter.EndIf();
+
+		jitter.MarkLabel(doneLabel);
+	}
+	jitter.End();
+
+	jitter.SetCompileStats(nullptr);
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+	m_loopOptimized = !jitter.GetCodeGen()->SupportsLoopRegisters() ||
+	                  (compileStats.GetPassStats(Jitter::CCompileStats::PASS_OPTIMIZE_LOOPS).changeCount != 0);
+}
+
+void CLoopInvariantTest::CompileSharedFunction(Jitter::CJitter& jitter)
+{
+	Jitter::CCompileStats compileStats;
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+	jitter.SetCompileStats(&compileStats);
+
+	jitter.Begin();
+	{
+		auto loopLabel = jitter.CreateLabel();
+
+		jitter.MarkLabel(loopLabel);
+
+		//Both (scale ^ 5) << 2, computed before the loop, and scale get a loop register
+		jitter.PushRel(offsetof(CONTEXT, sum));
+		jitter.PushRel(offsetof(CONTEXT, scale));
+		jitter.PushCst(5);
+		jitter.Xor();
+		jitter.Shl(2);
+		jitter.Add();
+		jitter.PushRel(offsetof(CONTEXT, scale));
+		jitter.Xor();
+		jitter.PushRel(offsetof(CONTEXT, scale));
+		jitter.PushCst(5);
+		jitter.Xor();
+		jitter.Shl(2);
+		jitter.Add();
+		jitter.PushRel(offsetof(CONTEXT, scale));
+		jitter.Sub();
+		jitter.PushRel(offsetof(CONTEXT, scale));
+		jitter.PushCst(5);
+		jitter.Xor();
+		jitter.Shl(2);
+		jitter.Xor();
+		jitter.PushRel(offsetof(CONTEXT, scale));
+		jitter.Add();
+		jitter.PushRel(offsetof(CONTEXT, scale));
+		jitter.PushCst(5);
+		jitter.Xor();
+		jitter.Shl(2);
+		jitter.Sub();
+		jitter.PushRel(offsetof(CONTEXT, scale));
+		jitter.Xor();
+		jitter.PullRel(offsetof(CONTEXT, sum));
+
+		jitter.PushRel(offsetof(CONTEXT, counter));
+		jitter.PushCst(1);
+		jitter.Sub();
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		jitter.PushRel(offsetof(CONTEXT, counter));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.Goto(loopLabel);
+		}
+		jitter.EndIf();
+	}
+	jitter.End();
+
+	jitter.SetCompileStats(nullptr);
+
+	m_sharedFunction = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+	m_loopOptimized = m_loopOptimized &&
+	                  (!jitter.GetCodeGen()->SupportsLoopRegisters() ||
+	                   (compileStats.GetPassStats(Jitter::CCompileStats::PASS_OPTIMIZE_LOOPS).changeCount != 0));
+}
+
+void CLoopInvariantTest::RunLoop(uint32 limit, uint32 expectedIterations)
+{
+	uint32 step = g_value + (g_scale ^ 3);
+
+	memset(&m_context, 0, sizeof(m_context));
+	m_context.values[2] = g_value;
+	m_context.index = 2;
+	m_context.scale = g_scale;
+	m_context.limit = limit;
+	m_context.counter = g_counter;
+
+	m_function(&m_context);
+
+	bool earlyExit = (expectedIterations * step) > limit;
+	TEST_VERIFY(m_context.sum == (expectedIterations * step));
+	TEST_VERIFY(m_context.counter == (g_counter - (earlyExit ? (expectedIterations - 1) : expectedIterations)));
+	TEST_VERIFY(m_context.earlyExit == (earlyExit ? 1 : 0));
+	TEST_VERIFY(m_context.values[2] == g_value);
+	TEST_VERIFY(m_context.index == 2);
+}
+
+void CLoopInvariantTest::RunShared()
+{
+	uint32 sum = 0;
+	uint32 shifted = (g_scale ^ 5) << 2;
+	for(uint32 i = 0; i < g_counter; i++)
+	{
+		sum = (((((((sum + shifted) ^ g_scale) + shifted) - g_scale) ^ shifted) + g_scale) - shifted) ^ g_scale;
+	}
+
+	memset(&m_context, 0, sizeof(m_context));
+	m_context.scale = g_scale;
+	m_context.counter = g_counter;
+
+	m_sharedFunction(&m_context);
+
+	TEST_VERIFY(m_context.sum == sum);
+	TEST_VERIFY(m_context.counter == 0);
+	TEST_VERIFY(m_context.scale == g_scale);
+}
+
+void CLoopInvariantTest::Run()
+{
+	TEST_VERIFY(m_loopOptimized);
+
+	//Leaves once the counter reaches zero
+	RunLoop(~0U, g_counter);
+
+	//Leaves on the third iteration
+	uint32 step = g_value + (g_scale ^ 3);
+	RunLoop((step * 2) + 1, 3);
+
+	RunShared();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Test.h"
+
+class CLoopInvariantTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 values[4];
+		uint32 index;
+		uint32 scale;
+		uint32 limit;
+		uint32 counter;
+		uint32 sum;
+		uint32 earlyExit;
+	};
+
+	void CompileExitFunction(Jitter::CJitter&);
+	void CompileSharedFunction(Jitter::CJitter&);
+
+	void RunLoop(uint32, uint32);
+	void RunShared();
+
+	CONTEXT m_context;
+	FunctionType m_function;
+	FunctionType m_sharedFunction;
+	bool m_loopOptimized = false;
+};
@@ -4,6 +4,7 @@
 #include "CursorTest.h"
 #include "MultTest.h"
 #include "DivTest.h"
+#include "MulDivConstTest.h"
 #include "RandomAluTest.h"
 #include "RandomAluTest2.h"
 #include "RandomAluTest3.h"
@@ -14,6 +15,7 @@
 #include "AliasTest.h"
 #include "AliasTest2.h"
 #include "FpSingleTest.h"
+#include "FpMulAddTest.h"
 #include "FpIntMixTest.h"
 #include "FpRoundModeTest.h"
 #include "FpClampTest.h"
@@ -27,25 +29,33 @@
 #include "MdUnpackTest.h"
 #include "MdFpTest.h"
 #include "MdFpFlagTest.h"
+#include "MdFpLaneTest.h"
+#include "AdjacentStoreTest.h"
 #include "MdCallTest.h"
 #include "MdMemAccessTest.h"
 #include "MdManipTest.h"
 #include "MdShiftTest.h"
+#include "MdConstantFoldTest.h"
+#include "MdShuffleTest.h"
 #include "CompareTest.h"
 #include "CompareTest2.h"
 #include "RegAllocTest.h"
 #include "RegAllocTempTest.h"
+#include "RegAllocIntervalTest.h"
+#include "RegAllocPressureTest.h"
 #include "ReorderAddTest.h"
 #include "MemAccessTest.h"
 #include "MemAccessIdxTest.h"
 #include "MemAccess8Test.h"
 #include "MemAccess16Test.h"
 #include "MemAccessRefTest.h"
+#include "MemAccessRelAddrTest.h"
 #include "GotoTest.h"
 #include "HugeJumpTest.h"
 #include "HugeJumpTestLiteral.h"
 #include "Alu64Test.h"
 #include "ConditionTest.h"
+#include "CmpBranchTest.h"
 #include "Cmp64Test.h"
 #include "Shift64Test.h"
 #include "Logic64Test.h"
@@ -55,6 +65,21 @@
 #include "LzcTest.h"
 #include "NestedIfTest.h"
 #include "ExternJumpTest.h"
+#include "X86AssemblerTest.h"
+#include "AArch32AssemblerTest.h"
+#include "AArch32CodeGenTest.h"
+#include "AArch64AssemblerTest.h"
+#include "WasmModuleTest.h"
+#include "BitfieldTest.h"
+#include "KnownBitsTest.h"
+#include "DeadStoreTest.h"
+#include "LoopInvariantTest.h"
+#include "CodeCacheTest.h"
+#include "ReplayTest.h"
+#include "ElfObjectFileTest.h"
+#include "AotCompilerTest.h"
+#include "CompileServiceTest.h"
+#include "CompileStatsTest.h"
 
 typedef std::function<CTest*()> TestFactoryFunction;
 
@@ -79,6 +104,8 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CCompareTest2(true,  true,  0, 0xFFFFFF80U); },
 	[] () { return new CRegAllocTest(); },
 	[] () { return new CRegAllocTempTest(); },
+	[] () { return new CRegAllocIntervalTest(); },
+	[] () { return new CRegAllocPressureTest(); },
 	[] () { return new CRandomAluTest(true); },
 	[] () { return new CRandomAluTest(false); },
 	[] () { return new CRandomAluTest2(true); },
@@ -108,6 +135,8 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CMultTest(false); },
 	[] () { return new CDivTest(true); },
 	[] () { return new CDivTest(false); },
+	[] () { return new CMulDivConstTest(true); },
+	[] () { return new CMulDivConstTest(false); },
 	[] () { return new CMemAccessTest(); },
 	[] () { return new CMemAccessIdxTest(true); },
 	[] () { return new CMemAccessIdxTest(false); },
@@ -116,6 +145,7 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CMemAccess16Test(true); },
 	[] () { return new CMemAccess16Test(false); },
 	[] () { return new CMemAccessRefTest(); },
+	[] () { return new CMemAccessRelAddrTest(); },
 	[] () { return new CGotoTest(); },
 	[] () { return new CHugeJumpTest(); },
 	[] () { return new CHugeJumpTestLiteral(); },
@@ -126,6 +156,7 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CAliasTest2(); },
 	[] () { return new CFpRoundModeTest(); },
 	[] () { return new CFpSingleTest(); },
+	[] () { return new CFpMulAddTest(); },
 	[] () { return new CFpIntMixTest(); },
 	[] () { return new CSimpleMdTest(); },
 	[] () { return new CMdTest(); },
@@ -137,15 +168,19 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CMdMinMaxTest(); },
 	[] () { return new CMdFpTest(); },
 	[] () { return new CMdFpFlagTest(); },
+	[] () { return new CMdFpLaneTest(); },
+	[] () { return new CAdjacentStoreTest(); },
 	[] () { return new CMdCallTest(); },
 	[] () { return new CMdMemAccessTest(); },
 	[] () { return new CMdManipTest(); },
+	[] () { return new CMdShuffleTest(); },
 	[] () { return new CMdShiftTest(0); },
 	[] () { return new CMdShiftTest(15); },
 	[] () { return new CMdShiftTest(16); },
 	[] () { return new CMdShiftTest(31); },
 	[] () { return new CMdShiftTest(32); },
 	[] () { return new CMdShiftTest(38); },
+	[] () { return new CMdConstantFoldTest(); },
 	[] () { return new CFpClampTest(); },
 	[] () { return new CAlu64Test(); },
 	//negative / positive
@@ -175,6 +210,12 @@ static const TestFactoryFunction s_factories[] =
 	[]() { return new CConditionTest(true,  0x000000FF, 0x0000000F); },
 	[]() { return new CConditionTest(true,  0x0000000F, 0x000000FF); },
 	[]() { return new CConditionTest(true,  0x000000FF, 0x000000FF); },
+	[]() { return new CCmpBranchTest(false, 0xFFFFFFFE, 0x00000002); },
+	[]() { return new CCmpBranchTest(false, 0x00000002, 0xFFFFFFFE); },
+	[]() { return new CCmpBranchTest(false, 0x00000002, 0x00000002); },
+	[]() { return new CCmpBranchTest(true,  0xFFFFFFFE, 0x00000002); },
+	[]() { return new CCmpBranchTest(true,  0x00000002, 0xFFFFFFFE); },
+	[]() { return new CCmpBranchTest(true,  0x00000002, 0x00000002); },
 	[] () { return new CCmp64Test(false, false, 0xFEDCBA9876543210ULL, 0x012389AB4567CDEFULL); },
 	[] () { return new CCmp64Test(false, true,  0xFEDCBA9876543210ULL, 0x012389AB4567CDEFULL); },
 	[] () { return new CCmp64Test(true,  true,  0xFEDCBA9876543210ULL, 0x012389AB4567CDEFULL); },
@@ -200,7 +241,22 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CMemAccess64Test(false); },
 	[] () { return new CMemAccess64Test(true); },
 	[] () { return new CCall64Test(); },
-	[] () { return new CExternJumpTest(); }
+	[] () { return new CExternJumpTest(); },
+	[] () { return new CX86AssemblerTest(); },
+	[] () { return new CAArch32AssemblerTest(); },
+	[] () { return new CAArch32CodeGenTest(); },
+	[] () { return new CAArch64AssemblerTest(); },
+	[] () { return new CWasmModuleTest(); },
+	[] () { return new CBitfieldTest(); },
+	[] () { return new CKnownBitsTest(); },
+	[] () { return new CDeadStoreTest(); },
+	[] () { return new CLoopInvariantTest(); },
+	[] () { return new CCodeCacheTest(); },
+	[] () { return new CReplayTest(); },
+	[] () { return new CElfObjectFileTest(); },
+	[] () { return new CAotCompilerTest(); },
+	[] () { return new CCompileServiceTest(); },
+	[] () { return new CCompileStatsTest(); }
 };
 // clang-format on
 
@@ -209,6 +265,12 @@ void PrepareExternalFunctions()
 	CCrc32Test::PrepareExternalFunctions();
 	CCall64Test::PrepareExternalFunctions();
 	CRegAllocTempTest::PrepareExternalFunctions();
+	CRegAllocIntervalTest::PrepareExternalFunctions();
+	CMdFpLaneTest::PrepareExternalFunctions();
+	CAdjacentStoreTest::PrepareExternalFunctions();
+	CCodeCacheTest::PrepareExternalFunctions();
+	CAotCompilerTest::PrepareExternalFunctions();
+	CDeadStoreTest::PrepareExternalFunctions();
 }
 
 int main(int argc, const char** argv)
@@ -0,0 +1,199 @@
+#include "MdConstantFoldTest.h"
+#include "MemStream.h"
+
+//Every operation is emitted twice: once on constant operands, which gets folded at compile time,
+//and once on the same values loaded from the context, which gets computed by the generated code.
+
+typedef void (*OperationType)(Jitter::CJitter&);
+
+static const uint32 g_constants[4] = {0x80017FFF, 0x00FF8001, 0x7FFF0080, 0xFFFE0102};
+static const uint32 g_value[4] = {0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210};
+
+//Each operation consumes the two operands on top of the stack
+static const OperationType g_operations[] =
+    {
+        [](Jitter::CJitter& jitter) { jitter.MD_AddB(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_AddBSS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_AddBUS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_AddH(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_AddHSS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_AddHUS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_AddW(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_AddWSS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_AddWUS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_SubB(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_SubBSS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_SubBUS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_SubH(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_SubHSS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_SubHUS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_SubW(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_SubWSS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_SubWUS(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_CmpEqB(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_CmpEqH(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_CmpEqW(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_CmpGtB(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_CmpGtH(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_CmpGtW(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_MinH(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_MinW(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_MaxH(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_MaxW(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_And(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_Or(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_Xor(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_PackHB(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_PackWH(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_UnpackLowerBH(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_UnpackLowerHW(); },
+        [](Jitter::CJitter& jitter) { jitter.MD_UnpackUpperWD(); },
+        [](Jitter::CJitter& jitter) { jitter.PullTop(); jitter.MD_Not(); },
+        [](Jitter::CJitter& jitter) { jitter.PullTop(); jitter.MD_SllH(3); },
+        [](Jitter::CJitter& jitter) { jitter.PullTop(); jitter.MD_SraH(5); },
+        [](Jitter::CJitter& jitter) { jitter.PullTop(); jitter.MD_SrlW(7); },
+        [](Jitter::CJitter& jitter) { jitter.PullTop(); jitter.MD_SraW(9); },
+        [](Jitter::CJitter& jitter) { jitter.PullTop(); jitter.MD_AbsS(); jitter.MD_NegS(); },
+        [](Jitter::CJitter& jitter) { jitter.PullTop(); jitter.MD_ShuffleW(0x1B); },
+        [](Jitter::CJitter& jitter) { jitter.PullTop(); jitter.MD_ShuffleB({15, 0, 3, 3, 8, 1, 12, 7, 6, 5, 4, 11, 2, 9, 14, 13}); },
+};
+static_assert((sizeof(g_operations) / sizeof(g_operations[0])) == 44, "Operation count mismatch");
+
+void CMdConstantFoldTest::Run()
+{
+	memset(&m_context, 0, sizeof(m_context));
+	memcpy(m_context.constants, g_constants, sizeof(g_constants));
+	memcpy(m_context.value, g_value, sizeof(g_value));
+
+	m_function(&m_context);
+
+	for(unsigned int i = 0; i < OPERATION_COUNT; i++)
+	{
+		for(unsigned int j = 0; j < 4; j++)
+		{
+			TEST_VERIFY(m_context.foldedResults[i][j] == m_context.computedResults[i][j]);
+		}
+	}
+
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		TEST_VERIFY(m_context.xorSelfResult[i] == 0);
+		TEST_VERIFY(m_context.subSelfResult[i] == 0);
+		TEST_VERIFY(m_context.cmpEqSelfResult[i] == ~0U);
+		TEST_VERIFY(m_context.cmpGtSelfResult[i] == 0);
+		TEST_VERIFY(m_context.minSelfResult[i] == g_value[i]);
+		TEST_VERIFY(m_context.andOnesResult[i] == g_value[i]);
+		TEST_VERIFY(m_context.andZeroResult[i] == 0);
+		TEST_VERIFY(m_context.orZeroResult[i] == g_value[i]);
+		TEST_VERIFY(m_context.orOnesResult[i] == ~0U);
+		TEST_VERIFY(m_context.addZeroResult[i] == g_value[i]);
+		TEST_VERIFY(m_context.subZeroResult[i] == g_value[i]);
+		TEST_VERIFY(m_context.shuffleIdentityResult[i] == g_value[i]);
+	}
+}
+
+void CMdConstantFoldTest::EmitOperands(Jitter::CJitter& jitter, bool folded)
+{
+	auto pushWord =
+	    [&](unsigned int index) {
+		    if(folded)
+		    {
+			    jitter.MD_PushCstExpandW(g_constants[index]);
+		    }
+		    else
+		    {
+			    jitter.MD_PushRelElementExpandW(offsetof(CONTEXT, constants), index);
+		    }
+	    };
+
+	//Mix the words to get operands with different lanes
+	pushWord(0);
+	pushWord(1);
+	jitter.MD_UnpackLowerBH();
+
+	pushWord(2);
+	pushWord(3);
+	jitter.MD_UnpackUpperHW();
+}
+
+void CMdConstantFoldTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		for(unsigned int i = 0; i < OPERATION_COUNT; i++)
+		{
+			EmitOperands(jitter, true);
+			g_operations[i](jitter);
+			jitter.MD_PullRel(offsetof(CONTEXT, foldedResults) + (i * sizeof(m_context.foldedResults[0])));
+
+			EmitOperands(jitter, false);
+			g_operations[i](jitter);
+			jitter.MD_PullRel(offsetof(CONTEXT, computedResults) + (i * sizeof(m_context.computedResults[0])));
+		}
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_Xor();
+		jitter.MD_PullRel(offsetof(CONTEXT, xorSelfResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_SubHSS();
+		jitter.MD_PullRel(offsetof(CONTEXT, subSelfResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_CmpEqB();
+		jitter.MD_PullRel(offsetof(CONTEXT, cmpEqSelfResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_CmpGtW();
+		jitter.MD_PullRel(offsetof(CONTEXT, cmpGtSelfResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_MinH();
+		jitter.MD_PullRel(offsetof(CONTEXT, minSelfResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushCstExpandW(~0U);
+		jitter.MD_And();
+		jitter.MD_PullRel(offsetof(CONTEXT, andOnesResult));
+
+		jitter.MD_PushCstExpandW(0);
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_And();
+		jitter.MD_PullRel(offsetof(CONTEXT, andZeroResult));
+
+		jitter.MD_PushCstExpandW(0);
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_Or();
+		jitter.MD_PullRel(offsetof(CONTEXT, orZeroResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushCstExpandW(~0U);
+		jitter.MD_Or();
+		jitter.MD_PullRel(offsetof(CONTEXT, orOnesResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushCstExpandW(0);
+		jitter.MD_AddW();
+		jitter.MD_PullRel(offsetof(CONTEXT, addZeroResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushCstExpandW(0);
+		jitter.MD_SubB();
+		jitter.MD_PullRel(offsetof(CONTEXT, subZeroResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_ShuffleW(0xE4);
+		jitter.MD_PullRel(offsetof(CONTEXT, shuffleIdentityResult));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Test.h"
+#include "Align16.h"
+
+class CMdConstantFoldTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	enum
+	{
+		OPERATION_COUNT = 44,
+	};
+
+	struct CONTEXT
+	{
+		ALIGN16
+
+		uint32 constants[4];
+		uint32 value[4];
+
+		uint32 foldedResults[OPERATION_COUNT][4];
+		uint32 computedResults[OPERATION_COUNT][4];
+
+		uint32 xorSelfResult[4];
+		uint32 subSelfResult[4];
+		uint32 cmpEqSelfResult[4];
+		uint32 cmpGtSelfResult[4];
+		uint32 minSelfResult[4];
+		uint32 andOnesResult[4];
+		uint32 andZeroResult[4];
+		uint32 orZeroResult[4];
+		uint32 orOnesResult[4];
+		uint32 addZeroResult[4];
+		uint32 subZeroResult[4];
+		uint32 shuffleIdentityResult[4];
+	};
+
+	void EmitOperands(Jitter::CJitter&, bool);
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,85 @@
+#include "MdFpLaneTest.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+//Context starts with the vector operated on by the test
+extern "C" void CMdFpLaneTest_Scale(float* value)
+{
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		value[i] *= 2;
+	}
+}
+
+void CMdFpLaneTest::PrepareExternalFunctions()
+{
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CMdFpLaneTest_Scale), "_CMdFpLaneTest_Scale", "vi");
+}
+
+void CMdFpLaneTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Scalar access to lanes of a vector also used by MD operations
+		jitter.FP_PushRel32(offsetof(CONTEXT, value[1]));
+		jitter.FP_PushRel32(offsetof(CONTEXT, value[2]));
+		jitter.FP_AddS();
+		jitter.FP_PullRel32(offsetof(CONTEXT, value[0]));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushRel(offsetof(CONTEXT, addend));
+		jitter.MD_AddS();
+		jitter.MD_PullRel(offsetof(CONTEXT, value));
+
+		jitter.FP_PushRel32(offsetof(CONTEXT, value[3]));
+		jitter.FP_PushRel32(offsetof(CONTEXT, value[0]));
+		jitter.FP_MulS();
+		jitter.FP_PullRel32(offsetof(CONTEXT, value[3]));
+
+		//Callee must see the updated vector and its changes must be visible afterwards
+		jitter.PushCtx();
+		jitter.Call(reinterpret_cast<void*>(&CMdFpLaneTest_Scale), 1, Jitter::CJitter::RETURN_VALUE_NONE);
+
+		jitter.FP_PushRel32(offsetof(CONTEXT, value[2]));
+		jitter.FP_PullRel32(offsetof(CONTEXT, laneResult));
+
+		jitter.FP_PushRel32(offsetof(CONTEXT, value[1]));
+		jitter.FP_NegS();
+		jitter.FP_PullRel32(offsetof(CONTEXT, value[1]));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, value));
+		jitter.MD_PushRel(offsetof(CONTEXT, addend));
+		jitter.MD_AddS();
+		jitter.MD_PullRel(offsetof(CONTEXT, result));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CMdFpLaneTest::Run()
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		m_context.value[i] = static_cast<float>(i + 1);
+		m_context.addend[i] = static_cast<float>((i + 1) * 10);
+	}
+	m_function(&m_context);
+
+	TEST_VERIFY(m_context.value[0] == 30.0f);
+	TEST_VERIFY(m_context.value[1] == -44.0f);
+	TEST_VERIFY(m_context.value[2] == 66.0f);
+	TEST_VERIFY(m_context.value[3] == 1320.0f);
+
+	TEST_VERIFY(m_context.result[0] == 40.0f);
+	TEST_VERIFY(m_context.result[1] == -24.0f);
+	TEST_VERIFY(m_context.result[2] == 96.0f);
+	TEST_VERIFY(m_context.result[3] == 1360.0f);
+
+	TEST_VERIFY(m_context.laneResult == 66.0f);
+}
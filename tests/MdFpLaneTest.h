@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Test.h"
+#include "Align16.h"
+
+class CMdFpLaneTest : public CTest
+{
+public:
+	static void PrepareExternalFunctions();
+
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		ALIGN16
+
+		float value[4];
+		float addend[4];
+		float result[4];
+		float laneResult;
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
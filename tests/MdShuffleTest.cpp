@@ -0,0 +1,85 @@
+#include "MdShuffleTest.h"
+#include "MemStream.h"
+
+static const std::array<uint8, 16> g_shuffleBReverse = {15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+static const std::array<uint8, 16> g_shuffleBMixed = {1, 0, 0, 3, 15, 7, 6, 6, 9, 12, 2, 2, 11, 8, 5, 14};
+
+void CMdShuffleTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		jitter.MD_PushRel(offsetof(CONTEXT, srcW));
+		jitter.MD_ShuffleW(0x1B);
+		jitter.MD_PullRel(offsetof(CONTEXT, dstShuffleWReverse));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, srcW));
+		jitter.MD_ShuffleW(0xAA);
+		jitter.MD_PullRel(offsetof(CONTEXT, dstShuffleWBroadcast));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, srcW));
+		jitter.MD_ShuffleW(0xE4);
+		jitter.MD_PullRel(offsetof(CONTEXT, dstShuffleWIdentity));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, srcW));
+		jitter.MD_ShuffleW(0x4D);
+		jitter.MD_PullRel(offsetof(CONTEXT, dstShuffleWMixed));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, dstShuffleWInPlace));
+		jitter.MD_ShuffleW(0x39);
+		jitter.MD_PullRel(offsetof(CONTEXT, dstShuffleWInPlace));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, srcB));
+		jitter.MD_ShuffleB(g_shuffleBReverse);
+		jitter.MD_PullRel(offsetof(CONTEXT, dstShuffleBReverse));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, srcB));
+		jitter.MD_ShuffleB(g_shuffleBMixed);
+		jitter.MD_PullRel(offsetof(CONTEXT, dstShuffleBMixed));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, dstShuffleBInPlace));
+		jitter.MD_ShuffleB(g_shuffleBMixed);
+		jitter.MD_PullRel(offsetof(CONTEXT, dstShuffleBInPlace));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CMdShuffleTest::Run()
+{
+	CONTEXT ALIGN16 context;
+	memset(&context, 0, sizeof(CONTEXT));
+
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		context.srcW[i] = 0x11111111 * (i + 1);
+		context.dstShuffleWInPlace[i] = 0x11111111 * (i + 1);
+	}
+
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		context.srcB[i] = static_cast<uint8>(0xA0 + i);
+		context.dstShuffleBInPlace[i] = static_cast<uint8>(0xA0 + i);
+	}
+
+	m_function(&context);
+
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		TEST_VERIFY(context.dstShuffleWReverse[i] == context.srcW[3 - i]);
+		TEST_VERIFY(context.dstShuffleWBroadcast[i] == context.srcW[2]);
+		TEST_VERIFY(context.dstShuffleWIdentity[i] == context.srcW[i]);
+		TEST_VERIFY(context.dstShuffleWMixed[i] == context.srcW[(0x4D >> (i * 2)) & 3]);
+		TEST_VERIFY(context.dstShuffleWInPlace[i] == context.srcW[(i + 1) & 3]);
+	}
+
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		TEST_VERIFY(context.dstShuffleBReverse[i] == context.srcB[g_shuffleBReverse[i]]);
+		TEST_VERIFY(context.dstShuffleBMixed[i] == context.srcB[g_shuffleBMixed[i]]);
+		TEST_VERIFY(context.dstShuffleBInPlace[i] == context.srcB[g_shuffleBMixed[i]]);
+	}
+}
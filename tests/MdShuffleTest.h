@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Test.h"
+#include "Align16.h"
+
+class CMdShuffleTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		ALIGN16
+
+		uint32 srcW[4];
+		uint8 srcB[16];
+
+		uint32 dstShuffleWReverse[4];
+		uint32 dstShuffleWBroadcast[4];
+		uint32 dstShuffleWIdentity[4];
+		uint32 dstShuffleWMixed[4];
+		uint32 dstShuffleWInPlace[4];
+
+		uint8 dstShuffleBReverse[16];
+		uint8 dstShuffleBMixed[16];
+		uint8 dstShuffleBInPlace[16];
+	};
+
+	FunctionType m_function;
+};
@@ -0,0 +1,208 @@
+#include "MemAccessRelAddrTest.h"
+#include "MemStream.h"
+
+//Accesses context fields through references obtained with PushRelAddrRef.
+//Accesses with constant offsets get turned into relative accesses by the jitter.
+
+static constexpr uint32 WORD_IDX_0 = 1;
+static constexpr uint32 WORD_IDX_1 = 3;
+static constexpr uint32 WORD_IDX_2 = 5;
+static constexpr uint32 WORD_IDX_3 = 6;
+static constexpr uint32 WORD_IDX_4 = 4;
+static constexpr uint32 WORD_IDX_5 = 7;
+static constexpr uint32 DWORD_IDX_0 = 1;
+static constexpr uint32 DWORD_IDX_1 = 2;
+static constexpr uint32 QWORD_IDX_0 = 0;
+static constexpr uint32 QWORD_IDX_1 = 1;
+static constexpr uint32 QWORD_IDX_2 = 2;
+static constexpr uint32 QWORD_IDX_3 = 3;
+
+static constexpr uint32 CONSTANT_1 = 0x12345678;
+static constexpr uint64 CONSTANT_2 = 0xFEDCBA9876543210ULL;
+static constexpr uint32 ALIAS_VALUE = 222;
+
+void CMemAccessRelAddrTest::Run()
+{
+	m_context = {};
+	for(unsigned int i = 0; i < WORD_COUNT; i++)
+	{
+		m_context.words[i] = 0x10101010 * (i + 1);
+	}
+	for(unsigned int i = 0; i < DWORD_COUNT; i++)
+	{
+		m_context.dwords[i] = 0x100000001ULL * (i + 1);
+	}
+	for(unsigned int i = 0; i < QWORD_COUNT; i++)
+	{
+		for(unsigned int j = 0; j < 4; j++)
+		{
+			m_context.qwords[i].nV[j] = (i << 4) | j;
+		}
+	}
+	m_context.wordVarIdx = WORD_IDX_3;
+	m_context.aliasIdx = WORD_IDX_0;
+	m_context.aliasValue = ALIAS_VALUE;
+
+	m_function(&m_context);
+	m_aliasFunction(&m_context);
+
+	TEST_VERIFY(m_context.wordResult == 0x20202020);
+	TEST_VERIFY(m_context.wordIdxResult == 0x40404040);
+	TEST_VERIFY(m_context.words[WORD_IDX_2] == CONSTANT_1);
+	TEST_VERIFY(m_context.wordSumResult == CONSTANT_1 + 0x40404040);
+
+	TEST_VERIFY(m_context.dwordResult == 0x200000002ULL);
+	TEST_VERIFY(m_context.dwords[DWORD_IDX_1] == CONSTANT_2);
+
+	TEST_VERIFY(m_context.qwordResult.nV[0] == 0x10);
+	TEST_VERIFY(m_context.qwordResult.nV[3] == 0x13);
+	TEST_VERIFY(m_context.qwords[QWORD_IDX_2].nV[0] == 0x10);
+	TEST_VERIFY(m_context.qwords[QWORD_IDX_2].nV[1] == 0x11);
+	TEST_VERIFY(m_context.qwords[QWORD_IDX_2].nV[2] == 0x12);
+	TEST_VERIFY(m_context.qwords[QWORD_IDX_2].nV[3] == 0x13);
+
+	//Lanes 1 and 2 come from memory
+	TEST_VERIFY(m_context.qwordMaskedResult.nV[0] == 0x10);
+	TEST_VERIFY(m_context.qwordMaskedResult.nV[1] == 0x31);
+	TEST_VERIFY(m_context.qwordMaskedResult.nV[2] == 0x32);
+	TEST_VERIFY(m_context.qwordMaskedResult.nV[3] == 0x13);
+
+	//Lanes 0 and 3 are written
+	TEST_VERIFY(m_context.qwords[QWORD_IDX_3].nV[0] == 0x00);
+	TEST_VERIFY(m_context.qwords[QWORD_IDX_3].nV[1] == 0x31);
+	TEST_VERIFY(m_context.qwords[QWORD_IDX_3].nV[2] == 0x32);
+	TEST_VERIFY(m_context.qwords[QWORD_IDX_3].nV[3] == 0x03);
+
+	TEST_VERIFY(m_context.byteResult == 0x50);
+	TEST_VERIFY(m_context.halfResult == 0x8080);
+
+	TEST_VERIFY(m_context.wordVarIdxResult == 0x70707070);
+	TEST_VERIFY(m_context.aliasResult0 == 0x20202020);
+	TEST_VERIFY(m_context.aliasResult1 == ALIAS_VALUE);
+}
+
+void CMemAccessRelAddrTest::Compile(Jitter::CJitter& jitter)
+{
+	CompileFunction(jitter);
+	CompileAliasFunction(jitter);
+}
+
+void CMemAccessRelAddrTest::CompileFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Load (constant offset)
+		jitter.PushRelAddrRef(offsetof(CONTEXT, words));
+		jitter.PushCst(WORD_IDX_0 * sizeof(uint32));
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.PullRel(offsetof(CONTEXT, wordResult));
+
+		//Load (constant index)
+		jitter.PushRelAddrRef(offsetof(CONTEXT, words));
+		jitter.PushCst(WORD_IDX_1);
+		jitter.LoadFromRefIdx();
+		jitter.PullRel(offsetof(CONTEXT, wordIdxResult));
+
+		//Store through reference, then read back as a relative
+		jitter.PushRelAddrRef(offsetof(CONTEXT, words));
+		jitter.PushCst(WORD_IDX_2);
+		jitter.PushCst(CONSTANT_1);
+		jitter.StoreAtRefIdx();
+
+		jitter.PushRel(offsetof(CONTEXT, words) + (WORD_IDX_2 * sizeof(uint32)));
+		jitter.PushRelAddrRef(offsetof(CONTEXT, words));
+		jitter.PushCst(WORD_IDX_1 * sizeof(uint32));
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, wordSumResult));
+
+		//64-bit load and store
+		jitter.PushRelAddrRef(offsetof(CONTEXT, dwords));
+		jitter.PushCst(DWORD_IDX_0 * sizeof(uint64));
+		jitter.AddRef();
+		jitter.Load64FromRef();
+		jitter.PullRel64(offsetof(CONTEXT, dwordResult));
+
+		jitter.PushRelAddrRef(offsetof(CONTEXT, dwords));
+		jitter.PushCst(DWORD_IDX_1 * sizeof(uint64));
+		jitter.PushCst64(CONSTANT_2);
+		jitter.Store64AtRefIdx(1);
+
+		//128-bit load and store
+		jitter.PushRelAddrRef(offsetof(CONTEXT, qwords));
+		jitter.PushCst(QWORD_IDX_1 * sizeof(uint128));
+		jitter.MD_LoadFromRefIdx(1);
+		jitter.MD_PullRel(offsetof(CONTEXT, qwordResult));
+
+		jitter.PushRelAddrRef(offsetof(CONTEXT, qwords));
+		jitter.PushCst(QWORD_IDX_2 * sizeof(uint128));
+		jitter.AddRef();
+		jitter.MD_PushRel(offsetof(CONTEXT, qwords) + (QWORD_IDX_1 * sizeof(uint128)));
+		jitter.MD_StoreAtRef();
+
+		//128-bit masked load and store
+		jitter.PushRelAddrRef(offsetof(CONTEXT, qwords));
+		jitter.PushCst(QWORD_IDX_3 * sizeof(uint128));
+		jitter.MD_PushRel(offsetof(CONTEXT, qwordResult));
+		jitter.MD_LoadFromRefIdxMasked(false, true, true, false);
+		jitter.MD_PullRel(offsetof(CONTEXT, qwordMaskedResult));
+
+		jitter.PushRelAddrRef(offsetof(CONTEXT, qwords));
+		jitter.PushCst(QWORD_IDX_3 * sizeof(uint128));
+		jitter.MD_PushRel(offsetof(CONTEXT, qwords) + (QWORD_IDX_0 * sizeof(uint128)));
+		jitter.MD_StoreAtRefIdxMasked(true, false, false, true);
+
+		//8-bit and 16-bit accesses are left alone
+		jitter.PushRelAddrRef(offsetof(CONTEXT, words));
+		jitter.PushCst(WORD_IDX_4 * sizeof(uint32));
+		jitter.AddRef();
+		jitter.Load8FromRef();
+		jitter.PullRel(offsetof(CONTEXT, byteResult));
+
+		jitter.PushRelAddrRef(offsetof(CONTEXT, words));
+		jitter.PushCst(WORD_IDX_5 * sizeof(uint32));
+		jitter.AddRef();
+		jitter.Load16FromRef();
+		jitter.PullRel(offsetof(CONTEXT, halfResult));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+//References accessed at a variable index may alias with any other access, nothing gets folded
+void CMemAccessRelAddrTest::CompileAliasFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		jitter.PushRelAddrRef(offsetof(CONTEXT, words));
+		jitter.PushRel(offsetof(CONTEXT, wordVarIdx));
+		jitter.LoadFromRefIdx();
+		jitter.PullRel(offsetof(CONTEXT, wordVarIdxResult));
+
+		jitter.PushRel(offsetof(CONTEXT, words) + (WORD_IDX_0 * sizeof(uint32)));
+		jitter.PullRel(offsetof(CONTEXT, aliasResult0));
+
+		jitter.PushRelAddrRef(offsetof(CONTEXT, words));
+		jitter.PushRel(offsetof(CONTEXT, aliasIdx));
+		jitter.PushRel(offsetof(CONTEXT, aliasValue));
+		jitter.StoreAtRefIdx();
+
+		jitter.PushRelAddrRef(offsetof(CONTEXT, words));
+		jitter.PushCst(WORD_IDX_0 * sizeof(uint32));
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.PullRel(offsetof(CONTEXT, aliasResult1));
+	}
+	jitter.End();
+
+	m_aliasFunction = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
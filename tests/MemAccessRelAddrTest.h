@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Test.h"
+#include "Align16.h"
+#include "uint128.h"
+
+class CMemAccessRelAddrTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	void CompileFunction(Jitter::CJitter&);
+	void CompileAliasFunction(Jitter::CJitter&);
+
+	static constexpr size_t WORD_COUNT = 8;
+	static constexpr size_t DWORD_COUNT = 4;
+	static constexpr size_t QWORD_COUNT = 4;
+
+	struct CONTEXT
+	{
+		ALIGN16
+
+		uint128 qwords[QWORD_COUNT];
+		uint64 dwords[DWORD_COUNT];
+		uint32 words[WORD_COUNT];
+
+		uint128 qwordResult;
+		uint128 qwordMaskedResult;
+		uint64 dwordResult;
+		uint32 wordResult;
+		uint32 wordIdxResult;
+		uint32 wordVarIdxResult;
+		uint32 wordSumResult;
+		uint32 byteResult;
+		uint32 halfResult;
+
+		uint32 wordVarIdx;
+		uint32 aliasIdx;
+		uint32 aliasValue;
+		uint32 aliasResult0;
+		uint32 aliasResult1;
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+	FunctionType m_aliasFunction;
+};
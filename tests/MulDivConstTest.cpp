@@ -0,0 +1,193 @@
+#include "MulDivConstTest.h"
+#include <random>
+#include "MemStream.h"
+
+// clang-format off
+static const uint32 g_fixedConstants[] =
+{
+	0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 15, 16, 17, 24, 25, 31, 40, 60, 100, 125, 641, 1000,
+	0x100, 0x1000, 0x10000, 0x10001, 0x40000000,
+	0x7FFFFFFF, 0x80000000, 0x80000001, 0xAAAAAAAB, 0xFFFFFFF0, 0xFFFFFFFD, 0xFFFFFFFE, 0xFFFFFFFF,
+	static_cast<uint32>(-3), static_cast<uint32>(-5), static_cast<uint32>(-7), static_cast<uint32>(-16), static_cast<uint32>(-1000)
+};
+
+static const uint32 g_fixedOperands[] =
+{
+	0, 1, 2, 3, 7, 0x7FFFFFFE, 0x7FFFFFFF, 0x80000000, 0x80000001, 0xFFFFFFFE, 0xFFFFFFFF
+};
+// clang-format on
+
+CMulDivConstTest::CMulDivConstTest(bool isSigned)
+    : m_isSigned(isSigned)
+{
+	static_assert((sizeof(g_fixedConstants) / sizeof(g_fixedConstants[0])) <= CONSTANT_COUNT, "Too many fixed constants.");
+
+	std::mt19937 generator(0xD1CE);
+	for(unsigned int i = 0; i < CONSTANT_COUNT; i++)
+	{
+		if(i < (sizeof(g_fixedConstants) / sizeof(g_fixedConstants[0])))
+		{
+			m_constants[i] = g_fixedConstants[i];
+		}
+		else if(i & 1)
+		{
+			//Combine two powers of two
+			uint32 constant = (1U << (generator() % 32)) + (1U << (generator() % 32));
+			m_constants[i] = (generator() & 1) ? constant : (0 - constant);
+		}
+		else
+		{
+			//Mix small and large constants
+			uint32 constant = generator();
+			constant >>= (generator() % 32);
+			m_constants[i] = (constant == 0) ? 1 : constant;
+		}
+	}
+}
+
+void CMulDivConstTest::Run()
+{
+	for(auto operand : g_fixedOperands)
+	{
+		CheckResults(operand);
+	}
+
+	std::mt19937 generator(0x1234567);
+	for(unsigned int i = 0; i < 0x4000; i++)
+	{
+		uint32 operand = generator();
+		operand >>= (generator() % 32);
+		CheckResults(operand);
+		CheckResults(0 - operand);
+	}
+}
+
+void CMulDivConstTest::CheckResults(uint32 operand)
+{
+	memset(&m_context, 0, sizeof(m_context));
+	m_context.operand = operand;
+
+	m_function(&m_context);
+
+	for(unsigned int i = 0; i < CONSTANT_COUNT; i++)
+	{
+		uint32 constant = m_constants[i];
+
+		uint64 product = 0;
+		if(m_isSigned)
+		{
+			product = static_cast<uint64>(static_cast<int64>(static_cast<int32>(operand)) * static_cast<int64>(static_cast<int32>(constant)));
+		}
+		else
+		{
+			product = static_cast<uint64>(operand) * static_cast<uint64>(constant);
+		}
+		TEST_VERIFY(m_context.productLo[i] == static_cast<uint32>(product));
+		TEST_VERIFY(m_context.productHi[i] == static_cast<uint32>(product >> 32));
+		TEST_VERIFY(m_context.lowOnlyProduct[i] == static_cast<uint32>(product));
+
+		//Division by zero is not compiled
+		if(constant == 0) continue;
+
+		uint32 quotient = 0;
+		uint32 remainder = 0;
+		if(m_isSigned)
+		{
+			if(static_cast<int32>(constant) == -1)
+			{
+				//Avoid overflow when dividend is INT_MIN
+				quotient = 0 - operand;
+				remainder = 0;
+			}
+			else
+			{
+				quotient = static_cast<int32>(operand) / static_cast<int32>(constant);
+				remainder = static_cast<int32>(operand) % static_cast<int32>(constant);
+			}
+		}
+		else
+		{
+			quotient = operand / constant;
+			remainder = operand % constant;
+		}
+		TEST_VERIFY(m_context.quotient[i] == quotient);
+		TEST_VERIFY(m_context.remainder[i] == remainder);
+	}
+}
+
+void CMulDivConstTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		for(unsigned int i = 0; i < CONSTANT_COUNT; i++)
+		{
+			uint32 constant = m_constants[i];
+
+			//Full product
+			jitter.PushRel(offsetof(CONTEXT, operand));
+			jitter.PushCst(constant);
+
+			if(m_isSigned)
+			{
+				jitter.MultS();
+			}
+			else
+			{
+				jitter.Mult();
+			}
+
+			jitter.PushTop();
+
+			jitter.ExtLow64();
+			jitter.PullRel(offsetof(CONTEXT, productLo[i]));
+
+			jitter.ExtHigh64();
+			jitter.PullRel(offsetof(CONTEXT, productHi[i]));
+
+			//Only low part of the product
+			jitter.PushCst(constant);
+			jitter.PushRel(offsetof(CONTEXT, operand));
+
+			if(m_isSigned)
+			{
+				jitter.MultS();
+			}
+			else
+			{
+				jitter.Mult();
+			}
+
+			jitter.ExtLow64();
+			jitter.PullRel(offsetof(CONTEXT, lowOnlyProduct[i]));
+
+			if(constant == 0) continue;
+
+			//Quotient and remainder
+			jitter.PushRel(offsetof(CONTEXT, operand));
+			jitter.PushCst(constant);
+
+			if(m_isSigned)
+			{
+				jitter.DivS();
+			}
+			else
+			{
+				jitter.Div();
+			}
+
+			jitter.PushTop();
+
+			jitter.ExtLow64();
+			jitter.PullRel(offsetof(CONTEXT, quotient[i]));
+
+			jitter.ExtHigh64();
+			jitter.PullRel(offsetof(CONTEXT, remainder[i]));
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
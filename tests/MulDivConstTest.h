@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include "Test.h"
+
+class CMulDivConstTest : public CTest
+{
+public:
+	CMulDivConstTest(bool);
+
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	enum
+	{
+		CONSTANT_COUNT = 80,
+	};
+
+	struct CONTEXT
+	{
+		uint32 operand;
+		uint32 productLo[CONSTANT_COUNT];
+		uint32 productHi[CONSTANT_COUNT];
+		uint32 lowOnlyProduct[CONSTANT_COUNT];
+		uint32 quotient[CONSTANT_COUNT];
+		uint32 remainder[CONSTANT_COUNT];
+	};
+
+	void CheckResults(uint32);
+
+	bool m_isSigned;
+	std::array<uint32, CONSTANT_COUNT> m_constants;
+	CONTEXT m_context;
+	FunctionType m_function;
+};
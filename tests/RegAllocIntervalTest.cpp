@@ -0,0 +1,93 @@
+#include "RegAllocIntervalTest.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+static uint32 g_accumulatedValue = 0;
+
+extern "C" void CRegAllocIntervalTest_Accumulate(uint32 value1, uint32 value2, uint32 value3)
+{
+	g_accumulatedValue = value1 + (value2 * 2) + (value3 * 3);
+}
+
+static uint32 GetInputValue(unsigned int index)
+{
+	return 0x10203040 * (index + 1) + 0x11;
+}
+
+void CRegAllocIntervalTest::PrepareExternalFunctions()
+{
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CRegAllocIntervalTest_Accumulate), "_CRegAllocIntervalTest_Accumulate", "viii");
+}
+
+void CRegAllocIntervalTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//More short lived symbols than there are registers, they must share registers
+		for(unsigned int i = 0; i < MAX_VARS / 2; i++)
+		{
+			jitter.PushRel(offsetof(CONTEXT, inValue[i]));
+			jitter.PushCst(i + 1);
+			jitter.Add();
+			jitter.PushRel(offsetof(CONTEXT, inValue[i]));
+			jitter.Xor();
+			jitter.PullRel(offsetof(CONTEXT, outValue[i]));
+		}
+
+		//Parameters are only consumed when the call is emitted
+		jitter.PushRel(offsetof(CONTEXT, paramValue[0]));
+		jitter.PushRel(offsetof(CONTEXT, paramValue[1]));
+		jitter.PushRel(offsetof(CONTEXT, paramValue[2]));
+		jitter.PushCst(1);
+		jitter.Add();
+		jitter.Call(reinterpret_cast<void*>(&CRegAllocIntervalTest_Accumulate), 3, Jitter::CJitter::RETURN_VALUE_NONE);
+
+		for(unsigned int i = MAX_VARS / 2; i < MAX_VARS; i++)
+		{
+			jitter.PushRel(offsetof(CONTEXT, inValue[i]));
+			jitter.PushRel(offsetof(CONTEXT, outValue[i - (MAX_VARS / 2)]));
+			jitter.Sub();
+			jitter.PullRel(offsetof(CONTEXT, outValue[i]));
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CRegAllocIntervalTest::Run()
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	for(unsigned int i = 0; i < MAX_VARS; i++)
+	{
+		m_context.inValue[i] = GetInputValue(i);
+	}
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		m_context.paramValue[i] = GetInputValue(MAX_VARS + i);
+	}
+	g_accumulatedValue = 0;
+	m_function(&m_context);
+
+	uint32 expectedOutValue[MAX_VARS];
+	for(unsigned int i = 0; i < MAX_VARS / 2; i++)
+	{
+		expectedOutValue[i] = (GetInputValue(i) + i + 1) ^ GetInputValue(i);
+	}
+	for(unsigned int i = MAX_VARS / 2; i < MAX_VARS; i++)
+	{
+		expectedOutValue[i] = GetInputValue(i) - expectedOutValue[i - (MAX_VARS / 2)];
+	}
+
+	for(unsigned int i = 0; i < MAX_VARS; i++)
+	{
+		TEST_VERIFY(m_context.inValue[i] == GetInputValue(i));
+		TEST_VERIFY(m_context.outValue[i] == expectedOutValue[i]);
+	}
+	uint32 expectedAccumulatedValue = GetInputValue(MAX_VARS + 0) + (GetInputValue(MAX_VARS + 1) * 2) + ((GetInputValue(MAX_VARS + 2) + 1) * 3);
+	TEST_VERIFY(g_accumulatedValue == expectedAccumulatedValue);
+}
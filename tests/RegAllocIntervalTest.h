@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Test.h"
+
+class CRegAllocIntervalTest : public CTest
+{
+public:
+	static void PrepareExternalFunctions();
+
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	enum MAX_VARS
+	{
+		MAX_VARS = 24,
+	};
+
+	struct CONTEXT
+	{
+		uint32 inValue[MAX_VARS];
+		uint32 outValue[MAX_VARS];
+		uint32 paramValue[3];
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,106 @@
+#include "RegAllocPressureTest.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+
+//Relatives used repeatedly are kept in registers while a large number of temporaries
+//are alive at the same time. On Wasm, registers and temporaries are both function locals.
+
+#define TEST_ACC0 (0x01234567)
+#define TEST_ACC1 (0x89ABCDEF)
+#define TEST_FP_ACC (3.0f)
+#define TEST_FP_SCALE (0.5f)
+
+void CRegAllocPressureTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		for(uint32 i = 0; i < ROUND_COUNT; i++)
+		{
+			jitter.PushRel(offsetof(CONTEXT, acc0));
+			jitter.PushRel(offsetof(CONTEXT, acc1));
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, acc0));
+
+			jitter.PushRel(offsetof(CONTEXT, acc1));
+			jitter.PushRel(offsetof(CONTEXT, acc0));
+			jitter.Xor();
+			jitter.PullRel(offsetof(CONTEXT, acc1));
+
+			jitter.FP_PushRel32(offsetof(CONTEXT, fpAcc));
+			jitter.FP_PushRel32(offsetof(CONTEXT, fpScale));
+			jitter.FP_MulS();
+			jitter.FP_PushRel32(offsetof(CONTEXT, fpScale));
+			jitter.FP_AddS();
+			jitter.FP_PullRel32(offsetof(CONTEXT, fpAcc));
+		}
+
+		//Registers need to be written back before leaving the block
+		jitter.PushRel(offsetof(CONTEXT, condition));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.PushRel(offsetof(CONTEXT, acc0));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, acc0));
+		}
+		jitter.EndIf();
+
+		//Every temporary stays alive until the sum is computed
+		for(uint32 i = 0; i < VALUE_COUNT; i++)
+		{
+			jitter.PushRel(offsetof(CONTEXT, values[i]));
+			jitter.PushRel(offsetof(CONTEXT, acc0));
+			jitter.Add();
+		}
+		for(uint32 i = 1; i < VALUE_COUNT; i++)
+		{
+			jitter.Add();
+		}
+		jitter.PullRel(offsetof(CONTEXT, sumResult));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CRegAllocPressureTest::Run()
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	for(uint32 i = 0; i < VALUE_COUNT; i++)
+	{
+		m_context.values[i] = (i * 0x01010101) ^ 0x5A5A5A5A;
+	}
+	m_context.acc0 = TEST_ACC0;
+	m_context.acc1 = TEST_ACC1;
+	m_context.fpAcc = TEST_FP_ACC;
+	m_context.fpScale = TEST_FP_SCALE;
+	m_context.condition = 1;
+
+	m_function(&m_context);
+
+	uint32 acc0 = TEST_ACC0;
+	uint32 acc1 = TEST_ACC1;
+	float fpAcc = TEST_FP_ACC;
+	for(uint32 i = 0; i < ROUND_COUNT; i++)
+	{
+		acc0 = acc0 + acc1;
+		acc1 = acc1 ^ acc0;
+		fpAcc = (fpAcc * TEST_FP_SCALE) + TEST_FP_SCALE;
+	}
+	acc0 += 1;
+
+	uint32 sum = 0;
+	for(uint32 i = 0; i < VALUE_COUNT; i++)
+	{
+		sum += m_context.values[i] + acc0;
+	}
+
+	TEST_VERIFY(m_context.acc0 == acc0);
+	TEST_VERIFY(m_context.acc1 == acc1);
+	TEST_VERIFY(m_context.fpAcc == fpAcc);
+	TEST_VERIFY(m_context.sumResult == sum);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Test.h"
+
+class CRegAllocPressureTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	//Enough values to need more locals than a single byte LEB128 count can hold on Wasm
+	static constexpr uint32 VALUE_COUNT = 160;
+	static constexpr uint32 ROUND_COUNT = 4;
+
+	struct CONTEXT
+	{
+		uint32 values[VALUE_COUNT];
+		uint32 acc0;
+		uint32 acc1;
+		float fpAcc;
+		float fpScale;
+		uint32 condition;
+		uint32 sumResult;
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,120 @@
+#include "ReplayTest.h"
+#include <stdexcept>
+#include "MemStream.h"
+
+#define CONSTANT_64 0x0123456789ABCDEFULL
+
+void CReplayTest::Run()
+{
+	TEST_VERIFY(m_serializationMatches);
+	TEST_VERIFY(m_invalidListsRejected);
+	TEST_VERIFY(m_codeMatches);
+
+	for(uint32 input = 0; input < 2; input++)
+	{
+		memset(&m_context, 0, sizeof(m_context));
+		m_context.input = input;
+
+		m_function(&m_context);
+
+		TEST_VERIFY(m_context.result0 == ((input != 0) ? ((input * 3) ^ 0x55) : 0xAA));
+		TEST_VERIFY(m_context.result1 == (CONSTANT_64 + input));
+	}
+}
+
+void CReplayTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream captureStream;
+	jitter.SetCaptureHandler(
+	    [&captureStream](const Jitter::StatementList& statements) {
+		    Jitter::SerializeStatementList(captureStream, statements);
+	    });
+
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.PushRel(offsetof(CONTEXT, input));
+			jitter.PushCst(3);
+			jitter.MultS();
+			jitter.ExtLow64();
+			jitter.PushCst(0x55);
+			jitter.Xor();
+			jitter.PullRel(offsetof(CONTEXT, result0));
+		}
+		jitter.Else();
+		{
+			jitter.PushCst(0xAA);
+			jitter.PullRel(offsetof(CONTEXT, result0));
+		}
+		jitter.EndIf();
+
+		jitter.PushCst64(CONSTANT_64);
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(0);
+		jitter.MergeTo64();
+		jitter.Add64();
+		jitter.PullRel64(offsetof(CONTEXT, result1));
+	}
+	jitter.End();
+
+	jitter.SetCaptureHandler(Jitter::CJitter::CaptureHandler());
+
+	//Read back the capture and compile it again
+	Jitter::CSymbolTable symbolTable;
+	captureStream.Seek(0, Framework::STREAM_SEEK_SET);
+	auto statements = Jitter::DeserializeStatementList(captureStream, symbolTable);
+
+	Framework::CMemStream serializedStream;
+	Jitter::SerializeStatementList(serializedStream, statements);
+	m_serializationMatches =
+	    (serializedStream.GetSize() == captureStream.GetSize()) &&
+	    (memcmp(serializedStream.GetBuffer(), captureStream.GetBuffer(), captureStream.GetSize()) == 0);
+
+	//Out of range operations and symbol types must be rejected
+	Framework::CMemStream validStream;
+	{
+		Jitter::CSymbolTable validSymbolTable;
+		Jitter::STATEMENT statement;
+		statement.op = Jitter::OP_MOV;
+		statement.dst = std::make_shared<Jitter::CSymbolRef>(validSymbolTable.MakeSymbol(Jitter::SYM_RELATIVE, offsetof(CONTEXT, result0), 0));
+		statement.src1 = std::make_shared<Jitter::CSymbolRef>(validSymbolTable.MakeSymbol(Jitter::SYM_CONSTANT, 0, 0));
+		Jitter::SerializeStatementList(validStream, Jitter::StatementList{statement});
+	}
+	auto isRejected =
+	    [&](uint32 position, uint8 value) {
+		    Framework::CMemStream invalidStream;
+		    invalidStream.Write(validStream.GetBuffer(), validStream.GetSize());
+		    invalidStream.Seek(position, Framework::STREAM_SEEK_SET);
+		    invalidStream.Write8(value);
+		    invalidStream.Seek(0, Framework::STREAM_SEEK_SET);
+		    try
+		    {
+			    Jitter::CSymbolTable invalidSymbolTable;
+			    Jitter::DeserializeStatementList(invalidStream, invalidSymbolTable);
+		    }
+		    catch(const std::runtime_error&)
+		    {
+			    return true;
+		    }
+		    return false;
+	    };
+	//Statement starts after magic (4 bytes), version (2 bytes) and statement count (4 bytes),
+	//its operation is at offset 10 and its first operand type follows condition, block and operand mask
+	m_invalidListsRejected = !isRejected(11, 0) && isRejected(11, 0xFF) && isRejected(18, 0x7F);
+
+	Framework::CMemStream replayCodeStream;
+	jitter.SetStream(&replayCodeStream);
+	jitter.Replay(statements);
+
+	m_codeMatches =
+	    (replayCodeStream.GetSize() == codeStream.GetSize()) &&
+	    (memcmp(replayCodeStream.GetBuffer(), codeStream.GetBuffer(), codeStream.GetSize()) == 0);
+
+	m_function = FunctionType(replayCodeStream.GetBuffer(), replayCodeStream.GetSize());
+}
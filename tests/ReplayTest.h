@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Test.h"
+
+class CReplayTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 input;
+		uint32 result0;
+		uint64 result1;
+	};
+
+	CONTEXT m_context;
+
+	bool m_codeMatches = false;
+	bool m_serializationMatches = false;
+	bool m_invalidListsRejected = false;
+
+	FunctionType m_function;
+};
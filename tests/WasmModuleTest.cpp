@@ -0,0 +1,216 @@
+#include "WasmModuleTest.h"
+#include <algorithm>
+#include <map>
+#include "Jitter_CodeGen_Wasm.h"
+#include "MemStream.h"
+#include "WasmDefs.h"
+#include "offsetof_def.h"
+
+//Functions generated between BeginModule and EndModule are written as a single module. Calls
+//to functions of the same module are direct calls.
+
+typedef std::map<uint8, std::vector<uint8>> SectionMap;
+
+//Only used to identify the callee, never executed
+static void WasmModuleTest_Callee(void*)
+{
+}
+
+static uint32 ReadULeb128(const std::vector<uint8>& data, size_t& position)
+{
+	uint32 value = 0;
+	for(unsigned int shift = 0;; shift += 7)
+	{
+		uint8 byte = data.at(position++);
+		value |= static_cast<uint32>(byte & 0x7F) << shift;
+		if((byte & 0x80) == 0) break;
+	}
+	return value;
+}
+
+static SectionMap ReadSections(const std::vector<uint8>& module)
+{
+	SectionMap sections;
+	size_t position = 8;
+	while(position < module.size())
+	{
+		uint8 sectionId = module[position++];
+		uint32 sectionSize = ReadULeb128(module, position);
+		sections[sectionId] = std::vector<uint8>(module.begin() + position, module.begin() + position + sectionSize);
+		position += sectionSize;
+	}
+	return sections;
+}
+
+void CWasmModuleTest::Run()
+{
+	//Output of the same function before modules could hold more than one function
+	// clang-format off
+	static const uint8 expectedSingleCode[] =
+	{
+		//Header
+		0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00,
+		//Section "Type"
+		0x01, 0x05, 0x01, 0x60, 0x01, 0x7F, 0x00,
+		//Section "Import"
+		0x02, 0x23, 0x02, 0x03, 0x65, 0x6E, 0x76, 0x06, 0x6D, 0x65, 0x6D, 0x6F, 0x72, 0x79, 0x02, 0x03,
+		0x01, 0x80, 0x80, 0x02, 0x03, 0x65, 0x6E, 0x76, 0x08, 0x66, 0x63, 0x74, 0x54, 0x61, 0x62, 0x6C,
+		0x65, 0x01, 0x70, 0x00, 0x01,
+		//Section "Function"
+		0x03, 0x02, 0x01, 0x00,
+		//Section "Export"
+		0x07, 0x0F, 0x01, 0x0B, 0x63, 0x6F, 0x64, 0x65, 0x47, 0x65, 0x6E, 0x46, 0x75, 0x6E, 0x63, 0x00,
+		0x00,
+		//Section "Code"
+		0x0A, 0x2E, 0x01, 0x2C, 0x01, 0x03, 0x7F, 0x02, 0x40, 0x20, 0x00, 0x41, 0x04, 0x6A, 0x28, 0x02,
+		0x00, 0x21, 0x02, 0x20, 0x00, 0x41, 0x00, 0x6A, 0x28, 0x02, 0x00, 0x21, 0x03, 0x20, 0x03, 0x20,
+		0x02, 0x6A, 0x21, 0x01, 0x20, 0x00, 0x41, 0x08, 0x6A, 0x20, 0x01, 0x36, 0x02, 0x00, 0x0B, 0x0B,
+	};
+	// clang-format on
+
+	TEST_VERIFY(m_singleCode.size() == sizeof(expectedSingleCode));
+	TEST_VERIFY(!memcmp(m_singleCode.data(), expectedSingleCode, sizeof(expectedSingleCode)));
+
+	static const uint8 expectedHeader[] = {0x00, 'a', 's', 'm', 0x01, 0x00, 0x00, 0x00};
+	TEST_VERIFY(m_moduleCode.size() >= sizeof(expectedHeader));
+	TEST_VERIFY(!memcmp(m_moduleCode.data(), expectedHeader, sizeof(expectedHeader)));
+
+	auto sections = ReadSections(m_moduleCode);
+
+	//The direct call doesn't need a signature of its own, all functions share the first one
+	{
+		const auto& typeSection = sections[Wasm::SECTION_ID_TYPE];
+		TEST_VERIFY(!typeSection.empty() && (typeSection[0] == 1));
+	}
+
+	{
+		static const std::vector<uint8> expectedFunctionSection = {0x02, 0x00, 0x00};
+		TEST_VERIFY(sections[Wasm::SECTION_ID_FUNCTION] == expectedFunctionSection);
+	}
+
+	{
+		// clang-format off
+		static const std::vector<uint8> expectedExportSection =
+		{
+			0x02,
+			0x0B, 'c', 'o', 'd', 'e', 'G', 'e', 'n', 'F', 'u', 'n', 'c', Wasm::IMPORT_EXPORT_TYPE_FUNCTION, 0x00,
+			0x0C, 'c', 'o', 'd', 'e', 'G', 'e', 'n', 'F', 'u', 'n', 'c', '1', Wasm::IMPORT_EXPORT_TYPE_FUNCTION, 0x01,
+		};
+		// clang-format on
+		TEST_VERIFY(sections[Wasm::SECTION_ID_EXPORT] == expectedExportSection);
+	}
+
+	{
+		const auto& codeSection = sections[Wasm::SECTION_ID_CODE];
+		size_t position = 0;
+		TEST_VERIFY(ReadULeb128(codeSection, position) == 2);
+		uint32 bodySize = ReadULeb128(codeSection, position);
+		std::vector<uint8> body(codeSection.begin() + position, codeSection.begin() + position + bodySize);
+
+		//The first function calls the second one with its context
+		static const uint8 expectedCall[] = {Wasm::INST_LOCAL_GET, 0x00, Wasm::INST_CALL, 0x01};
+		auto callIterator = std::search(body.begin(), body.end(), std::begin(expectedCall), std::end(expectedCall));
+		TEST_VERIFY(callIterator != body.end());
+	}
+
+	//Local counts take more than one byte, the function body must still end where its size says
+	{
+		auto localsSections = ReadSections(m_localsCode);
+		const auto& codeSection = localsSections[Wasm::SECTION_ID_CODE];
+		size_t position = 0;
+		TEST_VERIFY(ReadULeb128(codeSection, position) == 1);
+		uint32 bodySize = ReadULeb128(codeSection, position);
+		TEST_VERIFY((position + bodySize) == codeSection.size());
+		TEST_VERIFY(codeSection.back() == Wasm::INST_END);
+
+		uint32 localDeclCount = ReadULeb128(codeSection, position);
+		uint32 i32LocalCount = 0;
+		for(uint32 i = 0; i < localDeclCount; i++)
+		{
+			uint32 localCount = ReadULeb128(codeSection, position);
+			uint8 localType = codeSection.at(position++);
+			if(localType == Wasm::TYPE_I32) i32LocalCount += localCount;
+		}
+		TEST_VERIFY(i32LocalCount >= 0x80);
+	}
+}
+
+void CWasmModuleTest::Compile(Jitter::CJitter&)
+{
+	auto codeGen = new Jitter::CCodeGen_Wasm();
+	Jitter::CJitter jitter(codeGen);
+
+	{
+		Framework::CMemStream codeStream;
+		jitter.SetStream(&codeStream);
+
+		CompileFunction(jitter);
+
+		m_singleCode = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+	}
+
+	{
+		Framework::CMemStream codeStream;
+		jitter.SetStream(&codeStream);
+
+		codeGen->BeginModule();
+		codeGen->RegisterModuleFunction(reinterpret_cast<uintptr_t>(&WasmModuleTest_Callee), 1);
+
+		jitter.Begin();
+		{
+			jitter.PushCtx();
+			jitter.Call(reinterpret_cast<void*>(&WasmModuleTest_Callee), 1, Jitter::CJitter::RETURN_VALUE_NONE);
+		}
+		jitter.End();
+
+		CompileFunction(jitter);
+
+		//Nothing is written before the module is complete
+		TEST_VERIFY(codeStream.GetSize() == 0);
+
+		codeGen->EndModule();
+
+		m_moduleCode = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+	}
+
+	{
+		Framework::CMemStream codeStream;
+		jitter.SetStream(&codeStream);
+
+		CompileLocalsFunction(jitter);
+
+		m_localsCode = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+	}
+}
+
+void CWasmModuleTest::CompileFunction(Jitter::CJitter& jitter)
+{
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, result));
+	}
+	jitter.End();
+}
+
+void CWasmModuleTest::CompileLocalsFunction(Jitter::CJitter& jitter)
+{
+	//Every value stays alive until the sum is computed
+	jitter.Begin();
+	{
+		for(uint32 i = 0; i < LOCALS_VALUE_COUNT; i++)
+		{
+			jitter.PushRel(offsetof(CONTEXT, values) + (i * sizeof(uint32)));
+			jitter.PushCst(i + 1);
+			jitter.Add();
+		}
+		for(uint32 i = 1; i < LOCALS_VALUE_COUNT; i++)
+		{
+			jitter.Add();
+		}
+		jitter.PullRel(offsetof(CONTEXT, result));
+	}
+	jitter.End();
+}
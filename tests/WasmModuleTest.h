@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+
+class CWasmModuleTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	//Enough values to need more than 127 locals of the same type
+	static constexpr uint32 LOCALS_VALUE_COUNT = 160;
+
+	struct CONTEXT
+	{
+		uint32 value0;
+		uint32 value1;
+		uint32 result;
+		uint32 values[LOCALS_VALUE_COUNT];
+	};
+
+	static void CompileFunction(Jitter::CJitter&);
+	static void CompileLocalsFunction(Jitter::CJitter&);
+
+	std::vector<uint8> m_singleCode;
+	std::vector<uint8> m_moduleCode;
+	std::vector<uint8> m_localsCode;
+};
@@ -0,0 +1,149 @@
+#include "X86AssemblerTest.h"
+#include "X86Assembler.h"
+#include "MemStream.h"
+
+void CX86AssemblerTest::Run()
+{
+	//Reference encodings obtained from llvm-mc (x86_64)
+	// clang-format off
+	static const uint8 expectedCode[] =
+	{
+		0xF3, 0x0F, 0xBD, 0xC1,                   //lzcnt eax, ecx
+		0xF3, 0x44, 0x0F, 0xBD, 0x4B, 0x10,       //lzcnt r9d, [rbx + 0x10]
+		0xF3, 0x41, 0x0F, 0xBC, 0xD4,             //tzcnt edx, r12d
+		0xF3, 0x0F, 0xB8, 0xD8,                   //popcnt ebx, eax
+		0xF3, 0x41, 0x0F, 0xB8, 0xC7,             //popcnt eax, r15d
+		0xC4, 0xE2, 0x60, 0xF2, 0xC1,             //andn eax, ebx, ecx
+		0xC4, 0x62, 0x30, 0xF2, 0x45, 0x04,       //andn r8d, r9d, [rbp + 4]
+		0xC4, 0xE2, 0x68, 0xF5, 0xC1,             //bzhi eax, ecx, edx
+		0xC4, 0x42, 0x18, 0xF5, 0xD3,             //bzhi r10d, r11d, r12d
+		0xC4, 0xE2, 0x69, 0xF7, 0xC1,             //shlx eax, ecx, edx
+		0xC4, 0x62, 0x61, 0xF7, 0x6C, 0x24, 0x08, //shlx r13d, [rsp + 8], ebx
+		0xC4, 0xE2, 0x6B, 0xF7, 0xC1,             //shrx eax, ecx, edx
+		0xC4, 0xC2, 0x33, 0xF7, 0xDE,             //shrx ebx, r14d, r9d
+		0xC4, 0xE2, 0x6A, 0xF7, 0xC1,             //sarx eax, ecx, edx
+		0xC4, 0xE2, 0x2A, 0xF7, 0xD0,             //sarx edx, eax, r10d
+		0xC4, 0xE3, 0x7B, 0xF0, 0xC1, 0x05,       //rorx eax, ecx, 5
+		0xC4, 0x63, 0x7B, 0xF0, 0x1F, 0x1F,       //rorx r11d, [rdi], 31
+		0xC4, 0xE2, 0x71, 0xB9, 0xC2,             //vfmadd231ss xmm0, xmm1, xmm2
+		0xC4, 0x62, 0x61, 0xB9, 0x48, 0x08,       //vfmadd231ss xmm9, xmm3, [rax + 8]
+		0xC4, 0xE2, 0x71, 0xB8, 0xC2,             //vfmadd231ps xmm0, xmm1, xmm2
+		0xC4, 0x62, 0x09, 0xB8, 0x23,             //vfmadd231ps xmm12, xmm14, [rbx]
+		0x66, 0x0F, 0xC5, 0xC1, 0x03,             //pextrw eax, xmm1, 3
+		0x66, 0x41, 0x0F, 0xC5, 0xD1, 0x07,       //pextrw edx, xmm9, 7
+		0x66, 0x0F, 0xC4, 0xD0, 0x05,             //pinsrw xmm2, eax, 5
+		0x66, 0x45, 0x0F, 0xC4, 0xDA, 0x00,       //pinsrw xmm11, r10d, 0
+		0x66, 0x0F, 0xC4, 0x43, 0x06, 0x02,       //pinsrw xmm0, [rbx + 6], 2
+		0xC5, 0xF9, 0x70, 0xC1, 0x1B,             //vpshufd xmm0, xmm1, 0x1B
+		0xC5, 0x79, 0x70, 0x20, 0xE4,             //vpshufd xmm12, [rax], 0xE4
+		0xC4, 0xC1, 0x79, 0x70, 0xDD, 0x00,       //vpshufd xmm3, xmm13, 0x00
+		0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00,       //nop (6 bytes)
+		0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00, //nop (8 bytes)
+		0xE8, 0x78, 0x56, 0x34, 0x12,             //call +0x12345678
+		0xE9, 0xFC, 0xFF, 0xFF, 0xFF,             //jmp -4
+	};
+	// clang-format on
+
+	//Assembler output is padded for literal pool alignment
+	TEST_VERIFY(m_code.size() >= sizeof(expectedCode));
+	TEST_VERIFY(!memcmp(m_code.data(), expectedCode, sizeof(expectedCode)));
+
+	//Aligned labels, the forward jump only fits in a far jump once the padding is accounted for
+	// clang-format off
+	static const uint8 expectedAlignedCodeStart[] =
+	{
+		0x0F, 0x1F, 0x44, 0x00, 0x00,                         //nop (5 bytes)
+		0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00, //padding (9 bytes)
+		0x66, 0x90,                                           //padding (2 bytes)
+		0x0F, 0x1F, 0x00,                                     //loop: nop (3 bytes)
+		0x75, 0xFB,                                           //jnz loop
+		0xE9, 0x86, 0x00, 0x00, 0x00,                         //jmp done
+	};
+	static const uint8 expectedAlignedCodeEnd[] =
+	{
+		0x0F, 0x1F, 0x40, 0x00,                               //padding (4 bytes)
+		0xC3,                                                 //done: ret
+	};
+	// clang-format on
+
+	TEST_VERIFY(m_loopLabelOffset == 0x10);
+	TEST_VERIFY(m_doneLabelOffset == 0xA0);
+	TEST_VERIFY(m_alignedCode.size() >= (m_doneLabelOffset + 1));
+	TEST_VERIFY(!memcmp(m_alignedCode.data(), expectedAlignedCodeStart, sizeof(expectedAlignedCodeStart)));
+	TEST_VERIFY(!memcmp(m_alignedCode.data() + m_doneLabelOffset - 4, expectedAlignedCodeEnd, sizeof(expectedAlignedCodeEnd)));
+}
+
+void CX86AssemblerTest::Compile(Jitter::CJitter&)
+{
+	Framework::CMemStream codeStream;
+	CX86Assembler assembler;
+	assembler.SetStream(&codeStream);
+
+	assembler.Begin();
+	{
+		auto rootLabel = assembler.CreateLabel();
+		assembler.MarkLabel(rootLabel);
+
+		assembler.LzcntEd(CX86Assembler::rAX, CX86Assembler::MakeRegisterAddress(CX86Assembler::rCX));
+		assembler.LzcntEd(CX86Assembler::r9, CX86Assembler::MakeIndRegOffAddress(CX86Assembler::rBX, 0x10));
+		assembler.TzcntEd(CX86Assembler::rDX, CX86Assembler::MakeRegisterAddress(CX86Assembler::r12));
+		assembler.PopcntEd(CX86Assembler::rBX, CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX));
+		assembler.PopcntEd(CX86Assembler::rAX, CX86Assembler::MakeRegisterAddress(CX86Assembler::r15));
+		assembler.AndnEd(CX86Assembler::rAX, CX86Assembler::rBX, CX86Assembler::MakeRegisterAddress(CX86Assembler::rCX));
+		assembler.AndnEd(CX86Assembler::r8, CX86Assembler::r9, CX86Assembler::MakeIndRegOffAddress(CX86Assembler::rBP, 4));
+		assembler.BzhiEd(CX86Assembler::rAX, CX86Assembler::MakeRegisterAddress(CX86Assembler::rCX), CX86Assembler::rDX);
+		assembler.BzhiEd(CX86Assembler::r10, CX86Assembler::MakeRegisterAddress(CX86Assembler::r11), CX86Assembler::r12);
+		assembler.ShlxEd(CX86Assembler::rAX, CX86Assembler::MakeRegisterAddress(CX86Assembler::rCX), CX86Assembler::rDX);
+		assembler.ShlxEd(CX86Assembler::r13, CX86Assembler::MakeIndRegOffAddress(CX86Assembler::rSP, 8), CX86Assembler::rBX);
+		assembler.ShrxEd(CX86Assembler::rAX, CX86Assembler::MakeRegisterAddress(CX86Assembler::rCX), CX86Assembler::rDX);
+		assembler.ShrxEd(CX86Assembler::rBX, CX86Assembler::MakeRegisterAddress(CX86Assembler::r14), CX86Assembler::r9);
+		assembler.SarxEd(CX86Assembler::rAX, CX86Assembler::MakeRegisterAddress(CX86Assembler::rCX), CX86Assembler::rDX);
+		assembler.SarxEd(CX86Assembler::rDX, CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX), CX86Assembler::r10);
+		assembler.RorxEd(CX86Assembler::rAX, CX86Assembler::MakeRegisterAddress(CX86Assembler::rCX), 5);
+		assembler.RorxEd(CX86Assembler::r11, CX86Assembler::MakeIndRegAddress(CX86Assembler::rDI), 31);
+		assembler.Vfmadd231ssEd(CX86Assembler::xMM0, CX86Assembler::xMM1, CX86Assembler::MakeXmmRegisterAddress(CX86Assembler::xMM2));
+		assembler.Vfmadd231ssEd(CX86Assembler::xMM9, CX86Assembler::xMM3, CX86Assembler::MakeIndRegOffAddress(CX86Assembler::rAX, 8));
+		assembler.Vfmadd231psVo(CX86Assembler::xMM0, CX86Assembler::xMM1, CX86Assembler::MakeXmmRegisterAddress(CX86Assembler::xMM2));
+		assembler.Vfmadd231psVo(CX86Assembler::xMM12, CX86Assembler::xMM14, CX86Assembler::MakeIndRegAddress(CX86Assembler::rBX));
+		assembler.PextrwVo(CX86Assembler::rAX, CX86Assembler::xMM1, 3);
+		assembler.PextrwVo(CX86Assembler::rDX, CX86Assembler::xMM9, 7);
+		assembler.PinsrwVo(CX86Assembler::xMM2, CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX), 5);
+		assembler.PinsrwVo(CX86Assembler::xMM11, CX86Assembler::MakeRegisterAddress(CX86Assembler::r10), 0);
+		assembler.PinsrwVo(CX86Assembler::xMM0, CX86Assembler::MakeIndRegOffAddress(CX86Assembler::rBX, 6), 2);
+		assembler.VpshufdVo(CX86Assembler::xMM0, CX86Assembler::MakeXmmRegisterAddress(CX86Assembler::xMM1), 0x1B);
+		assembler.VpshufdVo(CX86Assembler::xMM12, CX86Assembler::MakeIndRegAddress(CX86Assembler::rAX), 0xE4);
+		assembler.VpshufdVo(CX86Assembler::xMM3, CX86Assembler::MakeXmmRegisterAddress(CX86Assembler::xMM13), 0x00);
+		assembler.Nop(6);
+		assembler.Nop(8);
+		assembler.CallJd(0x12345678);
+		assembler.JmpJd(0xFFFFFFFC);
+	}
+	assembler.End();
+
+	m_code = std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+
+	Framework::CMemStream alignedCodeStream;
+	assembler.SetStream(&alignedCodeStream);
+
+	assembler.Begin();
+
+	auto rootLabel = assembler.CreateLabel();
+	auto loopLabel = assembler.CreateLabel();
+	auto doneLabel = assembler.CreateLabel();
+	assembler.MarkLabel(rootLabel);
+
+	assembler.Nop(5);
+	assembler.MarkAlignedLabel(loopLabel, 0x10);
+	assembler.Nop(3);
+	assembler.JnzJx(loopLabel);
+	assembler.JmpJx(doneLabel);
+	assembler.Nop(130);
+	assembler.MarkAlignedLabel(doneLabel, 0x10);
+	assembler.Ret();
+
+	assembler.End();
+
+	m_loopLabelOffset = assembler.GetLabelOffset(loopLabel);
+	m_doneLabelOffset = assembler.GetLabelOffset(doneLabel);
+	m_alignedCode = std::vector<uint8>(alignedCodeStream.GetBuffer(), alignedCodeStream.GetBuffer() + alignedCodeStream.GetSize());
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+
+class CX86AssemblerTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	std::vector<uint8> m_code;
+	std::vector<uint8> m_alignedCode;
+	uint32 m_loopLabelOffset = 0;
+	uint32 m_doneLabelOffset = 0;
+};
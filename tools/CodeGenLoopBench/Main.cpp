@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+#include "Jitter.h"
+#include "Jitter_CodeGenFactory.h"
+#include "MemoryFunction.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+
+//Measures how the placement of a tight loop affects its speed. The loop is compiled once,
+//its head is aligned by the code generator. The code is then run behind a growing number of
+//NOPs, moving the loop head away from the alignment it was given, like it would be without it.
+
+// clang-format off
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	static const uint8 g_nop[] = { 0x90 };
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	static const uint8 g_nop[] = { 0x1F, 0x20, 0x03, 0xD5 };
+#elif defined(__arm__)
+	static const uint8 g_nop[] = { 0x00, 0xF0, 0x20, 0xE3 };
+#else
+	#error Architecture not supported
+#endif
+// clang-format on
+
+static const unsigned int g_maxShift = 64;
+
+struct CONTEXT
+{
+	uint32 counter;
+	uint32 value;
+	uint32 sum;
+};
+
+static std::vector<uint8> CompileLoop()
+{
+	Jitter::CJitter jitter(Jitter::CreateCodeGen());
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		auto loopLabel = jitter.CreateLabel();
+		jitter.MarkLabel(loopLabel);
+
+		//sum += (sum >> 3) ^ value
+		jitter.PushRel(offsetof(CONTEXT, sum));
+		jitter.PushRel(offsetof(CONTEXT, sum));
+		jitter.Srl(3);
+		jitter.PushRel(offsetof(CONTEXT, value));
+		jitter.Xor();
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, sum));
+
+		jitter.PushRel(offsetof(CONTEXT, counter));
+		jitter.PushCst(1);
+		jitter.Sub();
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		jitter.PushRel(offsetof(CONTEXT, counter));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.Goto(loopLabel);
+		}
+		jitter.EndIf();
+	}
+	jitter.End();
+
+	return std::vector<uint8>(codeStream.GetBuffer(), codeStream.GetBuffer() + codeStream.GetSize());
+}
+
+static double RunLoop(CMemoryFunction& function, uint32 iterations, unsigned int runs)
+{
+	double bestTime = 0;
+	for(unsigned int i = 0; i < runs; i++)
+	{
+		CONTEXT context = {};
+		context.counter = iterations;
+		context.value = 0x12345678;
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		function(&context);
+		auto endTime = std::chrono::high_resolution_clock::now();
+
+		if(context.counter != 0)
+		{
+			throw std::runtime_error("Loop didn't complete.");
+		}
+
+		double elapsed = std::chrono::duration<double>(endTime - startTime).count();
+		bestTime = (i == 0) ? elapsed : std::min(bestTime, elapsed);
+	}
+	return bestTime;
+}
+
+int main(int argc, const char** argv)
+{
+	uint32 iterations = (argc >= 2) ? strtoul(argv[1], nullptr, 0) : 100000000;
+	unsigned int runs = (argc >= 3) ? atoi(argv[2]) : 5;
+
+	try
+	{
+		auto code = CompileLoop();
+
+		printf("Code size:           %zu bytes\n", code.size());
+		printf("Iterations:          %u\n", iterations);
+		printf("\n%-10s %12s %14s\n", "Shift", "Time (ms)", "ns / iteration");
+
+		double alignedTime = 0;
+		double minTime = 0;
+		double maxTime = 0;
+		double totalTime = 0;
+		unsigned int count = 0;
+		for(unsigned int shift = 0; shift < g_maxShift; shift += sizeof(g_nop))
+		{
+			std::vector<uint8> shiftedCode;
+			for(unsigned int i = 0; i < shift; i += sizeof(g_nop))
+			{
+				shiftedCode.insert(shiftedCode.end(), std::begin(g_nop), std::end(g_nop));
+			}
+			shiftedCode.insert(shiftedCode.end(), code.begin(), code.end());
+
+			CMemoryFunction function(shiftedCode.data(), shiftedCode.size());
+			double time = RunLoop(function, iterations, runs);
+			printf("%-10u %12.3f %14.3f\n", shift, time * 1000.0, (time * 1000000000.0) / iterations);
+
+			if(shift == 0)
+			{
+				alignedTime = time;
+				continue;
+			}
+			minTime = (count == 0) ? time : std::min(minTime, time);
+			maxTime = std::max(maxTime, time);
+			totalTime += time;
+			count++;
+		}
+
+		printf("\nAligned:             %.3f ms\n", alignedTime * 1000.0);
+		printf("Shifted (mean):      %.3f ms\n", (totalTime / std::max<unsigned int>(count, 1)) * 1000.0);
+		printf("Shifted (best):      %.3f ms\n", minTime * 1000.0);
+		printf("Shifted (worst):     %.3f ms\n", maxTime * 1000.0);
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Error: %s\n", exception.what());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+#include <vector>
+#include "Jitter.h"
+#include "Jitter_CodeGenFactory.h"
+#include "MemStream.h"
+
+//Compiles functions captured with CJitter::SetCaptureHandler and reports compilation throughput.
+//The capture file is a sequence of lists written by SerializeStatementList.
+
+struct CAPTURED_FUNCTION
+{
+	Jitter::CSymbolTable symbolTable;
+	Jitter::StatementList statements;
+};
+typedef std::list<CAPTURED_FUNCTION> CapturedFunctionList;
+
+static CapturedFunctionList LoadCapture(const char* path)
+{
+	std::ifstream input(path, std::ios::binary);
+	if(!input)
+	{
+		throw std::runtime_error("Failed to open capture file.");
+	}
+	std::vector<char> contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+	Framework::CMemStream stream;
+	stream.Write(contents.data(), contents.size());
+	stream.Seek(0, Framework::STREAM_SEEK_SET);
+
+	CapturedFunctionList functions;
+	while(stream.Tell() < contents.size())
+	{
+		functions.emplace_back();
+		auto& function = functions.back();
+		function.statements = Jitter::DeserializeStatementList(stream, function.symbolTable);
+	}
+	return functions;
+}
+
+static void PrintCompileStats(const Jitter::CCompileStats& compileStats)
+{
+	typedef Jitter::CCompileStats CCompileStats;
+
+	printf("\n%-30s %10s %10s %12s %12s %12s\n", "Pass", "Runs", "Changes", "In", "Out", "Time (ms)");
+	for(unsigned int i = 0; i < CCompileStats::PASS_COUNT; i++)
+	{
+		auto pass = static_cast<CCompileStats::PASS>(i);
+		const auto& passStats = compileStats.GetPassStats(pass);
+		printf("%-30s %10llu %10llu %12llu %12llu %12.3f\n", CCompileStats::GetPassName(pass),
+		       static_cast<unsigned long long>(passStats.runCount), static_cast<unsigned long long>(passStats.changeCount),
+		       static_cast<unsigned long long>(passStats.statementsBefore), static_cast<unsigned long long>(passStats.statementsAfter),
+		       passStats.time.GetSum() / 1000000.0);
+	}
+
+	printf("\n%-30s %12s %12s %12s\n", "Value", "Mean", "Min", "Max");
+	for(unsigned int i = 0; i < CCompileStats::VALUE_COUNT; i++)
+	{
+		auto value = static_cast<CCompileStats::VALUE>(i);
+		const auto& histogram = compileStats.GetHistogram(value);
+		double mean = (histogram.GetCount() != 0) ? static_cast<double>(histogram.GetSum()) / histogram.GetCount() : 0;
+		printf("%-30s %12.1f %12llu %12llu\n", CCompileStats::GetValueName(value), mean,
+		       static_cast<unsigned long long>(histogram.GetMin()), static_cast<unsigned long long>(histogram.GetMax()));
+	}
+}
+
+int main(int argc, const char** argv)
+{
+	if(argc < 2)
+	{
+		printf("Usage: CodeGenReplay <capture file> [iterations]\n");
+		return 1;
+	}
+
+	unsigned int iterations = (argc >= 3) ? atoi(argv[2]) : 1;
+
+	try
+	{
+		auto functions = LoadCapture(argv[1]);
+
+		size_t statementCount = 0;
+		for(const auto& function : functions)
+		{
+			statementCount += function.statements.size();
+		}
+
+		Jitter::CJitter jitter(Jitter::CreateCodeGen());
+		Jitter::CCompileStats compileStats;
+		jitter.SetCompileStats(&compileStats);
+		uint64 codeSize = 0;
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		for(unsigned int i = 0; i < iterations; i++)
+		{
+			for(const auto& function : functions)
+			{
+				Framework::CMemStream codeStream;
+				jitter.SetStream(&codeStream);
+				jitter.Replay(function.statements);
+				codeSize += codeStream.GetSize();
+			}
+		}
+		auto endTime = std::chrono::high_resolution_clock::now();
+
+		double elapsed = std::chrono::duration<double>(endTime - startTime).count();
+		size_t compiledCount = functions.size() * iterations;
+
+		printf("Functions:           %zu\n", functions.size());
+		printf("Statements:          %zu\n", statementCount);
+		printf("Iterations:          %u\n", iterations);
+		printf("Code size:           %llu bytes\n", static_cast<unsigned long long>(codeSize / std::max<unsigned int>(iterations, 1)));
+		printf("Elapsed:             %.3f s\n", elapsed);
+		if(compiledCount != 0)
+		{
+			printf("Time per function:   %.2f us\n", (elapsed * 1000000.0) / compiledCount);
+			printf("Statements / second: %.0f\n", (statementCount * iterations) / elapsed);
+		}
+		PrintCompileStats(compileStats);
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Error: %s\n", exception.what());
+		return 1;
+	}
+
+	return 0;
+}